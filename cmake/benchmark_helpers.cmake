@@ -0,0 +1,81 @@
+include(CMakeParseArguments)
+# Benchmark registry for the top-level `bench` / `bench_baseline` targets.
+#
+# Usage (in any subdirectory, after the executable target exists):
+#   cpp_qa_lab_add_benchmark(<target> [ARGS <arg>...])
+#
+# Every registered program links csrc::microbench (BENCHMARK() files via csrc::microbench_main,
+# hand-written drivers through microbench::Report). python/bench_runner.py appends
+# --json=<file> --repetitions=<n> to ARGS and reads the per-repetition samples from the JSON.
+#
+# cpp_qa_lab_finalize_benchmarks() must be called once, after all subdirectories are added.
+# It writes <build>/bench/manifest.json and creates the targets.
+
+function(cpp_qa_lab_add_benchmark target)
+    set(options)
+    set(oneValueArgs)
+    set(multiValueArgs ARGS)
+    cmake_parse_arguments(PARSE_ARG "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+    if(PARSE_ARG_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR
+            "cpp_qa_lab_add_benchmark(${target}): unexpected ${PARSE_ARG_UNPARSED_ARGUMENTS}")
+    endif()
+
+    # Arguments are stored as a JSON array fragment; quotes and backslashes are escaped here
+    set(args_json "")
+    foreach(arg IN LISTS PARSE_ARG_ARGS)
+        string(REPLACE "\\" "\\\\" arg "${arg}")
+        string(REPLACE "\"" "\\\"" arg "${arg}")
+        if(args_json)
+            string(APPEND args_json ", ")
+        endif()
+        string(APPEND args_json "\"${arg}\"")
+    endforeach()
+
+    set(entry "    {\"name\": \"${target}\", ")
+    string(APPEND entry "\"path\": \"$<TARGET_FILE:${target}>\", \"args\": [${args_json}]}")
+    set_property(GLOBAL APPEND PROPERTY CPP_QA_LAB_BENCHMARK_ENTRIES "${entry}")
+    set_property(GLOBAL APPEND PROPERTY CPP_QA_LAB_BENCHMARK_TARGETS ${target})
+endfunction()
+
+function(cpp_qa_lab_finalize_benchmarks)
+    get_property(entries GLOBAL PROPERTY CPP_QA_LAB_BENCHMARK_ENTRIES)
+    get_property(targets GLOBAL PROPERTY CPP_QA_LAB_BENCHMARK_TARGETS)
+    if(NOT targets)
+        return()
+    endif()
+
+    find_package(Python3 COMPONENTS Interpreter)
+    if(NOT Python3_Interpreter_FOUND)
+        message(STATUS "Python3 not found: bench targets disabled")
+        return()
+    endif()
+
+    # Entries contain ';' only as list separators, so joining them gives the JSON array body
+    string(REPLACE ";" ",\n" entries_json "${entries}")
+    set(bench_dir ${CMAKE_BINARY_DIR}/bench)
+    file(GENERATE OUTPUT ${bench_dir}/manifest.json
+         CONTENT "{\n  \"benchmarks\": [\n${entries_json}\n  ]\n}\n")
+
+    # Extra runner options, e.g. -DBENCH_ARGS="--filter gemm --no-fail"
+    set(BENCH_ARGS "" CACHE STRING "Extra options passed to python/bench_runner.py")
+    separate_arguments(extra_args UNIX_COMMAND "${BENCH_ARGS}")
+    set(runner ${CMAKE_SOURCE_DIR}/python/bench_runner.py)
+    set(common_args --manifest ${bench_dir}/manifest.json --baseline ${bench_dir}/baseline.json
+                    --output ${bench_dir}/latest.json ${extra_args})
+
+    # bench: run everything, compare with the stored baseline, fail on significant regressions
+    add_custom_target(bench
+        COMMAND ${Python3_EXECUTABLE} ${runner} ${common_args}
+        DEPENDS ${targets}
+        USES_TERMINAL
+        COMMENT "Running registered benchmarks and comparing with baseline"
+    )
+    # bench_baseline: run everything and store the result as the new baseline
+    add_custom_target(bench_baseline
+        COMMAND ${Python3_EXECUTABLE} ${runner} ${common_args} --save-baseline
+        DEPENDS ${targets}
+        USES_TERMINAL
+        COMMENT "Running registered benchmarks and saving the baseline"
+    )
+endfunction()
@@ -11,20 +11,24 @@
  * 4. 灵活的节点管理和查找功能
  * 5. 便捷的节点添加和删除接口
  * 6. 自动缓存管理和安全的内存释放
+ * 7. 子树 Merkle 哈希去重（SubtreeDag）与按变化量比较两棵树（diffSubtrees）
  */
 
 #ifndef MULTI_TREE_HPP_
 #define MULTI_TREE_HPP_
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <memory>
 #include <queue>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -70,7 +74,7 @@ template <typename T> class TreeNode {
 
     void addInputName(const std::string & name) { input_names_.insert(name); }
 
-    void setNodeName(const std::string & node_name) { node_name_ = node_name; }
+    void setNodeName(std::string node_name) { node_name_ = std::move(node_name); }
 
     void setInputNames(const std::unordered_set<std::string> & input_names) {
         input_names_ = input_names;
@@ -286,6 +290,408 @@ template <typename T> class TreeNode {
     TreeNode *                      parent_{ nullptr };
 };
 
+/**
+ * 节点名称索引
+ *
+ * 按名称哈希分成 kShards 个分片，每个分片是一个 unordered_map。
+ * 普通查找与单个 map 没有区别；批量加载时每个分片可以交给一个线程独立建立。
+ */
+template <typename Node> class NameIndex {
+  public:
+    static constexpr size_t kShards = 64;
+
+    using shard_t = std::unordered_map<std::string, Node *>;
+
+    // 用哈希高位选分片，避免和分片内部 unordered_map 的取模相关
+    static size_t shardOf(size_t hash) { return (hash * 0x9E3779B97F4A7C15ULL) >> 58; }
+
+    static size_t shardOf(const std::string & name) {
+        return shardOf(std::hash<std::string>{}(name));
+    }
+
+    Node * find(const std::string & name) const {
+        const auto & shard = shards_[shardOf(name)];
+        auto         it    = shard.find(name);
+        return (it != shard.end()) ? it->second : nullptr;
+    }
+
+    // 同名时后写入的覆盖先写入的
+    void assign(const std::string & name, Node * node) { shards_[shardOf(name)][name] = node; }
+
+    void clear() {
+        for (auto & shard : shards_) {
+            shard.clear();
+        }
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto & shard : shards_) {
+            total += shard.size();
+        }
+        return total;
+    }
+
+    shard_t & shard(size_t index) { return shards_[index]; }
+
+  private:
+    std::vector<shard_t> shards_ = std::vector<shard_t>(kShards);
+};
+
+/**
+ * 子树结构去重：Merkle 哈希 + hash-consing
+ *
+ * 节点标签 = 名称 + 输入名集合（与顺序无关）+ 可选的载荷哈希；
+ * 子树哈希 = 标签哈希依次混入各子树哈希（子节点有序）。
+ * 后序遍历时按 (标签, 子树编号序列) 查表：结构相同就复用编号，否则分配新编号，
+ * 每个节点只查一次表，总代价 O(n)。查表时做精确比较，编号相等 <=> 子树完全相同，
+ * 不依赖哈希无碰撞。所有编号构成一个 DAG：重复的子树只保留一份。
+ *
+ * 同一个 SubtreeDag 可以 intern 多棵树，它们之间相同的子树得到相同编号，
+ * diffSubtrees 靠这一点跳过没有变化的子树。
+ * 节点指针作为 key 保存，intern 之后不能再修改或销毁这些树。
+ */
+template <typename T> class SubtreeDag {
+  public:
+    using node_t         = TreeNode<T>;
+    using payload_hash_t = std::function<uint64_t(const T &)>;
+
+    static constexpr uint32_t kNoId = std::numeric_limits<uint32_t>::max();
+
+    struct Entry {
+        uint64_t              hash;           // 子树 Merkle 哈希
+        uint64_t              label_hash;     // 只含本节点标签
+        uint64_t              payload_hash;   // 未提供载荷哈希或无载荷时为 0
+        const node_t *        representative; // 第一次遇到的该结构的节点
+        std::vector<uint32_t> children;       // 子节点的编号，保持原顺序
+        size_t                subtree_size;
+        size_t                occurrences;    // 在所有 intern 过的树中出现的次数
+        uint32_t              next_same_hash; // 哈希碰撞链
+    };
+
+    /**
+     * @param payload_hash 载荷参与比较时提供；为空时只比较名称和输入名
+     */
+    explicit SubtreeDag(payload_hash_t payload_hash = nullptr) :
+        payload_hash_(std::move(payload_hash)) {}
+
+    /**
+     * 把以 root 为根的子树加入 DAG，返回根的编号（root 为空返回 kNoId）
+     * 其中已经 intern 过的子树直接复用原编号，不重复计数
+     */
+    uint32_t intern(const node_t * root) {
+        if (!root) {
+            return kNoId;
+        }
+        if (uint32_t id = idOf(root); id != kNoId) {
+            return id;
+        }
+
+        // 栈式先序（子节点正序入栈、逆序弹出）的逆序恰好是子节点正序的后序，
+        // 处理到某个节点时它的各子树编号按顺序位于 ids 栈顶，不用再按指针查表；
+        // 不用递归，深链也不会爆栈。之前 intern 过的子树不再展开，直接复用编号
+        const bool                  has_known = !nodes_.empty();
+        std::vector<const node_t *> order;
+        std::vector<const node_t *> stack{ root };
+        while (!stack.empty()) {
+            const node_t * node = stack.back();
+            stack.pop_back();
+            order.push_back(node);
+            if (has_known && idOf(node) != kNoId) {
+                continue;
+            }
+            for (const auto & child : node->getChildren()) {
+                stack.push_back(child.get());
+            }
+        }
+
+        ids_.reserve(nodes_.size() + order.size());
+        nodes_.reserve(nodes_.size() + order.size());
+        std::vector<uint32_t> ids;
+        std::vector<uint32_t> child_ids;
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            if (uint32_t known = has_known ? idOf(*it) : kNoId; known != kNoId) {
+                ids.push_back(known);
+                continue;
+            }
+            const size_t child_count = (*it)->getChildrenCount();
+            child_ids.assign(ids.end() - child_count, ids.end());
+            ids.resize(ids.size() - child_count);
+            ids.push_back(internNode(*it, child_ids));
+            ids_.assign(keyOf(*it), ids.back());
+            nodes_.push_back(*it);
+        }
+        return ids.back();
+    }
+
+    uint32_t idOf(const node_t * node) const { return ids_.find(keyOf(node)); }
+
+    const Entry & entry(uint32_t id) const { return entries_.at(id); }
+
+    // 不同子树结构的数量（DAG 的节点数）
+    size_t size() const { return entries_.size(); }
+
+    // intern 过的原始节点数
+    size_t nodeCount() const { return nodes_.size(); }
+
+    /**
+     * 本节点标签（名称、输入名、载荷哈希）是否相同，不看子节点
+     */
+    bool sameLabel(const node_t * a, const node_t * b) const {
+        const Entry & ea = entry(idOf(a));
+        const Entry & eb = entry(idOf(b));
+        return ea.label_hash == eb.label_hash && ea.payload_hash == eb.payload_hash &&
+               a->getNodeName() == b->getNodeName() && a->getInputNames() == b->getInputNames();
+    }
+
+    /**
+     * 出现不止一次的子树，每组是结构相同的一批节点，按子树大小降序
+     * 嵌套在更大重复子树里的重复也会单独列出
+     */
+    std::vector<std::vector<const node_t *>> duplicateGroups(size_t min_subtree_size = 2) const {
+        std::vector<std::vector<const node_t *>> groups;
+        std::vector<size_t>                      group_of(entries_.size(), kNoGroup);
+        for (const node_t * node : nodes_) {
+            const uint32_t id = idOf(node);
+            const Entry &  e  = entries_[id];
+            if (e.occurrences < 2 || e.subtree_size < min_subtree_size) {
+                continue;
+            }
+            if (group_of[id] == kNoGroup) {
+                group_of[id] = groups.size();
+                groups.emplace_back();
+            }
+            groups[group_of[id]].push_back(node);
+        }
+        // 同样大小的组保持首次出现的顺序
+        std::stable_sort(groups.begin(), groups.end(), [&](const auto & a, const auto & b) {
+            return entries_[idOf(a.front())].subtree_size > entries_[idOf(b.front())].subtree_size;
+        });
+        return groups;
+    }
+
+  private:
+    static constexpr size_t kNoGroup = std::numeric_limits<size_t>::max();
+
+    /**
+     * 64 位键 -> 编号的开放寻址表，用于 节点指针 -> 编号 和 子树哈希 -> 碰撞链头
+     * 每个节点都要登记一次，unordered_map 逐个分配链表节点，插入开销比建 DAG 本身还大
+     */
+    class IdTable {
+      public:
+        void reserve(size_t n) {
+            if (n * 2 <= slots_.size()) {
+                return;
+            }
+            size_t capacity = 16;
+            while (capacity < n * 2) {
+                capacity *= 2;
+            }
+            std::vector<Slot> old(capacity, Slot{ 0, kNoId });
+            old.swap(slots_);
+            mask_ = capacity - 1;
+            for (const Slot & slot : old) {
+                if (slot.id != kNoId) {
+                    slots_[probe(slot.key)] = slot;
+                }
+            }
+        }
+
+        // 插入或覆盖
+        void assign(uint64_t key, uint32_t id) {
+            reserve(size_ + 1);
+            Slot & slot = slots_[probe(key)];
+            size_ += slot.id == kNoId;
+            slot = Slot{ key, id };
+        }
+
+        uint32_t find(uint64_t key) const {
+            return slots_.empty() ? kNoId : slots_[probe(key)].id;
+        }
+
+      private:
+        struct Slot {
+            uint64_t key;
+            uint32_t id; // kNoId 表示空槽
+        };
+
+        // 返回 key 所在的槽，或它应插入的空槽
+        size_t probe(uint64_t key) const {
+            size_t i = mix(key) & mask_;
+            while (slots_[i].id != kNoId && slots_[i].key != key) {
+                i = (i + 1) & mask_;
+            }
+            return i;
+        }
+
+        std::vector<Slot> slots_;
+        size_t            mask_ = 0;
+        size_t            size_ = 0;
+    };
+
+    static uint64_t keyOf(const node_t * node) { return reinterpret_cast<uintptr_t>(node); }
+
+    // splitmix64 的收尾混合
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    static uint64_t combine(uint64_t seed, uint64_t value) {
+        return mix(seed ^ (value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2)));
+    }
+
+    uint32_t internNode(const node_t * node, const std::vector<uint32_t> & child_ids) {
+        const std::hash<std::string> str_hash;
+
+        // 输入名是集合：各元素哈希混合后相加，与迭代顺序无关
+        uint64_t inputs_hash = 0;
+        for (const auto & input : node->getInputNames()) {
+            inputs_hash += mix(str_hash(input));
+        }
+        uint64_t payload_hash = 0;
+        if (payload_hash_ && node->hasData()) {
+            payload_hash = payload_hash_(*node->getData());
+        }
+        const uint64_t label_hash =
+            combine(combine(str_hash(node->getNodeName()), inputs_hash), payload_hash);
+
+        uint64_t hash         = combine(label_hash, child_ids.size());
+        size_t   subtree_size = 1;
+        for (uint32_t child : child_ids) {
+            hash = combine(hash, entries_[child].hash);
+            subtree_size += entries_[child].subtree_size;
+        }
+
+        const uint32_t head = by_hash_.find(hash);
+        for (uint32_t id = head; id != kNoId; id = entries_[id].next_same_hash) {
+            Entry & e = entries_[id];
+            if (e.label_hash == label_hash && e.payload_hash == payload_hash &&
+                e.children == child_ids &&
+                e.representative->getNodeName() == node->getNodeName() &&
+                e.representative->getInputNames() == node->getInputNames()) {
+                ++e.occurrences;
+                return id;
+            }
+        }
+
+        if (entries_.size() >= kNoId) {
+            throw std::length_error("SubtreeDag: too many distinct subtrees");
+        }
+        const auto id = static_cast<uint32_t>(entries_.size());
+        entries_.push_back(
+            Entry{ hash, label_hash, payload_hash, node, child_ids, subtree_size, 1, head });
+        by_hash_.assign(hash, id);
+        return id;
+    }
+
+    payload_hash_t              payload_hash_;
+    std::vector<Entry>          entries_;
+    IdTable                     by_hash_; // 子树哈希 -> 碰撞链头
+    IdTable                     ids_;     // 节点指针 -> 编号
+    std::vector<const node_t *> nodes_;   // 按 intern（后序）顺序
+};
+
+/**
+ * 两棵树的一处差异；Added / Removed 指整棵子树，只在子树根上报告一次
+ */
+template <typename T> struct TreeDiffEntry {
+    enum class Kind { Added, Removed, Modified };
+
+    Kind                kind;
+    const TreeNode<T> * before; // Added 时为空
+    const TreeNode<T> * after;  // Removed 时为空
+};
+
+/**
+ * 比较两棵已经 intern 进同一个 dag 的子树
+ *
+ * 编号相同的子树直接跳过，只沿着编号不同的路径往下走，代价与变化量（及其路径上的兄弟数）成正比。
+ * 名称不同视为"删旧增新"；名称相同但输入名或载荷不同报告 Modified 并继续比较子节点。
+ * 子节点按名称配对：同名的按出现顺序依次配对，配不上的报告 Removed / Added。
+ */
+template <typename T>
+std::vector<TreeDiffEntry<T>> diffSubtrees(const SubtreeDag<T> & dag, const TreeNode<T> * before,
+                                           const TreeNode<T> * after) {
+    using entry_t = TreeDiffEntry<T>;
+    using node_t  = TreeNode<T>;
+
+    std::vector<entry_t> changes;
+    if (!before || !after) {
+        if (before) {
+            changes.push_back({ entry_t::Kind::Removed, before, nullptr });
+        }
+        if (after) {
+            changes.push_back({ entry_t::Kind::Added, nullptr, after });
+        }
+        return changes;
+    }
+
+    std::vector<std::pair<const node_t *, const node_t *>> stack{ { before, after } };
+    std::unordered_map<std::string_view, std::vector<size_t>> after_by_name;
+    while (!stack.empty()) {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+        if (dag.idOf(a) == dag.idOf(b)) {
+            continue;
+        }
+        if (a->getNodeName() != b->getNodeName()) {
+            changes.push_back({ entry_t::Kind::Removed, a, nullptr });
+            changes.push_back({ entry_t::Kind::Added, nullptr, b });
+            continue;
+        }
+        if (!dag.sameLabel(a, b)) {
+            changes.push_back({ entry_t::Kind::Modified, a, b });
+        }
+
+        const auto & a_children = a->getChildren();
+        const auto & b_children = b->getChildren();
+
+        // 常见情况：子节点数量和名称逐个对应，直接按位置配对
+        bool positional = a_children.size() == b_children.size();
+        for (size_t i = 0; positional && i < a_children.size(); ++i) {
+            positional = a_children[i]->getNodeName() == b_children[i]->getNodeName();
+        }
+        // 逆序压栈，按原顺序弹出，差异按先序报告
+        if (positional) {
+            for (size_t i = a_children.size(); i-- > 0;) {
+                stack.push_back({ a_children[i].get(), b_children[i].get() });
+            }
+            continue;
+        }
+
+        after_by_name.clear();
+        for (size_t i = b_children.size(); i-- > 0;) {
+            after_by_name[b_children[i]->getNodeName()].push_back(i);
+        }
+        std::vector<bool>                                      matched(b_children.size(), false);
+        std::vector<std::pair<const node_t *, const node_t *>> pairs;
+        for (const auto & child : a_children) {
+            auto it = after_by_name.find(child->getNodeName());
+            if (it == after_by_name.end() || it->second.empty()) {
+                changes.push_back({ entry_t::Kind::Removed, child.get(), nullptr });
+                continue;
+            }
+            // 每个名字的下标是逆序压入的，back() 就是最靠前的未配对节点
+            const size_t j = it->second.back();
+            it->second.pop_back();
+            matched[j] = true;
+            pairs.push_back({ child.get(), b_children[j].get() });
+        }
+        for (size_t j = 0; j < b_children.size(); ++j) {
+            if (!matched[j]) {
+                changes.push_back({ entry_t::Kind::Added, nullptr, b_children[j].get() });
+            }
+        }
+        stack.insert(stack.end(), pairs.rbegin(), pairs.rend());
+    }
+    return changes;
+}
+
 /**
  * 通用多叉树
  * @tparam T 节点存储的数据类型
@@ -505,8 +911,7 @@ template <typename T> class MultiTree {
 
         if (use_cache_) {
             buildCacheIfNeeded();
-            auto it = name_cache_.find(node_name);
-            return (it != name_cache_.end()) ? it->second : nullptr;
+            return name_cache_.find(node_name);
         }
 
         for (auto * node : *this) {
@@ -594,16 +999,18 @@ template <typename T> class MultiTree {
         if (!parent) {
             return nullptr;
         }
-        invalidateCache();
-        return parent->createChild(std::forward<Args>(args)...);
+        auto * child = parent->createChild(std::forward<Args>(args)...);
+        updateCacheForNewNode(child);
+        return child;
     }
 
     template <typename... Args> node_t * createChildTo(node_t * parent, Args &&... args) {
         if (!parent) {
             throw std::invalid_argument("Parent node cannot be null");
         }
-        invalidateCache();
-        return parent->createChild(std::forward<Args>(args)...);
+        auto * child = parent->createChild(std::forward<Args>(args)...);
+        updateCacheForNewNode(child);
+        return child;
     }
 
     /**
@@ -749,19 +1156,7 @@ template <typename T> class MultiTree {
      * 合并同名节点的横向打印
      */
     void printTreeHorizontalMerged() const {
-        // 按层级收集节点，并去重同名节点
-        std::map<size_t, std::map<std::string, std::vector<const node_t *>>> level_nodes;
-        collectNodesByLevel(root_.get(), 0, level_nodes);
-
-        // 创建简化的层级结构
-        std::vector<std::vector<std::pair<std::string, std::vector<const node_t *>>>> levels;
-        for (const auto & [level, nodes_map] : level_nodes) {
-            std::vector<std::pair<std::string, std::vector<const node_t *>>> level_data;
-            for (const auto & [name, node_list] : nodes_map) {
-                level_data.push_back({ name, node_list });
-            }
-            levels.push_back(level_data);
-        }
+        const merged_levels_t levels = getMergedLevels();
 
         // 计算总宽度
         size_t max_width = 0;
@@ -796,6 +1191,80 @@ template <typename T> class MultiTree {
     }
 
   public:
+    // ========== 子树去重与比较 ==========
+
+    // 每层：(名称, 该层同名节点中各不同结构子树的代表节点)，按名称排序
+    using merged_levels_t =
+        std::vector<std::vector<std::pair<std::string, std::vector<const node_t *>>>>;
+
+    using payload_hash_t = typename SubtreeDag<T>::payload_hash_t;
+
+    /**
+     * 对整棵树做子树哈希去重，见 SubtreeDag
+     */
+    SubtreeDag<T> buildSubtreeDag(payload_hash_t payload_hash = nullptr) const {
+        SubtreeDag<T> dag(std::move(payload_hash));
+        dag.intern(root_.get());
+        return dag;
+    }
+
+    /**
+     * 合并打印用的分层数据
+     *
+     * 在 DAG 上按层展开：结构相同的子树只有一个编号，每层每个编号只展开一次，
+     * 重复的子树（比如模型里重复的 block）越多，省掉的遍历越多。
+     * 同名节点的子节点名集合是各代表节点子节点名的并集，和逐个节点收集的结果相同。
+     */
+    merged_levels_t getMergedLevels() const {
+        merged_levels_t levels;
+        if (isEmpty()) {
+            return levels;
+        }
+
+        const SubtreeDag<T>   dag = buildSubtreeDag();
+        std::vector<uint32_t> frontier{ dag.idOf(root_.get()) };
+        std::vector<uint32_t> next;
+        std::vector<size_t>   queued_at(dag.size(), 0); // 编号最近一次加入的层号 + 1
+
+        std::unordered_map<std::string_view, size_t> slot_of;
+        for (size_t level = 0; !frontier.empty(); ++level) {
+            auto & level_data = levels.emplace_back();
+            slot_of.clear();
+            next.clear();
+            for (uint32_t id : frontier) {
+                const auto & entry = dag.entry(id);
+                const auto & name  = entry.representative->getNodeName();
+                auto [it, inserted] = slot_of.emplace(name, level_data.size());
+                if (inserted) {
+                    level_data.push_back({ name, {} });
+                }
+                level_data[it->second].second.push_back(entry.representative);
+                for (uint32_t child : entry.children) {
+                    if (queued_at[child] != level + 2) {
+                        queued_at[child] = level + 2;
+                        next.push_back(child);
+                    }
+                }
+            }
+            std::sort(level_data.begin(), level_data.end(),
+                      [](const auto & a, const auto & b) { return a.first < b.first; });
+            frontier.swap(next);
+        }
+        return levels;
+    }
+
+    /**
+     * 与另一棵树比较，返回差异列表（见 diffSubtrees）
+     * 两棵树 intern 进同一个 DAG 是 O(n)；之后的比较只走有变化的路径
+     */
+    std::vector<TreeDiffEntry<T>> diff(const MultiTree & other,
+                                       payload_hash_t    payload_hash = nullptr) const {
+        SubtreeDag<T> dag(std::move(payload_hash));
+        dag.intern(root_.get());
+        dag.intern(other.root_.get());
+        return diffSubtrees(dag, root_.get(), other.root_.get());
+    }
+
     // ========== 缓存控制 ==========
 
     void enableCache(bool enable = true) {
@@ -811,14 +1280,26 @@ template <typename T> class MultiTree {
         buildCacheIfNeeded();
     }
 
+    /**
+     * 直接采用外部建好的名称索引（供批量加载使用，见 multi_tree_bulk_load.hpp）
+     * 调用者保证索引与当前树一致：每个非空名称都映射到树中同名的节点
+     */
+    void adoptNameIndex(NameIndex<node_t> index) {
+        name_cache_  = std::move(index);
+        cache_valid_ = use_cache_;
+        if (!use_cache_) {
+            name_cache_.clear();
+        }
+    }
+
   private:
     std::string tree_name_;
     node_ptr_t  root_{ nullptr };
 
     // 缓存相关
-    bool                                      use_cache_{ true };
-    bool                                      cache_valid_{ false };
-    std::unordered_map<std::string, node_t *> name_cache_;
+    bool              use_cache_{ true };
+    bool              cache_valid_{ false };
+    NameIndex<node_t> name_cache_;
 
     size_t calculateHeight(const node_t * node) const {
         if (!node || node->isLeaf()) {
@@ -859,7 +1340,7 @@ template <typename T> class MultiTree {
             for (auto * node : *this) {
                 const auto & name = node->getNodeName();
                 if (!name.empty()) {
-                    name_cache_[name] = node;
+                    name_cache_.assign(name, node);
                 }
             }
         }
@@ -869,32 +1350,29 @@ template <typename T> class MultiTree {
     void invalidateCache() { cache_valid_ = false; }
 
     /**
-     * 递归收集每一层的节点，按名称去重
+     * 新增节点后增量更新缓存，避免逐个 addNode 时每次都整树重建（O(n^2)）
+     * 同名节点已存在时，按层序"后者覆盖"的规则谁生效取决于位置，只能整体失效
      */
-    void collectNodesByLevel(
-        const node_t * node, size_t level,
-        std::map<size_t, std::map<std::string, std::vector<const node_t *>>> & level_nodes) const {
-        if (!node) {
+    void updateCacheForNewNode(node_t * node) {
+        if (!cache_valid_) {
             return;
         }
-
-        // 将节点添加到对应层级
-        level_nodes[level][node->getNodeName()].push_back(node);
-
-        // 递归处理子节点
-        for (const auto & child : node->getChildren()) {
-            collectNodesByLevel(child.get(), level + 1, level_nodes);
+        const auto & name = node->getNodeName();
+        if (name.empty()) {
+            return;
+        }
+        if (name_cache_.find(name) != nullptr) {
+            invalidateCache();
+            return;
         }
+        name_cache_.assign(name, node);
     }
 
     /**
      * 绘制合并同名节点后的树
      */
-    void drawMergedTree(
-        std::vector<std::vector<std::string>> & canvas,
-        const std::vector<std::vector<std::pair<std::string, std::vector<const node_t *>>>> &
-               levels,
-        size_t max_width) const {
+    void drawMergedTree(std::vector<std::vector<std::string>> & canvas,
+                        const merged_levels_t & levels, size_t max_width) const {
         if (levels.empty()) {
             return;
         }
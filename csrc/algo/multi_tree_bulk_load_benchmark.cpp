@@ -0,0 +1,347 @@
+/**
+ * @file multi_tree_bulk_load_benchmark.cpp
+ * @brief MultiTree 建树方式对比：逐个 createChildTo vs bulkLoadTree（串行 / OpenMP）vs CSV
+ *
+ * 输入是一棵随机递归树：节点 i 的父节点在 [0, i) 中均匀随机选取（深度约 ln n），
+ * 名字是 "node_<i>"，每个节点带一个 payload。
+ *
+ * 模式：
+ *   add_node      createRoot + 逐条 createChildTo(parent_name, ...)（每次按名字查父节点）
+ *   bulk_serial   bulkLoadTree + SerialBackend
+ *   bulk_openmp   bulkLoadTree + OpenMPBackend，按 --threads 逐个测
+ *   csv_openmp    loadTreeCsv（并行解析 CSV 文本 + bulkLoadTree），按 --threads 逐个测
+ *
+ * 用法: multi_tree_bulk_load_benchmark [--n N] [--threads 1,2,4] [--modes a,b]
+ *       [--repetitions=N] [--json=FILE]（microbench::Report 的 JSON 格式，供 bench 目标读取）
+ */
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "microbench.h"
+#include "multi_tree.hpp"
+#include "multi_tree_bulk_load.hpp"
+
+namespace {
+
+struct Payload {
+    uint64_t id = 0;
+
+    explicit Payload(uint64_t value) : id(value) {}
+};
+
+using Tree = algo::MultiTree<Payload>;
+using Edge = algo::TreeEdge<Payload>;
+
+struct BenchConfig {
+    size_t                   n       = 2000000;
+    std::vector<size_t>      threads = { 1, 2, 4 };
+    std::vector<std::string> modes   = { "add_node", "bulk_serial", "bulk_openmp", "csv_openmp" };
+    int                      reps    = 3;
+};
+
+struct BenchResult {
+    std::string         mode;
+    size_t              threads = 1;
+    std::vector<double> samples_seconds;
+    bool                correct = true;
+
+    std::string name() const { return mode + "/t" + std::to_string(threads); }
+
+    double median() const {
+        std::vector<double> sorted = samples_seconds;
+        std::sort(sorted.begin(), sorted.end());
+        size_t mid = sorted.size() / 2;
+        return sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+    }
+};
+
+std::vector<std::string> split_list(const std::string & s) {
+    std::vector<std::string> items;
+    std::stringstream        ss(s);
+    std::string              item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void print_usage(const char * prog) {
+    fmt::print("用法: {} [选项]\n"
+               "  --n N                  节点数（默认 2000000）\n"
+               "  --threads 1,2,4        OpenMP 线程数列表\n"
+               "  --modes a,b,...        add_node,bulk_serial,bulk_openmp,csv_openmp\n"
+               "  --repetitions=N        计时重复次数（默认 3）\n"
+               "  --json=FILE            输出 JSON 结果\n",
+               prog);
+}
+
+bool parse_args(int argc, char * argv[], BenchConfig & cfg) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg  = argv[i];
+        auto        next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--n") {
+            cfg.n = std::max<size_t>(1, std::strtoul(next().c_str(), nullptr, 10));
+        } else if (arg == "--threads") {
+            cfg.threads.clear();
+            for (const auto & v : split_list(next())) {
+                cfg.threads.push_back(std::max<size_t>(1, std::strtoul(v.c_str(), nullptr, 10)));
+            }
+        } else if (arg == "--modes") {
+            cfg.modes = split_list(next());
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    return true;
+}
+
+// ==================== 输入与校验 ====================
+
+struct Inputs {
+    std::vector<std::string> names;
+    std::vector<uint32_t>    parent; // parent[0] 无意义（根）
+    std::string              csv;
+};
+
+Inputs make_inputs(size_t n) {
+    Inputs       in;
+    std::mt19937 rng(2024);
+    in.names.resize(n);
+    in.parent.resize(n, 0);
+    std::ostringstream csv;
+    for (size_t i = 0; i < n; ++i) {
+        in.names[i] = "node_" + std::to_string(i);
+        if (i > 0) {
+            in.parent[i] = static_cast<uint32_t>(rng() % i);
+        }
+        csv << (i == 0 ? "" : in.names[in.parent[i]]) << ',' << in.names[i] << ',' << i << '\n';
+    }
+    in.csv = csv.str();
+    return in;
+}
+
+std::vector<Edge> make_edges(const Inputs & in) {
+    std::vector<Edge> edges(in.names.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+        edges[i].parent  = i == 0 ? std::string() : in.names[in.parent[i]];
+        edges[i].child   = in.names[i];
+        edges[i].payload = std::make_unique<Payload>(i);
+    }
+    return edges;
+}
+
+// 层序遍历摘要：名字、payload 和子节点数都参与，子节点顺序不同摘要也不同
+uint64_t digest(const Tree & tree) {
+    uint64_t h   = 1469598103934665603ULL;
+    auto     mix = [&h](uint64_t v) { h = (h ^ v) * 1099511628211ULL; };
+    for (const auto * node : tree) {
+        mix(std::hash<std::string>{}(node->getNodeName()));
+        mix(node->hasData() ? node->getData()->id : ~0ULL);
+        mix(node->getChildrenCount());
+    }
+    return h;
+}
+
+// 名称索引抽查：每隔一段取一个名字
+bool index_ok(const Tree & tree, const Inputs & in) {
+    for (size_t i = 0; i < in.names.size(); i += 997) {
+        const auto * node = tree.findNodeByName(in.names[i]);
+        if (node == nullptr || node->getData()->id != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Tree build_add_node(const Inputs & in) {
+    Tree tree("add_node");
+    tree.createRoot(in.names[0], std::unordered_set<std::string>{}, std::make_unique<Payload>(0));
+    for (size_t i = 1; i < in.names.size(); ++i) {
+        tree.createChildTo(in.names[in.parent[i]], in.names[i], std::unordered_set<std::string>{},
+                           std::make_unique<Payload>(i));
+    }
+    return tree;
+}
+
+std::unique_ptr<Payload> parse_payload(std::string_view field) {
+    uint64_t value = 0;
+    for (char c : field) {
+        value = value * 10 + static_cast<uint64_t>(c - '0');
+    }
+    return std::make_unique<Payload>(value);
+}
+
+template <typename Build>
+BenchResult measure(const BenchConfig & cfg, const Inputs & in, const std::string & mode,
+                    size_t threads, uint64_t expected, Build && build) {
+    BenchResult r;
+    r.mode    = mode;
+    r.threads = threads;
+    for (int rep = 0; rep < cfg.reps; ++rep) {
+        auto [seconds, tree] = build();
+        r.samples_seconds.push_back(seconds);
+        r.correct = r.correct && tree.getNodeCount() == cfg.n && digest(tree) == expected &&
+                    index_ok(tree, in);
+    }
+    return r;
+}
+
+// 计时只覆盖建树本身；边列表的准备和树的析构不计入
+template <typename Backend>
+std::pair<double, Tree> timed_bulk(Backend & backend, const Inputs & in) {
+    std::vector<Edge> edges = make_edges(in);
+    Tree              tree;
+    double            seconds = microbench::Seconds(
+        [&] { tree = algo::bulkLoadTree(backend, std::move(edges), "bulk"); });
+    return { seconds, std::move(tree) };
+}
+
+template <typename Backend>
+std::pair<double, Tree> timed_csv(Backend & backend, const Inputs & in) {
+    std::istringstream csv(in.csv);
+    Tree               tree;
+    double             seconds = microbench::Seconds(
+        [&] { tree = algo::loadTreeCsv<Payload>(backend, csv, parse_payload, "csv"); });
+    return { seconds, std::move(tree) };
+}
+
+bool wants(const std::vector<std::string> & list, const std::string & name) {
+    return std::find(list.begin(), list.end(), name) != list.end();
+}
+
+// ==================== 输出 ====================
+
+void print_results(const BenchConfig & cfg, const std::vector<BenchResult> & results) {
+    double baseline = 0.0;
+    for (const BenchResult & r : results) {
+        if (r.mode == "add_node") {
+            baseline = r.median();
+        }
+    }
+    fmt::print("\nn = {}，单位 ms，括号内为相对 add_node 的加速比\n", cfg.n);
+    fmt::print("  {:<14}", "模式");
+    for (size_t t : cfg.threads) {
+        fmt::print(" {:>18}", fmt::format("{} 线程", t));
+    }
+    fmt::print("\n");
+    for (const std::string & mode : cfg.modes) {
+        bool any = false;
+        for (const BenchResult & r : results) {
+            any = any || r.mode == mode;
+        }
+        if (!any) {
+            continue;
+        }
+        fmt::print("  {:<14}", mode);
+        for (size_t t : cfg.threads) {
+            std::string cell = "-";
+            for (const BenchResult & r : results) {
+                if (r.mode == mode && r.threads == t) {
+                    double ms = r.median() * 1e3;
+                    cell      = baseline > 0 ? fmt::format("{:.1f} ({:.2f}x){}", ms,
+                                                           baseline / r.median(),
+                                                           r.correct ? "" : " 错误")
+                                             : fmt::format("{:.1f}", ms);
+                }
+            }
+            fmt::print(" {:>18}", cell);
+        }
+        fmt::print("\n");
+    }
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    BenchConfig                       cfg;
+    std::optional<microbench::Report> report;
+    try {
+        report.emplace(argc, argv, cfg.reps);
+        cfg.reps = report->repetitions();
+        if (!parse_args(argc, argv, cfg)) {
+            return 0;
+        }
+    } catch (const std::exception & e) {
+        fmt::print(stderr, "参数错误: {}\n", e.what());
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    fmt::print("MultiTree 批量加载基准（createChildTo vs bulkLoadTree vs CSV）\n");
+    fmt::print("=====================================\n");
+    fmt::print("n = {}，硬件线程 {}，每项重复 {} 次取中位数\n", cfg.n,
+               std::thread::hardware_concurrency(), cfg.reps);
+
+    const Inputs in = make_inputs(cfg.n);
+    uint64_t     expected;
+    {
+        parallel::SerialBackend serial;
+        expected = digest(timed_bulk(serial, in).second);
+    }
+
+    std::vector<BenchResult> results;
+    const size_t             first_t = cfg.threads.front();
+    if (wants(cfg.modes, "add_node")) {
+        results.push_back(measure(cfg, in, "add_node", first_t, expected, [&] {
+            Tree   tree;
+            double seconds = microbench::Seconds([&] { tree = build_add_node(in); });
+            return std::pair<double, Tree>(seconds, std::move(tree));
+        }));
+    }
+    if (wants(cfg.modes, "bulk_serial")) {
+        parallel::SerialBackend serial;
+        results.push_back(measure(cfg, in, "bulk_serial", first_t, expected,
+                                  [&] { return timed_bulk(serial, in); }));
+    }
+    for (size_t t : cfg.threads) {
+        parallel::OpenMPBackend omp(t);
+        if (wants(cfg.modes, "bulk_openmp")) {
+            results.push_back(measure(cfg, in, "bulk_openmp", t, expected,
+                                      [&] { return timed_bulk(omp, in); }));
+        }
+        if (wants(cfg.modes, "csv_openmp")) {
+            results.push_back(measure(cfg, in, "csv_openmp", t, expected,
+                                      [&] { return timed_csv(omp, in); }));
+        }
+    }
+    print_results(cfg, results);
+
+    bool all_correct = true;
+    for (const BenchResult & r : results) {
+        all_correct = all_correct && r.correct;
+    }
+    fmt::print("\n结果一致: {}\n", all_correct ? "yes" : "NO");
+    // 样本按节点数折算成 ns/节点
+    for (const BenchResult & r : results) {
+        report->Add(r.name(), r.samples_seconds, cfg.n).correct = r.correct;
+    }
+    int status = report->Finish();
+
+    fmt::print("\n关键学习点：\n");
+    fmt::print("1. 逐个 createChildTo 每次都要按名字哈希查父节点，还要逐个分配节点，只能单线程\n");
+    fmt::print("2. 批量加载把名字解析、排序、校验都变成平坦的并行阶段，只有根的判定是串行的\n");
+    fmt::print("3. (父编号, 边序号) 的基数排序就是计数排序建 CSR，同时保住了子节点的输入顺序\n");
+    fmt::print("4. 单核上并行版本不会更快；它省下的是逐条调用的哈希查找和缓存维护\n");
+    return status;
+}
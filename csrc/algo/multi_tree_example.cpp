@@ -5,9 +5,11 @@
  */
 
 #include <iostream>
+#include <sstream>
 #include <string>
 
 #include "multi_tree.hpp"
+#include "multi_tree_bulk_load.hpp"
 
 // 简单的节点数据类型
 struct SimpleNodeData {
@@ -488,6 +490,115 @@ void example15_merge_nodes() {
     std::cout << "  - 这在显示有循环引用或共享节点的图结构时非常有用\n";
 }
 
+/**
+ * 示例16: 批量加载 - 从边列表 / CSV 一次建树
+ */
+void example16_bulk_load() {
+    printSeparator("示例16: 批量加载");
+
+    // OpenMPBackend 在未启用 OpenMP 时退化为串行
+    parallel::OpenMPBackend backend;
+
+    // (parent, child, payload) 边列表；parent 为空表示根，子节点顺序与输入一致
+    std::vector<algo::TreeEdge<SimpleNodeData>> edges;
+    edges.push_back({ "", "model", std::make_unique<SimpleNodeData>(0, "根") });
+    edges.push_back({ "model", "encoder", std::make_unique<SimpleNodeData>(1, "编码器") });
+    edges.push_back({ "model", "decoder", nullptr });
+    edges.push_back({ "encoder", "attention", nullptr });
+    edges.push_back({ "decoder", "output", std::make_unique<SimpleNodeData>(2, "输出层") });
+
+    auto tree = algo::bulkLoadTree(backend, std::move(edges), "批量加载");
+    tree.printTree(true);
+
+    // 名称索引在加载时已经建好，查找不需要再遍历
+    auto * output = tree.findNodeByName("output");
+    std::cout << "查找 output: " << output->getData()->description_ << std::endl;
+
+    // CSV：parent,child[,payload]；这里没有显式根，"graph" 不是任何边的子节点，成为隐式根
+    std::istringstream csv("# parent,child,value\n"
+                           "graph,conv1,10\n"
+                           "graph,conv2,20\n"
+                           "conv1,relu1,\n"
+                           "conv2,relu2,30\n");
+    auto               csv_tree = algo::loadTreeCsv<SimpleNodeData>(
+        backend, csv,
+        [](std::string_view field) -> std::unique_ptr<SimpleNodeData> {
+            if (field.empty()) {
+                return nullptr;
+            }
+            return std::make_unique<SimpleNodeData>(std::stoi(std::string(field)), "csv");
+        },
+        "CSV 加载");
+    csv_tree.printTree();
+
+    // 校验：环、多个根都会抛出 std::invalid_argument
+    std::vector<algo::TreeEdge<SimpleNodeData>> bad;
+    bad.push_back({ "a", "b", nullptr });
+    bad.push_back({ "c", "d", nullptr });
+    try {
+        algo::bulkLoadTree(backend, std::move(bad));
+    } catch (const std::invalid_argument & e) {
+        std::cout << "校验失败（预期）: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * 示例17: 子树哈希去重与树比较
+ */
+void example17_subtree_dedup() {
+    printSeparator("示例17: 子树哈希去重与树比较");
+
+    // 两个结构完全相同的 block（名称、输入名、子节点都一样）
+    auto build = [](algo::MultiTree<SimpleNodeData> & tree, int fc_value) {
+        auto * root = tree.createRoot("model");
+        for (const char * block_name : { "block", "block" }) {
+            auto * block = root->createChild(block_name);
+            auto * attn  = block->createChild("attention", std::unordered_set<std::string>{ "x" });
+            attn->createChild("softmax");
+            block->createChild("mlp")->createChild(
+                "fc", std::unordered_set<std::string>{},
+                std::make_unique<SimpleNodeData>(fc_value, "fc"));
+        }
+        root->createChild("head");
+    };
+
+    algo::MultiTree<SimpleNodeData> tree("去重示例");
+    build(tree, 1);
+    tree.printTree();
+
+    // 载荷默认不参与比较；需要时传入载荷哈希
+    auto payload_hash = [](const SimpleNodeData & data) {
+        return static_cast<uint64_t>(data.value_);
+    };
+    auto dag = tree.buildSubtreeDag(payload_hash);
+    std::cout << "节点数 " << dag.nodeCount() << "，不同子树 " << dag.size() << std::endl;
+    for (const auto & group : dag.duplicateGroups()) {
+        std::cout << "  重复 " << group.size() << " 次: " << group.front()->getNodeName()
+                  << "（子树大小 " << dag.entry(dag.idOf(group.front())).subtree_size << "）\n";
+    }
+
+    // 合并打印在 DAG 上展开，两个 block 只展开一次
+    tree.printTreeHorizontal(true);
+
+    // 比较：改一个载荷、加一个节点；相同的子树整棵跳过
+    algo::MultiTree<SimpleNodeData> changed("修改后");
+    build(changed, 1);
+    changed.getRoot()->getChildAt(1)->getChildAt(1)->getChildAt(0)->getData()->value_ = 2;
+    changed.getRoot()->getChildAt(2)->createChild("argmax");
+
+    for (const auto & change : tree.diff(changed, payload_hash)) {
+        using Kind = algo::TreeDiffEntry<SimpleNodeData>::Kind;
+        const char * kind = "修改";
+        if (change.kind == Kind::Added) {
+            kind = "新增";
+        } else if (change.kind == Kind::Removed) {
+            kind = "删除";
+        }
+        const auto * node = change.after ? change.after : change.before;
+        std::cout << "  " << kind << ": " << node->getNodeName() << std::endl;
+    }
+}
+
 int main() {
     std::cout << "=========================================\n";
     std::cout << "   MultiTree 多叉树使用示例\n";
@@ -509,6 +620,8 @@ int main() {
         example13_print_tree();
         example14_print_tree_horizontal();
         example15_merge_nodes();
+        example16_bulk_load();
+        example17_subtree_dedup();
 
         std::cout << "\n所有示例执行完成！\n";
 
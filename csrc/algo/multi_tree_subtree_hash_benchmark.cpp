@@ -0,0 +1,372 @@
+/**
+ * @file multi_tree_subtree_hash_benchmark.cpp
+ * @brief MultiTree 子树哈希去重：合并打印的分层收集、两棵树的比较
+ *
+ * 输入模拟重复 block 的模型：根下挂 --blocks 个 block，每个 block 是 --kinds 种模板之一
+ * （模板是大小为 --block-size 的随机递归树，节点名在模板内有重复，payload 为模板内序号）。
+ * 比较用的第二棵树与第一棵相同，只随机改 --changes 个节点的 payload。
+ *
+ * 模式（levels_* 计时包含对每个 (层, 名称) 求子节点名并集，即 drawMergedTree 准备连线的工作，
+ * 它遍历列表里每个节点的子节点，列表长度在这里起作用）：
+ *   levels_map    原实现：递归收集到 map<层, map<名称, vector<节点>>>，列表含全部节点
+ *   levels_dag    getMergedLevels()：建 SubtreeDag，每层每种子树只展开一次，列表只含代表节点
+ *   diff_walk     两棵树逐节点同步遍历比较标签，O(n)
+ *   dag_build     两棵树 intern 进同一个 SubtreeDag（diff_merkle 的前置，O(n)）
+ *   diff_merkle   diffSubtrees：编号相同的子树整棵跳过，只走有变化的路径
+ *
+ * 用法: multi_tree_subtree_hash_benchmark [--blocks N] [--block-size N] [--kinds N]
+ *       [--changes N] [--modes a,b] [--repetitions=N]
+ *       [--json=FILE]（microbench::Report 的 JSON 格式，供 bench 目标读取）
+ */
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <optional>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "microbench.h"
+#include "multi_tree.hpp"
+
+namespace {
+
+struct Payload {
+    uint64_t value = 0;
+
+    explicit Payload(uint64_t v) : value(v) {}
+};
+
+using Tree    = algo::MultiTree<Payload>;
+using Node    = algo::TreeNode<Payload>;
+using Dag     = algo::SubtreeDag<Payload>;
+using Levels  = Tree::merged_levels_t;
+using Changes = std::vector<algo::TreeDiffEntry<Payload>>;
+
+struct BenchConfig {
+    size_t                   blocks     = 2000;
+    size_t                   block_size = 200;
+    size_t                   kinds      = 8;
+    size_t                   changes    = 10;
+    std::vector<std::string> modes      = { "levels_map", "levels_dag", "diff_walk", "dag_build",
+                                            "diff_merkle" };
+    int                      reps       = 3;
+
+    size_t nodes() const { return 1 + blocks * block_size; }
+};
+
+struct BenchResult {
+    std::string         mode;
+    std::vector<double> samples_seconds;
+    bool                correct = true;
+
+    std::string name() const { return mode; }
+
+    double median() const {
+        std::vector<double> sorted = samples_seconds;
+        std::sort(sorted.begin(), sorted.end());
+        size_t mid = sorted.size() / 2;
+        return sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+    }
+
+    double min() const { return *std::min_element(samples_seconds.begin(), samples_seconds.end()); }
+};
+
+std::vector<std::string> split_list(const std::string & s) {
+    std::vector<std::string> items;
+    std::stringstream        ss(s);
+    std::string              item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void print_usage(const char * prog) {
+    fmt::print("用法: {} [选项]\n"
+               "  --blocks N             block 个数（默认 2000）\n"
+               "  --block-size N         每个 block 的节点数（默认 200）\n"
+               "  --kinds N              不同 block 模板数（默认 8）\n"
+               "  --changes N            第二棵树中修改的节点数（默认 10）\n"
+               "  --modes a,b,...        levels_map,levels_dag,diff_walk,dag_build,diff_merkle\n"
+               "  --repetitions=N        计时重复次数（默认 3）\n"
+               "  --json=FILE            输出 JSON 结果\n",
+               prog);
+}
+
+bool parse_args(int argc, char * argv[], BenchConfig & cfg) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg  = argv[i];
+        auto        next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        auto next_size = [&]() {
+            return std::max<size_t>(1, std::strtoul(next().c_str(), nullptr, 10));
+        };
+        if (arg == "--blocks") {
+            cfg.blocks = next_size();
+        } else if (arg == "--block-size") {
+            cfg.block_size = next_size();
+        } else if (arg == "--kinds") {
+            cfg.kinds = next_size();
+        } else if (arg == "--changes") {
+            cfg.changes = std::strtoul(next().c_str(), nullptr, 10);
+        } else if (arg == "--modes") {
+            cfg.modes = split_list(next());
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    return true;
+}
+
+// ==================== 输入 ====================
+
+// 模板 k：节点 j 的父节点在 [0, j) 中随机，名字在模板内循环复用 16 个
+Tree build_tree(const BenchConfig & cfg) {
+    std::mt19937                       rng(2024);
+    std::vector<std::vector<uint32_t>> templates(cfg.kinds);
+    for (auto & parent : templates) {
+        parent.resize(cfg.block_size, 0);
+        for (size_t j = 1; j < parent.size(); ++j) {
+            parent[j] = static_cast<uint32_t>(rng() % j);
+        }
+    }
+
+    Tree   tree("model");
+    auto * root =
+        tree.createRoot("model", std::unordered_set<std::string>{}, std::make_unique<Payload>(0));
+    for (size_t b = 0; b < cfg.blocks; ++b) {
+        const size_t        kind   = b % cfg.kinds;
+        const auto &        parent = templates[kind];
+        std::vector<Node *> nodes(parent.size());
+        const std::string   prefix = "k" + std::to_string(kind) + "_op";
+        for (size_t j = 0; j < parent.size(); ++j) {
+            Node * up = j == 0 ? root : nodes[parent[j]];
+            nodes[j]  = up->createChild(j == 0 ? "block_" + std::to_string(kind)
+                                               : prefix + std::to_string(j % 16),
+                                        std::unordered_set<std::string>{},
+                                        std::make_unique<Payload>(j));
+        }
+    }
+    return tree;
+}
+
+// 随机改 count 个节点的 payload，返回被改的节点
+std::vector<const Node *> mutate(Tree & tree, size_t count) {
+    std::vector<Node *>    all = tree.getAllNodes();
+    std::mt19937           rng(7);
+    std::set<const Node *> changed;
+    while (changed.size() < std::min(count, all.size() - 1)) {
+        Node * node = all[1 + rng() % (all.size() - 1)];
+        if (changed.insert(node).second) {
+            node->getData()->value += 1000000;
+        }
+    }
+    return { changed.begin(), changed.end() };
+}
+
+uint64_t payload_hash(const Payload & p) { return p.value; }
+
+// ==================== 两种分层收集 ====================
+
+void collect_map(const Node * node, size_t level,
+                 std::map<size_t, std::map<std::string, std::vector<const Node *>>> & out) {
+    out[level][node->getNodeName()].push_back(node);
+    for (const auto & child : node->getChildren()) {
+        collect_map(child.get(), level + 1, out);
+    }
+}
+
+Levels levels_map(const Tree & tree) {
+    std::map<size_t, std::map<std::string, std::vector<const Node *>>> level_nodes;
+    collect_map(tree.getRoot(), 0, level_nodes);
+    Levels levels;
+    for (const auto & [level, nodes_map] : level_nodes) {
+        auto & level_data = levels.emplace_back();
+        for (const auto & [name, node_list] : nodes_map) {
+            level_data.push_back({ name, node_list });
+        }
+    }
+    return levels;
+}
+
+// 打印只用到 (层, 名称) 以及同名节点的子节点名并集，两种收集在这一层面必须一致
+using LevelShape = std::vector<std::vector<std::pair<std::string, std::set<std::string>>>>;
+
+LevelShape shape_of(const Levels & levels) {
+    LevelShape shape;
+    for (const auto & level : levels) {
+        auto & out = shape.emplace_back();
+        for (const auto & [name, nodes] : level) {
+            std::set<std::string> child_names;
+            for (const auto * node : nodes) {
+                for (const auto & child : node->getChildren()) {
+                    child_names.insert(child->getNodeName());
+                }
+            }
+            out.push_back({ name, std::move(child_names) });
+        }
+    }
+    return shape;
+}
+
+// ==================== 两种比较 ====================
+
+// 基线：两棵树结构相同，逐节点同步遍历，标签不同记为 Modified
+Changes diff_walk(const Tree & before, const Tree & after) {
+    Changes                                            changes;
+    std::vector<std::pair<const Node *, const Node *>> stack{ { before.getRoot(),
+                                                                after.getRoot() } };
+    while (!stack.empty()) {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+        if (a->getNodeName() != b->getNodeName() || a->getInputNames() != b->getInputNames() ||
+            payload_hash(*a->getData()) != payload_hash(*b->getData())) {
+            changes.push_back({ algo::TreeDiffEntry<Payload>::Kind::Modified, a, b });
+        }
+        for (size_t i = a->getChildrenCount(); i-- > 0;) {
+            stack.push_back({ a->getChildAt(i), b->getChildAt(i) });
+        }
+    }
+    return changes;
+}
+
+std::vector<const Node *> changed_nodes(const Changes & changes) {
+    std::vector<const Node *> nodes;
+    for (const auto & c : changes) {
+        nodes.push_back(c.after);
+    }
+    std::sort(nodes.begin(), nodes.end());
+    return nodes;
+}
+
+// 计时只覆盖 run()；check() 校验结果，不计入
+template <typename Run, typename Check>
+BenchResult measure(const BenchConfig & cfg, const std::string & mode, Run && run,
+                    Check && check) {
+    BenchResult r;
+    r.mode = mode;
+    for (int rep = 0; rep < cfg.reps; ++rep) {
+        decltype(run()) result{};
+        r.samples_seconds.push_back(microbench::Seconds([&] { result = run(); }));
+        r.correct = r.correct && check(result);
+    }
+    return r;
+}
+
+bool wants(const std::vector<std::string> & list, const std::string & name) {
+    return std::find(list.begin(), list.end(), name) != list.end();
+}
+
+// ==================== 输出 ====================
+
+void print_results(const BenchConfig & cfg, const std::vector<BenchResult> & results) {
+    fmt::print("\n节点数 {}，单位 ms\n", cfg.nodes());
+    fmt::print("  {:<14} {:>12} {:>12}\n", "模式", "中位数", "最小值");
+    for (const BenchResult & r : results) {
+        fmt::print("  {:<14} {:>12.2f} {:>12.2f}{}\n", r.mode, r.median() * 1e3, r.min() * 1e3,
+                   r.correct ? "" : " 错误");
+    }
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    BenchConfig                       cfg;
+    std::optional<microbench::Report> report;
+    try {
+        report.emplace(argc, argv, cfg.reps);
+        cfg.reps = report->repetitions();
+        if (!parse_args(argc, argv, cfg)) {
+            return 0;
+        }
+    } catch (const std::exception & e) {
+        fmt::print(stderr, "参数错误: {}\n", e.what());
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    fmt::print("MultiTree 子树哈希基准（合并打印分层 / 树比较）\n");
+    fmt::print("=====================================\n");
+    fmt::print("{} 个 block × {} 节点，{} 种模板，修改 {} 个节点，每项重复 {} 次取中位数\n",
+               cfg.blocks, cfg.block_size, cfg.kinds, cfg.changes, cfg.reps);
+
+    const Tree                      before = build_tree(cfg);
+    Tree                            after  = build_tree(cfg);
+    const std::vector<const Node *> expected_changes = mutate(after, cfg.changes);
+    const LevelShape                expected_shape   = shape_of(levels_map(before));
+
+    auto same_shape   = [&](const LevelShape & shape) { return shape == expected_shape; };
+    auto same_changes = [&](const Changes & changes) {
+        return changed_nodes(changes) == expected_changes;
+    };
+
+    std::vector<BenchResult> results;
+    if (wants(cfg.modes, "levels_map")) {
+        results.push_back(
+            measure(cfg, "levels_map", [&] { return shape_of(levels_map(before)); }, same_shape));
+    }
+    if (wants(cfg.modes, "levels_dag")) {
+        results.push_back(measure(
+            cfg, "levels_dag", [&] { return shape_of(before.getMergedLevels()); }, same_shape));
+    }
+    if (wants(cfg.modes, "diff_walk")) {
+        results.push_back(
+            measure(cfg, "diff_walk", [&] { return diff_walk(before, after); }, same_changes));
+    }
+    if (wants(cfg.modes, "dag_build")) {
+        results.push_back(measure(
+            cfg, "dag_build",
+            [&] {
+                Dag dag(payload_hash);
+                dag.intern(before.getRoot());
+                dag.intern(after.getRoot());
+                return dag.nodeCount();
+            },
+            [&](size_t count) { return count == 2 * cfg.nodes(); }));
+    }
+    if (wants(cfg.modes, "diff_merkle")) {
+        Dag dag(payload_hash);
+        dag.intern(before.getRoot());
+        dag.intern(after.getRoot());
+        fmt::print("DAG：{} 个节点 -> {} 种不同子树\n", dag.nodeCount(), dag.size());
+        results.push_back(measure(
+            cfg, "diff_merkle",
+            [&] { return algo::diffSubtrees(dag, before.getRoot(), after.getRoot()); },
+            same_changes));
+    }
+    print_results(cfg, results);
+
+    bool all_correct = true;
+    for (const BenchResult & r : results) {
+        all_correct = all_correct && r.correct;
+    }
+    fmt::print("\n结果一致: {}\n", all_correct ? "yes" : "NO");
+    for (const BenchResult & r : results) {
+        report->Add(r.name(), r.samples_seconds).correct = r.correct;
+    }
+    int status = report->Finish();
+
+    fmt::print("\n关键学习点：\n");
+    fmt::print("1. 子树哈希 = 标签哈希混入有序的子树哈希，后序一遍就能给每棵子树定编号\n");
+    fmt::print("2. 查表时精确比较 (标签, 子编号序列)，编号相等即结构相等，不怕哈希碰撞\n");
+    fmt::print("3. 合并打印在 DAG 上按层展开，同名列表只放代表节点，画连线时不再逐个遍历重复的 block\n");
+    fmt::print("4. 建 DAG 是 O(n)，之后的比较只沿编号不同的路径走，代价与变化量成正比\n");
+    return status;
+}
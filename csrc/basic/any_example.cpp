@@ -3,8 +3,10 @@
 // pointer cast, moving and storing custom types.
 // Uses fmt for formatted output (via vcpkg-installed fmt).
 // Also demonstrates spdlog for comparison with fmt::print.
+// Part 3 shows the small-buffer Any / AnyFormatter / AnyVector from small_any.h.
 
 #include "common.h"
+#include "small_any.h"
 
 struct Point {
     int x;
@@ -143,6 +145,52 @@ void demo_with_spdlog() {
     fmt::print("\n--- End of spdlog demo ---\n");
 }
 
+// 小缓冲区 any：与 Part 1 相同的操作，外加按类型编号分派的格式化器
+void demo_small_any() {
+    using cpp_qa_lab::basic::Any;
+    using cpp_qa_lab::basic::AnyCast;
+    using cpp_qa_lab::basic::AnyFormatter;
+    using cpp_qa_lab::basic::AnyVector;
+
+    fmt::print("\n=== Part 3: small-buffer Any (small_any.h) ===\n\n");
+
+    // 1) 存储与类型检查：std::string 直接放在 32 字节内联缓冲区中，不分配内存
+    Any a = 42;
+    a     = std::string("hello");
+    fmt::print("1. a holds std::string: {}, stored inline: {}, sizeof(Any) = {}\n",
+               a.Is<std::string>(), a.is_inline(), sizeof(Any));
+
+    // 2) AnyCast：指针版本类型不符返回 nullptr，引用版本抛 std::bad_any_cast
+    if (const int * p = AnyCast<int>(&a)) {
+        fmt::print("2. unexpected int: {}\n", *p);
+    } else {
+        fmt::print("2. AnyCast<int> -> nullptr, AnyCast<std::string> -> '{}'\n",
+                   AnyCast<std::string>(a));
+    }
+
+    // 3) 格式化器：每种类型登记一次，之后不需要 any_cast 链
+    AnyFormatter formatter;
+    formatter.Register<int>();
+    formatter.Register<double>();
+    formatter.Register<std::string>();
+    formatter.Register<Point>([](const Point & p, fmt::memory_buffer & out) {
+        fmt::format_to(std::back_inserter(out), "Point({}, {})", p.x, p.y);
+    });
+
+    // 4) AnyVector：异构值紧凑地存放在一块连续内存中
+    AnyVector props;
+    props.PushBack(7);
+    props.PushBack(2.5);
+    props.PushBack(std::string("name"));
+    props.PushBack(Point{ 3, 4 });
+    props.PushBack(1.5f); // 未登记的类型交给默认处理：输出类型名
+    fmt::print("3. AnyVector ({} values, {} arena bytes):", props.size(), props.arena_bytes());
+    for (size_t i = 0; i < props.size(); ++i) {
+        fmt::print(" {}", formatter.ToString(props[i]));
+    }
+    fmt::print("\n\n--- End of small-buffer Any demo ---\n");
+}
+
 int main() {
     fmt::print("\n");
     fmt::print("╔════════════════════════════════════════════════════════════════╗\n");
@@ -155,6 +203,9 @@ int main() {
     // 第二部分：使用 spdlog 演示
     demo_with_spdlog();
 
+    // 第三部分：小缓冲区 Any
+    demo_small_any();
+
     // 对比说明
     fmt::print("\n");
     fmt::print("╔════════════════════════════════════════════════════════════════╗\n");
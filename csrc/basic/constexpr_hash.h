@@ -0,0 +1,342 @@
+// ============================================================================
+// 编译期字符串与哈希工具 - variadic_examples.cpp 1.12 节 CompileTimeSum 的延伸
+// ============================================================================
+// 按名字查找（std::unordered_map<std::string, T>）每次都要在运行时哈希字符串，
+// 用字符串字面量查找时还要先构造一个 std::string。键集合在编译期已知时，这些都可以省掉：
+//
+//   - Fnv1a64 / XxHash64       : constexpr 哈希，"name"_fnv 可以直接用作 switch 的 case
+//   - FixedString<Chars...>    : 把字符串编码进类型（C++17 还不能用类类型做非类型模板参数，
+//                                用 CPP_VARIADIC_FIXED_STRING("...") 生成），哈希值是类型的常量
+//   - StaticHashMap<V, N>      : 编译期生成的完美哈希表（hash-and-displace），
+//                                查找 = 一次哈希 + 两次数组访问 + 一次字符串比较；
+//                                键也是常量时整个查找在编译期完成
+// ============================================================================
+
+#ifndef CPP_QA_LAB_CSRC_BASIC_CONSTEXPR_HASH_H_
+#define CPP_QA_LAB_CSRC_BASIC_CONSTEXPR_HASH_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace cpp_variadic {
+
+// ----------------------------------------------------------------------------
+// 1. constexpr 哈希
+// ----------------------------------------------------------------------------
+
+// FNV-1a：逐字节异或再乘，实现最简单；逐字节循环在长度不定的键上分支难以预测
+constexpr std::uint64_t Fnv1a64(std::string_view s, std::uint64_t seed = 0xcbf29ce484222325ULL) {
+    std::uint64_t h = seed;
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+namespace hash_detail {
+
+constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr std::uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr std::uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+constexpr std::uint64_t Rotl(std::uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// 按小端序逐字节拼装：constexpr 里不能 reinterpret_cast，编译器会把它合并成一次加载
+constexpr std::uint64_t Read64(std::string_view s, std::size_t i) {
+    std::uint64_t v = 0;
+    for (int b = 7; b >= 0; --b) {
+        v = (v << 8) | static_cast<unsigned char>(s[i + b]);
+    }
+    return v;
+}
+
+constexpr std::uint64_t Read32(std::string_view s, std::size_t i) {
+    std::uint64_t v = 0;
+    for (int b = 3; b >= 0; --b) {
+        v = (v << 8) | static_cast<unsigned char>(s[i + b]);
+    }
+    return v;
+}
+
+constexpr std::uint64_t Round(std::uint64_t acc, std::uint64_t input) {
+    return Rotl(acc + input * kPrime2, 31) * kPrime1;
+}
+
+constexpr std::uint64_t MergeRound(std::uint64_t acc, std::uint64_t val) {
+    return (acc ^ Round(0, val)) * kPrime1 + kPrime4;
+}
+
+// splitmix64 的收尾混合：把一个 64 位值打散到所有位
+constexpr std::uint64_t Mix64(std::uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+} // namespace hash_detail
+
+// XXH64：按 8 / 4 字节成块处理，短键只需几次乘法，长键每轮处理 32 字节；结果与官方实现一致
+constexpr std::uint64_t XxHash64(std::string_view s, std::uint64_t seed = 0) {
+    using namespace hash_detail;
+    const std::size_t len = s.size();
+    std::size_t       i   = 0;
+    std::uint64_t     h   = 0;
+
+    if (len >= 32) {
+        std::uint64_t v1 = seed + kPrime1 + kPrime2;
+        std::uint64_t v2 = seed + kPrime2;
+        std::uint64_t v3 = seed;
+        std::uint64_t v4 = seed - kPrime1;
+        for (; i + 32 <= len; i += 32) {
+            v1 = Round(v1, Read64(s, i));
+            v2 = Round(v2, Read64(s, i + 8));
+            v3 = Round(v3, Read64(s, i + 16));
+            v4 = Round(v4, Read64(s, i + 24));
+        }
+        h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+        h = MergeRound(h, v1);
+        h = MergeRound(h, v2);
+        h = MergeRound(h, v3);
+        h = MergeRound(h, v4);
+    } else {
+        h = seed + kPrime5;
+    }
+
+    h += len;
+    for (; i + 8 <= len; i += 8) {
+        h ^= Round(0, Read64(s, i));
+        h  = Rotl(h, 27) * kPrime1 + kPrime4;
+    }
+    if (i + 4 <= len) {
+        h ^= Read32(s, i) * kPrime1;
+        h  = Rotl(h, 23) * kPrime2 + kPrime3;
+        i += 4;
+    }
+    for (; i < len; ++i) {
+        h ^= static_cast<unsigned char>(s[i]) * kPrime5;
+        h  = Rotl(h, 11) * kPrime1;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+namespace literals {
+
+// switch (Fnv1a64(name)) { case "add"_fnv: ... }
+constexpr std::uint64_t operator""_fnv(const char * s, std::size_t n) {
+    return Fnv1a64(std::string_view(s, n));
+}
+
+constexpr std::uint64_t operator""_xxh(const char * s, std::size_t n) {
+    return XxHash64(std::string_view(s, n));
+}
+
+} // namespace literals
+
+// ----------------------------------------------------------------------------
+// 2. FixedString - 编码进类型的字符串
+// ----------------------------------------------------------------------------
+
+template <char... Chars> struct FixedString {
+    static constexpr char             kData[] = { Chars..., '\0' };
+    static constexpr std::string_view kView{ kData, sizeof...(Chars) };
+    static constexpr std::uint64_t    kHash = Fnv1a64(kView);
+
+    static constexpr std::size_t size() { return sizeof...(Chars); }
+
+    constexpr operator std::string_view() const { return kView; }
+};
+
+namespace hash_detail {
+
+template <typename Holder, std::size_t... I>
+constexpr auto MakeFixedString(Holder, std::index_sequence<I...>) {
+    return FixedString<Holder::Get()[I]...>{};
+}
+
+} // namespace hash_detail
+
+// 把字面量拆成字符包：CPP_VARIADIC_FIXED_STRING("abc") 的类型是 FixedString<'a', 'b', 'c'>
+#define CPP_VARIADIC_FIXED_STRING(literal)                                                 \
+    ([] {                                                                                  \
+        struct Holder {                                                                    \
+            static constexpr std::string_view Get() { return literal; }                    \
+        };                                                                                 \
+        return ::cpp_variadic::hash_detail::MakeFixedString(                               \
+            Holder{}, std::make_index_sequence<Holder::Get().size()>{});                   \
+    }())
+
+// ----------------------------------------------------------------------------
+// 3. StaticHashMap - 编译期完美哈希表
+// ----------------------------------------------------------------------------
+
+template <typename V> struct StaticMapEntry {
+    std::string_view key;
+    V                value;
+};
+
+// 构造过程（hash-and-displace）：
+//   1. 每个键算一次 XXH64 哈希 h，按 h 的低位分到 kBuckets 个桶里
+//   2. 桶按大小从大到小处理：为每个桶找一个位移 d，使桶内所有键的 Mix64(h ^ d) 都落在空槽上
+//   3. 查找时 h -> 桶 -> d -> 槽位 -> 比较哈希和键
+// 槽位数取不小于 N 的 2 的幂，负载因子在 0.5 ~ 1 之间；所有工作都在 constexpr 构造函数里完成
+template <typename V, std::size_t N> class StaticHashMap {
+    static_assert(N > 0, "StaticHashMap needs at least one key");
+
+    static constexpr std::size_t NextPow2(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+  public:
+    using Entry = StaticMapEntry<V>;
+
+    static constexpr std::size_t   kSlots   = NextPow2(N);
+    static constexpr std::size_t   kBuckets = NextPow2((N + 3) / 4);
+    static constexpr std::uint32_t kEmpty   = 0xffffffffu;
+
+    constexpr explicit StaticHashMap(const Entry (&entries)[N])
+        : StaticHashMap(entries, std::make_index_sequence<N>{}) {}
+
+    constexpr std::size_t size() const { return N; }
+
+    constexpr const Entry * begin() const { return entries_.data(); }
+
+    constexpr const Entry * end() const { return entries_.data() + N; }
+
+    // 键不存在时返回 nullptr
+    constexpr const V * Find(std::string_view key) const {
+        std::uint64_t h = XxHash64(key);
+        std::uint32_t e = slot_entry_[SlotOf(h, displacement_[h & (kBuckets - 1)])];
+        if (e == kEmpty || hashes_[e] != h || entries_[e].key != key) {
+            return nullptr;
+        }
+        return &entries_[e].value;
+    }
+
+    constexpr bool Contains(std::string_view key) const { return Find(key) != nullptr; }
+
+    // 键不存在时抛 std::out_of_range；在常量表达式里则是编译错误
+    constexpr const V & At(std::string_view key) const {
+        const V * v = Find(key);
+        if (v == nullptr) {
+            throw std::out_of_range("StaticHashMap: unknown key");
+        }
+        return *v;
+    }
+
+    template <char... Chars> constexpr const V & At(FixedString<Chars...>) const {
+        return At(FixedString<Chars...>::kView);
+    }
+
+  private:
+    template <std::size_t... I>
+    constexpr StaticHashMap(const Entry (&entries)[N], std::index_sequence<I...>)
+        : entries_{ { entries[I]... } } {
+        Build();
+    }
+
+    static constexpr std::size_t SlotOf(std::uint64_t h, std::uint32_t d) {
+        return hash_detail::Mix64(h ^ d) & (kSlots - 1);
+    }
+
+    constexpr void Build() {
+        std::array<std::uint32_t, kBuckets> bucket_size{};
+        for (std::size_t i = 0; i < N; ++i) {
+            hashes_[i] = XxHash64(entries_[i].key);
+            ++bucket_size[hashes_[i] & (kBuckets - 1)];
+        }
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t j = 0; j < i; ++j) {
+                if (hashes_[i] == hashes_[j] && entries_[i].key == entries_[j].key) {
+                    throw std::invalid_argument("StaticHashMap: duplicate key");
+                }
+            }
+        }
+
+        // 桶按大小降序（插入排序，constexpr 里没有 std::sort）
+        std::array<std::uint32_t, kBuckets> order{};
+        for (std::size_t b = 0; b < kBuckets; ++b) {
+            std::size_t j = b;
+            while (j > 0 && bucket_size[order[j - 1]] < bucket_size[b]) {
+                order[j] = order[j - 1];
+                --j;
+            }
+            order[j] = static_cast<std::uint32_t>(b);
+        }
+        for (auto & e : slot_entry_) {
+            e = kEmpty;
+        }
+
+        std::array<std::uint32_t, N> members{};
+        for (std::uint32_t b : order) {
+            if (bucket_size[b] == 0) {
+                break;
+            }
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < N; ++i) {
+                if ((hashes_[i] & (kBuckets - 1)) == b) {
+                    members[count++] = static_cast<std::uint32_t>(i);
+                }
+            }
+            displacement_[b] = FindDisplacement(members, count);
+            for (std::size_t k = 0; k < count; ++k) {
+                slot_entry_[SlotOf(hashes_[members[k]], displacement_[b])] = members[k];
+            }
+        }
+    }
+
+    // 找一个让桶内键全部落在空槽且互不冲突的位移
+    constexpr std::uint32_t FindDisplacement(const std::array<std::uint32_t, N> & members,
+                                             std::size_t                         count) const {
+        for (std::uint32_t d = 0; d < (1u << 20); ++d) {
+            bool ok = true;
+            for (std::size_t k = 0; k < count && ok; ++k) {
+                std::size_t slot = SlotOf(hashes_[members[k]], d);
+                ok               = slot_entry_[slot] == kEmpty;
+                for (std::size_t m = 0; m < k && ok; ++m) {
+                    ok = SlotOf(hashes_[members[m]], d) != slot;
+                }
+            }
+            if (ok) {
+                return d;
+            }
+        }
+        throw std::logic_error("StaticHashMap: no displacement found");
+    }
+
+    std::array<Entry, N>                entries_;
+    std::array<std::uint64_t, N>        hashes_{};
+    std::array<std::uint32_t, kBuckets> displacement_{};
+    std::array<std::uint32_t, kSlots>   slot_entry_{};
+};
+
+// 推导键个数：MakeStaticHashMap<int>({ { "a", 1 }, { "b", 2 } })
+template <typename V, std::size_t N>
+constexpr StaticHashMap<V, N> MakeStaticHashMap(const StaticMapEntry<V> (&entries)[N]) {
+    return StaticHashMap<V, N>(entries);
+}
+
+} // namespace cpp_variadic
+
+#endif // CPP_QA_LAB_CSRC_BASIC_CONSTEXPR_HASH_H_
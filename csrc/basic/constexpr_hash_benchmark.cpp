@@ -0,0 +1,249 @@
+// ============================================================================
+// 编译期字符串哈希 / 完美哈希表基准测试
+// ============================================================================
+// 用法: constexpr_hash_benchmark [查找次数]
+//
+// 关键字表（48 个 C++ 关键字 -> 记号编号），查找序列中 1/4 是不存在的标识符：
+// 1. unordered_map<std::string> + std::string 键：键已经是 std::string，只付哈希 + 比较
+// 2. unordered_map<std::string> + 字面量：像 findNodeByName("grandchild") 那样，
+//    每次先构造 std::string
+// 3. StaticHashMap + string_view：运行时键，编译期生成的完美哈希
+// 4. switch (Fnv1a64(key)) { case Fnv1a64("if"): ... }：运行时键，哈希后走二分比较
+// 5. StaticHashMap + 编译期常量键：查找在编译期完成，运行时只剩加载常量
+// ============================================================================
+
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "constexpr_hash.h"
+#include "microbench.h"
+
+namespace cpp_variadic {
+
+constexpr StaticMapEntry<int> kKeywordEntries[] = {
+    { "alignas", 1 },    { "alignof", 2 },   { "auto", 3 },        { "bool", 4 },
+    { "break", 5 },      { "case", 6 },      { "catch", 7 },       { "char", 8 },
+    { "class", 9 },      { "const", 10 },    { "constexpr", 11 },  { "continue", 12 },
+    { "decltype", 13 },  { "default", 14 },  { "delete", 15 },     { "do", 16 },
+    { "double", 17 },    { "else", 18 },     { "enum", 19 },       { "explicit", 20 },
+    { "extern", 21 },    { "false", 22 },    { "float", 23 },      { "for", 24 },
+    { "friend", 25 },    { "if", 26 },       { "inline", 27 },     { "int", 28 },
+    { "long", 29 },      { "mutable", 30 },  { "namespace", 31 },  { "new", 32 },
+    { "noexcept", 33 },  { "nullptr", 34 },  { "operator", 35 },   { "private", 36 },
+    { "protected", 37 }, { "public", 38 },   { "return", 39 },     { "short", 40 },
+    { "sizeof", 41 },    { "static", 42 },   { "struct", 43 },     { "switch", 44 },
+    { "template", 45 },  { "this", 46 },     { "typename", 47 },   { "while", 48 },
+};
+
+constexpr auto kKeywords = MakeStaticHashMap(kKeywordEntries);
+
+// 编译期校验：常量键的查找结果、未知键、哈希与官方 XXH64 / FNV-1a 测试向量
+static_assert(kKeywords.At("while") == 48 && kKeywords.At("alignas") == 1);
+static_assert(!kKeywords.Contains("whilst") && !kKeywords.Contains(""));
+static_assert(kKeywords.At(CPP_VARIADIC_FIXED_STRING("template")) == 45);
+static_assert(XxHash64("") == 0xEF46DB3751D8E999ULL);
+static_assert(XxHash64("a") == 0xD24EC4F1A98C6E5BULL);
+static_assert(XxHash64("abc") == 0x44BC2CF5AD770999ULL);
+static_assert(Fnv1a64("a") == 0xaf63dc4c8601ec8cULL);
+
+// 4. 手写 switch：case 标签是编译期哈希；哈希相同后仍需比较字符串
+int LookupBySwitch(std::string_view key) {
+    switch (Fnv1a64(key)) {
+#define KEYWORD_CASE(word, id)                                                                     \
+    case Fnv1a64(word):                                                                            \
+        return key == word ? id : 0;
+        KEYWORD_CASE("alignas", 1)
+        KEYWORD_CASE("alignof", 2)
+        KEYWORD_CASE("auto", 3)
+        KEYWORD_CASE("bool", 4)
+        KEYWORD_CASE("break", 5)
+        KEYWORD_CASE("case", 6)
+        KEYWORD_CASE("catch", 7)
+        KEYWORD_CASE("char", 8)
+        KEYWORD_CASE("class", 9)
+        KEYWORD_CASE("const", 10)
+        KEYWORD_CASE("constexpr", 11)
+        KEYWORD_CASE("continue", 12)
+        KEYWORD_CASE("decltype", 13)
+        KEYWORD_CASE("default", 14)
+        KEYWORD_CASE("delete", 15)
+        KEYWORD_CASE("do", 16)
+        KEYWORD_CASE("double", 17)
+        KEYWORD_CASE("else", 18)
+        KEYWORD_CASE("enum", 19)
+        KEYWORD_CASE("explicit", 20)
+        KEYWORD_CASE("extern", 21)
+        KEYWORD_CASE("false", 22)
+        KEYWORD_CASE("float", 23)
+        KEYWORD_CASE("for", 24)
+        KEYWORD_CASE("friend", 25)
+        KEYWORD_CASE("if", 26)
+        KEYWORD_CASE("inline", 27)
+        KEYWORD_CASE("int", 28)
+        KEYWORD_CASE("long", 29)
+        KEYWORD_CASE("mutable", 30)
+        KEYWORD_CASE("namespace", 31)
+        KEYWORD_CASE("new", 32)
+        KEYWORD_CASE("noexcept", 33)
+        KEYWORD_CASE("nullptr", 34)
+        KEYWORD_CASE("operator", 35)
+        KEYWORD_CASE("private", 36)
+        KEYWORD_CASE("protected", 37)
+        KEYWORD_CASE("public", 38)
+        KEYWORD_CASE("return", 39)
+        KEYWORD_CASE("short", 40)
+        KEYWORD_CASE("sizeof", 41)
+        KEYWORD_CASE("static", 42)
+        KEYWORD_CASE("struct", 43)
+        KEYWORD_CASE("switch", 44)
+        KEYWORD_CASE("template", 45)
+        KEYWORD_CASE("this", 46)
+        KEYWORD_CASE("typename", 47)
+        KEYWORD_CASE("while", 48)
+#undef KEYWORD_CASE
+        default:
+            return 0;
+    }
+}
+
+// 防止编译器把整个循环算完：结果写进 volatile
+volatile std::int64_t g_sink;
+
+void BenchmarkLookup(microbench::Report & report, std::size_t lookups) {
+    std::unordered_map<std::string, int> table;
+    for (const auto & e : kKeywords) {
+        table.emplace(std::string(e.key), e.value);
+    }
+
+    // 查找序列：3/4 命中关键字，1/4 是普通标识符（包括超过 SSO 长度的长名字）
+    const char * const kMisses[] = { "value", "index", "whilst", "tmp",
+                                     "a_rather_long_identifier" };
+    std::vector<const char *> names;
+    std::mt19937              rng(42);
+    for (std::size_t i = 0; i < 4096; ++i) {
+        if (rng() % 4 == 0) {
+            names.push_back(kMisses[rng() % 5]);
+        } else {
+            names.push_back(kKeywordEntries[rng() % kKeywords.size()].key.data());
+        }
+    }
+    std::vector<std::string>      strings(names.begin(), names.end());
+    std::vector<std::string_view> views(names.begin(), names.end());
+    const std::size_t             rounds = std::max<std::size_t>(1, lookups / names.size());
+    const double                  total  = static_cast<double>(rounds * names.size());
+    std::int64_t                  sums[6] = {};
+
+    double t_string = report.Time("runtime_key/unordered_map_string", [&] {
+        std::int64_t sum = 0;
+        for (std::size_t r = 0; r < rounds; ++r) {
+            for (const std::string & s : strings) {
+                auto it = table.find(s);
+                sum += it == table.end() ? 0 : it->second;
+            }
+        }
+        sums[0] = sum;
+    });
+
+    double t_literal = report.Time("runtime_key/unordered_map_char_ptr", [&] {
+        std::int64_t sum = 0;
+        for (std::size_t r = 0; r < rounds; ++r) {
+            for (const char * name : names) {
+                auto it = table.find(name);
+                sum += it == table.end() ? 0 : it->second;
+            }
+        }
+        sums[1] = sum;
+    });
+
+    double t_static = report.Time("runtime_key/static_hash_map", [&] {
+        std::int64_t sum = 0;
+        for (std::size_t r = 0; r < rounds; ++r) {
+            for (std::string_view v : views) {
+                const int * id = kKeywords.Find(v);
+                sum += id == nullptr ? 0 : *id;
+            }
+        }
+        sums[2] = sum;
+    });
+
+    double t_switch = report.Time("runtime_key/switch_fnv", [&] {
+        std::int64_t sum = 0;
+        for (std::size_t r = 0; r < rounds; ++r) {
+            for (std::string_view v : views) {
+                sum += LookupBySwitch(v);
+            }
+        }
+        sums[3] = sum;
+    });
+
+    bool same = sums[1] == sums[0] && sums[2] == sums[0] && sums[3] == sums[0];
+    auto ns   = [&](double seconds) { return seconds / total * 1e9; };
+    fmt::print("[1] 运行时键查找（{} 次，ns/次）\n", rounds * names.size());
+    fmt::print("{:>22} {:>20} {:>14} {:>12} {:>10}  结果一致\n", "unordered_map+string",
+               "unordered_map+char*", "StaticHashMap", "switch+fnv", "vs string");
+    fmt::print("{:>22.2f} {:>20.2f} {:>14.2f} {:>12.2f} {:>9.2f}x  {}\n\n", ns(t_string),
+               ns(t_literal), ns(t_static), ns(t_switch), t_string / t_static, same ? "yes" : "NO");
+
+    // 键是常量：unordered_map 仍要构造 std::string + 哈希；StaticHashMap 的查找在编译期完成
+    double t_const_map = report.Time("constant_key/unordered_map", [&] {
+        std::int64_t sum = 0;
+        for (std::size_t i = 0; i < lookups; ++i) {
+            sum += table.find("namespace")->second;
+            g_sink = sum;
+        }
+        sums[4] = sum;
+    });
+    double t_const_static = report.Time("constant_key/static_hash_map", [&] {
+        std::int64_t sum = 0;
+        for (std::size_t i = 0; i < lookups; ++i) {
+            constexpr int kId = kKeywords.At("namespace");
+            sum += kId;
+            g_sink = sum;
+        }
+        sums[5] = sum;
+    });
+    auto per = [&](double seconds) { return seconds / static_cast<double>(lookups) * 1e9; };
+    fmt::print("[2] 常量键查找 \"namespace\"（{} 次，ns/次，含写 volatile 的循环开销）\n", lookups);
+    fmt::print("    unordered_map: {:.2f}   StaticHashMap(constexpr): {:.3f}   {:.0f}x  {}\n\n",
+               per(t_const_map), per(t_const_static), t_const_map / t_const_static,
+               sums[4] == sums[5] ? "结果一致" : "结果不一致");
+}
+
+void ShowTableShape() {
+    fmt::print("[0] StaticHashMap: {} 个键, {} 个槽位, {} 个桶, sizeof = {} 字节\n",
+               kKeywords.size(), decltype(kKeywords)::kSlots, decltype(kKeywords)::kBuckets,
+               sizeof(kKeywords));
+    auto name = CPP_VARIADIC_FIXED_STRING("constexpr");
+    using Name = decltype(name);
+    fmt::print("    FixedString \"{}\": size = {}, 编译期哈希 = {:#018x}\n\n", Name::kView, Name::size(),
+               Name::kHash);
+}
+
+} // namespace cpp_variadic
+
+int main(int argc, char * argv[]) {
+    microbench::Report report(argc, argv);
+    std::size_t        lookups = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000000;
+    lookups                    = std::max<std::size_t>(4096, lookups);
+
+    spdlog::info("编译期字符串哈希 / 完美哈希表基准测试");
+    spdlog::info("=====================================");
+    cpp_variadic::ShowTableShape();
+    cpp_variadic::BenchmarkLookup(report, lookups);
+
+    spdlog::info("关键学习点：");
+    spdlog::info("1. constexpr 哈希让 \"name\"_fnv 成为编译期常量，可以直接写进 case 标签");
+    spdlog::info("2. 完美哈希：一次哈希 + 两次数组访问 + 一次比较，没有链表、没有探测");
+    spdlog::info("3. 用字面量查 unordered_map<std::string> 每次都要构造临时 std::string");
+    spdlog::info("4. 键是常量时查找在编译期完成——这才是数量级的差距；运行时键一般是几倍");
+    return report.Finish();
+}
@@ -0,0 +1,235 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 批量数据处理引擎 - friend_example_demo.cpp 中 DataProcessor 的高性能版本
+//
+// 原始 DataProcessor::ProcessData 的开销：
+// - 输入整体拷贝到 raw_data_，results_.clear() 后逐元素 push_back：首次调用反复扩容，
+//   之后每次 push_back 仍要检查容量，循环无法向量化
+// - 只能处理 std::vector，调用者已有的缓冲区也要先拷贝一份
+//
+// BatchDataProcessor 的做法：
+// - 输入是 Span<const int> 视图（不拷贝），输出写入调用者提供的缓冲区或预分配的内部缓冲区
+// - 按块（默认 16K 个元素，约 64KB）调用 SIMD 内核，AVX2 可用时一次处理 8 个 int
+// - 输入超过 parallel_threshold 时用 OpenMP 把块分给多个线程
+// - 允许原地处理（输出与输入是同一块内存）
+
+#ifndef CPP_QA_LAB_CSRC_BASIC_DATA_PROCESSOR_H_
+#define CPP_QA_LAB_CSRC_BASIC_DATA_PROCESSOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#    define DATA_PROCESSOR_HAVE_X86 1
+#    include <immintrin.h>
+#else
+#    define DATA_PROCESSOR_HAVE_X86 0
+#endif
+
+namespace cpp_qa_lab {
+namespace basic {
+
+// ============================================================================
+// 1. Span - C++20 std::span 的最小替代（本项目使用 C++17）
+// ============================================================================
+
+// 非拥有的连续内存视图：一个指针加一个长度，按值传递
+template <typename T> class Span {
+  public:
+    constexpr Span() = default;
+
+    constexpr Span(T * data, size_t size) : data_(data), size_(size) {}
+
+    // 从 std::vector 构造；Span<const int> 也可以由 const std::vector<int> 构造
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+    Span(std::vector<U> & v) : data_(v.data()), size_(v.size()) {}
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<const U *, T *>>>
+    Span(const std::vector<U> & v) : data_(v.data()), size_(v.size()) {}
+
+    template <size_t N> constexpr Span(T (&array)[N]) : data_(array), size_(N) {}
+
+    // Span<int> -> Span<const int>
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+    constexpr Span(Span<U> other) : data_(other.data()), size_(other.size()) {}
+
+    constexpr T * data() const { return data_; }
+
+    constexpr size_t size() const { return size_; }
+
+    constexpr bool empty() const { return size_ == 0; }
+
+    constexpr T * begin() const { return data_; }
+
+    constexpr T * end() const { return data_ + size_; }
+
+    constexpr T & operator[](size_t i) const { return data_[i]; }
+
+    constexpr Span subspan(size_t offset, size_t count) const {
+        return Span(data_ + offset, count);
+    }
+
+  private:
+    T *    data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// ============================================================================
+// 2. 平方内核：标量 / AVX2
+// ============================================================================
+
+namespace data_processor_detail {
+
+static_assert(sizeof(int) == sizeof(int32_t), "kernels process int as int32_t");
+
+// 平方在 uint32_t 上计算：结果与 int 乘法的低 32 位相同，但溢出时行为有定义
+inline int32_t SquareOne(int32_t v) {
+    uint32_t u = static_cast<uint32_t>(v);
+    return static_cast<int32_t>(u * u);
+}
+
+// 没有 restrict：允许 out == in（原地处理），编译器会生成带运行时别名检查的向量化代码
+inline void SquarePortable(const int32_t * in, int32_t * out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = SquareOne(in[i]);
+    }
+}
+
+#if DATA_PROCESSOR_HAVE_X86
+
+// 先读后写同一位置，因此 out == in 也是安全的
+__attribute__((target("avx2"))) inline void SquareAvx2(const int32_t * in, int32_t * out,
+                                                       size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_mullo_epi32(v, v));
+    }
+    SquarePortable(in + i, out + i, n - i);
+}
+
+inline bool HasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#endif // DATA_PROCESSOR_HAVE_X86
+
+} // namespace data_processor_detail
+
+enum class ProcessorKernel {
+    kAuto,     // 运行时选择最快的可用内核
+    kPortable, // 标量循环（依赖编译器自动向量化）
+    kAvx2,     // AVX2，一次 8 个 int
+};
+
+struct ProcessorOptions {
+    ProcessorKernel kernel             = ProcessorKernel::kAuto;
+    size_t          chunk_size         = 16 * 1024; // 每块元素个数，块的输入+输出应能放进 L2
+    size_t          parallel_threshold = 1 << 20;   // 元素个数达到该值才启用 OpenMP
+};
+
+// ============================================================================
+// 3. BatchDataProcessor - 分块 + SIMD + OpenMP
+// ============================================================================
+
+class BatchDataProcessor {
+  public:
+    explicit BatchDataProcessor(ProcessorOptions options = {}) : options_(options) {
+        if (options_.chunk_size == 0) {
+            throw std::invalid_argument("chunk_size must be positive");
+        }
+        kernel_ = SelectKernel(options_.kernel);
+    }
+
+    /**
+     * 把 input 中每个元素的平方写入 output（长度必须相同）。
+     * output 可以与 input 是同一块内存（原地处理）；不做任何堆分配。
+     */
+    void Square(Span<const int> input, Span<int> output) const {
+        if (input.size() != output.size()) {
+            throw std::invalid_argument("input and output sizes differ");
+        }
+        const int32_t * in     = reinterpret_cast<const int32_t *>(input.data());
+        int32_t *       out    = reinterpret_cast<int32_t *>(output.data());
+        const size_t    n      = input.size();
+        const size_t    chunk  = options_.chunk_size;
+        const auto      chunks = static_cast<int64_t>((n + chunk - 1) / chunk);
+
+#ifdef _OPENMP
+#    pragma omp parallel for schedule(static) if (n >= options_.parallel_threshold)
+#endif
+        for (int64_t c = 0; c < chunks; ++c) {
+            size_t begin = static_cast<size_t>(c) * chunk;
+            size_t count = std::min(chunk, n - begin);
+            kernel_(in + begin, out + begin, count);
+        }
+    }
+
+    // 原地平方
+    void Square(Span<int> data) const { Square(data, data); }
+
+    /**
+     * 写入内部结果缓冲区并返回其视图。缓冲区只增不减：
+     * 处理同样大小或更小的输入时不会重新分配。视图在下一次调用前有效。
+     */
+    Span<const int> Process(Span<const int> input) {
+        if (results_.size() < input.size()) {
+            results_.resize(input.size());
+        }
+        Span<int> output(results_.data(), input.size());
+        Square(input, output);
+        return output;
+    }
+
+    // 预先分配内部缓冲区，之后 Process 不再分配
+    void Reserve(size_t n) {
+        if (results_.size() < n) {
+            results_.resize(n);
+        }
+    }
+
+    const char * kernel_name() const {
+#if DATA_PROCESSOR_HAVE_X86
+        if (kernel_ == &data_processor_detail::SquareAvx2) {
+            return "avx2";
+        }
+#endif
+        return "portable";
+    }
+
+  private:
+    using KernelFn = void (*)(const int32_t *, int32_t *, size_t);
+
+    static KernelFn SelectKernel(ProcessorKernel kernel) {
+#if DATA_PROCESSOR_HAVE_X86
+        bool avx2 = data_processor_detail::HasAvx2();
+        if (kernel == ProcessorKernel::kAvx2 && !avx2) {
+            throw std::runtime_error("AVX2 kernel requested but not supported by this CPU");
+        }
+        if (kernel != ProcessorKernel::kPortable && avx2) {
+            return &data_processor_detail::SquareAvx2;
+        }
+#else
+        if (kernel == ProcessorKernel::kAvx2) {
+            throw std::runtime_error("AVX2 kernel is only available on x86");
+        }
+#endif
+        return &data_processor_detail::SquarePortable;
+    }
+
+    ProcessorOptions options_;
+    KernelFn         kernel_ = nullptr;
+    std::vector<int> results_;
+};
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+#endif // CPP_QA_LAB_CSRC_BASIC_DATA_PROCESSOR_H_
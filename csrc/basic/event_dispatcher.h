@@ -0,0 +1,407 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 多播事件分发器 - 在 variadic_using.cpp 的 MyDelegate 基础上构建
+//
+// MyDelegate 把"对象指针 + 成员函数指针"封装成可调用对象，但类型里带着 T，
+// 不同类的处理函数无法放进同一个容器。常见的事件总线改用 std::vector<std::function>，代价是：
+// - 捕获较大时每个 handler 一次堆分配，调用要经过 std::function 的类型擦除
+// - 遍历期间退订（handler 在回调里把自己删掉）会使迭代器失效
+// - 多线程同时 Emit 需要加锁
+//
+// 本文件的做法：
+// - Delegate<R(Args...)>：对象指针 + 成员函数指针（内联存放）+ 一个调用桩函数，
+//   可平凡拷贝、大小固定，不做任何堆分配；Bind<&T::Method>(obj) 在编译期绑定成员函数
+// - EventDispatcher<Args...>：所有 handler 连续存放在一个不可变快照数组中。
+//   订阅/退订在写锁下复制出新快照并原子发布（每次修改一次分配，与 handler 个数无关）；
+//   Emit 只读快照，不加锁
+// - 旧快照通过两个 epoch 读者计数延迟回收：确认没有读者还在使用后才释放
+// - 退订会把所有仍可能被读取的快照里对应条目标记为失效，
+//   所以在回调中退订自己或其他 handler 是安全的，且被退订的 handler 不会再被调用
+
+#ifndef CPP_QA_LAB_CSRC_BASIC_EVENT_DISPATCHER_H_
+#define CPP_QA_LAB_CSRC_BASIC_EVENT_DISPATCHER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cpp_qa_lab {
+namespace basic {
+
+// ============================================================================
+// 1. Delegate - 类型擦除的 MyDelegate
+// ============================================================================
+
+template <typename Signature> class Delegate;
+
+template <typename R, typename... Args> class Delegate<R(Args...)> {
+  public:
+    Delegate() = default;
+
+    // 与 MyDelegate 相同的用法：Delegate d(&a, &A::Fun)
+    template <typename T> Delegate(T * object, R (T::*method)(Args...)) {
+        BindMethod(object, method, &InvokeMethod<T, R (T::*)(Args...)>);
+    }
+
+    // const 成员函数（MyDelegate 注释里提到但没有实现的部分）
+    template <typename T> Delegate(const T * object, R (T::*method)(Args...) const) {
+        BindMethod(object, method, &InvokeMethod<const T, R (T::*)(Args...) const>);
+    }
+
+    // 普通函数
+    Delegate(R (*function)(Args...)) {
+        if (function != nullptr) {
+            object_ = reinterpret_cast<void *>(function);
+            stub_   = &InvokeFunction;
+        }
+    }
+
+    // 编译期绑定成员函数：调用桩直接调用 Method，编译器可以内联
+    template <auto Method, typename T> static Delegate Bind(T * object) {
+        Delegate d;
+        d.object_ = const_cast<void *>(static_cast<const void *>(object));
+        d.stub_   = &InvokeBound<T, Method>;
+        return d;
+    }
+
+    R operator()(Args... args) const { return stub_(*this, std::forward<Args>(args)...); }
+
+    explicit operator bool() const { return stub_ != nullptr; }
+
+    // 同一对象上的同一成员函数视为相等（用于按 Delegate 退订）
+    bool operator==(const Delegate & other) const {
+        return object_ == other.object_ && stub_ == other.stub_ &&
+               std::memcmp(method_, other.method_, sizeof(method_)) == 0;
+    }
+
+    bool operator!=(const Delegate & other) const { return !(*this == other); }
+
+  private:
+    using Stub = R (*)(const Delegate &, Args...);
+
+    // Itanium ABI 下成员函数指针是两个指针宽；MSVC 多重/虚继承时可能更大，由 static_assert 把关
+    struct MethodProbe {
+        void Method();
+    };
+
+    static constexpr size_t kMethodSize = 2 * sizeof(void *);
+    static_assert(sizeof(void (MethodProbe::*)()) <= kMethodSize, "method pointer too large");
+
+    template <typename T, typename Method>
+    void BindMethod(T * object, Method method, Stub stub) {
+        static_assert(sizeof(Method) <= kMethodSize, "method pointer too large");
+        if (object != nullptr && method != nullptr) {
+            object_ = const_cast<void *>(static_cast<const void *>(object));
+            std::memcpy(method_, &method, sizeof(method));
+            stub_ = stub;
+        }
+    }
+
+    template <typename T, typename Method> static R InvokeMethod(const Delegate & d, Args... args) {
+        Method method;
+        std::memcpy(&method, d.method_, sizeof(method));
+        return (static_cast<T *>(d.object_)->*method)(std::forward<Args>(args)...);
+    }
+
+    template <typename T, auto Method> static R InvokeBound(const Delegate & d, Args... args) {
+        return (static_cast<T *>(d.object_)->*Method)(std::forward<Args>(args)...);
+    }
+
+    static R InvokeFunction(const Delegate & d, Args... args) {
+        return reinterpret_cast<R (*)(Args...)>(d.object_)(std::forward<Args>(args)...);
+    }
+
+    void * object_ = nullptr;
+    alignas(void *) unsigned char method_[kMethodSize] = {};
+    Stub stub_ = nullptr;
+};
+
+// 推导指引：Delegate d(&a, &A::Fun) 推导为 Delegate<void(int)>
+template <typename T, typename R, typename... Args>
+Delegate(T *, R (T::*)(Args...)) -> Delegate<R(Args...)>;
+
+template <typename T, typename R, typename... Args>
+Delegate(const T *, R (T::*)(Args...) const) -> Delegate<R(Args...)>;
+
+template <typename R, typename... Args> Delegate(R (*)(Args...)) -> Delegate<R(Args...)>;
+
+// ============================================================================
+// 2. EventDispatcher - 连续存储 + 写时复制 + 无锁读
+// ============================================================================
+
+using SubscriptionId = uint64_t;
+
+template <typename... Args> class EventDispatcher {
+  public:
+    using Handler = Delegate<void(Args...)>;
+
+    EventDispatcher() = default;
+
+    EventDispatcher(const EventDispatcher &)             = delete;
+    EventDispatcher & operator=(const EventDispatcher &) = delete;
+
+    // 析构时不能有其他线程还在 Emit
+    ~EventDispatcher() {
+        delete head_.load(std::memory_order_relaxed);
+        for (Snapshot * s : retired_) {
+            delete s;
+        }
+    }
+
+    /**
+     * 订阅事件，返回用于退订的 id（从 1 开始）。空 Delegate 返回 0。
+     * 正在进行的 Emit 看不到新 handler，之后的 Emit 才会调用它。
+     */
+    SubscriptionId Subscribe(Handler handler) {
+        if (!handler) {
+            return 0;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Snapshot * current = head_.load(std::memory_order_relaxed);
+        size_t           n       = current != nullptr ? current->size : 0;
+        auto *           next    = new Snapshot(n + 1);
+        for (size_t i = 0; i < n; ++i) {
+            next->entries[i].handler = current->entries[i].handler;
+            next->entries[i].id      = current->entries[i].id;
+        }
+        SubscriptionId id        = ++last_id_;
+        next->entries[n].handler = handler;
+        next->entries[n].id      = id;
+        Publish(next);
+        return id;
+    }
+
+    // 批量订阅：只复制一次快照
+    void Subscribe(const std::vector<Handler> & handlers, std::vector<SubscriptionId> * ids) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Snapshot * current = head_.load(std::memory_order_relaxed);
+        size_t           n       = current != nullptr ? current->size : 0;
+        auto *           next    = new Snapshot(n + handlers.size());
+        for (size_t i = 0; i < n; ++i) {
+            next->entries[i].handler = current->entries[i].handler;
+            next->entries[i].id      = current->entries[i].id;
+        }
+        size_t count = n;
+        for (const Handler & handler : handlers) {
+            SubscriptionId id = handler ? ++last_id_ : 0;
+            if (handler) {
+                next->entries[count].handler = handler;
+                next->entries[count].id      = id;
+                ++count;
+            }
+            if (ids != nullptr) {
+                ids->push_back(id);
+            }
+        }
+        next->size = count;
+        Publish(next);
+    }
+
+    /**
+     * 退订。返回 false 表示 id 不存在（或已经退订）。
+     * 可以在 handler 回调内部调用：本次 Emit 中尚未调用到的该 handler 会被跳过。
+     * 其他线程上已经开始执行的那一次回调不会被打断。
+     */
+    bool Unsubscribe(SubscriptionId id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Snapshot * current = head_.load(std::memory_order_relaxed);
+        if (current == nullptr) {
+            return false;
+        }
+        const Entry * begin = current->entries.get();
+        const Entry * end   = begin + current->size;
+        const Entry * found =
+            std::find_if(begin, end, [id](const Entry & e) { return e.id == id; });
+        if (found == end) {
+            return false;
+        }
+        Remove(static_cast<size_t>(found - begin));
+        return true;
+    }
+
+    // 按 Delegate 退订第一个相等的 handler
+    bool Unsubscribe(const Handler & handler) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Snapshot * current = head_.load(std::memory_order_relaxed);
+        if (current == nullptr) {
+            return false;
+        }
+        for (size_t i = 0; i < current->size; ++i) {
+            if (current->entries[i].handler == handler) {
+                Remove(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * 依次调用当前所有 handler（按订阅顺序）。可以多线程并发调用，不加锁、不分配内存。
+     * 参数以左值传给每个 handler，因此不会被第一个 handler 移走。
+     */
+    void Emit(Args... args) const {
+        ReadGuard        guard(*this);
+        const Snapshot * snapshot = head_.load(std::memory_order_acquire);
+        if (snapshot == nullptr) {
+            return;
+        }
+        const Entry * entries = snapshot->entries.get();
+        for (size_t i = 0, n = snapshot->size; i < n; ++i) {
+            if (entries[i].live.load(std::memory_order_acquire)) {
+                entries[i].handler(args...);
+            }
+        }
+    }
+
+    void operator()(Args... args) const { Emit(args...); }
+
+    size_t size() const {
+        ReadGuard        guard(*this);
+        const Snapshot * snapshot = head_.load(std::memory_order_acquire);
+        return snapshot != nullptr ? snapshot->size : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // 等待回收的旧快照个数（用于观察回收是否及时）
+    size_t retired_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return retired_.size();
+    }
+
+  private:
+    struct Entry {
+        Handler           handler;
+        SubscriptionId    id = 0;
+        std::atomic<bool> live{ true };
+    };
+
+    struct Snapshot {
+        explicit Snapshot(size_t n) : size(n), entries(new Entry[n]) {}
+
+        size_t                   size;
+        std::unique_ptr<Entry[]> entries;
+        uint64_t                 retired_epoch = 0;
+    };
+
+    // 读者计数放在各自的缓存行上，避免与快照指针伪共享
+    struct alignas(64) ReaderCount {
+        std::atomic<uint64_t> value{ 0 };
+    };
+
+    /**
+     * 读者登记：在当前 epoch 对应的计数上加一，再确认 epoch 没有变化。
+     * 如果登记期间 epoch 推进了，撤销后重试（写者只推进 epoch，读者从不等待锁）。
+     */
+    class ReadGuard {
+      public:
+        explicit ReadGuard(const EventDispatcher & dispatcher) {
+            for (;;) {
+                uint64_t epoch = dispatcher.epoch_.load(std::memory_order_seq_cst);
+                count_         = &dispatcher.readers_[epoch & 1].value;
+                count_->fetch_add(1, std::memory_order_seq_cst);
+                if (dispatcher.epoch_.load(std::memory_order_seq_cst) == epoch) {
+                    return;
+                }
+                count_->fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        ~ReadGuard() { count_->fetch_sub(1, std::memory_order_release); }
+
+        ReadGuard(const ReadGuard &)             = delete;
+        ReadGuard & operator=(const ReadGuard &) = delete;
+
+      private:
+        std::atomic<uint64_t> * count_ = nullptr;
+    };
+
+    // 以下函数都在 mutex_ 下调用
+
+    void Remove(size_t index) {
+        Snapshot *     current = head_.load(std::memory_order_relaxed);
+        SubscriptionId id      = current->entries[index].id;
+
+        // 先在当前快照和所有未回收的旧快照中标记失效：正在遍历它们的 Emit 会跳过该 handler
+        MarkDead(current, id);
+        for (Snapshot * s : retired_) {
+            MarkDead(s, id);
+        }
+
+        Snapshot * next = nullptr;
+        if (current->size > 1) {
+            next = new Snapshot(current->size - 1);
+            for (size_t i = 0, j = 0; i < current->size; ++i) {
+                if (i != index) {
+                    next->entries[j].handler = current->entries[i].handler;
+                    next->entries[j].id      = current->entries[i].id;
+                    ++j;
+                }
+            }
+        }
+        Publish(next);
+    }
+
+    static void MarkDead(Snapshot * snapshot, SubscriptionId id) {
+        for (size_t i = 0; i < snapshot->size; ++i) {
+            if (snapshot->entries[i].id == id) {
+                snapshot->entries[i].live.store(false, std::memory_order_release);
+                return;
+            }
+        }
+    }
+
+    void Publish(Snapshot * next) {
+        Snapshot * old = head_.exchange(next, std::memory_order_seq_cst);
+        if (old != nullptr) {
+            old->retired_epoch = epoch_.load(std::memory_order_relaxed);
+            retired_.push_back(old);
+        }
+        Reclaim();
+    }
+
+    /**
+     * epoch 从 e 推进到 e+1 的前提：登记在 e-1 的读者已全部离开（两个计数交替使用）。
+     * 在 epoch t 时退役的快照，等 epoch 推进到 t+2 后一定没有读者：
+     * 登记在 t+1 及之后的读者读取快照指针时，新快照已经发布。
+     * 不会阻塞：读者未离开时留到下一次修改再回收，因此在回调中退订不会死锁。
+     */
+    void Reclaim() {
+        for (int step = 0; step < 2; ++step) {
+            uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+            if (readers_[(epoch + 1) & 1].value.load(std::memory_order_seq_cst) != 0) {
+                break;
+            }
+            epoch_.store(epoch + 1, std::memory_order_seq_cst);
+        }
+        uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+        auto     keep  = std::remove_if(retired_.begin(), retired_.end(), [epoch](Snapshot * s) {
+            if (s->retired_epoch + 2 <= epoch) {
+                delete s;
+                return true;
+            }
+            return false;
+        });
+        retired_.erase(keep, retired_.end());
+    }
+
+    std::atomic<Snapshot *> head_{ nullptr };
+    std::atomic<uint64_t>   epoch_{ 0 };
+    mutable ReaderCount     readers_[2];
+    mutable std::mutex      mutex_;
+    std::vector<Snapshot *> retired_;
+    SubscriptionId          last_id_ = 0;
+};
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+#endif // CPP_QA_LAB_CSRC_BASIC_EVENT_DISPATCHER_H_
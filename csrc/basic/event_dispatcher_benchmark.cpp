@@ -0,0 +1,269 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 多播事件分发基准测试：std::vector<std::function> vs EventDispatcher
+//
+// 用法: event_dispatcher_benchmark [每种规模的事件总数(handler 调用次数)]
+//
+// 1. 单线程 Emit 吞吐：订阅者 1 / 10 / 100 / 1000
+//    - function-list   : std::vector<std::function<void(int)>>，lambda 捕获对象指针，不加锁
+//    - function+rwlock : 同上，每次 Emit 持有 std::shared_mutex 读锁（支持并发 Emit 的最简写法）
+//    - delegate        : EventDispatcher + Delegate(obj, &T::Method)（MyDelegate 写法）
+//    - bound           : EventDispatcher + Delegate::Bind<&T::Method>(obj)
+// 2. 回调中退订：handler 删除自己和后一个 handler
+// 3. 多线程 Emit + 并发订阅/退订：检查每次 Emit 看到的都是完整快照
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+#include "event_dispatcher.h"
+#include "microbench.h"
+
+namespace cpp_qa_lab {
+namespace basic {
+
+// 两种不同的订阅者类型：放进同一个分发器需要类型擦除
+class Counter {
+  public:
+    void OnEvent(int value) { sum_ += value; }
+
+    int64_t sum() const { return sum_; }
+
+  private:
+    int64_t sum_ = 0;
+};
+
+class Histogram {
+  public:
+    void OnEvent(int value) { ++buckets_[value & 7]; }
+
+    int64_t total() const {
+        int64_t t = 0;
+        for (int64_t b : buckets_) {
+            t += b;
+        }
+        return t;
+    }
+
+  private:
+    int64_t buckets_[8] = {};
+};
+
+void BenchmarkEmit(microbench::Report & report, size_t total_calls) {
+    fmt::print("[1] 单线程 Emit（每种规模共约 {} 次 handler 调用，ns/次调用）\n", total_calls);
+    fmt::print("{:>12} {:>15} {:>16} {:>10} {:>10} {:>9} {:>9}  结果一致\n", "subscribers",
+               "function-list", "function+rwlock", "delegate", "bound", "vs list", "vs rwlock");
+
+    for (size_t subscribers : { 1, 10, 100, 1000 }) {
+        size_t events = std::max<size_t>(1, total_calls / subscribers);
+
+        // 一半 Counter、一半 Histogram，每种方式各自一组对象，最后比较累计结果
+        std::vector<Counter>   counters[4];
+        std::vector<Histogram> histograms[4];
+        for (int k = 0; k < 4; ++k) {
+            counters[k].resize((subscribers + 1) / 2);
+            histograms[k].resize(subscribers / 2);
+        }
+
+        std::vector<std::function<void(int)>> function_list, locked_list;
+        std::shared_mutex                     locked_mutex;
+        EventDispatcher<int>                  delegate_event;
+        EventDispatcher<int>                  bound_event;
+        std::vector<Delegate<void(int)>>      delegates, bound;
+        for (auto & c : counters[0]) {
+            function_list.emplace_back([&c](int v) { c.OnEvent(v); });
+        }
+        for (auto & h : histograms[0]) {
+            function_list.emplace_back([&h](int v) { h.OnEvent(v); });
+        }
+        for (auto & c : counters[3]) {
+            locked_list.emplace_back([&c](int v) { c.OnEvent(v); });
+        }
+        for (auto & h : histograms[3]) {
+            locked_list.emplace_back([&h](int v) { h.OnEvent(v); });
+        }
+        for (auto & c : counters[1]) {
+            delegates.emplace_back(&c, &Counter::OnEvent);
+        }
+        for (auto & h : histograms[1]) {
+            delegates.emplace_back(&h, &Histogram::OnEvent);
+        }
+        for (auto & c : counters[2]) {
+            bound.push_back(Delegate<void(int)>::Bind<&Counter::OnEvent>(&c));
+        }
+        for (auto & h : histograms[2]) {
+            bound.push_back(Delegate<void(int)>::Bind<&Histogram::OnEvent>(&h));
+        }
+        delegate_event.Subscribe(delegates, nullptr);
+        bound_event.Subscribe(bound, nullptr);
+
+        double t_function = report.Time(fmt::format("emit/function_list/{}", subscribers), [&] {
+            for (size_t e = 0; e < events; ++e) {
+                for (auto & f : function_list) {
+                    f(static_cast<int>(e));
+                }
+            }
+        });
+
+        double t_locked = report.Time(fmt::format("emit/function_rwlock/{}", subscribers), [&] {
+            for (size_t e = 0; e < events; ++e) {
+                std::shared_lock<std::shared_mutex> lock(locked_mutex);
+                for (auto & f : locked_list) {
+                    f(static_cast<int>(e));
+                }
+            }
+        });
+
+        double t_delegate = report.Time(fmt::format("emit/delegate/{}", subscribers), [&] {
+            for (size_t e = 0; e < events; ++e) {
+                delegate_event.Emit(static_cast<int>(e));
+            }
+        });
+
+        double t_bound = report.Time(fmt::format("emit/bound/{}", subscribers), [&] {
+            for (size_t e = 0; e < events; ++e) {
+                bound_event.Emit(static_cast<int>(e));
+            }
+        });
+
+        bool same = true;
+        for (int k = 1; k < 4; ++k) {
+            for (size_t i = 0; i < counters[k].size(); ++i) {
+                same = same && counters[k][i].sum() == counters[0][i].sum();
+            }
+            for (size_t i = 0; i < histograms[k].size(); ++i) {
+                same = same && histograms[k][i].total() == histograms[0][i].total();
+            }
+        }
+
+        auto ns = [&](double seconds) {
+            return seconds / static_cast<double>(events * subscribers) * 1e9;
+        };
+        fmt::print("{:>12} {:>15.2f} {:>16.2f} {:>10.2f} {:>10.2f} {:>8.2f}x {:>8.2f}x  {}\n",
+                   subscribers, ns(t_function), ns(t_locked), ns(t_delegate), ns(t_bound),
+                   t_function / t_bound, t_locked / t_bound, same ? "yes" : "NO");
+    }
+    fmt::print("\n");
+}
+
+// handler 在回调中退订自己和下一个 handler；下一个 handler 在本次 Emit 中不应再被调用
+class SelfRemover {
+  public:
+    void OnEvent(int) {
+        ++calls_;
+        if (dispatcher_ != nullptr) {
+            dispatcher_->Unsubscribe(self_);
+            dispatcher_->Unsubscribe(next_);
+            dispatcher_ = nullptr;
+        }
+    }
+
+    EventDispatcher<int> * dispatcher_ = nullptr;
+    SubscriptionId         self_ = 0, next_ = 0;
+    int                    calls_ = 0;
+};
+
+void CheckUnsubscribeDuringEmit() {
+    EventDispatcher<int> event;
+    SelfRemover          remover;
+    Counter              victim, survivor;
+    remover.dispatcher_ = &event;
+    remover.self_       = event.Subscribe(Delegate(&remover, &SelfRemover::OnEvent));
+    remover.next_       = event.Subscribe(Delegate(&victim, &Counter::OnEvent));
+    event.Subscribe(Delegate(&survivor, &Counter::OnEvent));
+
+    event.Emit(1);
+    event.Emit(10);
+    bool ok = remover.calls_ == 1 && victim.sum() == 0 && survivor.sum() == 11 && event.size() == 1;
+    fmt::print("[2] 回调中退订: remover 调用 {} 次, 被退订者累计 {}, 剩余 handler 累计 {} -> {}\n\n",
+               remover.calls_, victim.sum(), survivor.sum(), ok ? "正确" : "错误");
+}
+
+// 每个订阅者把收到的值加到共享计数上
+void BenchmarkConcurrent(microbench::Report & report, size_t emits_per_thread) {
+    const int            kEmitters = 4;
+    const int            kFixed    = 16;
+    EventDispatcher<int> event;
+    std::atomic<int64_t> fixed_sum{ 0 };
+
+    struct Sink {
+        std::atomic<int64_t> * sum;
+
+        void OnEvent(int v) { sum->fetch_add(v, std::memory_order_relaxed); }
+    };
+
+    std::vector<Sink> fixed(kFixed, Sink{ &fixed_sum });
+    for (auto & s : fixed) {
+        event.Subscribe(Delegate<void(int)>::Bind<&Sink::OnEvent>(&s));
+    }
+
+    // 抖动订阅者：另一个线程不断订阅/退订，统计到单独的计数上
+    std::atomic<int64_t> churn_sum{ 0 };
+    Sink                 churn{ &churn_sum };
+    std::atomic<bool>    stop{ false };
+    size_t               mutations = 0;
+    std::thread          mutator([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            SubscriptionId id = event.Subscribe(Delegate<void(int)>::Bind<&Sink::OnEvent>(&churn));
+            event.Unsubscribe(id);
+            mutations += 2;
+            std::this_thread::yield();
+        }
+    });
+
+    double seconds = microbench::Seconds([&] {
+        std::vector<std::thread> emitters;
+        for (int t = 0; t < kEmitters; ++t) {
+            emitters.emplace_back([&] {
+                for (size_t i = 0; i < emits_per_thread; ++i) {
+                    event.Emit(1);
+                }
+            });
+        }
+        for (auto & t : emitters) {
+            t.join();
+        }
+    });
+    stop.store(true);
+    mutator.join();
+
+    // 固定订阅者必须恰好收到每一次 Emit；抖动订阅者收到多少取决于时序
+    int64_t expected = static_cast<int64_t>(kEmitters) * emits_per_thread * kFixed;
+    report.Add("concurrent_emit", { seconds }, kEmitters * emits_per_thread).correct =
+        fixed_sum.load() == expected;
+    fmt::print("[3] {} 个线程并发 Emit，另一线程订阅/退订 {} 次\n", kEmitters, mutations);
+    fmt::print("    {:.1f} ns/Emit ({} 个固定订阅者), 固定订阅者收到 {} / {} -> {}\n",
+               seconds / (kEmitters * emits_per_thread) * 1e9, kFixed, fixed_sum.load(), expected,
+               fixed_sum.load() == expected ? "正确" : "错误");
+    fmt::print("    抖动订阅者收到 {} 次, 待回收快照 {} 个\n", churn_sum.load(),
+               event.retired_count());
+}
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+int main(int argc, char * argv[]) {
+    microbench::Report report(argc, argv);
+    size_t             total = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000000;
+    total                    = std::max<size_t>(1000, total);
+
+    spdlog::info("多播事件分发基准测试");
+    spdlog::info("=====================================");
+    cpp_qa_lab::basic::BenchmarkEmit(report, total);
+    cpp_qa_lab::basic::CheckUnsubscribeDuringEmit();
+    cpp_qa_lab::basic::BenchmarkConcurrent(report, total / 64);
+
+    spdlog::info("关键学习点：");
+    spdlog::info("1. Delegate 只有对象指针 + 成员函数指针 + 调用桩，可平凡拷贝，不分配内存");
+    spdlog::info("2. 所有 handler 连续存放，遍历时缓存友好；Bind<&T::Method> 让调用桩可以内联");
+    spdlog::info("3. 写时复制：Emit 遍历不可变快照，回调里订阅/退订不会破坏遍历");
+    spdlog::info("4. epoch 读者计数让旧快照延迟回收，Emit 路径上没有锁");
+    spdlog::info("5. 读者登记是每次 Emit 的固定开销（两次原子读改写），订阅者越多摊得越薄");
+    return report.Finish();
+}
@@ -8,6 +8,8 @@
 #include <vector>
 
 #include "common.h"
+#include "data_processor.h"
+#include "money.h"
 
 namespace cpp_qa_lab {
 namespace basic {
@@ -16,51 +18,55 @@ namespace basic {
 // 1. 友元函数示例 - 访问私有成员
 // ============================================================================
 
-class BankAccount {
+// 金额类型作为模板参数：Amount 可以是 double（旧写法）或 Money（定点整数，见 money.h）。
+// Amount 只需要支持 +=、-=、比较，以及值初始化为 0。
+template <typename Amount> class BankAccount;
+template <typename Amount> class AccountManager;
+
+// 友元函数模板需要先声明，类中才能把某一个特化声明为友元
+template <typename Amount> void PrintAccountDetails(const BankAccount<Amount> & account);
+template <typename Amount>
+void TransferMoney(BankAccount<Amount> & from, BankAccount<Amount> & to, Amount amount);
+template <typename Amount> Amount GetBalance(const BankAccount<Amount> & account);
+
+template <typename Amount> class BankAccount {
   public:
-    explicit BankAccount(std::string account_id, double balance = 0.0) :
+    explicit BankAccount(std::string account_id, Amount balance = Amount()) :
         account_id_(std::move(account_id)),
         balance_(balance) {}
 
     // 友元函数声明 - 可以访问私有成员
-    friend void   PrintAccountDetails(const BankAccount & account);
-    friend void   TransferMoney(BankAccount & from, BankAccount & to, double amount);
-    friend double GetBalance(const BankAccount & account);
+    // <> 表示只有相同 Amount 的特化是友元（一对一），BankAccount<double> 的友元
+    // 不能访问 BankAccount<Money> 的私有成员
+    friend void   PrintAccountDetails<>(const BankAccount & account);
+    friend void   TransferMoney<>(BankAccount & from, BankAccount & to, Amount amount);
+    friend Amount GetBalance<>(const BankAccount & account);
 
     // 友元类声明
-    friend class AccountManager;
+    friend class AccountManager<Amount>;
 
     // 公共接口
     const std::string & GetAccountId() const { return account_id_; }
 
-    void Deposit(double amount);
-    bool Withdraw(double amount);
+    void Deposit(Amount amount);
+    bool Withdraw(Amount amount);
 
   private:
     std::string account_id_;
-    double      balance_;
+    Amount      balance_;
 };
 
-// 友元函数 - 打印账户详情
-void PrintAccountDetails(const BankAccount & account);
-
-// 友元函数 - 转账功能
-void TransferMoney(BankAccount & from, BankAccount & to, double amount);
-
-// 友元函数 - 获取余额
-double GetBalance(const BankAccount & account);
-
 // 实现：BankAccount 与相关友元函数（紧跟声明）
-void BankAccount::Deposit(double amount) {
-    if (amount > 0) {
+template <typename Amount> void BankAccount<Amount>::Deposit(Amount amount) {
+    if (amount > Amount()) {
         balance_ += amount;
         spdlog::info("Deposited ${} to account {}. New balance: ${}", amount, account_id_,
                      balance_);
     }
 }
 
-bool BankAccount::Withdraw(double amount) {
-    if (amount > 0 && balance_ >= amount) {
+template <typename Amount> bool BankAccount<Amount>::Withdraw(Amount amount) {
+    if (amount > Amount() && balance_ >= amount) {
         balance_ -= amount;
         spdlog::info("Withdrew ${} from account {}. New balance: ${}", amount, account_id_,
                      balance_);
@@ -70,7 +76,7 @@ bool BankAccount::Withdraw(double amount) {
     return false;
 }
 
-void PrintAccountDetails(const BankAccount & account) {
+template <typename Amount> void PrintAccountDetails(const BankAccount<Amount> & account) {
     // 友元函数可以访问私有成员
     spdlog::info("=== Account Details ===");
     spdlog::info("Account ID: {}", account.account_id_);
@@ -78,8 +84,9 @@ void PrintAccountDetails(const BankAccount & account) {
     spdlog::info("======================");
 }
 
-void TransferMoney(BankAccount & from, BankAccount & to, double amount) {
-    if (amount <= 0) {
+template <typename Amount>
+void TransferMoney(BankAccount<Amount> & from, BankAccount<Amount> & to, Amount amount) {
+    if (amount <= Amount()) {
         spdlog::warn("Invalid transfer amount");
         return;
     }
@@ -96,7 +103,7 @@ void TransferMoney(BankAccount & from, BankAccount & to, double amount) {
     spdlog::info("Transferred ${} from {} to {}", amount, from.account_id_, to.account_id_);
 }
 
-double GetBalance(const BankAccount & account) {
+template <typename Amount> Amount GetBalance(const BankAccount<Amount> & account) {
     // 友元函数可以访问私有成员
     return account.balance_;
 }
@@ -105,29 +112,30 @@ double GetBalance(const BankAccount & account) {
 // 2. 友元类示例 - 账户管理器
 // ============================================================================
 
-class AccountManager {
+template <typename Amount> class AccountManager {
   public:
     explicit AccountManager(std::string manager_id) : manager_id_(std::move(manager_id)) {}
 
-    // 作为 BankAccount 的友元类，可以访问其私有成员
-    void AuditAccount(const BankAccount & account) const;
-    void FreezeAccount(BankAccount & account);
-    void UnfreezeAccount(BankAccount & account);
-    void SetBalance(BankAccount & account, double new_balance);
+    // 作为 BankAccount<Amount> 的友元类，可以访问其私有成员
+    void AuditAccount(const BankAccount<Amount> & account) const;
+    void FreezeAccount(BankAccount<Amount> & account);
+    void UnfreezeAccount(BankAccount<Amount> & account);
+    void SetBalance(BankAccount<Amount> & account, Amount new_balance);
 
     // 管理多个账户
-    void AddAccount(BankAccount * account);
+    void AddAccount(BankAccount<Amount> * account);
     void RemoveAccount(const std::string & account_id);
     void PrintAllAccounts() const;
 
   private:
-    std::string                manager_id_;
-    std::vector<BankAccount *> managed_accounts_;
-    bool                       is_frozen_ = false;
+    std::string                        manager_id_;
+    std::vector<BankAccount<Amount> *> managed_accounts_;
+    bool                               is_frozen_ = false;
 };
 
 // 实现：AccountManager 方法（紧跟声明）
-void AccountManager::AuditAccount(const BankAccount & account) const {
+template <typename Amount>
+void AccountManager<Amount>::AuditAccount(const BankAccount<Amount> & account) const {
     // 作为友元类，可以访问 BankAccount 的私有成员
     spdlog::info("=== Account Audit ===");
     spdlog::info("Manager: {}", manager_id_);
@@ -137,35 +145,40 @@ void AccountManager::AuditAccount(const BankAccount & account) const {
     spdlog::info("====================");
 }
 
-void AccountManager::FreezeAccount(BankAccount & account) {
+template <typename Amount>
+void AccountManager<Amount>::FreezeAccount(BankAccount<Amount> & account) {
     // 模拟冻结账户 - 在实际应用中可能设置状态标志
     spdlog::info("Account {} has been frozen by manager {}", account.account_id_, manager_id_);
     is_frozen_ = true;
 }
 
-void AccountManager::UnfreezeAccount(BankAccount & account) {
+template <typename Amount>
+void AccountManager<Amount>::UnfreezeAccount(BankAccount<Amount> & account) {
     spdlog::info("Account {} has been unfrozen by manager {}", account.account_id_, manager_id_);
     is_frozen_ = false;
 }
 
-void AccountManager::SetBalance(BankAccount & account, double new_balance) {
+template <typename Amount>
+void AccountManager<Amount>::SetBalance(BankAccount<Amount> & account, Amount new_balance) {
     // 作为友元类，可以直接修改私有成员
     spdlog::info("Manager {} changed balance of account {} from ${} to {}", manager_id_,
                  account.account_id_, account.balance_, new_balance);
     account.balance_ = new_balance;
 }
 
-void AccountManager::AddAccount(BankAccount * account) {
+template <typename Amount> void AccountManager<Amount>::AddAccount(BankAccount<Amount> * account) {
     if (account != nullptr) {
         managed_accounts_.push_back(account);
         spdlog::info("Account {} added to manager {}", account->GetAccountId(), manager_id_);
     }
 }
 
-void AccountManager::RemoveAccount(const std::string & account_id) {
-    auto it = std::find_if(
-        managed_accounts_.begin(), managed_accounts_.end(),
-        [&account_id](const BankAccount * acc) { return acc->GetAccountId() == account_id; });
+template <typename Amount>
+void AccountManager<Amount>::RemoveAccount(const std::string & account_id) {
+    auto it = std::find_if(managed_accounts_.begin(), managed_accounts_.end(),
+                           [&account_id](const BankAccount<Amount> * acc) {
+                               return acc->GetAccountId() == account_id;
+                           });
 
     if (it != managed_accounts_.end()) {
         spdlog::info("Account {} removed from manager {}", account_id, manager_id_);
@@ -173,7 +186,7 @@ void AccountManager::RemoveAccount(const std::string & account_id) {
     }
 }
 
-void AccountManager::PrintAllAccounts() const {
+template <typename Amount> void AccountManager<Amount>::PrintAllAccounts() const {
     spdlog::info("=== Accounts managed by {} ===", manager_id_);
     for (const auto * account : managed_accounts_) {
         spdlog::info("Account: {}, Balance: ${}", account->GetAccountId(), GetBalance(*account));
@@ -391,15 +404,16 @@ void ProcessDataHelper(DataProcessor & processor) {
 void DemonstrateFriendFunctions() {
     spdlog::info("\n=== 友元函数示例 ===");
 
-    BankAccount account1("ACC001", 1000.0);
-    BankAccount account2("ACC002", 500.0);
+    // 类模板实参推导：由 Money 类型的初始余额推导出 BankAccount<Money>
+    BankAccount account1("ACC001", Money::FromUnits(1000));
+    BankAccount account2("ACC002", Money::FromUnits(500));
 
     spdlog::info("初始状态:");
     PrintAccountDetails(account1);
     PrintAccountDetails(account2);
 
     // 使用友元函数进行转账
-    TransferMoney(account1, account2, 200.0);
+    TransferMoney(account1, account2, Money::FromUnits(200));
 
     spdlog::info("转账后:");
     PrintAccountDetails(account1);
@@ -409,14 +423,14 @@ void DemonstrateFriendFunctions() {
 void DemonstrateFriendClasses() {
     spdlog::info("\n=== 友元类示例 ===");
 
-    BankAccount    account("ACC003", 1500.0);
-    AccountManager manager("MGR001");
+    BankAccount           account("ACC003", Money::FromUnits(1500));
+    AccountManager<Money> manager("MGR001");
 
     // 账户管理器作为友元类可以审计账户
     manager.AuditAccount(account);
 
     // 管理器可以直接修改余额
-    manager.SetBalance(account, 2000.0);
+    manager.SetBalance(account, Money::FromUnits(2000));
 
     // 添加账户到管理器
     manager.AddAccount(&account);
@@ -426,6 +440,22 @@ void DemonstrateFriendClasses() {
     manager.FreezeAccount(account);
 }
 
+void DemonstrateAmountTypes() {
+    spdlog::info("\n=== 金额类型：double vs Money ===");
+
+    // 同一份账户代码，分别用 double 和定点 Money 实例化，各存入 10 次 0.10
+    BankAccount<double> legacy("ACC-D", 0.0);
+    BankAccount<Money>  exact("ACC-M");
+    for (int i = 0; i < 10; ++i) {
+        legacy.Deposit(0.1);
+        exact.Deposit(*Money::Parse("0.10"));
+    }
+    spdlog::info("double: {:.17g} == 1.0 ? {}", GetBalance(legacy),
+                 GetBalance(legacy) == 1.0 ? "true" : "false");
+    spdlog::info("Money : {} == 1.00 ? {}", GetBalance(exact),
+                 GetBalance(exact) == Money::FromUnits(1) ? "true" : "false");
+}
+
 void DemonstrateFriendOperators() {
     spdlog::info("\n=== 运算符重载中的友元函数示例 ===");
 
@@ -470,6 +500,12 @@ void DemonstrateFriendBestPractices() {
 
     const auto & results = processor.GetResults();
     spdlog::info("Results: {}", fmt::join(results, " "));
+
+    // 批量版本（data_processor.h）：不拷贝输入，结果写入调用者提供的缓冲区
+    BatchDataProcessor batch;
+    std::vector<int>   squares(data.size());
+    batch.Square(data, squares);
+    spdlog::info("BatchDataProcessor ({}): {}", batch.kernel_name(), fmt::join(squares, " "));
 }
 
 } // namespace basic
@@ -504,6 +540,9 @@ int main() {
     // 演示友元类
     cpp_qa_lab::basic::DemonstrateFriendClasses();
 
+    // 演示同一份账户代码在不同金额类型下的差异
+    cpp_qa_lab::basic::DemonstrateAmountTypes();
+
     // 演示运算符重载中的友元函数
     cpp_qa_lab::basic::DemonstrateFriendOperators();
 
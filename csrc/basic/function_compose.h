@@ -0,0 +1,207 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 编译期函数组合与静态分发表
+//
+// - Compose(f1, f2, ..., fn)：返回 x -> f1(f2(...fn(x)))，各阶段按值存放在一个对象里，
+//   嵌套的 Compose 在编译期被展平；没有 std::function，也没有额外的间接调用层，
+//   整条链可以被编译器内联成一个函数体
+// - kFn<&F>：把函数指针 / 成员函数指针提升为无状态的类型，调用目标在编译期已知，
+//   因此可以内联；直接传函数指针时每个阶段仍是一次间接调用
+// - DispatchTable(h0, h1, ..., hn)：把运行时 opcode 映射到静态生成的处理函数，
+//   内部是一个 switch，编译器会把它生成为跳转表，每个 case 里的调用都可以内联
+
+#ifndef CPP_QA_LAB_CSRC_BASIC_FUNCTION_COMPOSE_H_
+#define CPP_QA_LAB_CSRC_BASIC_FUNCTION_COMPOSE_H_
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace cpp_qa_lab {
+namespace basic {
+
+namespace compose_detail {
+
+// C++17 的 std::invoke 不是 constexpr：普通可调用对象直接调用，只有成员指针才走 std::invoke
+template <typename F, typename... Args> constexpr decltype(auto) Invoke(F && f, Args &&... args) {
+    if constexpr (std::is_member_pointer_v<std::decay_t<F>>) {
+        return std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+    } else {
+        return std::forward<F>(f)(std::forward<Args>(args)...);
+    }
+}
+
+} // namespace compose_detail
+
+// ============================================================================
+// kFn<&F>：编译期已知的调用目标
+// ============================================================================
+
+template <auto F> struct FnConstant {
+    template <typename... Args>
+    constexpr decltype(auto) operator()(Args &&... args) const
+        noexcept(std::is_nothrow_invocable_v<decltype(F), Args...>) {
+        return compose_detail::Invoke(F, std::forward<Args>(args)...);
+    }
+};
+
+template <auto F> inline constexpr FnConstant<F> kFn{};
+
+// ============================================================================
+// Compose：变参、编译期展平的函数组合
+// ============================================================================
+
+template <typename... Fs> class Composed;
+
+namespace compose_detail {
+
+template <typename T> struct IsComposed : std::false_type {};
+
+template <typename... Fs> struct IsComposed<Composed<Fs...>> : std::true_type {};
+
+// 普通可调用对象包成单元素 tuple，Composed 直接拿出内部的 tuple，再用 tuple_cat 拼接
+template <typename F> constexpr auto AsStages(F && f) {
+    using Decayed = std::decay_t<F>;
+    if constexpr (IsComposed<Decayed>::value) {
+        return std::forward<F>(f).stages();
+    } else {
+        return std::tuple<Decayed>(std::forward<F>(f));
+    }
+}
+
+template <typename Tuple> struct ComposedFromTuple;
+
+template <typename... Fs> struct ComposedFromTuple<std::tuple<Fs...>> {
+    using type = Composed<Fs...>;
+};
+
+} // namespace compose_detail
+
+// 调用顺序与数学记号一致：Composed<F1, F2, F3>(x) == F1(F2(F3(x)))
+template <typename... Fs> class Composed {
+    static_assert(sizeof...(Fs) > 0, "Composed needs at least one stage");
+
+  public:
+    using Stages = std::tuple<Fs...>;
+
+    static constexpr size_t kStageCount = sizeof...(Fs);
+
+    constexpr explicit Composed(Stages stages) : stages_(std::move(stages)) {}
+
+    template <typename... Args> constexpr decltype(auto) operator()(Args &&... args) const {
+        return Apply<0>(std::forward<Args>(args)...);
+    }
+
+    constexpr const Stages & stages() const & { return stages_; }
+
+    constexpr Stages && stages() && { return std::move(stages_); }
+
+  private:
+    // 最内层（最后一个）阶段接收原始参数，其余阶段只接收上一阶段的结果
+    template <size_t I, typename... Args> constexpr decltype(auto) Apply(Args &&... args) const {
+        if constexpr (I + 1 == kStageCount) {
+            return compose_detail::Invoke(std::get<I>(stages_), std::forward<Args>(args)...);
+        } else {
+            return compose_detail::Invoke(std::get<I>(stages_),
+                                          Apply<I + 1>(std::forward<Args>(args)...));
+        }
+    }
+
+    Stages stages_;
+};
+
+template <typename... Fs> constexpr auto Compose(Fs &&... fs) {
+    auto stages = std::tuple_cat(compose_detail::AsStages(std::forward<Fs>(fs))...);
+    using Result = typename compose_detail::ComposedFromTuple<decltype(stages)>::type;
+    return Result(std::move(stages));
+}
+
+namespace compose_detail {
+
+template <typename Tuple, size_t... I>
+constexpr auto ComposeReversed(Tuple && stages, std::index_sequence<I...>) {
+    return Compose(std::get<sizeof...(I) - 1 - I>(std::forward<Tuple>(stages))...);
+}
+
+} // namespace compose_detail
+
+// Pipe 是从左到右的写法：Pipe(f, g, h)(x) == h(g(f(x)))
+template <typename... Fs> constexpr auto Pipe(Fs &&... fs) {
+    auto stages = std::tuple_cat(compose_detail::AsStages(std::forward<Fs>(fs))...);
+    return compose_detail::ComposeReversed(
+        std::move(stages), std::make_index_sequence<std::tuple_size_v<decltype(stages)>>{});
+}
+
+// ============================================================================
+// DispatchTable：运行时 opcode -> 静态生成的处理函数
+// ============================================================================
+
+// 单个 switch 能展开的最大 case 数；超过时请拆成两级表
+inline constexpr size_t kMaxDispatchCases = 64;
+
+template <typename... Handlers> class DispatchTable {
+  public:
+    static constexpr size_t kSize = sizeof...(Handlers);
+
+    static_assert(kSize > 0, "DispatchTable needs at least one handler");
+    static_assert(kSize <= kMaxDispatchCases, "too many handlers for one switch");
+
+    constexpr explicit DispatchTable(Handlers... handlers) : handlers_(std::move(handlers)...) {}
+
+    // 所有处理函数对同一组参数的返回值必须有公共类型
+    template <typename... Args>
+    using Result = std::common_type_t<std::invoke_result_t<const Handlers &, Args...>...>;
+
+    // 越界的 opcode 抛出 std::out_of_range；热路径上只多一次比较
+    template <typename... Args> Result<Args...> operator()(size_t opcode, Args &&... args) const {
+        switch (opcode) {
+#define CPP_QA_LAB_DISPATCH_CASE(i)                                                               \
+    case (i):                                                                                     \
+        if constexpr ((i) < kSize) {                                                              \
+            return compose_detail::Invoke(std::get<(i)>(handlers_), std::forward<Args>(args)...); \
+        }                                                                                         \
+        break;
+#define CPP_QA_LAB_DISPATCH_CASE4(i)                                                              \
+    CPP_QA_LAB_DISPATCH_CASE(i)                                                                   \
+    CPP_QA_LAB_DISPATCH_CASE(i + 1)                                                               \
+    CPP_QA_LAB_DISPATCH_CASE(i + 2)                                                               \
+    CPP_QA_LAB_DISPATCH_CASE(i + 3)
+#define CPP_QA_LAB_DISPATCH_CASE16(i)                                                             \
+    CPP_QA_LAB_DISPATCH_CASE4(i)                                                                  \
+    CPP_QA_LAB_DISPATCH_CASE4(i + 4)                                                              \
+    CPP_QA_LAB_DISPATCH_CASE4(i + 8)                                                              \
+    CPP_QA_LAB_DISPATCH_CASE4(i + 12)
+            CPP_QA_LAB_DISPATCH_CASE16(0)
+            CPP_QA_LAB_DISPATCH_CASE16(16)
+            CPP_QA_LAB_DISPATCH_CASE16(32)
+            CPP_QA_LAB_DISPATCH_CASE16(48)
+#undef CPP_QA_LAB_DISPATCH_CASE16
+#undef CPP_QA_LAB_DISPATCH_CASE4
+#undef CPP_QA_LAB_DISPATCH_CASE
+            default:
+                break;
+        }
+        throw std::out_of_range("DispatchTable: opcode " + std::to_string(opcode) +
+                                " out of range");
+    }
+
+    template <size_t I> constexpr const auto & handler() const { return std::get<I>(handlers_); }
+
+  private:
+    std::tuple<Handlers...> handlers_;
+};
+
+template <typename... Handlers> constexpr auto MakeDispatchTable(Handlers... handlers) {
+    return DispatchTable<Handlers...>(std::move(handlers)...);
+}
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+#endif // CPP_QA_LAB_CSRC_BASIC_FUNCTION_COMPOSE_H_
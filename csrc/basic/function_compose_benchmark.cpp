@@ -0,0 +1,346 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 编译期函数组合 / 静态分发表基准测试
+//
+// 用法: function_compose_benchmark [指令条数]
+//
+// 1. 操作码解释器：累加器虚拟机，10 种操作（含两条由 Compose 组合出的融合指令）
+//    - std::function  : Calculator 式写法，std::function 表里混放函数指针、std::mem_fn、lambda
+//    - fn-pointer     : 函数指针数组，成员函数和融合指令包一层无捕获 lambda
+//    - dispatch-table : DispatchTable + kFn<&F> + Compose，switch 跳转表，处理函数可内联
+//    - hand-switch    : 手写 switch，作为上限参考
+// 2. 变换链：对一组 double 依次应用 6 个阶段
+//    - Pipeline       : std::vector<std::function<double(double)>>，逐个间接调用
+//    - nested Compose : 两两 Compose 后存进 std::function（每层一次间接调用）
+//    - Compose(...)   : 变参 Compose 展平后内联成一个函数体
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "common.h"
+#include "function_compose.h"
+#include "microbench.h"
+
+namespace cpp_qa_lab {
+namespace basic {
+
+// ============================================================================
+// 1. 操作码解释器
+// ============================================================================
+
+// 寄存器：累加器 + 当前指令的立即数；每条指令都是 Regs -> Regs
+struct Regs {
+    uint64_t acc;
+    uint64_t imm;
+
+    // 旋转位数取 1..31，避免移位 64 位的未定义行为
+    Regs Rotl() const {
+        unsigned s = (imm & 31) | 1;
+        return { (acc << s) | (acc >> (64 - s)), imm };
+    }
+
+    Regs Neg() const { return { ~acc + 1, imm }; }
+};
+
+Regs OpAdd(Regs r) {
+    return { r.acc + r.imm, r.imm };
+}
+
+Regs OpSub(Regs r) {
+    return { r.acc - r.imm, r.imm };
+}
+
+Regs OpXor(Regs r) {
+    return { r.acc ^ (r.imm * 0x9e3779b97f4a7c15ULL), r.imm };
+}
+
+Regs OpMul(Regs r) {
+    return { r.acc * (r.imm | 1), r.imm };
+}
+
+inline constexpr auto kHalve = [](Regs r) {
+    return Regs{ r.acc >> 1 | (r.acc & 1) << 63, r.imm };
+};
+
+inline constexpr auto kSwapHalves = [](Regs r) {
+    return Regs{ r.acc << 32 | r.acc >> 32, r.imm };
+};
+
+// 两条融合指令：先乘后加、先异或再旋转
+inline constexpr auto kMulAdd = Compose(kFn<&OpAdd>, kFn<&OpMul>);
+inline constexpr auto kXorRotl = Compose(kFn<&Regs::Rotl>, kFn<&OpXor>);
+
+constexpr size_t kOpCount = 10;
+
+struct Instr {
+    uint8_t  op;
+    uint32_t imm;
+};
+
+using RegsFn = Regs (*)(Regs);
+
+std::vector<std::function<Regs(Regs)>> MakeFunctionTable() {
+    // 老写法：两两组合，每一层都是 std::function
+    auto compose2 = [](std::function<Regs(Regs)> f, std::function<Regs(Regs)> g) {
+        return [f = std::move(f), g = std::move(g)](Regs r) { return f(g(r)); };
+    };
+    return {
+        OpAdd,
+        OpSub,
+        OpXor,
+        OpMul,
+        std::mem_fn(&Regs::Rotl),
+        std::mem_fn(&Regs::Neg),
+        kHalve,
+        kSwapHalves,
+        compose2(OpAdd, OpMul),
+        compose2(std::mem_fn(&Regs::Rotl), OpXor),
+    };
+}
+
+constexpr RegsFn kPointerTable[kOpCount] = {
+    OpAdd,
+    OpSub,
+    OpXor,
+    OpMul,
+    [](Regs r) { return r.Rotl(); },
+    [](Regs r) { return r.Neg(); },
+    kHalve,
+    kSwapHalves,
+    [](Regs r) { return OpAdd(OpMul(r)); },
+    [](Regs r) { return OpXor(r).Rotl(); },
+};
+
+inline constexpr auto kDispatch = MakeDispatchTable(kFn<&OpAdd>, kFn<&OpSub>, kFn<&OpXor>,
+                                                    kFn<&OpMul>, kFn<&Regs::Rotl>, kFn<&Regs::Neg>,
+                                                    kHalve, kSwapHalves, kMulAdd, kXorRotl);
+static_assert(decltype(kDispatch)::kSize == kOpCount);
+
+uint64_t RunHandSwitch(const std::vector<Instr> & program, uint64_t acc) {
+    for (const Instr & in : program) {
+        Regs r{ acc, in.imm };
+        switch (in.op) {
+            case 0:
+                r = OpAdd(r);
+                break;
+            case 1:
+                r = OpSub(r);
+                break;
+            case 2:
+                r = OpXor(r);
+                break;
+            case 3:
+                r = OpMul(r);
+                break;
+            case 4:
+                r = r.Rotl();
+                break;
+            case 5:
+                r = r.Neg();
+                break;
+            case 6:
+                r = kHalve(r);
+                break;
+            case 7:
+                r = kSwapHalves(r);
+                break;
+            case 8:
+                r = OpAdd(OpMul(r));
+                break;
+            case 9:
+                r = OpXor(r).Rotl();
+                break;
+            default:
+                break;
+        }
+        acc = r.acc;
+    }
+    return acc;
+}
+
+// predictable = false 时操作码均匀随机（间接跳转难以预测）；否则按固定的短周期重复
+std::vector<Instr> MakeProgram(size_t n, bool predictable) {
+    std::mt19937_64                         rng(42);
+    std::uniform_int_distribution<uint32_t> op_dist(0, kOpCount - 1);
+    std::vector<Instr>                      program(n);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t op = predictable ? static_cast<uint32_t>(i % 5 * 2 % kOpCount) : op_dist(rng);
+        program[i]  = Instr{ static_cast<uint8_t>(op), static_cast<uint32_t>(rng() % 1000) };
+    }
+    return program;
+}
+
+void BenchmarkInterpreter(microbench::Report & report, size_t instructions) {
+    fmt::print("[1] 操作码解释器（{} 条指令，ns/条指令）\n", instructions);
+    fmt::print("{:>12} {:>14} {:>11} {:>15} {:>12} {:>14}  结果一致\n", "opcodes",
+               "std::function", "fn-pointer", "dispatch-table", "hand-switch", "vs function");
+
+    auto function_table = MakeFunctionTable();
+    for (bool predictable : { false, true }) {
+        std::vector<Instr> program    = MakeProgram(instructions, predictable);
+        const char *       mode       = predictable ? "periodic" : "random";
+        uint64_t           results[4] = {};
+
+        double t_function = report.Time(fmt::format("interpreter/std_function/{}", mode), [&] {
+            uint64_t acc = 1;
+            for (const Instr & in : program) {
+                acc = function_table[in.op](Regs{ acc, in.imm }).acc;
+            }
+            results[0] = acc;
+        });
+
+        double t_pointer = report.Time(fmt::format("interpreter/fn_pointer/{}", mode), [&] {
+            uint64_t acc = 1;
+            for (const Instr & in : program) {
+                acc = kPointerTable[in.op](Regs{ acc, in.imm }).acc;
+            }
+            results[1] = acc;
+        });
+
+        double t_dispatch = report.Time(fmt::format("interpreter/dispatch_table/{}", mode), [&] {
+            uint64_t acc = 1;
+            for (const Instr & in : program) {
+                acc = kDispatch(in.op, Regs{ acc, in.imm }).acc;
+            }
+            results[2] = acc;
+        });
+
+        double t_switch = report.Time(fmt::format("interpreter/hand_switch/{}", mode),
+                                      [&] { results[3] = RunHandSwitch(program, 1); });
+
+        bool same = results[0] == results[1] && results[1] == results[2] &&
+                    results[2] == results[3];
+        auto ns   = [&](double seconds) {
+            return seconds / static_cast<double>(instructions) * 1e9;
+        };
+        fmt::print("{:>12} {:>14.2f} {:>11.2f} {:>15.2f} {:>12.2f} {:>13.2f}x  {}\n", mode,
+                   ns(t_function), ns(t_pointer), ns(t_dispatch), ns(t_switch),
+                   t_function / t_dispatch, same ? "yes" : "NO");
+    }
+    fmt::print("\n");
+}
+
+// ============================================================================
+// 2. 变换链
+// ============================================================================
+
+double Scale(double x) {
+    return x * 1.5;
+}
+
+double Offset(double x) {
+    return x - 0.25;
+}
+
+struct Clamp {
+    double lo, hi;
+
+    double operator()(double x) const { return std::max(lo, std::min(x, hi)); }
+};
+
+void BenchmarkChain(microbench::Report & report, size_t n) {
+    std::vector<double> input(n), out[3];
+    std::mt19937_64     rng(7);
+    // 输入范围让 clamp 很少生效：否则分支预测失败会掩盖调用开销本身
+    std::uniform_real_distribution<double> dist(-3.0, 3.0);
+    for (double & x : input) {
+        x = dist(rng);
+    }
+
+    auto square  = [](double x) { return x * x; };
+    auto half    = [](double x) { return x * 0.5; };
+    auto clamp   = Clamp{ -4.0, 4.0 };
+    auto compose2 = [](std::function<double(double)> f, std::function<double(double)> g) {
+        return std::function<double(double)>([f = std::move(f), g = std::move(g)](double x) {
+            return f(g(x));
+        });
+    };
+
+    // 三种写法都按 Scale -> Offset -> clamp -> square -> half -> Offset 的顺序执行
+    std::vector<std::function<double(double)>> pipeline = { Scale, Offset, clamp,
+                                                            square, half,  Offset };
+    std::function<double(double)>              nested   = compose2(
+        Offset, compose2(half, compose2(square, compose2(clamp, compose2(Offset, Scale)))));
+    auto composed = Pipe(kFn<&Scale>, kFn<&Offset>, clamp, square, half, kFn<&Offset>);
+    static_assert(decltype(composed)::kStageCount == 6);
+
+    for (auto & o : out) {
+        o.resize(n);
+    }
+    double t_pipeline = report.Time("chain/pipeline", [&] {
+        for (size_t i = 0; i < n; ++i) {
+            double x = input[i];
+            for (const auto & f : pipeline) {
+                x = f(x);
+            }
+            out[0][i] = x;
+        }
+    });
+    double t_nested   = report.Time("chain/nested_compose", [&] {
+        for (size_t i = 0; i < n; ++i) {
+            out[1][i] = nested(input[i]);
+        }
+    });
+    double t_composed = report.Time("chain/compose", [&] {
+        for (size_t i = 0; i < n; ++i) {
+            out[2][i] = composed(input[i]);
+        }
+    });
+
+    bool same = out[0] == out[1] && out[1] == out[2];
+    auto ns   = [&](double seconds) {
+        return seconds / static_cast<double>(n) * 1e9;
+    };
+    fmt::print("[2] 6 阶段变换链（{} 个元素，ns/元素）\n", n);
+    fmt::print("{:>10} {:>15} {:>13} {:>13}  结果一致\n", "Pipeline", "nested Compose",
+               "Compose(...)", "vs Pipeline");
+    fmt::print("{:>10.2f} {:>15.2f} {:>13.2f} {:>12.2f}x  {}\n\n", ns(t_pipeline), ns(t_nested),
+               ns(t_composed), t_pipeline / t_composed, same ? "yes" : "NO");
+}
+
+// 越界 opcode 抛异常；Compose 可以在编译期求值
+void CheckSemantics() {
+    constexpr auto inc    = [](int x) { return x + 1; };
+    constexpr auto twice  = [](int x) { return x * 2; };
+    constexpr auto nested = Compose(Compose(inc, twice), Compose(inc));
+    static_assert(decltype(nested)::kStageCount == 3, "nested Compose is flattened");
+    static_assert(nested(5) == 13, "inc(twice(inc(5)))");
+    static_assert(Pipe(inc, twice)(5) == 12, "twice(inc(5))");
+
+    bool threw = false;
+    try {
+        kDispatch(kOpCount, Regs{ 1, 1 });
+    } catch (const std::out_of_range &) {
+        threw = true;
+    }
+    fmt::print("[3] 越界 opcode {} -> {}\n\n", kOpCount, threw ? "抛出 std::out_of_range" : "未检测到");
+}
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+int main(int argc, char * argv[]) {
+    microbench::Report report(argc, argv);
+    size_t             n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    n                    = std::max<size_t>(1000, n);
+
+    spdlog::info("编译期函数组合 / 静态分发表基准测试");
+    spdlog::info("=====================================");
+    cpp_qa_lab::basic::BenchmarkInterpreter(report, n);
+    cpp_qa_lab::basic::BenchmarkChain(report, n);
+    cpp_qa_lab::basic::CheckSemantics();
+
+    spdlog::info("关键学习点：");
+    spdlog::info("1. std::function / 函数指针 / 成员函数指针都是间接调用，编译器看不到调用目标");
+    spdlog::info("2. kFn<&F> 把调用目标变成类型的一部分，Compose 展平后整条链可以内联");
+    spdlog::info("3. DispatchTable 用 switch 生成跳转表：每条指令仍有一次间接跳转，但省掉了调用");
+    spdlog::info("4. 融合指令（Compose 出来的超级指令）减少了分发次数，是解释器最常用的优化");
+    spdlog::info("5. 操作码随机时分支预测失败占主导，几种写法的差距会被压缩");
+    return report.Finish();
+}
@@ -3,6 +3,8 @@
 // 展示：函数指针、std::function、lambda、成员函数指针、std::invoke、递归等
 
 #include "common.h"
+#include "function_compose.h"
+#include "memo_combinator.h"
 
 // ============================================================================
 // 1. 函数指针 - 传统 C 风格函数指针
@@ -70,12 +72,9 @@ class Calculator {
     Operation op_;
 };
 
-// 函数组合模板
-template <typename F, typename G> auto Compose(F f, G g) {
-    return [f = std::move(f), g = std::move(g)](auto &&... args) {
-        return f(g(std::forward<decltype(args)>(args)...));
-    };
-}
+// 函数组合：变参 Compose 定义在 function_compose.h，Compose(f, g)(x) == f(g(x))
+using cpp_qa_lab::basic::Compose;
+using cpp_qa_lab::basic::kFn;
 
 void DemoStdFunction() {
     spdlog::info("\n=== 2. std::function 和 Lambda 示例 ===");
@@ -104,6 +103,12 @@ void DemoStdFunction() {
     auto composed = Compose(add_ten, double_it);
     spdlog::info("函数组合: (5 * 2) + 10 = {}", composed(5.0));
 
+    // 变参组合：嵌套的 Compose 在编译期展平，kFn<&F> 让函数指针也能内联；
+    // 只有最内层阶段接收原始参数，所以它可以是二元函数
+    auto chain = Compose(composed, kFn<&Subtract>);
+    spdlog::info("三段组合: ((7 - 1) * 2) + 10 = {}（共 {} 个阶段）", chain(7.0, 1.0),
+                 decltype(chain)::kStageCount);
+
     // Lambda 捕获示例
     double factor     = 2.5;
     auto   multiplier = [factor](double x) {
@@ -288,18 +293,9 @@ auto MakeRecursiveFibonacci() {
     return fib;
 }
 
-// Y 组合子实现通用递归
-template <typename F> struct YCombinator {
-    F func;
-
-    template <typename... Args> auto operator()(Args &&... args) const {
-        return func(*this, std::forward<Args>(args)...);
-    }
-};
-
-template <typename F> YCombinator<std::decay_t<F>> MakeYCombinator(F && func) {
-    return { std::forward<F>(func) };
-}
+// Y 组合子实现通用递归（定义见 memo_combinator.h，那里还有记忆化和 trampoline 版本）
+using cpp_qa_lab::basic::MakeYCombinator;
+using cpp_qa_lab::basic::YCombinator;
 
 void DemoRecursion() {
     spdlog::info("\n=== 6. 递归示例 ===");
@@ -326,6 +322,14 @@ void DemoRecursion() {
         return self(n - 1) + self(n - 2);
     });
     spdlog::info("Y组合子斐波那契({}) = {}", n, fibonacci_y(n));
+
+    // 记忆化 Y 组合子：同样的写法，每个 n 只计算一次，fib(90) 也是瞬间完成
+    using cpp_qa_lab::basic::FlatMemo;
+    auto fibonacci_memo = cpp_qa_lab::basic::MakeMemoY<FlatMemo<uint64_t, int>>(
+        [](auto & self, int k) -> uint64_t { return k < 2 ? k : self(k - 1) + self(k - 2); });
+    uint64_t fib90 = fibonacci_memo(90);
+    spdlog::info("记忆化Y组合子斐波那契(90) = {}（缓存了 {} 个状态）", fib90,
+                 fibonacci_memo.cache().size());
 }
 
 // ============================================================================
@@ -0,0 +1,400 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 并发账本引擎 - 从 friend_example_demo.cpp 中的 BankAccount / TransferMoney 演化而来
+//
+// 原始版本的问题：
+// - TransferMoney 直接修改两个账户的 balance_，没有任何同步，多线程下会丢失更新
+// - AccountManager 用 std::vector<BankAccount *> 保存账户，RemoveAccount 线性查找
+//
+// 本文件的做法：
+// - 账户存放在预分配的槽位数组中，按 AccountId 直接寻址；名称索引按哈希分片
+// - 转账使用两个账户各自的锁，并始终按 AccountId 从小到大加锁，避免死锁
+// - 余额是 std::atomic<Money>（定点整数，见 money.h），读余额不加锁（无锁读路径）
+// - LedgerEngine 提供批量提交：生产者一次提交一批转账，由工作线程执行
+
+#ifndef CPP_QA_LAB_CSRC_BASIC_LEDGER_H_
+#define CPP_QA_LAB_CSRC_BASIC_LEDGER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "money.h"
+
+namespace cpp_qa_lab {
+namespace basic {
+
+using AccountId = uint32_t;
+
+enum class TransferStatus {
+    kOk,
+    kInvalidAmount,
+    kInsufficientFunds,
+    kUnknownAccount,
+    kSameAccount,
+    kOverflow,
+};
+
+inline const char * ToString(TransferStatus status) {
+    switch (status) {
+        case TransferStatus::kOk:
+            return "ok";
+        case TransferStatus::kInvalidAmount:
+            return "invalid amount";
+        case TransferStatus::kInsufficientFunds:
+            return "insufficient funds";
+        case TransferStatus::kUnknownAccount:
+            return "unknown account";
+        case TransferStatus::kSameAccount:
+            return "same account";
+        case TransferStatus::kOverflow:
+            return "balance overflow";
+    }
+    return "unknown";
+}
+
+struct TransferRequest {
+    AccountId from = 0;
+    AccountId to   = 0;
+    Money     amount;
+};
+
+// ============================================================================
+// 1. ConcurrentLedger - 分片存储 + 有序加锁 + 无锁读
+// ============================================================================
+
+class ConcurrentLedger {
+  public:
+    // capacity: 最大账户数（槽位一次性分配，之后地址不变，读路径无需加锁）
+    // num_shards: 名称索引的分片数
+    explicit ConcurrentLedger(size_t capacity, size_t num_shards = 64) :
+        capacity_(capacity),
+        slots_(new AccountSlot[capacity]),
+        shards_(std::max<size_t>(1, num_shards)) {}
+
+    ConcurrentLedger(const ConcurrentLedger &)             = delete;
+    ConcurrentLedger & operator=(const ConcurrentLedger &) = delete;
+
+    // 开户；名称重复或容量已满时抛出异常
+    AccountId OpenAccount(const std::string & account_id, Money initial_balance = Money()) {
+        return OpenAccount(account_id, initial_balance, [](AccountId) {});
+    }
+
+    // on_commit(id) 在账户对外可见之前调用（用于写日志，保证日志顺序先于该账户的任何转账）
+    template <typename OnCommit>
+    AccountId OpenAccount(const std::string & account_id, Money initial_balance,
+                          OnCommit && on_commit) {
+        Shard &                             shard = ShardFor(account_id);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        if (shard.index.count(account_id) != 0) {
+            throw std::invalid_argument("duplicate account id: " + account_id);
+        }
+        AccountId id = next_id_.fetch_add(1, std::memory_order_relaxed);
+        if (id >= capacity_) {
+            next_id_.fetch_sub(1, std::memory_order_relaxed);
+            throw std::length_error("ledger capacity exhausted");
+        }
+        AccountSlot & slot = slots_[id];
+        slot.account_id    = account_id;
+        slot.balance.store(initial_balance, std::memory_order_relaxed);
+        on_commit(id);
+        slot.open.store(true, std::memory_order_release);
+        shard.index.emplace(account_id, id);
+        return id;
+    }
+
+    /**
+     * 恢复用：在指定 AccountId 上重建账户（日志回放 / 加载快照）。
+     * 不同 id 可以由多个线程并发恢复。
+     */
+    void RestoreAccount(AccountId id, const std::string & account_id, Money balance) {
+        if (id >= capacity_) {
+            throw std::length_error("ledger capacity exhausted");
+        }
+        Shard &                             shard = ShardFor(account_id);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        AccountSlot &                       slot = slots_[id];
+        slot.account_id                          = account_id;
+        slot.balance.store(balance, std::memory_order_relaxed);
+        slot.open.store(true, std::memory_order_release);
+        shard.index[account_id] = id;
+
+        AccountId next = next_id_.load(std::memory_order_relaxed);
+        while (next <= id && !next_id_.compare_exchange_weak(next, id + 1)) {
+        }
+    }
+
+    // 按名称查找，O(1)（替代 AccountManager::RemoveAccount 中的线性查找）
+    std::optional<AccountId> Find(const std::string & account_id) const {
+        const Shard &                       shard = ShardFor(account_id);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto                                it = shard.index.find(account_id);
+        if (it == shard.index.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    // 无锁读：只做一次原子 load。注意读多个账户时不是一致快照
+    Money GetBalance(AccountId id) const {
+        return slots_[Checked(id)].balance.load(std::memory_order_acquire);
+    }
+
+    const std::string & GetAccountId(AccountId id) const { return slots_[Checked(id)].account_id; }
+
+    /**
+     * 转账：锁住两个账户，检查余额后修改。
+     *
+     * 死锁避免：两个线程同时执行 A->B 与 B->A 时，若各自先锁 from 就会互相等待。
+     * 这里总是先锁 AccountId 较小的账户，所有线程的加锁顺序一致，环路等待不可能出现。
+     */
+    TransferStatus Transfer(AccountId from, AccountId to, Money amount) {
+        return Transfer(from, to, amount, [] {});
+    }
+
+    // on_commit() 在两个账户的锁内、余额修改之后调用：同一账户上的操作
+    // 调用 on_commit 的顺序与实际生效顺序一致（日志据此保证按账户有序）
+    template <typename OnCommit>
+    TransferStatus Transfer(AccountId from, AccountId to, Money amount, OnCommit && on_commit) {
+        if (amount <= Money()) {
+            return TransferStatus::kInvalidAmount;
+        }
+        if (!IsOpen(from) || !IsOpen(to)) {
+            return TransferStatus::kUnknownAccount;
+        }
+        if (from == to) {
+            return TransferStatus::kSameAccount;
+        }
+
+        AccountSlot &               src    = slots_[from];
+        AccountSlot &               dst    = slots_[to];
+        AccountSlot &               first  = from < to ? src : dst;
+        AccountSlot &               second = from < to ? dst : src;
+        std::lock_guard<std::mutex> lock_first(first.mutex);
+        std::lock_guard<std::mutex> lock_second(second.mutex);
+
+        Money from_balance = src.balance.load(std::memory_order_relaxed);
+        if (from_balance < amount) {
+            return TransferStatus::kInsufficientFunds;
+        }
+        // 先算出两个新余额，溢出时两边都不修改
+        Money to_balance;
+        if (!Money::CheckedAdd(dst.balance.load(std::memory_order_relaxed), amount, &to_balance)) {
+            return TransferStatus::kOverflow;
+        }
+        // 写者持锁，读者只看到 release 之后的值
+        src.balance.store(from_balance - amount, std::memory_order_release);
+        dst.balance.store(to_balance, std::memory_order_release);
+        on_commit();
+        return TransferStatus::kOk;
+    }
+
+    TransferStatus Transfer(const TransferRequest & request) {
+        return Transfer(request.from, request.to, request.amount);
+    }
+
+    // 单账户存款（与 BankAccount::Deposit 对应）
+    bool Deposit(AccountId id, Money amount) {
+        return Deposit(id, amount, [] {});
+    }
+
+    template <typename OnCommit> bool Deposit(AccountId id, Money amount, OnCommit && on_commit) {
+        if (amount <= Money() || !IsOpen(id)) {
+            return false;
+        }
+        AccountSlot &               slot = slots_[id];
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        Money                       balance;
+        if (!Money::CheckedAdd(slot.balance.load(std::memory_order_relaxed), amount, &balance)) {
+            return false;
+        }
+        slot.balance.store(balance, std::memory_order_release);
+        on_commit();
+        return true;
+    }
+
+    // 管理员直接设置余额（与 AccountManager::SetBalance 对应）
+    void SetBalance(AccountId id, Money new_balance) {
+        SetBalance(id, new_balance, [] {});
+    }
+
+    template <typename OnCommit>
+    void SetBalance(AccountId id, Money new_balance, OnCommit && on_commit) {
+        AccountSlot &               slot = slots_[Checked(id)];
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.balance.store(new_balance, std::memory_order_release);
+        on_commit();
+    }
+
+    // 恢复用：不做余额检查地加上 delta（回放已经提交过的转账）
+    void ApplyDelta(AccountId id, Money delta) {
+        AccountSlot &               slot = slots_[Checked(id)];
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.balance.store(slot.balance.load(std::memory_order_relaxed) + delta,
+                           std::memory_order_release);
+    }
+
+    // 所有余额之和（无锁扫描；并发转账期间只是近似值，静止时精确）
+    // 在 128 位中累加，不会溢出；定点整数求和与顺序无关，审计时可直接用 == 比较
+    Money128 TotalBalance() const {
+        Money128  total;
+        AccountId n = size();
+        for (AccountId id = 0; id < n; ++id) {
+            total += Money128(slots_[id].balance.load(std::memory_order_acquire));
+        }
+        return total;
+    }
+
+    AccountId size() const {
+        return std::min<AccountId>(next_id_.load(std::memory_order_acquire),
+                                   static_cast<AccountId>(capacity_));
+    }
+
+    size_t capacity() const { return capacity_; }
+
+  private:
+    // 每个账户独占一条缓存行，避免相邻账户的锁/余额之间的伪共享
+    struct alignas(64) AccountSlot {
+        std::mutex         mutex;
+        std::atomic<Money> balance{ Money() };
+        std::atomic<bool>  open{ false };
+        std::string        account_id;
+    };
+    static_assert(std::atomic<Money>::is_always_lock_free, "Money balance must be lock-free");
+
+    struct Shard {
+        mutable std::shared_mutex                  mutex;
+        std::unordered_map<std::string, AccountId> index;
+    };
+
+    Shard & ShardFor(const std::string & account_id) {
+        return shards_[std::hash<std::string>{}(account_id) % shards_.size()];
+    }
+
+    const Shard & ShardFor(const std::string & account_id) const {
+        return shards_[std::hash<std::string>{}(account_id) % shards_.size()];
+    }
+
+    bool IsOpen(AccountId id) const {
+        return id < capacity_ && slots_[id].open.load(std::memory_order_acquire);
+    }
+
+    AccountId Checked(AccountId id) const {
+        if (!IsOpen(id)) {
+            throw std::out_of_range("unknown account: " + std::to_string(id));
+        }
+        return id;
+    }
+
+    size_t                         capacity_;
+    std::unique_ptr<AccountSlot[]> slots_;
+    std::atomic<AccountId>         next_id_{ 0 };
+    std::vector<Shard>             shards_;
+};
+
+// ============================================================================
+// 2. LedgerEngine - 批量提交
+// ============================================================================
+//
+// 生产者每次提交一批转账（一次入队、一次唤醒、一个 future），
+// 而不是每笔转账都做一次队列同步；工作线程整批执行。
+
+struct BatchResult {
+    size_t                      applied  = 0;
+    size_t                      rejected = 0;
+    std::vector<TransferStatus> statuses;
+};
+
+class LedgerEngine {
+  public:
+    LedgerEngine(ConcurrentLedger & ledger, size_t num_workers) : ledger_(ledger) {
+        for (size_t i = 0; i < std::max<size_t>(1, num_workers); ++i) {
+            workers_.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ~LedgerEngine() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto & worker : workers_) {
+            worker.join();
+        }
+    }
+
+    LedgerEngine(const LedgerEngine &)             = delete;
+    LedgerEngine & operator=(const LedgerEngine &) = delete;
+
+    std::future<BatchResult> Submit(std::vector<TransferRequest> batch) {
+        std::packaged_task<BatchResult()> task(
+            [this, batch = std::move(batch)]() { return Execute(batch); });
+        std::future<BatchResult> result = task.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+        return result;
+    }
+
+    // 在调用线程中直接执行一批（不经过队列）
+    BatchResult Execute(const std::vector<TransferRequest> & batch) {
+        BatchResult result;
+        result.statuses.reserve(batch.size());
+        for (const auto & request : batch) {
+            TransferStatus status = ledger_.Transfer(request);
+            result.statuses.push_back(status);
+            if (status == TransferStatus::kOk) {
+                ++result.applied;
+            } else {
+                ++result.rejected;
+            }
+        }
+        return result;
+    }
+
+  private:
+    void WorkerLoop() {
+        while (true) {
+            std::packaged_task<BatchResult()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+                if (stop_ && queue_.empty()) {
+                    return;
+                }
+                task = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            task();
+        }
+    }
+
+    ConcurrentLedger &                            ledger_;
+    std::vector<std::thread>                      workers_;
+    std::deque<std::packaged_task<BatchResult()>> queue_;
+    std::mutex                                    mutex_;
+    std::condition_variable                       cv_;
+    bool                                          stop_ = false;
+};
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+#endif // CPP_QA_LAB_CSRC_BASIC_LEDGER_H_
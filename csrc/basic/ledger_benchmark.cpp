@@ -0,0 +1,206 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 账本引擎吞吐量(TPS)基准测试
+//
+// 用法: ledger_benchmark [账户数] [总转账笔数] [zipf 参数 s] [最大线程数]
+//
+// 账户按 Zipf 分布被选中（少数热点账户承担大部分转账），对比三种实现：
+// - global-mutex : 整个账本一把锁（friend_example_demo 中的写法加一把全局锁）
+// - ordered-lock : ConcurrentLedger，每账户一把锁，按 AccountId 顺序加锁
+// - engine-batch : LedgerEngine，批量提交给工作线程执行
+
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+#include "ledger.h"
+#include "microbench.h"
+
+namespace cpp_qa_lab {
+namespace basic {
+
+// Zipf 分布：P(rank = k) ∝ 1 / k^s，预计算 CDF 后二分查找
+class ZipfGenerator {
+  public:
+    ZipfGenerator(size_t n, double s) : cdf_(n) {
+        double sum = 0.0;
+        for (size_t k = 0; k < n; ++k) {
+            sum += 1.0 / std::pow(static_cast<double>(k + 1), s);
+            cdf_[k] = sum;
+        }
+        for (auto & c : cdf_) {
+            c /= sum;
+        }
+    }
+
+    template <typename Rng> AccountId operator()(Rng & rng) const {
+        double u  = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        auto   it = std::lower_bound(cdf_.begin(), cdf_.end(), u);
+        return static_cast<AccountId>(std::min<size_t>(it - cdf_.begin(), cdf_.size() - 1));
+    }
+
+  private:
+    std::vector<double> cdf_;
+};
+
+// 基线：一把全局锁保护所有余额
+class GlobalMutexLedger {
+  public:
+    GlobalMutexLedger(size_t n, Money initial) : balances_(n, initial) {}
+
+    TransferStatus Transfer(const TransferRequest & r) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (r.from == r.to) {
+            return TransferStatus::kSameAccount;
+        }
+        if (balances_[r.from] < r.amount) {
+            return TransferStatus::kInsufficientFunds;
+        }
+        balances_[r.from] -= r.amount;
+        balances_[r.to] += r.amount;
+        return TransferStatus::kOk;
+    }
+
+    Money128 TotalBalance() const { return SumMoney(balances_); }
+
+  private:
+    std::mutex         mutex_;
+    std::vector<Money> balances_;
+};
+
+// 预先生成每个线程的转账序列，生成开销不计入计时
+std::vector<std::vector<TransferRequest>> MakeWorkload(size_t accounts, size_t total,
+                                                       size_t threads, double zipf_s) {
+    ZipfGenerator                             zipf(accounts, zipf_s);
+    std::vector<std::vector<TransferRequest>> per_thread(threads);
+    for (size_t t = 0; t < threads; ++t) {
+        std::mt19937_64                    rng(1000 + t);
+        std::uniform_int_distribution<int> amount(1, 10);
+        size_t                             count = total / threads + (t < total % threads ? 1 : 0);
+        per_thread[t].reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            AccountId from = zipf(rng);
+            AccountId to   = zipf(rng);
+            if (from == to) {
+                to = (to + 1) % accounts;
+            }
+            per_thread[t].push_back({ from, to, Money::FromUnits(amount(rng)) });
+        }
+    }
+    return per_thread;
+}
+
+// 用 threads 个线程执行 workload，返回耗时（秒）
+template <typename Body>
+double RunThreads(const std::vector<std::vector<TransferRequest>> & workload, Body body) {
+    return microbench::Seconds([&] {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < workload.size(); ++t) {
+            threads.emplace_back([&, t] { body(workload[t]); });
+        }
+        for (auto & th : threads) {
+            th.join();
+        }
+    });
+}
+
+void RunBenchmark(microbench::Report & report, size_t accounts, size_t total, double zipf_s,
+                  size_t max_threads) {
+    constexpr size_t kBatchSize      = 256;
+    const Money      kInitialBalance = Money::FromUnits(1000);
+    const Money128   expected_total  = Money128(kInitialBalance) * static_cast<int64_t>(accounts);
+
+    fmt::print("账户数: {}, 转账笔数: {}, zipf s = {}, 批大小: {}\n\n", accounts, total, zipf_s,
+               kBatchSize);
+    fmt::print("{:>8} {:>16} {:>16} {:>16}   余额守恒\n", "threads", "global-mutex", "ordered-lock",
+               "engine-batch");
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        auto workload  = MakeWorkload(accounts, total, threads, zipf_s);
+        bool conserved = true;
+        // 转账会改变账本状态，每种实现只计时一次；余额不守恒的结果记为错误
+        auto record = [&](const char * variant, double seconds, bool ok) {
+            report.Add(fmt::format("transfer/{}/{}", variant, threads), { seconds }, total)
+                .correct = ok;
+            conserved = conserved && ok;
+        };
+
+        // 1. 全局锁
+        GlobalMutexLedger global(accounts, kInitialBalance);
+        double            t_global = RunThreads(workload, [&](const auto & requests) {
+            for (const auto & r : requests) {
+                global.Transfer(r);
+            }
+        });
+        record("global_mutex", t_global, global.TotalBalance() == expected_total);
+
+        // 2. 每账户锁 + 有序加锁
+        ConcurrentLedger ledger(accounts);
+        for (size_t i = 0; i < accounts; ++i) {
+            ledger.OpenAccount(fmt::format("ACC{:07}", i), kInitialBalance);
+        }
+        double t_ordered = RunThreads(workload, [&](const auto & requests) {
+            for (const auto & r : requests) {
+                ledger.Transfer(r);
+            }
+        });
+        record("ordered_lock", t_ordered, ledger.TotalBalance() == expected_total);
+
+        // 3. 批量提交：threads 个工作线程，生产者按批提交
+        ConcurrentLedger batch_ledger(accounts);
+        for (size_t i = 0; i < accounts; ++i) {
+            batch_ledger.OpenAccount(fmt::format("ACC{:07}", i), kInitialBalance);
+        }
+        double t_batch = 0.0;
+        {
+            LedgerEngine                          engine(batch_ledger, threads);
+            std::vector<std::future<BatchResult>> pending;
+            t_batch = microbench::Seconds([&] {
+                for (const auto & requests : workload) {
+                    for (size_t i = 0; i < requests.size(); i += kBatchSize) {
+                        auto first = requests.begin() + i;
+                        auto last  = requests.begin() + std::min(i + kBatchSize, requests.size());
+                        pending.push_back(engine.Submit(std::vector<TransferRequest>(first, last)));
+                    }
+                }
+                for (auto & f : pending) {
+                    f.get();
+                }
+            });
+        }
+        record("engine_batch", t_batch, batch_ledger.TotalBalance() == expected_total);
+
+        auto tps = [&](double seconds) { return static_cast<double>(total) / seconds; };
+        fmt::print("{:>8} {:>16.0f} {:>16.0f} {:>16.0f}   {}\n", threads, tps(t_global),
+                   tps(t_ordered), tps(t_batch), conserved ? "yes" : "NO");
+    }
+}
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+int main(int argc, char * argv[]) {
+    microbench::Report report(argc, argv);
+    size_t             accounts    = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    size_t             total       = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+    double             zipf_s      = argc > 3 ? std::strtod(argv[3], nullptr) : 0.99;
+    size_t             max_threads = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 64;
+
+    spdlog::info("并发账本 TPS 基准测试");
+    spdlog::info("=====================================");
+    cpp_qa_lab::basic::RunBenchmark(report, std::max<size_t>(2, accounts), total, zipf_s,
+                                    std::max<size_t>(1, max_threads));
+
+    spdlog::info("关键学习点：");
+    spdlog::info("1. 全局锁把所有转账串行化，线程越多竞争越激烈");
+    spdlog::info("2. 每账户一把锁只让访问同一账户的转账互斥；按 ID 顺序加锁避免死锁");
+    spdlog::info("3. Zipf 倾斜越大，热点账户的锁竞争越接近全局锁");
+    spdlog::info("4. 批量提交把每笔转账的队列同步开销摊到整批上");
+    return report.Finish();
+}
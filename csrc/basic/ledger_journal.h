@@ -0,0 +1,695 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 账本的预写日志(WAL)与快照
+//
+// ConcurrentLedger 的余额只在内存中，进程重启即丢失。JournaledLedger 在其外面加一层持久化：
+// - 每个修改操作先在账户锁内追加一条二进制日志记录，再等待该记录落盘后才返回（持久化语义）
+// - 组提交(group commit)：多个线程/一整批转账的记录合并成一次 write + fdatasync
+// - 快照(checkpoint)：把所有余额写成紧凑的快照文件，之前的日志段即可删除
+// - 启动恢复：加载快照，再按账户分区并行回放快照之后的日志
+//
+// 目录布局:
+//   <dir>/snapshot.bin                 最近一次快照（先写 snapshot-<LSN>.tmp 再原子 rename）
+//   <dir>/journal-<首条LSN>.wal        日志段，每次启动/快照后开启新段
+//
+// 日志记录格式（小端，本机字节序）:
+//   uint32 payload_len | uint32 crc32(lsn..payload) | uint64 lsn | uint8 type | payload
+// 金额以 Money 的原始 int64 值（1/10000 元）写入，回放是精确的整数运算。
+// 末尾写了一半的记录（CRC 不符或长度不足）在恢复时被截断丢弃。
+
+#ifndef CPP_QA_LAB_CSRC_BASIC_LEDGER_JOURNAL_H_
+#define CPP_QA_LAB_CSRC_BASIC_LEDGER_JOURNAL_H_
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ledger.h"
+
+namespace cpp_qa_lab {
+namespace basic {
+
+enum class JournalRecordType : uint8_t {
+    kOpenAccount = 1, // id, initial_balance, name
+    kTransfer    = 2, // from, to, amount
+    kSetBalance  = 3, // id, balance
+    kDeposit     = 4, // id, amount
+};
+
+namespace journal_detail {
+
+inline uint32_t Crc32(const char * data, size_t size, uint32_t crc = 0) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+template <typename T> void Put(std::vector<char> & out, const T & value) {
+    const char * p = reinterpret_cast<const char *>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+// 从 [*pos, end) 读取一个 T；越界返回 false
+template <typename T> bool Get(const char *& pos, const char * end, T & value) {
+    if (static_cast<size_t>(end - pos) < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+[[noreturn]] inline void ThrowErrno(const std::string & what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+inline void WriteAll(int fd, const char * data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ThrowErrno("journal write failed");
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+inline void SyncDirectory(const std::string & dir) {
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+// 解码后的日志记录（回放用）
+struct Record {
+    uint64_t          lsn  = 0;
+    JournalRecordType type = JournalRecordType::kTransfer;
+    AccountId         a    = 0; // from / id
+    AccountId         b    = 0; // to
+    Money             value; // amount / balance
+    std::string       name;
+};
+
+constexpr size_t kRecordHeaderSize = sizeof(uint32_t) * 2;
+
+} // namespace journal_detail
+
+// ============================================================================
+// 1. LedgerJournal - 追加写日志 + 组提交
+// ============================================================================
+
+class LedgerJournal {
+  public:
+    // 在 dir 中开启一个以 first_lsn 命名的新日志段
+    LedgerJournal(std::string dir, uint64_t first_lsn, bool sync) :
+        dir_(std::move(dir)),
+        sync_(sync),
+        next_lsn_(first_lsn),
+        durable_lsn_(first_lsn - 1) {
+        OpenSegment(first_lsn);
+    }
+
+    ~LedgerJournal() {
+        try {
+            Rotate(/*open_next=*/false);
+        } catch (...) {
+            // 析构中不抛异常；未落盘的记录本来就没有向调用者确认过
+        }
+    }
+
+    LedgerJournal(const LedgerJournal &)             = delete;
+    LedgerJournal & operator=(const LedgerJournal &) = delete;
+
+    /**
+     * 编码一条记录追加到内存缓冲区，返回其 LSN（日志序列号）。
+     * 只持有日志互斥量很短的时间，不做 I/O。
+     */
+    uint64_t Append(JournalRecordType type, AccountId a, AccountId b, Money value,
+                    const std::string & name = std::string()) {
+        std::vector<char> payload;
+        journal_detail::Put(payload, a);
+        if (type == JournalRecordType::kTransfer) {
+            journal_detail::Put(payload, b);
+        }
+        journal_detail::Put(payload, value);
+        if (type == JournalRecordType::kOpenAccount) {
+            journal_detail::Put(payload, static_cast<uint32_t>(name.size()));
+            payload.insert(payload.end(), name.begin(), name.end());
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t                    lsn = next_lsn_++;
+
+        // body = lsn | type | payload，CRC 覆盖整个 body
+        std::vector<char> body;
+        body.reserve(sizeof(lsn) + 1 + payload.size());
+        journal_detail::Put(body, lsn);
+        journal_detail::Put(body, static_cast<uint8_t>(type));
+        body.insert(body.end(), payload.begin(), payload.end());
+
+        journal_detail::Put(buffer_, static_cast<uint32_t>(payload.size()));
+        journal_detail::Put(buffer_, journal_detail::Crc32(body.data(), body.size()));
+        buffer_.insert(buffer_.end(), body.begin(), body.end());
+        return lsn;
+    }
+
+    /**
+     * 组提交：等待 lsn 之前（含）的记录全部落盘。
+     *
+     * 第一个发现需要刷盘的线程成为 leader，取走当前缓冲区中的所有记录，在锁外
+     * write + fdatasync；期间其他线程追加的记录留给下一轮，等待者被一次唤醒。
+     * 并发越高，每次 fdatasync 覆盖的记录越多。
+     */
+    void WaitDurable(uint64_t lsn) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (durable_lsn_ < lsn) {
+            if (flushing_) {
+                cv_.wait(lock);
+                continue;
+            }
+            flushing_ = true;
+            std::vector<char> batch;
+            batch.swap(buffer_);
+            uint64_t target = next_lsn_ - 1;
+            int      fd     = fd_;
+            lock.unlock();
+
+            std::exception_ptr error;
+            try {
+                FlushToDisk(fd, batch);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            lock.lock();
+            flushing_ = false;
+            if (!error) {
+                durable_lsn_ = target;
+            }
+            cv_.notify_all();
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    /**
+     * 把缓冲区全部落盘并关闭当前段；open_next 为 true 时开启下一段。
+     * 返回已落盘的最后一个 LSN。调用者需保证此时没有并发 Append（快照时成立）。
+     */
+    uint64_t Rotate(bool open_next = true) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !flushing_; });
+        if (fd_ < 0) {
+            return durable_lsn_;
+        }
+        FlushToDisk(fd_, buffer_);
+        buffer_.clear();
+        durable_lsn_ = next_lsn_ - 1;
+        ::close(fd_);
+        fd_ = -1;
+        if (open_next) {
+            OpenSegment(next_lsn_);
+        }
+        cv_.notify_all();
+        return durable_lsn_;
+    }
+
+    uint64_t next_lsn() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return next_lsn_;
+    }
+
+    uint64_t syncs() const { return syncs_.load(std::memory_order_relaxed); }
+
+    const std::string & current_segment() const { return segment_path_; }
+
+  private:
+    void OpenSegment(uint64_t first_lsn) {
+        segment_path_ = SegmentPath(dir_, first_lsn);
+        fd_           = ::open(segment_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd_ < 0) {
+            journal_detail::ThrowErrno("cannot open journal segment " + segment_path_);
+        }
+        journal_detail::SyncDirectory(dir_);
+    }
+
+    void FlushToDisk(int fd, const std::vector<char> & batch) {
+        if (batch.empty()) {
+            return;
+        }
+        journal_detail::WriteAll(fd, batch.data(), batch.size());
+        if (sync_ && ::fdatasync(fd) != 0) {
+            journal_detail::ThrowErrno("fdatasync failed");
+        }
+        syncs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+  public:
+    static std::string SegmentPath(const std::string & dir, uint64_t first_lsn) {
+        char name[48];
+        std::snprintf(name, sizeof(name), "journal-%020llu.wal",
+                      static_cast<unsigned long long>(first_lsn));
+        return dir + "/" + name;
+    }
+
+  private:
+    std::string             dir_;
+    bool                    sync_;
+    int                     fd_ = -1;
+    std::string             segment_path_;
+    mutable std::mutex      mutex_;
+    std::condition_variable cv_;
+    std::vector<char>       buffer_;
+    uint64_t                next_lsn_;
+    uint64_t                durable_lsn_;
+    bool                    flushing_ = false;
+    std::atomic<uint64_t>   syncs_{ 0 };
+};
+
+// ============================================================================
+// 2. JournaledLedger - 持久化账本
+// ============================================================================
+
+struct JournalOptions {
+    bool   sync                = true; // false 时只 write 不 fdatasync（测试/基准用）
+    size_t checkpoint_interval = 0; // 每追加多少条记录自动快照，0 表示只手动快照
+    size_t replay_threads      = 0; // 0 表示 hardware_concurrency
+};
+
+struct RecoveryStats {
+    uint64_t snapshot_lsn     = 0;
+    size_t   snapshot_accounts = 0;
+    size_t   replayed_records = 0;
+    size_t   segments         = 0;
+    bool     truncated_tail   = false; // 是否截断了写了一半的末尾记录
+};
+
+class JournaledLedger {
+  public:
+    JournaledLedger(std::string dir, size_t capacity, JournalOptions options = {}) :
+        dir_(std::move(dir)),
+        options_(options),
+        ledger_(capacity) {
+        std::filesystem::create_directories(dir_);
+        uint64_t next_lsn = Recover();
+        journal_          = std::make_unique<LedgerJournal>(dir_, next_lsn, options_.sync);
+    }
+
+    AccountId OpenAccount(const std::string & account_id, Money initial_balance = Money()) {
+        uint64_t  lsn = 0;
+        AccountId id  = 0;
+        {
+            std::shared_lock<std::shared_mutex> guard(checkpoint_mutex_);
+            id = ledger_.OpenAccount(account_id, initial_balance, [&](AccountId new_id) {
+                lsn = journal_->Append(JournalRecordType::kOpenAccount, new_id, 0,
+                                       initial_balance, account_id);
+            });
+        }
+        Commit(lsn);
+        return id;
+    }
+
+    // 持久化转账：返回时记录已落盘（kOk 时）
+    TransferStatus Transfer(AccountId from, AccountId to, Money amount) {
+        uint64_t       lsn = 0;
+        TransferStatus status;
+        {
+            std::shared_lock<std::shared_mutex> guard(checkpoint_mutex_);
+            status = ledger_.Transfer(from, to, amount, [&] {
+                lsn = journal_->Append(JournalRecordType::kTransfer, from, to, amount);
+            });
+        }
+        if (status == TransferStatus::kOk) {
+            Commit(lsn);
+        }
+        return status;
+    }
+
+    // 批量转账：整批只等待一次落盘（一批一次 fdatasync）
+    BatchResult SubmitBatch(const std::vector<TransferRequest> & batch) {
+        BatchResult result;
+        result.statuses.reserve(batch.size());
+        uint64_t last_lsn = 0;
+        {
+            std::shared_lock<std::shared_mutex> guard(checkpoint_mutex_);
+            for (const auto & r : batch) {
+                TransferStatus status = ledger_.Transfer(r.from, r.to, r.amount, [&] {
+                    last_lsn = journal_->Append(JournalRecordType::kTransfer, r.from, r.to,
+                                                r.amount);
+                });
+                result.statuses.push_back(status);
+                if (status == TransferStatus::kOk) {
+                    ++result.applied;
+                } else {
+                    ++result.rejected;
+                }
+            }
+        }
+        if (result.applied > 0) {
+            Commit(last_lsn, result.applied);
+        }
+        return result;
+    }
+
+    bool Deposit(AccountId id, Money amount) {
+        uint64_t lsn = 0;
+        bool     ok  = false;
+        {
+            std::shared_lock<std::shared_mutex> guard(checkpoint_mutex_);
+            ok = ledger_.Deposit(id, amount, [&] {
+                lsn = journal_->Append(JournalRecordType::kDeposit, id, 0, amount);
+            });
+        }
+        if (ok) {
+            Commit(lsn);
+        }
+        return ok;
+    }
+
+    void SetBalance(AccountId id, Money new_balance) {
+        uint64_t lsn = 0;
+        {
+            std::shared_lock<std::shared_mutex> guard(checkpoint_mutex_);
+            ledger_.SetBalance(id, new_balance, [&] {
+                lsn = journal_->Append(JournalRecordType::kSetBalance, id, 0, new_balance);
+            });
+        }
+        Commit(lsn);
+    }
+
+    /**
+     * 快照：短暂阻塞所有写操作，取得一致的余额切面和对应 LSN，随后在锁外写文件。
+     * 快照落盘后删除它已覆盖的旧日志段。
+     *
+     * 整个过程由 checkpoint_writer_mutex_ 串行化：两次快照交错时，较旧的快照可能在
+     * 较新的之后 rename，而较新快照的清理已经删掉了旧快照需要的日志段。
+     */
+    void Checkpoint() {
+        std::lock_guard<std::mutex>         writer(checkpoint_writer_mutex_);
+        std::vector<journal_detail::Record> image;
+        uint64_t                            snapshot_lsn = 0;
+        {
+            std::unique_lock<std::shared_mutex> guard(checkpoint_mutex_);
+            snapshot_lsn = journal_->Rotate();
+            AccountId n  = ledger_.size();
+            image.reserve(n);
+            for (AccountId id = 0; id < n; ++id) {
+                journal_detail::Record r;
+                r.a     = id;
+                r.value = ledger_.GetBalance(id);
+                r.name  = ledger_.GetAccountId(id);
+                image.push_back(std::move(r));
+            }
+            records_since_checkpoint_.store(0, std::memory_order_relaxed);
+        }
+        WriteSnapshot(snapshot_lsn, image);
+
+        // 只删除首条 LSN 不超过已写入快照 LSN 的段：Rotate 后新段从 snapshot_lsn + 1 开始，
+        // 这些段中的记录都已包含在快照里
+        for (const auto & segment : ListSegments()) {
+            if (SegmentFirstLsn(segment) <= snapshot_lsn) {
+                std::filesystem::remove(segment);
+            }
+        }
+    }
+
+    const ConcurrentLedger & ledger() const { return ledger_; }
+
+    const RecoveryStats & recovery_stats() const { return recovery_; }
+
+    uint64_t syncs() const { return journal_->syncs(); }
+
+  private:
+    void Commit(uint64_t lsn, size_t records = 1) {
+        journal_->WaitDurable(lsn);
+        if (options_.checkpoint_interval == 0) {
+            return;
+        }
+        size_t pending = records_since_checkpoint_.fetch_add(records, std::memory_order_relaxed);
+        if (pending + records >= options_.checkpoint_interval &&
+            !checkpointing_.exchange(true, std::memory_order_acquire)) {
+            Checkpoint();
+            checkpointing_.store(false, std::memory_order_release);
+        }
+    }
+
+    std::string SnapshotPath() const { return dir_ + "/snapshot.bin"; }
+
+    // 从 journal-<首条LSN>.wal 解析首条 LSN
+    static uint64_t SegmentFirstLsn(const std::string & path) {
+        std::string name = std::filesystem::path(path).stem().string();
+        return std::strtoull(name.c_str() + std::strlen("journal-"), nullptr, 10);
+    }
+
+    std::vector<std::string> ListSegments() const {
+        std::vector<std::string> segments;
+        for (const auto & entry : std::filesystem::directory_iterator(dir_)) {
+            std::string name = entry.path().filename().string();
+            if (name.rfind("journal-", 0) == 0 && entry.path().extension() == ".wal") {
+                segments.push_back(entry.path().string());
+            }
+        }
+        std::sort(segments.begin(), segments.end()); // 文件名中的 LSN 定宽补零，字典序即 LSN 序
+        return segments;
+    }
+
+    // 快照格式: "LSNP" | uint64 lsn | uint64 count | count * (id, balance, name_len, name) | crc32
+    void WriteSnapshot(uint64_t lsn, const std::vector<journal_detail::Record> & image) {
+        std::vector<char> out;
+        out.insert(out.end(), { 'L', 'S', 'N', 'P' });
+        journal_detail::Put(out, lsn);
+        journal_detail::Put(out, static_cast<uint64_t>(image.size()));
+        for (const auto & r : image) {
+            journal_detail::Put(out, r.a);
+            journal_detail::Put(out, r.value);
+            journal_detail::Put(out, static_cast<uint32_t>(r.name.size()));
+            out.insert(out.end(), r.name.begin(), r.name.end());
+        }
+        journal_detail::Put(out, journal_detail::Crc32(out.data(), out.size()));
+
+        // 临时文件名带上快照 LSN，不同快照不会写同一个文件
+        char tmp_name[48];
+        std::snprintf(tmp_name, sizeof(tmp_name), "snapshot-%020llu.tmp",
+                      static_cast<unsigned long long>(lsn));
+        std::string tmp = dir_ + "/" + tmp_name;
+        int         fd  = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            journal_detail::ThrowErrno("cannot open " + tmp);
+        }
+        try {
+            journal_detail::WriteAll(fd, out.data(), out.size());
+            if (options_.sync && ::fsync(fd) != 0) {
+                journal_detail::ThrowErrno("fsync failed");
+            }
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd);
+        // rename 是原子的：崩溃后要么看到旧快照，要么看到完整的新快照
+        std::filesystem::rename(tmp, SnapshotPath());
+        journal_detail::SyncDirectory(dir_);
+    }
+
+    static std::vector<char> ReadFile(const std::string & path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in),
+                                 std::istreambuf_iterator<char>());
+    }
+
+    // 加载快照，返回快照 LSN（无快照返回 0）
+    uint64_t LoadSnapshot() {
+        if (!std::filesystem::exists(SnapshotPath())) {
+            return 0;
+        }
+        std::vector<char> data = ReadFile(SnapshotPath());
+        if (data.size() < 4 + 16 + 4 || std::memcmp(data.data(), "LSNP", 4) != 0) {
+            throw std::runtime_error("corrupt snapshot: " + SnapshotPath());
+        }
+        uint32_t stored_crc = 0;
+        std::memcpy(&stored_crc, data.data() + data.size() - 4, 4);
+        if (journal_detail::Crc32(data.data(), data.size() - 4) != stored_crc) {
+            throw std::runtime_error("snapshot checksum mismatch: " + SnapshotPath());
+        }
+
+        const char * pos = data.data() + 4;
+        const char * end = data.data() + data.size() - 4;
+        uint64_t     lsn = 0, count = 0;
+        journal_detail::Get(pos, end, lsn);
+        journal_detail::Get(pos, end, count);
+        for (uint64_t i = 0; i < count; ++i) {
+            AccountId id      = 0;
+            Money     balance;
+            uint32_t  len     = 0;
+            if (!journal_detail::Get(pos, end, id) || !journal_detail::Get(pos, end, balance) ||
+                !journal_detail::Get(pos, end, len) || static_cast<size_t>(end - pos) < len) {
+                throw std::runtime_error("truncated snapshot: " + SnapshotPath());
+            }
+            ledger_.RestoreAccount(id, std::string(pos, len), balance);
+            pos += len;
+        }
+        recovery_.snapshot_accounts = count;
+        return lsn;
+    }
+
+    // 解析一个日志段；遇到写了一半的记录时截断文件并停止
+    void ParseSegment(const std::string & path, uint64_t after_lsn,
+                      std::vector<journal_detail::Record> & records) {
+        std::vector<char> data = ReadFile(path);
+        const char *      pos  = data.data();
+        const char *      end  = data.data() + data.size();
+        while (pos < end) {
+            const size_t record_offset = static_cast<size_t>(pos - data.data());
+            uint32_t     len = 0, crc = 0;
+            bool ok = journal_detail::Get(pos, end, len) && journal_detail::Get(pos, end, crc);
+            size_t body_size = sizeof(uint64_t) + 1 + len;
+            ok = ok && static_cast<size_t>(end - pos) >= body_size &&
+                 journal_detail::Crc32(pos, body_size) == crc;
+            if (!ok) {
+                recovery_.truncated_tail = true;
+                std::filesystem::resize_file(path, record_offset);
+                return;
+            }
+
+            journal_detail::Record r;
+            uint8_t                type = 0;
+            journal_detail::Get(pos, end, r.lsn);
+            journal_detail::Get(pos, end, type);
+            const char * payload_end = pos + len;
+            r.type                   = static_cast<JournalRecordType>(type);
+            journal_detail::Get(pos, payload_end, r.a);
+            if (r.type == JournalRecordType::kTransfer) {
+                journal_detail::Get(pos, payload_end, r.b);
+            }
+            journal_detail::Get(pos, payload_end, r.value);
+            if (r.type == JournalRecordType::kOpenAccount) {
+                uint32_t name_len = 0;
+                journal_detail::Get(pos, payload_end, name_len);
+                r.name.assign(pos, std::min<size_t>(name_len, payload_end - pos));
+            }
+            pos = payload_end;
+            if (r.lsn > after_lsn) {
+                records.push_back(std::move(r));
+            }
+        }
+    }
+
+    /**
+     * 启动恢复：快照 + 并行回放。
+     *
+     * 回放按账户分区：线程 t 只负责 id % T == t 的账户，但按 LSN 顺序扫描全部记录。
+     * 同一账户的所有修改都由同一个线程按原始顺序执行，因此结果与串行回放完全一致；
+     * 转账拆成两半（-amount 给 from 的分区，+amount 给 to 的分区），回放时不再检查余额。
+     */
+    uint64_t Recover() {
+        uint64_t snapshot_lsn  = LoadSnapshot();
+        recovery_.snapshot_lsn = snapshot_lsn;
+
+        std::vector<journal_detail::Record> records;
+        std::vector<std::string>            segments = ListSegments();
+        recovery_.segments                           = segments.size();
+        for (const auto & segment : segments) {
+            ParseSegment(segment, snapshot_lsn, records);
+        }
+        recovery_.replayed_records = records.size();
+
+        size_t threads = options_.replay_threads != 0 ? options_.replay_threads
+                                                      : std::thread::hardware_concurrency();
+        threads        = std::max<size_t>(1, std::min(threads, records.size() / 1024 + 1));
+        auto replay    = [&](size_t part) {
+            auto mine = [&](AccountId id) { return id % threads == part; };
+            for (const auto & r : records) {
+                switch (r.type) {
+                    case JournalRecordType::kOpenAccount:
+                        if (mine(r.a)) {
+                            ledger_.RestoreAccount(r.a, r.name, r.value);
+                        }
+                        break;
+                    case JournalRecordType::kTransfer:
+                        if (mine(r.a)) {
+                            ledger_.ApplyDelta(r.a, -r.value);
+                        }
+                        if (mine(r.b)) {
+                            ledger_.ApplyDelta(r.b, r.value);
+                        }
+                        break;
+                    case JournalRecordType::kSetBalance:
+                        if (mine(r.a)) {
+                            ledger_.SetBalance(r.a, r.value);
+                        }
+                        break;
+                    case JournalRecordType::kDeposit:
+                        if (mine(r.a)) {
+                            ledger_.ApplyDelta(r.a, r.value);
+                        }
+                        break;
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (size_t part = 1; part < threads; ++part) {
+            workers.emplace_back(replay, part);
+        }
+        replay(0);
+        for (auto & w : workers) {
+            w.join();
+        }
+
+        uint64_t last_lsn = records.empty() ? snapshot_lsn : records.back().lsn;
+        return std::max(last_lsn, snapshot_lsn) + 1;
+    }
+
+    std::string                    dir_;
+    JournalOptions                 options_;
+    ConcurrentLedger               ledger_;
+    std::unique_ptr<LedgerJournal> journal_;
+    std::shared_mutex              checkpoint_mutex_;
+    std::mutex                     checkpoint_writer_mutex_; // 串行化整个 Checkpoint()
+    std::atomic<size_t>            records_since_checkpoint_{ 0 };
+    std::atomic<bool>              checkpointing_{ false };
+    RecoveryStats                  recovery_;
+};
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+#endif // CPP_QA_LAB_CSRC_BASIC_LEDGER_JOURNAL_H_
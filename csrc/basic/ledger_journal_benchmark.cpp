@@ -0,0 +1,219 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 持久化账本基准测试
+//
+// 用法: ledger_journal_benchmark [工作目录] [账户数] [最大恢复日志长度]
+//
+// 1. 持久化 TPS 随批大小的变化：每批一次 fdatasync，批越大摊销越多
+// 2. 多线程逐笔提交：组提交把并发线程的记录合并到一次 fdatasync
+// 3. 恢复时间随日志长度的变化，以及快照对恢复时间的影响
+
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+#include "ledger_journal.h"
+#include "microbench.h"
+
+namespace cpp_qa_lab {
+namespace basic {
+
+const Money kInitialBalance = Money::FromUnits(1000);
+
+std::vector<TransferRequest> MakeTransfers(size_t accounts, size_t count, uint64_t seed) {
+    std::mt19937_64                          rng(seed);
+    std::uniform_int_distribution<AccountId> pick(0, static_cast<AccountId>(accounts - 1));
+    std::uniform_int_distribution<int>       amount(1, 10);
+    std::vector<TransferRequest>             out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        AccountId from = pick(rng);
+        AccountId to   = pick(rng);
+        if (from == to) {
+            to = (to + 1) % accounts;
+        }
+        out.push_back({ from, to, Money::FromUnits(amount(rng)) });
+    }
+    return out;
+}
+
+void OpenAccounts(JournaledLedger & ledger, size_t accounts) {
+    for (size_t i = 0; i < accounts; ++i) {
+        ledger.OpenAccount(fmt::format("ACC{:07}", i), kInitialBalance);
+    }
+}
+
+// 下面三组实验都会改变磁盘上的日志，每个点只计时一次，作为一个样本记录
+
+// 1. 批大小 vs 持久化 TPS（单线程提交，sync = true）
+void BenchmarkBatchSize(microbench::Report & report, const std::string & root, size_t accounts) {
+    fmt::print("\n[1] 持久化 TPS vs 批大小（每批一次 fdatasync）\n");
+    fmt::print("{:>8} {:>12} {:>10} {:>12}\n", "batch", "transfers", "syncs", "TPS");
+    for (size_t batch : { 1, 4, 16, 64, 256, 1024 }) {
+        std::string dir = root + "/batch";
+        std::filesystem::remove_all(dir);
+        JournaledLedger ledger(dir, accounts);
+        OpenAccounts(ledger, accounts);
+
+        // 批越大单批越快，笔数随批大小增加，保证每个点运行时间相近
+        size_t   total     = std::min<size_t>(batch * 200, 200000);
+        auto     transfers = MakeTransfers(accounts, total, batch);
+        uint64_t syncs0    = ledger.syncs();
+        double   seconds   = microbench::Seconds([&] {
+            for (size_t i = 0; i < transfers.size(); i += batch) {
+                auto first = transfers.begin() + i;
+                auto last  = transfers.begin() + std::min(i + batch, transfers.size());
+                ledger.SubmitBatch(std::vector<TransferRequest>(first, last));
+            }
+        });
+        report.Add(fmt::format("submit_batch/{}", batch), { seconds }, total);
+        fmt::print("{:>8} {:>12} {:>10} {:>12.0f}\n", batch, total, ledger.syncs() - syncs0,
+                   static_cast<double>(total) / seconds);
+    }
+}
+
+// 2. 多线程逐笔提交：每个 Transfer 都等待落盘，组提交合并并发线程的 fdatasync
+void BenchmarkGroupCommit(microbench::Report & report, const std::string & root,
+                          size_t accounts) {
+    fmt::print("\n[2] 组提交：多线程逐笔持久化转账\n");
+    fmt::print("{:>8} {:>12} {:>10} {:>14} {:>12}\n", "threads", "transfers", "syncs",
+               "records/sync", "TPS");
+    constexpr size_t kPerThread = 500;
+    for (size_t threads : { 1, 2, 4, 8, 16 }) {
+        std::string dir = root + "/group";
+        std::filesystem::remove_all(dir);
+        JournaledLedger ledger(dir, accounts);
+        OpenAccounts(ledger, accounts);
+
+        uint64_t syncs0  = ledger.syncs();
+        double   seconds = microbench::Seconds([&] {
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t] {
+                    for (const auto & r : MakeTransfers(accounts, kPerThread, 100 + t)) {
+                        ledger.Transfer(r.from, r.to, r.amount);
+                    }
+                });
+            }
+            for (auto & w : workers) {
+                w.join();
+            }
+        });
+        size_t   total = threads * kPerThread;
+        uint64_t syncs = ledger.syncs() - syncs0;
+        report.Add(fmt::format("group_commit/{}", threads), { seconds }, total)
+            .counters["records_per_sync"] =
+            static_cast<double>(total) / static_cast<double>(std::max<uint64_t>(1, syncs));
+        fmt::print("{:>8} {:>12} {:>10} {:>14.1f} {:>12.0f}\n", threads, total, syncs,
+                   static_cast<double>(total) / static_cast<double>(std::max<uint64_t>(1, syncs)),
+                   static_cast<double>(total) / seconds);
+    }
+}
+
+// 3. 恢复时间 vs 日志长度（日志用 sync = false 快速写出，恢复本身与 sync 无关）
+void BenchmarkRecovery(microbench::Report & report, const std::string & root, size_t accounts,
+                       size_t max_records) {
+    fmt::print("\n[3] 恢复时间 vs 日志长度\n");
+    fmt::print("{:>10} {:>10} {:>10} {:>12} {:>10} {:>10}\n", "records", "snapshot", "replayed",
+               "recover(s)", "records/s", "余额一致");
+    JournalOptions fast;
+    fast.sync = false;
+
+    for (size_t records = 10000; records <= max_records; records *= 10) {
+        for (bool checkpoint : { false, true }) {
+            std::string dir = root + "/recovery";
+            std::filesystem::remove_all(dir);
+            std::vector<Money> expected(accounts);
+            {
+                JournaledLedger ledger(dir, accounts, fast);
+                OpenAccounts(ledger, accounts);
+                auto transfers = MakeTransfers(accounts, records, records);
+                for (size_t i = 0; i < transfers.size(); i += 1024) {
+                    auto first = transfers.begin() + i;
+                    auto last  = transfers.begin() + std::min<size_t>(i + 1024, transfers.size());
+                    ledger.SubmitBatch(std::vector<TransferRequest>(first, last));
+                    // 快照放在 90% 处：恢复时只需回放最后 10% 的日志
+                    if (checkpoint && i < records * 9 / 10 && i + 1024 >= records * 9 / 10) {
+                        ledger.Checkpoint();
+                    }
+                }
+                for (size_t id = 0; id < accounts; ++id) {
+                    expected[id] = ledger.ledger().GetBalance(static_cast<AccountId>(id));
+                }
+            }
+
+            // 构造函数里完成恢复（打开目录、读快照、并行回放）
+            std::unique_ptr<JournaledLedger> recovered;
+            double                           seconds = microbench::Seconds(
+                [&] { recovered = std::make_unique<JournaledLedger>(dir, accounts, fast); });
+            const RecoveryStats & stats = recovered->recovery_stats();
+            bool                  match = recovered->ledger().size() == accounts;
+            for (size_t id = 0; match && id < accounts; ++id) {
+                match = recovered->ledger().GetBalance(static_cast<AccountId>(id)) == expected[id];
+            }
+            report
+                .Add(fmt::format("recover/{}/{}", records, checkpoint ? "snapshot" : "full"),
+                     { seconds }, stats.replayed_records)
+                .correct = match;
+            fmt::print("{:>10} {:>10} {:>10} {:>12.4f} {:>10.0f} {:>10}\n", records,
+                       checkpoint ? "yes" : "no", stats.replayed_records, seconds,
+                       static_cast<double>(stats.replayed_records) / seconds,
+                       match ? "yes" : "NO");
+        }
+    }
+}
+
+// 4. 崩溃模拟：在日志末尾追加半条记录，恢复应截断它且不丢失已提交的数据
+void CheckTornTail(const std::string & root, size_t accounts) {
+    std::string dir = root + "/torn";
+    std::filesystem::remove_all(dir);
+    Money128 total;
+    {
+        JournaledLedger ledger(dir, accounts);
+        OpenAccounts(ledger, accounts);
+        ledger.SubmitBatch(MakeTransfers(accounts, 1000, 7));
+        total = ledger.ledger().TotalBalance();
+    }
+    for (const auto & entry : std::filesystem::directory_iterator(dir)) {
+        std::ofstream out(entry.path(), std::ios::binary | std::ios::app);
+        out.write("\x20\x00\x00\x00garbage", 11);
+    }
+    JournaledLedger recovered(dir, accounts);
+    fmt::print("\n[4] 末尾半条记录: 截断 = {}, 余额守恒 = {}\n",
+               recovered.recovery_stats().truncated_tail ? "yes" : "no",
+               recovered.ledger().TotalBalance() == total ? "yes" : "NO");
+}
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+int main(int argc, char * argv[]) {
+    microbench::Report report(argc, argv);
+    std::string        root        = argc > 1 ? argv[1] : "/tmp/ledger_journal_benchmark";
+    size_t             accounts    = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000;
+    size_t             max_records = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1000000;
+    accounts                       = std::max<size_t>(2, accounts);
+
+    spdlog::info("持久化账本（WAL + 快照）基准测试");
+    spdlog::info("=====================================");
+    fmt::print("工作目录: {}, 账户数: {}\n", root, accounts);
+
+    cpp_qa_lab::basic::BenchmarkBatchSize(report, root, accounts);
+    cpp_qa_lab::basic::BenchmarkGroupCommit(report, root, accounts);
+    cpp_qa_lab::basic::BenchmarkRecovery(report, root, accounts, max_records);
+    cpp_qa_lab::basic::CheckTornTail(root, accounts);
+    std::filesystem::remove_all(root);
+
+    spdlog::info("关键学习点：");
+    spdlog::info("1. 先写日志再确认：记录落盘之前不向调用者返回成功");
+    spdlog::info("2. fdatasync 是持久化的主要成本，批量/组提交把它摊到多条记录上");
+    spdlog::info("3. 快照限制了需要回放的日志长度，也让旧日志段可以删除");
+    spdlog::info("4. 按账户分区回放：同一账户的修改保持原顺序，不同分区可以并行");
+    return report.Finish();
+}
@@ -0,0 +1,471 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 记忆化 Y 组合子 - function_examples.cpp 中 YCombinator 的扩展
+//
+// YCombinator 让 lambda 可以递归调用自己，但：
+// - 没有记忆化：fib(45) 这样的重叠子问题是指数级的
+// - 每一层递归都占用原生调用栈：深度上百万时（如 fib(10^6)）会栈溢出
+// - 缓存如果由调用者手写，多个线程共享时需要自己加锁
+//
+// 本文件提供同一种写法（[](auto & self, Args... args) -> R）的三种求值方式：
+// - MakeMemoY<Cache>(f)        : 递归 + 记忆化，缓存可替换
+// - MakeTrampolinedY<Cache>(f) : 显式栈求值（trampoline），递归深度只受堆内存限制
+// - ConcurrentMemo             : 分片加锁的缓存，多个线程可以共享同一个 MemoY
+// 缓存策略：
+// - HashMemo<R, Args...>   : 任意可哈希参数，std::unordered_map<std::tuple<Args...>, R>
+// - FlatMemo<R, Index>     : 单个非负整数参数，数组直接寻址（稠密键最快）
+
+#ifndef CPP_QA_LAB_CSRC_BASIC_MEMO_COMBINATOR_H_
+#define CPP_QA_LAB_CSRC_BASIC_MEMO_COMBINATOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace cpp_qa_lab {
+namespace basic {
+
+// ============================================================================
+// 1. YCombinator - 原始版本（无记忆化），作为对照
+// ============================================================================
+
+template <typename F> struct YCombinator {
+    F func;
+
+    template <typename... Args> auto operator()(Args &&... args) const {
+        return func(*this, std::forward<Args>(args)...);
+    }
+};
+
+template <typename F> YCombinator<std::decay_t<F>> MakeYCombinator(F && func) {
+    return { std::forward<F>(func) };
+}
+
+// ============================================================================
+// 2. 缓存策略
+// ============================================================================
+//
+// 缓存需要提供：
+//   using key_type / result_type;
+//   bool Lookup(const key_type & key, result_type & out) const;  命中时把结果拷贝到 out
+//   void Insert(const key_type & key, const result_type & value);
+//   size_t size() const;  void Clear();
+// Lookup 按值返回结果，这样并发缓存在解锁后不会留下悬空指针。
+
+struct TupleHash {
+    template <typename... Ts> size_t operator()(const std::tuple<Ts...> & key) const {
+        size_t seed = 0;
+        std::apply(
+            [&seed](const Ts &... parts) {
+                // boost::hash_combine 的做法
+                ((seed ^= std::hash<Ts>()(parts) + 0x9e3779b97f4a7c15ULL + (seed << 6) +
+                          (seed >> 2)),
+                 ...);
+            },
+            key);
+        return seed;
+    }
+};
+
+template <typename R, typename... Args> class HashMemo {
+  public:
+    using key_type    = std::tuple<std::decay_t<Args>...>;
+    using result_type = R;
+
+    explicit HashMemo(size_t expected = 0) { map_.reserve(expected); }
+
+    bool Lookup(const key_type & key, R & out) const {
+        auto it = map_.find(key);
+        if (it == map_.end()) {
+            return false;
+        }
+        out = it->second;
+        return true;
+    }
+
+    void Insert(const key_type & key, const R & value) { map_.emplace(key, value); }
+
+    size_t size() const { return map_.size(); }
+
+    void Clear() { map_.clear(); }
+
+  private:
+    std::unordered_map<key_type, R, TupleHash> map_;
+};
+
+/**
+ * 稠密整数键：值存放在按下标寻址的数组中，按需扩容。
+ * 负数键抛 std::out_of_range。
+ */
+template <typename R, typename Index = size_t> class FlatMemo {
+    static_assert(std::is_integral_v<Index>, "FlatMemo requires an integral key");
+
+  public:
+    using key_type    = Index;
+    using result_type = R;
+
+    explicit FlatMemo(size_t expected = 0) {
+        values_.reserve(expected);
+        present_.reserve(expected);
+    }
+
+    bool Lookup(Index key, R & out) const {
+        size_t i = ToSlot(key);
+        if (i >= present_.size() || !present_[i]) {
+            return false;
+        }
+        out = values_[i];
+        return true;
+    }
+
+    void Insert(Index key, const R & value) {
+        size_t i = ToSlot(key);
+        if (i >= present_.size()) {
+            size_t n = std::max(i + 1, present_.size() * 2);
+            values_.resize(n);
+            present_.resize(n, 0);
+        }
+        size_ += present_[i] ? 0 : 1;
+        values_[i]  = value;
+        present_[i] = 1;
+    }
+
+    size_t size() const { return size_; }
+
+    void Clear() {
+        values_.clear();
+        present_.clear();
+        size_ = 0;
+    }
+
+  private:
+    static size_t ToSlot(Index key) {
+        if constexpr (std::is_signed_v<Index>) {
+            if (key < 0) {
+                throw std::out_of_range("FlatMemo key must be non-negative");
+            }
+        }
+        return static_cast<size_t>(key);
+    }
+
+    std::vector<R>       values_;
+    std::vector<uint8_t> present_; // 不用 vector<bool>：按字节访问更快
+    size_t               size_ = 0;
+};
+
+/**
+ * 线程安全的哈希缓存：按键的哈希分成 kShards 个分片，每个分片一把读写锁。
+ * 两个线程可能同时计算同一个键（都未命中），先插入的结果保留；对纯函数这是无害的重复计算。
+ */
+template <typename R, typename... Args> class ConcurrentMemo {
+  public:
+    using key_type    = std::tuple<std::decay_t<Args>...>;
+    using result_type = R;
+
+    static constexpr size_t kShards = 64;
+
+    explicit ConcurrentMemo(size_t expected = 0) : shards_(new Shard[kShards]) {
+        for (size_t i = 0; i < kShards; ++i) {
+            shards_[i].map.reserve(expected / kShards);
+        }
+    }
+
+    bool Lookup(const key_type & key, R & out) const {
+        const Shard &                       shard = ShardFor(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto                                it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return false;
+        }
+        out = it->second;
+        return true;
+    }
+
+    void Insert(const key_type & key, const R & value) {
+        Shard &                             shard = ShardFor(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.map.emplace(key, value);
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i < kShards; ++i) {
+            std::shared_lock<std::shared_mutex> lock(shards_[i].mutex);
+            total += shards_[i].map.size();
+        }
+        return total;
+    }
+
+    void Clear() {
+        for (size_t i = 0; i < kShards; ++i) {
+            std::unique_lock<std::shared_mutex> lock(shards_[i].mutex);
+            shards_[i].map.clear();
+        }
+    }
+
+  private:
+    // 每个分片独占缓存行，避免相邻分片的锁互相伪共享
+    struct alignas(64) Shard {
+        mutable std::shared_mutex                  mutex;
+        std::unordered_map<key_type, R, TupleHash> map;
+    };
+
+    Shard & ShardFor(const key_type & key) const {
+        // 分片用哈希的高位，桶内定位用低位，两者互不相关
+        size_t h = TupleHash()(key) * 0x9e3779b97f4a7c15ULL;
+        return shards_[(h >> 58) % kShards];
+    }
+
+    std::unique_ptr<Shard[]> shards_;
+};
+
+// ============================================================================
+// 3. MemoY - 递归 + 记忆化
+// ============================================================================
+
+namespace memo_detail {
+
+template <typename T> struct IsTuple : std::false_type {};
+
+template <typename... Ts> struct IsTuple<std::tuple<Ts...>> : std::true_type {};
+
+// TrampolinedY 记录祖先链的键集合：tuple 键用哈希集合
+template <typename Key, typename = void> class KeySet {
+  public:
+    bool Contains(const Key & key) const { return set_.count(key) != 0; }
+
+    void Insert(const Key & key) { set_.insert(key); }
+
+    void Erase(const Key & key) { set_.erase(key); }
+
+  private:
+    using Hash = std::conditional_t<IsTuple<Key>::value, TupleHash, std::hash<Key>>;
+
+    std::unordered_set<Key, Hash> set_;
+};
+
+// 整数键（FlatMemo）与缓存一样按键直接寻址：每个状态都要进出集合，哈希节点的分配太贵
+template <typename Key> class KeySet<Key, std::enable_if_t<std::is_integral_v<Key>>> {
+  public:
+    bool Contains(Key key) const {
+        auto i = static_cast<size_t>(key);
+        return key >= 0 && i < flags_.size() && flags_[i];
+    }
+
+    void Insert(Key key) {
+        if (key < 0) {
+            throw std::out_of_range("TrampolinedY integer key must be non-negative");
+        }
+        auto i = static_cast<size_t>(key);
+        if (i >= flags_.size()) {
+            flags_.resize(std::max(i + 1, flags_.size() * 2), 0);
+        }
+        flags_[i] = 1;
+    }
+
+    void Erase(Key key) {
+        auto i = static_cast<size_t>(key);
+        if (key >= 0 && i < flags_.size()) {
+            flags_[i] = 0;
+        }
+    }
+
+  private:
+    std::vector<char> flags_;
+};
+
+// 把缓存键展开成用户函数的参数：tuple 键逐个展开，标量键直接传入
+template <typename F, typename Self, typename Key>
+decltype(auto) CallWithKey(const F & func, Self & self, const Key & key) {
+    if constexpr (IsTuple<Key>::value) {
+        return std::apply([&](const auto &... args) { return func(self, args...); }, key);
+    } else {
+        return func(self, key);
+    }
+}
+
+} // namespace memo_detail
+
+/**
+ * 与 YCombinator 相同的写法，每个参数组合只计算一次。
+ * self 是一个轻量句柄，用户函数可以写 auto self 或 auto & self，都不会拷贝缓存。
+ * 仍然使用原生调用栈：递归深度等于依赖链长度。
+ */
+template <typename Cache, typename F> class MemoY {
+  public:
+    using key_type    = typename Cache::key_type;
+    using result_type = typename Cache::result_type;
+
+    explicit MemoY(F func, Cache cache = Cache())
+        : func_(std::move(func)), cache_(std::move(cache)) {}
+
+    template <typename... Args> result_type operator()(Args &&... args) const {
+        key_type    key{ std::forward<Args>(args)... };
+        result_type value;
+        if (cache_.Lookup(key, value)) {
+            return value;
+        }
+        Self self{ this };
+        value = memo_detail::CallWithKey(func_, self, key);
+        cache_.Insert(key, value);
+        return value;
+    }
+
+    Cache & cache() const { return cache_; }
+
+  private:
+    struct Self {
+        const MemoY * y;
+
+        template <typename... Args> result_type operator()(Args &&... args) const {
+            return (*y)(std::forward<Args>(args)...);
+        }
+    };
+
+    F             func_;
+    mutable Cache cache_;
+};
+
+template <typename Cache, typename F> MemoY<Cache, std::decay_t<F>> MakeMemoY(F && func) {
+    return MemoY<Cache, std::decay_t<F>>(std::forward<F>(func));
+}
+
+template <typename Cache, typename F>
+MemoY<Cache, std::decay_t<F>> MakeMemoY(F && func, Cache cache) {
+    return MemoY<Cache, std::decay_t<F>>(std::forward<F>(func), std::move(cache));
+}
+
+// ============================================================================
+// 4. TrampolinedY - 显式栈求值，不占用原生调用栈
+// ============================================================================
+
+/**
+ * 用户函数不变，但 self(k) 不再递归：
+ * - k 已在缓存中：直接返回结果
+ * - 否则记下 k 为"缺失依赖"，返回 result_type{} 占位，本次计算结果作废
+ * 调度循环把缺失依赖压入显式栈，先算依赖，再重新执行当前函数（trampoline：每次都"跳回"循环）。
+ *
+ * 要求：用户函数是纯函数（重复执行结果相同），result_type 可默认构造。
+ * 每个状态可能被执行"缺失依赖批次数 + 1"次；调用栈深度恒定，显式栈占用堆内存。
+ *
+ * 环检测：已执行过、还在等依赖的键，加上正在执行的键，就是当前栈顶的祖先链。
+ * - 本次执行中第一个缺失的依赖之前没有拿到过占位值，它若在祖先链上就是真正的环，
+ *   抛 std::logic_error（否则显式栈会无限增长）
+ * - 之后的请求可能是由占位值算出来的（如 Hofstadter Q 的 q(n - q(n - 1))），
+ *   落在祖先链上时只是跳过，等前面的依赖就绪、重新执行时再判断
+ */
+template <typename Cache, typename F> class TrampolinedY {
+  public:
+    using key_type    = typename Cache::key_type;
+    using result_type = typename Cache::result_type;
+
+    explicit TrampolinedY(F func, Cache cache = Cache())
+        : func_(std::move(func)), cache_(std::move(cache)) {}
+
+    template <typename... Args> result_type operator()(Args &&... args) const {
+        key_type    root{ std::forward<Args>(args)... };
+        result_type value;
+        if (cache_.Lookup(root, value)) {
+            return value;
+        }
+
+        std::vector<key_type> stack{ root };
+        std::vector<char>     waiting{ 0 }; // 与 stack 对应：该键已执行过、记在 active 中
+        std::vector<key_type> missing;
+        ActiveSet             active;
+        Self                  self{ this, &missing, &active, nullptr };
+        while (!stack.empty()) {
+            key_type key = stack.back();
+            if (cache_.Lookup(key, value)) {
+                if (waiting.back()) {
+                    active.Erase(key);
+                }
+                stack.pop_back();
+                waiting.pop_back();
+                continue;
+            }
+            missing.clear();
+            self.current = &key;
+            value        = memo_detail::CallWithKey(func_, self, key);
+            if (missing.empty()) {
+                cache_.Insert(key, value);
+                if (waiting.back()) {
+                    active.Erase(key);
+                }
+                stack.pop_back();
+                waiting.pop_back();
+            } else {
+                ++reruns_;
+                if (!waiting.back()) {
+                    active.Insert(key);
+                    waiting.back() = 1;
+                }
+                stack.insert(stack.end(), missing.begin(), missing.end());
+                waiting.resize(stack.size(), 0);
+            }
+        }
+        cache_.Lookup(root, value);
+        return value;
+    }
+
+    Cache & cache() const { return cache_; }
+
+    // 因依赖缺失而作废的执行次数（用于观察额外开销）
+    size_t reruns() const { return reruns_; }
+
+  private:
+    using ActiveSet = memo_detail::KeySet<key_type>;
+
+    struct Self {
+        const TrampolinedY *    y;
+        std::vector<key_type> * missing;
+        const ActiveSet *       active;  // 祖先链（不含正在执行的键）
+        const key_type *        current; // 正在执行的键
+
+        template <typename... Args> result_type operator()(Args &&... args) const {
+            key_type    key{ std::forward<Args>(args)... };
+            result_type value{};
+            if (y->cache_.Lookup(key, value)) {
+                return value;
+            }
+            if (!(key == *current) && !active->Contains(key)) {
+                missing->push_back(std::move(key));
+            } else if (missing->empty()) {
+                throw std::logic_error("TrampolinedY: 递推关系有环（状态依赖于自身或祖先）");
+            }
+            return value;
+        }
+    };
+
+    F              func_;
+    mutable Cache  cache_;
+    mutable size_t reruns_ = 0;
+};
+
+template <typename Cache, typename F>
+TrampolinedY<Cache, std::decay_t<F>> MakeTrampolinedY(F && func) {
+    return TrampolinedY<Cache, std::decay_t<F>>(std::forward<F>(func));
+}
+
+template <typename Cache, typename F>
+TrampolinedY<Cache, std::decay_t<F>> MakeTrampolinedY(F && func, Cache cache) {
+    return TrampolinedY<Cache, std::decay_t<F>>(std::forward<F>(func), std::move(cache));
+}
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+#endif // CPP_QA_LAB_CSRC_BASIC_MEMO_COMBINATOR_H_
@@ -0,0 +1,315 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 记忆化 Y 组合子基准测试：经典动态规划递推
+//
+// 用法: memo_combinator_benchmark [朴素斐波那契的 n]
+//
+// 1. 斐波那契：YCombinator（指数级）vs MemoY(FlatMemo / HashMemo) vs TrampolinedY
+// 2. 组合数 C(n, k) mod p（两个参数）：MemoY / TrampolinedY vs 自底向上填表
+// 3. 最长公共子序列：编码成单个下标的 FlatMemo vs 键 (i, j) 的 HashMemo vs 填表
+// 4. 深递归：fib(n) mod p，n = 10^6，只有 TrampolinedY 不会栈溢出
+// 5. 多线程：多个线程查询 C(n, k)，共享 ConcurrentMemo vs 每线程私有 HashMemo
+
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+#include "memo_combinator.h"
+#include "microbench.h"
+
+namespace cpp_qa_lab {
+namespace basic {
+
+constexpr uint64_t kMod = 1000000007;
+
+void PrintRow(const char * name, double seconds, uint64_t result, size_t states) {
+    fmt::print("  {:<34} {:>12.3f} {:>22} {:>12}\n", name, seconds * 1e3, result, states);
+}
+
+void PrintHeader(const char * title) {
+    fmt::print("{}\n  {:<34} {:>12} {:>22} {:>12}\n", title, "方式", "时间(ms)", "结果", "状态数");
+}
+
+// 同一个递推写一次，交给不同的求值方式
+auto Fibonacci() {
+    return [](auto & self, int n) -> uint64_t { return n < 2 ? n : self(n - 1) + self(n - 2); };
+}
+
+void BenchmarkFibonacci(microbench::Report & report, int naive_n) {
+    PrintHeader("[1] 斐波那契");
+    uint64_t naive = 0;
+    auto     fib_y = MakeYCombinator([](auto self, int n) -> uint64_t {
+        return n < 2 ? n : self(n - 1) + self(n - 2);
+    });
+    double   t_naive = report.Time(fmt::format("fibonacci/y_combinator/{}", naive_n),
+                                   [&] { naive = fib_y(naive_n); });
+    PrintRow(fmt::format("YCombinator fib({})", naive_n).c_str(), t_naive, naive, 0);
+
+    // 记忆化版本每次都用新缓存，每次重复连续算 1000 遍取平均
+    const int kReps = 1000;
+    uint64_t  flat = 0, hash = 0, tramp = 0;
+    size_t    flat_states = 0, hash_states = 0, tramp_states = 0;
+    double    t_flat = report.Time(
+        fmt::format("fibonacci/memo_flat/{}", naive_n),
+        [&] {
+            auto fib    = MakeMemoY<FlatMemo<uint64_t, int>>(Fibonacci());
+            flat        = fib(naive_n);
+            flat_states = fib.cache().size();
+        },
+        kReps);
+    double t_hash = report.Time(
+        fmt::format("fibonacci/memo_hash/{}", naive_n),
+        [&] {
+            auto fib    = MakeMemoY<HashMemo<uint64_t, int>>(Fibonacci());
+            hash        = fib(naive_n);
+            hash_states = fib.cache().size();
+        },
+        kReps);
+    double t_tramp = report.Time(
+        fmt::format("fibonacci/trampolined_flat/{}", naive_n),
+        [&] {
+            auto fib     = MakeTrampolinedY<FlatMemo<uint64_t, int>>(Fibonacci());
+            tramp        = fib(naive_n);
+            tramp_states = fib.cache().size();
+        },
+        kReps);
+    PrintRow("MemoY + FlatMemo", t_flat, flat, flat_states);
+    PrintRow("MemoY + HashMemo", t_hash, hash, hash_states);
+    PrintRow("TrampolinedY + FlatMemo", t_tramp, tramp, tramp_states);
+    fmt::print("  结果一致: {}, 朴素版本 / FlatMemo: {:.0f}x\n\n",
+               naive == flat && flat == hash && flat == tramp ? "yes" : "NO", t_naive / t_flat);
+}
+
+// C(n, k) = C(n-1, k-1) + C(n-1, k)，C(n, 0) = C(n, n) = 1
+auto Binomial() {
+    return [](auto & self, int n, int k) -> uint64_t {
+        if (k == 0 || k == n) {
+            return 1;
+        }
+        return (self(n - 1, k - 1) + self(n - 1, k)) % kMod;
+    };
+}
+
+uint64_t BinomialTable(int n, int k) {
+    std::vector<uint64_t> row(k + 1, 0);
+    row[0] = 1;
+    for (int i = 1; i <= n; ++i) {
+        for (int j = std::min(i, k); j > 0; --j) {
+            row[j] = (row[j] + row[j - 1]) % kMod;
+        }
+    }
+    return row[k];
+}
+
+void BenchmarkBinomial(microbench::Report & report) {
+    const int n = 2000, k = 1000;
+    PrintHeader(fmt::format("[2] 组合数 C({}, {}) mod 1e9+7", n, k).c_str());
+    uint64_t memo = 0, tramp = 0, table = 0;
+    size_t   memo_states = 0, tramp_states = 0, reruns = 0;
+    double   t_memo = report.Time("binomial/memo_hash", [&] {
+        auto c      = MakeMemoY<HashMemo<uint64_t, int, int>>(Binomial());
+        memo        = c(n, k);
+        memo_states = c.cache().size();
+    });
+    double   t_tramp = report.Time("binomial/trampolined_hash", [&] {
+        auto c       = MakeTrampolinedY<HashMemo<uint64_t, int, int>>(Binomial());
+        tramp        = c(n, k);
+        tramp_states = c.cache().size();
+        reruns       = c.reruns();
+    });
+    double   t_table = report.Time("binomial/table", [&] { table = BinomialTable(n, k); });
+    PrintRow("MemoY + HashMemo", t_memo, memo, memo_states);
+    PrintRow("TrampolinedY + HashMemo", t_tramp, tramp, tramp_states);
+    PrintRow("自底向上填表", t_table, table, static_cast<size_t>(n) * (k + 1));
+    fmt::print("  结果一致: {}, TrampolinedY 作废重算 {} 次\n\n",
+               memo == tramp && memo == table ? "yes" : "NO", reruns);
+}
+
+// LCS(i, j)：a[i..] 与 b[j..] 的最长公共子序列长度
+void BenchmarkLcs(microbench::Report & report) {
+    const size_t      n = 1500;
+    std::mt19937      rng(5);
+    std::string       a(n, 'a'), b(n, 'a');
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = static_cast<char>('a' + rng() % 4);
+        b[i] = static_cast<char>('a' + rng() % 4);
+    }
+    PrintHeader(fmt::format("[3] 最长公共子序列（两个长度 {} 的随机串）", n).c_str());
+
+    auto lcs_pair = [&a, &b](auto & self, size_t i, size_t j) -> uint32_t {
+        if (i == a.size() || j == b.size()) {
+            return 0;
+        }
+        if (a[i] == b[j]) {
+            return self(i + 1, j + 1) + 1;
+        }
+        return std::max(self(i + 1, j), self(i, j + 1));
+    };
+    // 稠密的二维键编码成一个下标：key = i * (n + 1) + j
+    const size_t stride    = b.size() + 1;
+    auto         lcs_index = [&a, &b, stride](auto & self, size_t key) -> uint32_t {
+        size_t i = key / stride, j = key % stride;
+        if (i == a.size() || j == b.size()) {
+            return 0;
+        }
+        if (a[i] == b[j]) {
+            return self(key + stride + 1) + 1;
+        }
+        return std::max(self(key + stride), self(key + 1));
+    };
+
+    uint64_t hash = 0, flat = 0, tramp = 0, table = 0;
+    size_t   hash_states = 0, flat_states = 0, tramp_states = 0;
+    double   t_flat = report.Time("lcs/memo_flat", [&] {
+        auto lcs    = MakeMemoY(lcs_index, FlatMemo<uint32_t, size_t>(stride * stride));
+        flat        = lcs(size_t{ 0 });
+        flat_states = lcs.cache().size();
+    });
+    double   t_tramp = report.Time("lcs/trampolined_flat", [&] {
+        auto lcs     = MakeTrampolinedY(lcs_index, FlatMemo<uint32_t, size_t>(stride * stride));
+        tramp        = lcs(size_t{ 0 });
+        tramp_states = lcs.cache().size();
+    });
+    // 哈希表放在最后：它释放的大量小节点会影响之后大数组的分配速度
+    double   t_hash = report.Time("lcs/memo_hash", [&] {
+        auto lcs    = MakeMemoY(lcs_pair, HashMemo<uint32_t, size_t, size_t>(n * n));
+        hash        = lcs(size_t{ 0 }, size_t{ 0 });
+        hash_states = lcs.cache().size();
+    });
+    double   t_table = report.Time("lcs/table", [&] {
+        std::vector<uint32_t> next(n + 1, 0), cur(n + 1, 0);
+        for (size_t i = n; i-- > 0;) {
+            for (size_t j = n; j-- > 0;) {
+                cur[j] = a[i] == b[j] ? next[j + 1] + 1 : std::max(next[j], cur[j + 1]);
+            }
+            std::swap(cur, next);
+        }
+        table = next[0];
+    });
+    PrintRow("MemoY + FlatMemo<i*(n+1)+j>", t_flat, flat, flat_states);
+    PrintRow("TrampolinedY + FlatMemo", t_tramp, tramp, tramp_states);
+    PrintRow("MemoY + HashMemo<(i, j)>", t_hash, hash, hash_states);
+    PrintRow("自底向上填表（两行滚动）", t_table, table, n * n);
+    fmt::print("  结果一致: {}\n\n", hash == flat && flat == tramp && flat == table ? "yes" : "NO");
+}
+
+void BenchmarkDeep(microbench::Report & report) {
+    const int n = 1000000;
+    PrintHeader(fmt::format("[4] 深递归 fib({}) mod 1e9+7", n).c_str());
+    auto fib_mod = [](auto & self, int i) -> uint64_t {
+        return i < 2 ? i : (self(i - 1) + self(i - 2)) % kMod;
+    };
+    uint64_t tramp = 0, loop = 0;
+    size_t   states = 0;
+    double   t_tramp = report.Time("deep_fibonacci/trampolined_flat", [&] {
+        auto fib = MakeTrampolinedY(fib_mod, FlatMemo<uint64_t, int>(n + 1));
+        tramp    = fib(n);
+        states   = fib.cache().size();
+    });
+    double   t_loop = report.Time("deep_fibonacci/loop", [&] {
+        uint64_t x = 0, y = 1;
+        for (int i = 0; i < n; ++i) {
+            uint64_t z = (x + y) % kMod;
+            x          = y;
+            y          = z;
+        }
+        loop = x;
+    });
+    PrintRow("TrampolinedY + FlatMemo", t_tramp, tramp, states);
+    PrintRow("迭代", t_loop, loop, 0);
+    fmt::print("  结果一致: {}（MemoY 需要 {} 层原生调用栈，这里不运行）\n\n",
+               tramp == loop ? "yes" : "NO", n);
+}
+
+// 每个线程查询一批 C(n, k)；共享缓存时其他线程已算出的状态可以直接复用
+void BenchmarkConcurrent(microbench::Report & report) {
+    const int kThreads = 4, kQueries = 50;
+    std::vector<std::pair<int, int>> queries;
+    std::mt19937                     rng(9);
+    for (int i = 0; i < kThreads * kQueries; ++i) {
+        int n = 300 + static_cast<int>(rng() % 300);
+        queries.emplace_back(n, static_cast<int>(rng() % (n + 1)));
+    }
+
+    std::vector<uint64_t> shared_results(queries.size()), private_results(queries.size());
+    size_t                shared_states = 0, private_states = 0;
+    auto shared = MakeMemoY(Binomial(), ConcurrentMemo<uint64_t, int, int>(1 << 18));
+
+    // 共享缓存跨次保留，重复运行就全是命中了，所以两种方式都只计时一次
+    double t_shared = microbench::Seconds([&] {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                for (int q = t; q < kThreads * kQueries; q += kThreads) {
+                    shared_results[q] = shared(queries[q].first, queries[q].second);
+                }
+            });
+        }
+        for (auto & th : threads) {
+            th.join();
+        }
+        shared_states = shared.cache().size();
+    });
+
+    std::vector<size_t> states(kThreads, 0);
+    double              t_private = microbench::Seconds([&] {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                auto c = MakeMemoY<HashMemo<uint64_t, int, int>>(Binomial());
+                for (int q = t; q < kThreads * kQueries; q += kThreads) {
+                    private_results[q] = c(queries[q].first, queries[q].second);
+                }
+                states[t] = c.cache().size();
+            });
+        }
+        for (auto & th : threads) {
+            th.join();
+        }
+    });
+    for (size_t s : states) {
+        private_states += s;
+    }
+    report.Add("concurrent/shared_concurrent_memo", { t_shared }, queries.size());
+    report.Add("concurrent/private_hash_memo", { t_private }, queries.size());
+
+    bool same = shared_results == private_results;
+    for (size_t q = 0; q < queries.size() && same; q += 37) {
+        same = shared_results[q] == BinomialTable(queries[q].first, queries[q].second);
+    }
+    PrintHeader(fmt::format("[5] {} 个线程共 {} 次 C(n, k) 查询", kThreads, queries.size()).c_str());
+    PrintRow("共享 ConcurrentMemo", t_shared, shared_results[0], shared_states);
+    PrintRow("每线程私有 HashMemo", t_private, private_results[0], private_states);
+    fmt::print("  结果一致（含抽样填表校验）: {}, 硬件线程: {}\n\n", same ? "yes" : "NO",
+               std::thread::hardware_concurrency());
+}
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+int main(int argc, char * argv[]) {
+    microbench::Report report(argc, argv);
+    int                naive_n = argc > 1 ? std::atoi(argv[1]) : 40;
+    naive_n = std::max(2, std::min(naive_n, 93)); // fib(93) 是 uint64_t 能表示的最大值
+
+    spdlog::info("记忆化 Y 组合子基准测试");
+    spdlog::info("=====================================");
+    cpp_qa_lab::basic::BenchmarkFibonacci(report, naive_n);
+    cpp_qa_lab::basic::BenchmarkBinomial(report);
+    cpp_qa_lab::basic::BenchmarkLcs(report);
+    cpp_qa_lab::basic::BenchmarkDeep(report);
+    cpp_qa_lab::basic::BenchmarkConcurrent(report);
+
+    spdlog::info("关键学习点：");
+    spdlog::info("1. 记忆化把重叠子问题从指数级降到状态数级，写法与 YCombinator 相同");
+    spdlog::info("2. 稠密整数键用数组直接寻址，比哈希表快一个数量级");
+    spdlog::info("3. trampoline 把递归改成显式栈，深度只受堆内存限制，代价是部分状态重复执行");
+    spdlog::info("4. 分片读写锁让多个线程共享缓存，其他线程算过的状态可以直接复用");
+    spdlog::info("5. 已知求值顺序时，自底向上填表仍然是最快的");
+    return report.Finish();
+}
@@ -0,0 +1,391 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 定点小数金额类型 Money
+//
+// 用 double 表示金额的问题：
+// - 0.1 + 0.2 != 0.3，大量转账累加后总额不守恒，只能做"近似相等"的审计
+// - 比较/校验要处理 NaN、负零等特殊值
+//
+// BasicMoney<Rep> 把金额存为整数个最小单位（1/10000 元），加减法是精确的整数运算：
+// - Money    = BasicMoney<int64_t>  : 约 ±9.2 * 10^14 元，std::atomic<Money> 无锁
+// - Money128 = BasicMoney<__int128> : 用于汇总（所有余额之和不会溢出）
+// - 所有算术都检查溢出：运算符版本抛 std::overflow_error，CheckedAdd/CheckedSub 返回 bool
+// - SumMoney / CountBelow 是审计用的批量操作，AVX2 可用时走 SIMD 路径
+// - 文件末尾提供 fmt::formatter 特化，可直接用于 fmt::print / spdlog
+
+#ifndef CPP_QA_LAB_CSRC_BASIC_MONEY_H_
+#define CPP_QA_LAB_CSRC_BASIC_MONEY_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/format.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#    define MONEY_HAVE_X86 1
+#    include <immintrin.h>
+#else
+#    define MONEY_HAVE_X86 0
+#endif
+
+namespace cpp_qa_lab {
+namespace basic {
+
+__extension__ typedef __int128 Int128;
+__extension__ typedef unsigned __int128 UInt128;
+
+template <typename Rep> class BasicMoney {
+    static_assert(std::is_same_v<Rep, int64_t> || std::is_same_v<Rep, Int128>,
+                  "BasicMoney supports int64_t and __int128 representations");
+
+    using URep = std::conditional_t<sizeof(Rep) == 16, UInt128, uint64_t>;
+
+  public:
+    static constexpr int kDecimals = 4;
+    static constexpr Rep kScale    = 10000;
+    static constexpr Rep kMaxRaw   = static_cast<Rep>(~URep(0) >> 1);
+    static constexpr Rep kMinRaw   = -kMaxRaw - 1;
+
+    constexpr BasicMoney() = default;
+
+    // 从其他表示转换（如 Money -> Money128）；变窄时检查范围
+    template <typename Other>
+    explicit BasicMoney(BasicMoney<Other> other) : raw_(Narrow(other.raw())) {}
+
+    static constexpr BasicMoney FromRaw(Rep raw) { return BasicMoney(raw); }
+
+    // 整数元，例如 FromUnits(100) 表示 100.0000
+    static BasicMoney FromUnits(int64_t units) {
+        Rep raw = 0;
+        if (__builtin_mul_overflow(static_cast<Rep>(units), kScale, &raw)) {
+            throw std::overflow_error("money overflow");
+        }
+        return BasicMoney(raw);
+    }
+
+    // 与旧的 double 接口互通：四舍五入到最小单位，NaN / 超出范围时抛异常
+    static BasicMoney FromDouble(double value) {
+        long double scaled = std::round(static_cast<long double>(value) * kScale);
+        if (!(scaled >= static_cast<long double>(kMinRaw) &&
+              scaled < -static_cast<long double>(kMinRaw))) {
+            throw std::overflow_error("money out of range");
+        }
+        return BasicMoney(static_cast<Rep>(scaled));
+    }
+
+    // 解析 "-1234.5" 这样的十进制字符串；小数位超过 kDecimals 或溢出时返回 nullopt
+    static std::optional<BasicMoney> Parse(std::string_view text) {
+        bool negative = false;
+        if (!text.empty() && (text[0] == '-' || text[0] == '+')) {
+            negative = text[0] == '-';
+            text.remove_prefix(1);
+        }
+        Rep  raw       = 0;
+        int  decimals  = -1; // 见到小数点之前为 -1
+        bool has_digit = false;
+        for (char c : text) {
+            if (c == '.' && decimals < 0) {
+                decimals = 0;
+                continue;
+            }
+            if (c < '0' || c > '9' || decimals == kDecimals) {
+                return std::nullopt;
+            }
+            Rep digit = negative ? -(c - '0') : (c - '0');
+            if (__builtin_mul_overflow(raw, Rep(10), &raw) ||
+                __builtin_add_overflow(raw, digit, &raw)) {
+                return std::nullopt;
+            }
+            has_digit = true;
+            if (decimals >= 0) {
+                ++decimals;
+            }
+        }
+        if (!has_digit) {
+            return std::nullopt;
+        }
+        for (int d = std::max(decimals, 0); d < kDecimals; ++d) {
+            if (__builtin_mul_overflow(raw, Rep(10), &raw)) {
+                return std::nullopt;
+            }
+        }
+        return BasicMoney(raw);
+    }
+
+    constexpr Rep raw() const { return raw_; }
+
+    double ToDouble() const { return static_cast<double>(raw_) / static_cast<double>(kScale); }
+
+    // 不抛异常的检查运算（热路径用）：溢出返回 false，*out 不变
+    static bool CheckedAdd(BasicMoney a, BasicMoney b, BasicMoney * out) {
+        Rep raw = 0;
+        if (__builtin_add_overflow(a.raw_, b.raw_, &raw)) {
+            return false;
+        }
+        out->raw_ = raw;
+        return true;
+    }
+
+    static bool CheckedSub(BasicMoney a, BasicMoney b, BasicMoney * out) {
+        Rep raw = 0;
+        if (__builtin_sub_overflow(a.raw_, b.raw_, &raw)) {
+            return false;
+        }
+        out->raw_ = raw;
+        return true;
+    }
+
+    BasicMoney & operator+=(BasicMoney rhs) {
+        if (!CheckedAdd(*this, rhs, this)) {
+            throw std::overflow_error("money overflow");
+        }
+        return *this;
+    }
+
+    BasicMoney & operator-=(BasicMoney rhs) {
+        if (!CheckedSub(*this, rhs, this)) {
+            throw std::overflow_error("money overflow");
+        }
+        return *this;
+    }
+
+    BasicMoney & operator*=(int64_t factor) {
+        if (__builtin_mul_overflow(raw_, static_cast<Rep>(factor), &raw_)) {
+            throw std::overflow_error("money overflow");
+        }
+        return *this;
+    }
+
+    friend BasicMoney operator+(BasicMoney lhs, BasicMoney rhs) { return lhs += rhs; }
+
+    friend BasicMoney operator-(BasicMoney lhs, BasicMoney rhs) { return lhs -= rhs; }
+
+    friend BasicMoney operator*(BasicMoney lhs, int64_t factor) { return lhs *= factor; }
+
+    friend BasicMoney operator-(BasicMoney m) { return BasicMoney() - m; }
+
+    friend constexpr bool operator==(BasicMoney a, BasicMoney b) { return a.raw_ == b.raw_; }
+
+    friend constexpr bool operator!=(BasicMoney a, BasicMoney b) { return a.raw_ != b.raw_; }
+
+    friend constexpr bool operator<(BasicMoney a, BasicMoney b) { return a.raw_ < b.raw_; }
+
+    friend constexpr bool operator<=(BasicMoney a, BasicMoney b) { return a.raw_ <= b.raw_; }
+
+    friend constexpr bool operator>(BasicMoney a, BasicMoney b) { return a.raw_ > b.raw_; }
+
+    friend constexpr bool operator>=(BasicMoney a, BasicMoney b) { return a.raw_ >= b.raw_; }
+
+    // 最长输出："-" + 39 位整数 + "." + 4 位小数
+    static constexpr size_t kMaxChars = 48;
+
+    /**
+     * 写出十进制表示，返回结尾指针。小数至少保留两位，多余的尾零去掉：
+     * 12 -> "12.00"，12.5 -> "12.50"，12.3456 -> "12.3456"。
+     * 纯整数运算，不经过 double，也不依赖 locale。
+     */
+    char * ToChars(char * out) const {
+        URep magnitude = raw_ < 0 ? URep(0) - static_cast<URep>(raw_) : static_cast<URep>(raw_);
+        URep whole     = magnitude / static_cast<URep>(kScale);
+        auto fraction  = static_cast<uint32_t>(magnitude % static_cast<URep>(kScale));
+
+        char   digits[kMaxChars];
+        char * p = digits + kMaxChars;
+        do {
+            *--p = static_cast<char>('0' + static_cast<int>(whole % 10));
+            whole /= 10;
+        } while (whole != 0);
+        if (raw_ < 0) {
+            *--p = '-';
+        }
+        while (p != digits + kMaxChars) {
+            *out++ = *p++;
+        }
+
+        *out++ = '.';
+        char frac[kDecimals];
+        for (int i = kDecimals - 1; i >= 0; --i) {
+            frac[i] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        int keep = kDecimals;
+        while (keep > 2 && frac[keep - 1] == '0') {
+            --keep;
+        }
+        for (int i = 0; i < keep; ++i) {
+            *out++ = frac[i];
+        }
+        return out;
+    }
+
+    std::string ToString() const {
+        char buf[kMaxChars];
+        return std::string(buf, ToChars(buf));
+    }
+
+  private:
+    constexpr explicit BasicMoney(Rep raw) : raw_(raw) {}
+
+    template <typename Other> static Rep Narrow(Other raw) {
+        if constexpr (sizeof(Other) > sizeof(Rep)) {
+            if (raw > static_cast<Other>(kMaxRaw) || raw < static_cast<Other>(kMinRaw)) {
+                throw std::overflow_error("money out of range");
+            }
+        }
+        return static_cast<Rep>(raw);
+    }
+
+    Rep raw_ = 0;
+};
+
+using Money    = BasicMoney<int64_t>;
+using Money128 = BasicMoney<Int128>;
+
+static_assert(sizeof(Money) == sizeof(int64_t) && std::is_trivially_copyable_v<Money>,
+              "Money must be a plain int64_t so that batches can be processed as int64 arrays");
+
+// ============================================================================
+// 批量审计操作
+// ============================================================================
+
+namespace money_detail {
+
+inline Int128 SumPortable(const int64_t * data, size_t n) {
+    Int128 total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        total += data[i];
+    }
+    return total;
+}
+
+inline size_t CountBelowPortable(const int64_t * data, size_t n, int64_t threshold) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += data[i] < threshold ? 1 : 0;
+    }
+    return count;
+}
+
+#if MONEY_HAVE_X86
+
+__attribute__((target("avx2"))) inline uint64_t HorizontalSum(__m256i v) {
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+/**
+ * 精确求和：64 位加法会溢出，AVX2 又没有 128 位整数。
+ * 把每个 int64 拆成 x = hi * 2^32 + lo - neg * 2^64（hi、lo 为无符号 32 位，neg 为符号位），
+ * 三部分分别在 64 位通道中累加：每块不超过 2^31 个元素，各部分的和都不会溢出，
+ * 最后在标量中用 128 位整数合并。只用到逻辑移位和加法。
+ */
+__attribute__((target("avx2"))) inline Int128 SumAvx2(const int64_t * data, size_t n) {
+    constexpr size_t kBlock   = size_t(1) << 31;
+    const __m256i    low_mask = _mm256_set1_epi64x(0xFFFFFFFFll);
+    Int128           total    = 0;
+    size_t           i        = 0;
+    while (i + 4 <= n) {
+        size_t  end  = std::min(n - (n - i) % 4, i + kBlock);
+        __m256i lo   = _mm256_setzero_si256();
+        __m256i hi   = _mm256_setzero_si256();
+        __m256i sign = _mm256_setzero_si256();
+        for (; i < end; i += 4) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            lo        = _mm256_add_epi64(lo, _mm256_and_si256(x, low_mask));
+            hi        = _mm256_add_epi64(hi, _mm256_srli_epi64(x, 32));
+            sign      = _mm256_add_epi64(sign, _mm256_srli_epi64(x, 63));
+        }
+        total += static_cast<Int128>(HorizontalSum(lo));
+        total += static_cast<Int128>(HorizontalSum(hi)) << 32;
+        total -= static_cast<Int128>(HorizontalSum(sign)) << 64;
+    }
+    return total + SumPortable(data + i, n - i);
+}
+
+__attribute__((target("avx2"))) inline size_t CountBelowAvx2(const int64_t * data, size_t n,
+                                                              int64_t threshold) {
+    const __m256i limit = _mm256_set1_epi64x(threshold);
+    __m256i       count = _mm256_setzero_si256();
+    size_t        i     = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        // 比较结果为全 1（即 -1），用减法累加个数
+        count = _mm256_sub_epi64(count, _mm256_cmpgt_epi64(limit, x));
+    }
+    return static_cast<size_t>(HorizontalSum(count)) +
+           CountBelowPortable(data + i, n - i, threshold);
+}
+
+inline bool HasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#endif // MONEY_HAVE_X86
+
+inline const int64_t * AsRaw(const Money * data) {
+    return reinterpret_cast<const int64_t *>(data);
+}
+
+} // namespace money_detail
+
+// 所有金额之和（精确，不会溢出）。审计"总余额守恒"时用它代替 double 累加
+inline Money128 SumMoney(const Money * data, size_t n) {
+#if MONEY_HAVE_X86
+    if (money_detail::HasAvx2()) {
+        return Money128::FromRaw(money_detail::SumAvx2(money_detail::AsRaw(data), n));
+    }
+#endif
+    return Money128::FromRaw(money_detail::SumPortable(money_detail::AsRaw(data), n));
+}
+
+inline Money128 SumMoney(const std::vector<Money> & values) {
+    return SumMoney(values.data(), values.size());
+}
+
+// 小于 threshold 的金额个数，例如 CountBelow(balances, Money()) 统计透支账户
+inline size_t CountBelow(const Money * data, size_t n, Money threshold) {
+#if MONEY_HAVE_X86
+    if (money_detail::HasAvx2()) {
+        return money_detail::CountBelowAvx2(money_detail::AsRaw(data), n, threshold.raw());
+    }
+#endif
+    return money_detail::CountBelowPortable(money_detail::AsRaw(data), n, threshold.raw());
+}
+
+inline size_t CountBelow(const std::vector<Money> & values, Money threshold) {
+    return CountBelow(values.data(), values.size(), threshold);
+}
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+// 与 ComplexNumber 相同的写法：提供 fmt 格式化器特化，Money 可直接用于 fmt::print / spdlog
+namespace fmt {
+template <typename Rep> struct formatter<cpp_qa_lab::basic::BasicMoney<Rep>> {
+    // 使用默认解析
+    constexpr auto parse(format_parse_context & ctx) -> decltype(ctx.begin()) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const cpp_qa_lab::basic::BasicMoney<Rep> & m,
+                FormatContext &                           ctx) const -> decltype(ctx.out()) {
+        char buf[cpp_qa_lab::basic::BasicMoney<Rep>::kMaxChars];
+        return std::copy(buf, m.ToChars(buf), ctx.out());
+    }
+};
+} // namespace fmt
+
+#endif // CPP_QA_LAB_CSRC_BASIC_MONEY_H_
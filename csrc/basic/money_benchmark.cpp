@@ -0,0 +1,137 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// Money 批量审计与格式化基准测试
+//
+// 用法: money_benchmark [余额个数] [--repetitions=<n>] [--json=<文件>]
+//
+// 对比 double 与定点 Money 在"审计所有余额"场景下的速度和精确性：
+// - 求和：double 累加 / Money 标量 128 位累加 / SumMoney（AVX2）
+// - 校验：统计透支（余额 < 0）的账户个数
+// - 格式化：fmt::format("{}") 输出 double 与 Money
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "common.h"
+#include "microbench.h"
+#include "money.h"
+
+namespace cpp_qa_lab {
+namespace basic {
+
+// 边界值检查：SIMD 路径必须与标量 128 位累加逐位一致
+bool CheckKernels() {
+    std::vector<Money> edge = { Money::FromRaw(Money::kMaxRaw), Money::FromRaw(Money::kMaxRaw),
+                                Money::FromRaw(Money::kMinRaw), Money::FromRaw(-1),
+                                Money::FromRaw(1),              Money::FromRaw(Money::kMaxRaw),
+                                Money::FromRaw(Money::kMinRaw) };
+    for (size_t n = 0; n <= edge.size(); ++n) {
+        Int128 expected = 0;
+        size_t negative = 0;
+        for (size_t i = 0; i < n; ++i) {
+            expected += edge[i].raw();
+            negative += edge[i] < Money() ? 1 : 0;
+        }
+        if (SumMoney(edge.data(), n).raw() != expected ||
+            CountBelow(edge.data(), n, Money()) != negative) {
+            return false;
+        }
+    }
+    return Money::Parse("-12.345")->ToString() == "-12.345" && !Money::Parse("1.23456") &&
+           Money::FromUnits(7).ToString() == "7.00";
+}
+
+void RunBenchmark(microbench::Report & report, size_t n) {
+    // 余额以"分"为单位随机生成，约 1% 的账户透支
+    std::mt19937_64                        rng(42);
+    std::uniform_int_distribution<int64_t> cents(-1000, 99999999);
+    std::vector<Money>                     balances(n);
+    std::vector<double>                    doubles(n);
+    for (size_t i = 0; i < n; ++i) {
+        balances[i] = Money::FromRaw(cents(rng) * 100);
+        doubles[i]  = balances[i].ToDouble();
+    }
+
+    fmt::print("余额个数: {}, 重复 {} 次取最优\n", n, report.repetitions());
+    fmt::print("SIMD 内核边界值校验: {}\n\n", CheckKernels() ? "通过" : "失败");
+
+    double   sum_double = 0.0;
+    Money128 sum_scalar, sum_simd;
+    double   t_double = report.Time("audit/sum_double", [&] {
+        sum_double = std::accumulate(doubles.begin(), doubles.end(), 0.0);
+    });
+
+    double t_scalar = report.Time("audit/sum_money_scalar", [&] {
+        sum_scalar = Money128();
+        for (Money m : balances) {
+            sum_scalar += Money128(m);
+        }
+    });
+
+    double t_simd = report.Time("audit/sum_money_simd", [&] { sum_simd = SumMoney(balances); });
+
+    size_t neg_double = 0, neg_simd = 0;
+    double t_neg_double = report.Time("audit/count_negative_double", [&] {
+        neg_double = std::count_if(doubles.begin(), doubles.end(), [](double d) { return d < 0; });
+    });
+
+    double t_neg_simd =
+        report.Time("audit/count_below_simd", [&] { neg_simd = CountBelow(balances, Money()); });
+
+    auto gbps = [&](double seconds) { return static_cast<double>(n) * 8 / seconds / 1e9; };
+    fmt::print("{:<28} {:>12} {:>10}   {}\n", "审计", "时间(ms)", "GB/s", "结果");
+    fmt::print("{:<28} {:>12.3f} {:>10.2f}   {:.4f}\n", "求和 double", t_double * 1e3,
+               gbps(t_double), sum_double);
+    fmt::print("{:<28} {:>12.3f} {:>10.2f}   {}\n", "求和 Money 标量(128 位)", t_scalar * 1e3,
+               gbps(t_scalar), sum_scalar);
+    fmt::print("{:<28} {:>12.3f} {:>10.2f}   {}\n", "求和 SumMoney", t_simd * 1e3, gbps(t_simd),
+               sum_simd);
+    fmt::print("{:<28} {:>12.3f} {:>10.2f}   {}\n", "透支计数 double", t_neg_double * 1e3,
+               gbps(t_neg_double), neg_double);
+    fmt::print("{:<28} {:>12.3f} {:>10.2f}   {}\n", "透支计数 CountBelow", t_neg_simd * 1e3,
+               gbps(t_neg_simd), neg_simd);
+    fmt::print("SumMoney 与标量结果一致: {}, double 求和误差: {:.6f}\n\n",
+               sum_simd == sum_scalar ? "yes" : "NO",
+               sum_double - static_cast<double>(sum_scalar.raw()) / Money128::kScale);
+
+    // 格式化：只取前 100 万个，避免输出字符串占用过多内存
+    size_t m     = std::min<size_t>(n, 1000000);
+    size_t chars = 0;
+    double t_fd  = report.Time("format/double", [&] {
+        chars = 0;
+        for (size_t i = 0; i < m; ++i) {
+            chars += fmt::formatted_size("{}", doubles[i]);
+        }
+    });
+
+    double t_fm = report.Time("format/money", [&] {
+        chars = 0;
+        for (size_t i = 0; i < m; ++i) {
+            chars += fmt::formatted_size("{}", balances[i]);
+        }
+    });
+    fmt::print("格式化 {} 个金额: double {:.1f} ns/个, Money {:.1f} ns/个 (示例: {} / {})\n", m,
+               t_fd / m * 1e9, t_fm / m * 1e9, doubles[0], balances[0]);
+}
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+int main(int argc, char * argv[]) {
+    microbench::Report report(argc, argv);
+    size_t             n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+
+    spdlog::info("定点金额 Money 审计基准测试");
+    spdlog::info("=====================================");
+    cpp_qa_lab::basic::RunBenchmark(report, std::max<size_t>(1, n));
+
+    spdlog::info("关键学习点：");
+    spdlog::info("1. 定点整数的加减法是精确的，总额守恒可以用 == 审计");
+    spdlog::info("2. 拆成高低 32 位分别累加，AVX2 也能得到不溢出的精确 128 位和");
+    spdlog::info("3. 整数比较没有 NaN，校验循环无分支，易于向量化");
+    spdlog::info("4. 定点数格式化只需整数除法，不需要浮点数的最短表示算法");
+    return report.Finish();
+}
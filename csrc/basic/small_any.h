@@ -0,0 +1,622 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 小缓冲区 any - any_example.cpp 中 std::any 用法的高性能替代
+//
+// std::any 在属性包热路径上的开销：
+// - libstdc++ 的内联缓冲区只有一个指针大，std::string、Point3 这类值每次构造/拷贝都要堆分配
+// - 想格式化一个未知类型的值，只能按顺序尝试 any_cast<int>、any_cast<double>……，
+//   每次失败都要比较一次 type_info
+// - std::vector<std::any> 中每个元素都是独立的堆对象，遍历时到处跳转
+//
+// 本文件的做法：
+// - BasicAny<kInlineSize>：缓冲区大小可配置（Any = 32 字节，可放下 std::string），
+//   放不下或移动可能抛异常的类型才堆分配；AnyCast<T> 只比较一次类型描述符指针
+// - 每个类型有一个稠密的整数编号（AnyTypeInfo::index），
+//   AnyVisitorRegistry 按编号直接索引处理函数，一次数组访问完成分派
+// - AnyVector：所有元素的值按各自的对齐紧凑存放在一块连续内存中，另有一个 16 字节的槽位数组
+
+#ifndef CPP_QA_LAB_CSRC_BASIC_SMALL_ANY_H_
+#define CPP_QA_LAB_CSRC_BASIC_SMALL_ANY_H_
+
+#include <algorithm>
+#include <any>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace cpp_qa_lab {
+namespace basic {
+
+// ============================================================================
+// 1. AnyTypeInfo - 每个类型一个描述符（取代 std::type_info + 手写的 any_cast 链）
+// ============================================================================
+
+struct AnyTypeInfo {
+    uint32_t     index; // 稠密编号：从 0 开始，按类型第一次使用的顺序分配
+    uint32_t     size;
+    uint32_t     align;
+    bool         nothrow_move;
+    const char * name;
+    void (*copy)(void * dst, const void * src);
+    void (*move)(void * dst, void * src) noexcept; // 移动构造到 dst，并析构 src
+    void (*destroy)(void * p) noexcept;
+};
+
+namespace any_detail {
+
+inline uint32_t NextTypeIndex() {
+    static std::atomic<uint32_t> next{ 0 };
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 普通对齐的值走不带对齐参数的 operator new（通常比对齐分配快）
+inline void * Allocate(size_t size, size_t align) {
+    if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        return ::operator new(size, std::align_val_t{ align });
+    }
+    return ::operator new(size);
+}
+
+inline void Deallocate(void * p, size_t align) noexcept {
+    if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        ::operator delete(p, std::align_val_t{ align });
+    } else {
+        ::operator delete(p);
+    }
+}
+
+template <typename T> void Copy(void * dst, const void * src) {
+    ::new (dst) T(*static_cast<const T *>(src));
+}
+
+// 只用于内联存放的值（移动构造不抛异常）；堆上的值移动时只转移指针
+template <typename T> void Move(void * dst, void * src) noexcept {
+    T * from = static_cast<T *>(src);
+    ::new (dst) T(std::move(*from));
+    from->~T();
+}
+
+template <typename T> void Destroy(void * p) noexcept {
+    static_cast<T *>(p)->~T();
+}
+
+} // namespace any_detail
+
+// 函数内静态变量：保证在第一次使用时初始化，静态初始化期间使用也安全
+template <typename T> const AnyTypeInfo & TypeInfoOf() {
+    static_assert(std::is_same_v<T, std::decay_t<T>>, "use the decayed type");
+    static_assert(std::is_copy_constructible_v<T>, "any requires copyable types");
+    static const AnyTypeInfo info = {
+        any_detail::NextTypeIndex(),
+        static_cast<uint32_t>(sizeof(T)),
+        static_cast<uint32_t>(alignof(T)),
+        std::is_nothrow_move_constructible_v<T>,
+        typeid(T).name(),
+        &any_detail::Copy<T>,
+        &any_detail::Move<T>,
+        &any_detail::Destroy<T>,
+    };
+    return info;
+}
+
+// 类型擦除后的只读引用：类型描述符 + 值的地址。BasicAny 和 AnyVector 的元素都可以转成它
+class AnyRef {
+  public:
+    AnyRef() = default;
+
+    AnyRef(const AnyTypeInfo * info, const void * data) : info_(info), data_(data) {}
+
+    bool has_value() const { return info_ != nullptr; }
+
+    const AnyTypeInfo * info() const { return info_; }
+
+    const void * data() const { return data_; }
+
+    template <typename T> bool Is() const { return info_ == &TypeInfoOf<T>(); }
+
+    template <typename T> const T * Get() const {
+        return Is<T>() ? static_cast<const T *>(data_) : nullptr;
+    }
+
+  private:
+    const AnyTypeInfo * info_ = nullptr;
+    const void *        data_ = nullptr;
+};
+
+// ============================================================================
+// 2. BasicAny - 可配置内联缓冲区的 any
+// ============================================================================
+
+template <size_t kInlineSize> class BasicAny {
+    static_assert(kInlineSize >= sizeof(void *), "buffer must hold at least a pointer");
+
+  public:
+    // 8 字节对齐：sizeof(Any) = 40；16 字节对齐的类型（long double 等）放到堆上
+    static constexpr size_t kInlineAlign = 8;
+
+    // 编译期可知：T 的值是否直接放在缓冲区里
+    template <typename T>
+    static constexpr bool kStoresInline = sizeof(T) <= kInlineSize && alignof(T) <= kInlineAlign &&
+                                          std::is_nothrow_move_constructible_v<T>;
+
+    BasicAny() = default;
+
+    template <typename T, typename D = std::decay_t<T>,
+              typename = std::enable_if_t<!std::is_same_v<D, BasicAny>>>
+    BasicAny(T && value) {
+        Construct<D>(std::forward<T>(value));
+    }
+
+    BasicAny(const BasicAny & other) { CopyFrom(other); }
+
+    BasicAny(BasicAny && other) noexcept { MoveFrom(other); }
+
+    BasicAny & operator=(const BasicAny & other) {
+        if (this != &other) {
+            BasicAny copy(other); // 先拷贝再交换：拷贝抛异常时 *this 不变
+            Reset();
+            MoveFrom(copy);
+        }
+        return *this;
+    }
+
+    BasicAny & operator=(BasicAny && other) noexcept {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    template <typename T, typename D = std::decay_t<T>,
+              typename = std::enable_if_t<!std::is_same_v<D, BasicAny>>>
+    BasicAny & operator=(T && value) {
+        Emplace<D>(std::forward<T>(value));
+        return *this;
+    }
+
+    ~BasicAny() { Reset(); }
+
+    template <typename T, typename... Args> T & Emplace(Args &&... args) {
+        Reset();
+        Construct<T>(std::forward<Args>(args)...);
+        return *static_cast<T *>(data());
+    }
+
+    void Reset() {
+        if (info_ != nullptr) {
+            if (IsInline(*info_)) {
+                info_->destroy(buffer_);
+            } else {
+                void * p = HeapPointer();
+                info_->destroy(p);
+                any_detail::Deallocate(p, info_->align);
+            }
+            info_ = nullptr;
+        }
+    }
+
+    bool has_value() const { return info_ != nullptr; }
+
+    // 空时返回 nullptr
+    const AnyTypeInfo * type() const { return info_; }
+
+    template <typename T> bool Is() const { return info_ == &TypeInfoOf<T>(); }
+
+    bool is_inline() const { return info_ != nullptr && IsInline(*info_); }
+
+    void * data() {
+        if (info_ == nullptr) {
+            return nullptr;
+        }
+        return IsInline(*info_) ? static_cast<void *>(buffer_) : HeapPointer();
+    }
+
+    const void * data() const { return const_cast<BasicAny *>(this)->data(); }
+
+    // 已知类型时的快速路径：存储位置在编译期确定，不需要运行时判断
+    template <typename T> T & GetUnchecked() {
+        if constexpr (kStoresInline<T>) {
+            return *std::launder(reinterpret_cast<T *>(buffer_));
+        } else {
+            return *static_cast<T *>(HeapPointer());
+        }
+    }
+
+    template <typename T> const T & GetUnchecked() const {
+        return const_cast<BasicAny *>(this)->GetUnchecked<T>();
+    }
+
+    operator AnyRef() const { return AnyRef(info_, data()); }
+
+  private:
+    static bool IsInline(const AnyTypeInfo & info) {
+        return info.size <= kInlineSize && info.align <= kInlineAlign && info.nothrow_move;
+    }
+
+    void * HeapPointer() const {
+        void * p;
+        std::memcpy(&p, buffer_, sizeof(p));
+        return p;
+    }
+
+    template <typename T, typename... Args> void Construct(Args &&... args) {
+        if constexpr (kStoresInline<T>) {
+            ::new (static_cast<void *>(buffer_)) T(std::forward<Args>(args)...);
+        } else {
+            void * p = any_detail::Allocate(sizeof(T), alignof(T));
+            try {
+                ::new (p) T(std::forward<Args>(args)...);
+            } catch (...) {
+                any_detail::Deallocate(p, alignof(T));
+                throw;
+            }
+            std::memcpy(buffer_, &p, sizeof(p));
+        }
+        info_ = &TypeInfoOf<T>();
+    }
+
+    void CopyFrom(const BasicAny & other) {
+        const AnyTypeInfo * info = other.info_;
+        if (info == nullptr) {
+            return;
+        }
+        if (IsInline(*info)) {
+            info->copy(buffer_, other.buffer_);
+        } else {
+            void * p = any_detail::Allocate(info->size, info->align);
+            try {
+                info->copy(p, other.HeapPointer());
+            } catch (...) {
+                any_detail::Deallocate(p, info->align);
+                throw;
+            }
+            std::memcpy(buffer_, &p, sizeof(p));
+        }
+        info_ = info;
+    }
+
+    // 内联值逐个移动构造；堆上的值只转移指针
+    void MoveFrom(BasicAny & other) noexcept {
+        const AnyTypeInfo * info = other.info_;
+        if (info == nullptr) {
+            return;
+        }
+        if (IsInline(*info)) {
+            info->move(buffer_, other.buffer_);
+        } else {
+            std::memcpy(buffer_, other.buffer_, sizeof(void *));
+        }
+        info_       = info;
+        other.info_ = nullptr;
+    }
+
+    alignas(kInlineAlign) unsigned char buffer_[kInlineSize];
+    const AnyTypeInfo *                 info_ = nullptr;
+};
+
+// 32 字节缓冲区：可以内联存放 std::string、std::vector、三维向量等常见属性值
+using Any = BasicAny<32>;
+
+// 与 std::any_cast 相同的约定：指针版本类型不符返回 nullptr，引用版本抛 std::bad_any_cast
+template <typename T, size_t N> T * AnyCast(BasicAny<N> * any) {
+    return any != nullptr && any->template Is<T>() ? &any->template GetUnchecked<T>() : nullptr;
+}
+
+template <typename T, size_t N> const T * AnyCast(const BasicAny<N> * any) {
+    return any != nullptr && any->template Is<T>() ? &any->template GetUnchecked<T>() : nullptr;
+}
+
+template <typename T, size_t N> const T & AnyCast(const BasicAny<N> & any) {
+    if (!any.template Is<T>()) {
+        throw std::bad_any_cast();
+    }
+    return any.template GetUnchecked<T>();
+}
+
+// ============================================================================
+// 3. AnyVisitorRegistry - 按类型编号索引的处理函数表
+// ============================================================================
+
+template <typename Signature> class AnyVisitorRegistry;
+
+/**
+ * 为每种类型登记一个处理函数，Visit 时用值的类型编号直接取表项：
+ * 不论登记了多少类型，分派都是一次数组访问加一次间接调用。
+ * 登记应在启动阶段完成；登记与 Visit 并发时需要调用者自行同步。
+ */
+template <typename R, typename... Args> class AnyVisitorRegistry<R(Args...)> {
+  public:
+    template <typename T> using Handler = R (*)(const T &, Args...);
+
+    using Fallback = R (*)(AnyRef, Args...);
+
+    explicit AnyVisitorRegistry(Fallback fallback = nullptr) : fallback_(fallback) {}
+
+    // 接受函数指针或无捕获的 lambda
+    template <typename T, typename F> void Register(F handler) {
+        Handler<T>          fn   = handler;
+        const AnyTypeInfo & info = TypeInfoOf<T>();
+        if (entries_.size() <= info.index) {
+            entries_.resize(info.index + 1);
+        }
+        entries_[info.index] = { reinterpret_cast<void (*)()>(fn), &Thunk<T> };
+    }
+
+    template <typename T> bool Contains() const {
+        uint32_t index = TypeInfoOf<T>().index;
+        return index < entries_.size() && entries_[index].thunk != nullptr;
+    }
+
+    /**
+     * 调用 value 类型对应的处理函数。
+     * 空值或未登记的类型交给 fallback；没有 fallback 时抛 std::bad_any_cast。
+     */
+    R Visit(AnyRef value, Args... args) const {
+        const AnyTypeInfo * info = value.info();
+        if (info != nullptr && info->index < entries_.size()) {
+            const Entry & entry = entries_[info->index];
+            if (entry.thunk != nullptr) {
+                return entry.thunk(entry.fn, value.data(), std::forward<Args>(args)...);
+            }
+        }
+        if (fallback_ != nullptr) {
+            return fallback_(value, std::forward<Args>(args)...);
+        }
+        throw std::bad_any_cast();
+    }
+
+  private:
+    using ThunkFn = R (*)(void (*)(), const void *, Args...);
+
+    struct Entry {
+        void (*fn)()  = nullptr;
+        ThunkFn thunk = nullptr;
+    };
+
+    template <typename T> static R Thunk(void (*fn)(), const void * data, Args... args) {
+        return reinterpret_cast<Handler<T>>(fn)(*static_cast<const T *>(data),
+                                                std::forward<Args>(args)...);
+    }
+
+    std::vector<Entry> entries_;
+    Fallback           fallback_;
+};
+
+/**
+ * 格式化器：把值追加到 fmt::memory_buffer。
+ * Register<T>() 使用 fmt 对 T 的默认格式化；也可以传入自定义函数。
+ */
+class AnyFormatter {
+  public:
+    AnyFormatter() : registry_(&FormatUnknown) {}
+
+    template <typename T> void Register() {
+        registry_.Register<T>([](const T & value, fmt::memory_buffer & out) {
+            fmt::format_to(std::back_inserter(out), "{}", value);
+        });
+    }
+
+    template <typename T, typename F> void Register(F handler) {
+        registry_.Register<T>(handler);
+    }
+
+    void Format(AnyRef value, fmt::memory_buffer & out) const { registry_.Visit(value, out); }
+
+    std::string ToString(AnyRef value) const {
+        fmt::memory_buffer out;
+        Format(value, out);
+        return fmt::to_string(out);
+    }
+
+  private:
+    static void FormatUnknown(AnyRef value, fmt::memory_buffer & out) {
+        if (value.has_value()) {
+            fmt::format_to(std::back_inserter(out), "<{}>", value.info()->name);
+        } else {
+            fmt::format_to(std::back_inserter(out), "<empty>");
+        }
+    }
+
+    AnyVisitorRegistry<void(fmt::memory_buffer &)> registry_;
+};
+
+// ============================================================================
+// 4. AnyVector - 值连续存放的异构数组
+// ============================================================================
+
+/**
+ * 每个元素占一个 16 字节槽位（类型描述符 + 在数据区中的偏移），
+ * 值按自身对齐紧凑地追加到一块连续的数据区中：int 只占 4 字节，而不是一个完整的 any。
+ * 超过 kInlineLimit 字节、对齐超过 max_align_t 或移动可能抛异常的值放在堆上，数据区只存指针。
+ * 数据区扩容时逐个移动构造到新内存（偏移不变）；扩容后之前取得的指针失效。
+ */
+class AnyVector {
+  public:
+    static constexpr size_t kInlineLimit = 64;
+    static constexpr size_t kArenaAlign  = alignof(std::max_align_t);
+
+    AnyVector() = default;
+
+    AnyVector(const AnyVector & other) {
+        Reserve(other.slots_.size(), other.used_);
+        for (size_t i = 0; i < other.slots_.size(); ++i) {
+            const Slot & slot = other.slots_[i];
+            Append(*slot.info, slot.heap,
+                   [&](void * dst) { slot.info->copy(dst, other.data(i)); });
+        }
+    }
+
+    AnyVector(AnyVector && other) noexcept
+        : slots_(std::move(other.slots_)),
+          arena_(std::exchange(other.arena_, nullptr)),
+          used_(std::exchange(other.used_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)) {
+        other.slots_.clear();
+    }
+
+    AnyVector & operator=(AnyVector other) noexcept {
+        Swap(other);
+        return *this;
+    }
+
+    ~AnyVector() {
+        Clear();
+        any_detail::Deallocate(arena_, kArenaAlign);
+    }
+
+    void Swap(AnyVector & other) noexcept {
+        slots_.swap(other.slots_);
+        std::swap(arena_, other.arena_);
+        std::swap(used_, other.used_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    template <typename T, typename... Args> T & EmplaceBack(Args &&... args) {
+        constexpr bool kHeap = !(sizeof(T) <= kInlineLimit && alignof(T) <= kArenaAlign &&
+                                 std::is_nothrow_move_constructible_v<T>);
+        void * p = Append(TypeInfoOf<T>(), kHeap, [&](void * dst) {
+            ::new (dst) T(std::forward<Args>(args)...);
+        });
+        return *static_cast<T *>(p);
+    }
+
+    template <typename T> void PushBack(T && value) {
+        EmplaceBack<std::decay_t<T>>(std::forward<T>(value));
+    }
+
+    // 预留元素个数与数据区字节数
+    void Reserve(size_t elements, size_t bytes) {
+        slots_.reserve(elements);
+        if (bytes > capacity_) {
+            Grow(bytes);
+        }
+    }
+
+    void Clear() {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            DestroyAt(i);
+        }
+        slots_.clear();
+        used_ = 0;
+    }
+
+    size_t size() const { return slots_.size(); }
+
+    bool empty() const { return slots_.empty(); }
+
+    // 数据区已使用的字节数（不含堆上的值）
+    size_t arena_bytes() const { return used_; }
+
+    const AnyTypeInfo * type(size_t i) const { return slots_[i].info; }
+
+    template <typename T> bool Is(size_t i) const { return slots_[i].info == &TypeInfoOf<T>(); }
+
+    const void * data(size_t i) const {
+        const Slot & slot = slots_[i];
+        void *       p    = arena_ + slot.offset;
+        if (slot.heap) {
+            std::memcpy(&p, p, sizeof(p));
+        }
+        return p;
+    }
+
+    template <typename T> const T * Get(size_t i) const {
+        return Is<T>(i) ? static_cast<const T *>(data(i)) : nullptr;
+    }
+
+    template <typename T> T * Get(size_t i) {
+        return const_cast<T *>(static_cast<const AnyVector *>(this)->Get<T>(i));
+    }
+
+    AnyRef operator[](size_t i) const { return AnyRef(slots_[i].info, data(i)); }
+
+  private:
+    struct Slot {
+        const AnyTypeInfo * info;
+        uint32_t            offset;
+        bool                heap;
+    };
+
+    // 在数据区末尾（或堆上）为一个 info 类型的值分配空间，由 construct 在给定地址构造
+    template <typename Construct>
+    void * Append(const AnyTypeInfo & info, bool heap, Construct construct) {
+        size_t align  = heap ? alignof(void *) : info.align;
+        size_t bytes  = heap ? sizeof(void *) : info.size;
+        size_t offset = (used_ + align - 1) & ~(align - 1);
+        if (offset + bytes > capacity_) {
+            Grow(std::max(offset + bytes, capacity_ * 2));
+        }
+        if (offset > UINT32_MAX) {
+            throw std::length_error("AnyVector arena exceeds 4 GiB");
+        }
+        slots_.reserve(slots_.size() + 1); // 先保证槽位可用，构造成功后不会再抛异常
+
+        void * slot_address = arena_ + offset;
+        void * value        = slot_address;
+        if (heap) {
+            value = any_detail::Allocate(info.size, info.align);
+            try {
+                construct(value);
+            } catch (...) {
+                any_detail::Deallocate(value, info.align);
+                throw;
+            }
+            std::memcpy(slot_address, &value, sizeof(value));
+        } else {
+            construct(value);
+        }
+        slots_.push_back({ &info, static_cast<uint32_t>(offset), heap });
+        used_ = offset + bytes;
+        return value;
+    }
+
+    // 新数据区中偏移不变：内联值逐个移动构造，堆上的值只复制指针
+    void Grow(size_t min_capacity) {
+        size_t capacity  = std::max<size_t>(min_capacity, 256);
+        auto * new_arena =
+            static_cast<unsigned char *>(any_detail::Allocate(capacity, kArenaAlign));
+        for (const Slot & slot : slots_) {
+            if (slot.heap) {
+                std::memcpy(new_arena + slot.offset, arena_ + slot.offset, sizeof(void *));
+            } else {
+                slot.info->move(new_arena + slot.offset, arena_ + slot.offset);
+            }
+        }
+        any_detail::Deallocate(arena_, kArenaAlign);
+        arena_    = new_arena;
+        capacity_ = capacity;
+    }
+
+    void DestroyAt(size_t i) {
+        const Slot & slot = slots_[i];
+        void *       p    = const_cast<void *>(data(i));
+        slot.info->destroy(p);
+        if (slot.heap) {
+            any_detail::Deallocate(p, slot.info->align);
+        }
+    }
+
+    std::vector<Slot> slots_;
+    unsigned char *   arena_    = nullptr;
+    size_t            used_     = 0;
+    size_t            capacity_ = 0;
+};
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+#endif // CPP_QA_LAB_CSRC_BASIC_SMALL_ANY_H_
@@ -0,0 +1,350 @@
+// Copyright 2025 The cpp-qa-lab Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// 属性包基准测试：std::any vs Any（小缓冲区）vs AnyVector（连续存储）
+//
+// 用法: small_any_benchmark [属性个数]
+//
+// 属性值随机取 int / double / std::string / Point / Point3 五种类型，对比：
+// 1. 构造：逐个放入 std::vector<std::any> / std::vector<Any> / AnyVector
+// 2. 拷贝：整个容器拷贝一次
+// 3. 访问：对每个值求一个 double（std::any 用 any_cast 链，Any 用类型编号索引的注册表）
+// 4. 格式化：每个值格式化到同一个 fmt::memory_buffer
+// 同时统计每个阶段的堆分配次数（本文件替换了全局 operator new）
+
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "microbench.h"
+#include "small_any.h"
+
+// 统计堆分配次数；只替换不带对齐参数的版本（本测试中的类型都不超过默认对齐）。
+// std::any / std::string 直接走全局 operator new，所以计数只能放在这里；
+// 真正的 malloc/free 放在不内联的函数里，否则 GCC 内联 delete 后会把
+// operator new 返回的指针交给 free 判为不匹配（-Wmismatched-new-delete）
+static size_t g_allocations = 0;
+
+[[gnu::noinline]] static void * CountedAllocate(size_t size) {
+    ++g_allocations;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+[[gnu::noinline]] static void CountedRelease(void * p) noexcept {
+    std::free(p);
+}
+
+void * operator new(size_t size) {
+    if (void * p = CountedAllocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept {
+    CountedRelease(p);
+}
+
+void operator delete(void * p, size_t) noexcept {
+    CountedRelease(p);
+}
+
+namespace cpp_qa_lab {
+namespace basic {
+
+// any_example.cpp 中的 Point，以及一个放不进 std::any 内联缓冲区的 Point3
+struct Point {
+    int x;
+    int y;
+};
+
+struct Point3 {
+    double x, y, z;
+};
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+template <> struct fmt::formatter<cpp_qa_lab::basic::Point> : fmt::formatter<int> {
+    template <typename FormatContext>
+    auto format(const cpp_qa_lab::basic::Point & p, FormatContext & ctx) const {
+        return fmt::format_to(ctx.out(), "({}, {})", p.x, p.y);
+    }
+};
+
+namespace cpp_qa_lab {
+namespace basic {
+
+// 取最快一次的耗时；*allocations 记录最后一次运行的堆分配次数
+template <typename Body>
+double TimeCounting(microbench::Report & report, std::string name, size_t * allocations,
+                    Body body) {
+    return report.Time(std::move(name), [&] {
+        size_t before = g_allocations;
+        body();
+        *allocations = g_allocations - before;
+    });
+}
+
+// std::any 的写法：依次尝试每一种类型
+double ToDoubleChain(const std::any & value) {
+    if (const int * i = std::any_cast<int>(&value)) {
+        return *i;
+    }
+    if (const double * d = std::any_cast<double>(&value)) {
+        return *d;
+    }
+    if (const std::string * s = std::any_cast<std::string>(&value)) {
+        return static_cast<double>(s->size());
+    }
+    if (const Point * p = std::any_cast<Point>(&value)) {
+        return p->x + p->y;
+    }
+    if (const Point3 * p = std::any_cast<Point3>(&value)) {
+        return p->x + p->y + p->z;
+    }
+    return 0;
+}
+
+void FormatChain(const std::any & value, fmt::memory_buffer & out) {
+    if (const int * i = std::any_cast<int>(&value)) {
+        fmt::format_to(std::back_inserter(out), "{}", *i);
+    } else if (const double * d = std::any_cast<double>(&value)) {
+        fmt::format_to(std::back_inserter(out), "{}", *d);
+    } else if (const std::string * s = std::any_cast<std::string>(&value)) {
+        fmt::format_to(std::back_inserter(out), "{}", *s);
+    } else if (const Point * p = std::any_cast<Point>(&value)) {
+        fmt::format_to(std::back_inserter(out), "{}", *p);
+    } else if (const Point3 * p = std::any_cast<Point3>(&value)) {
+        fmt::format_to(std::back_inserter(out), "[{}, {}, {}]", p->x, p->y, p->z);
+    }
+}
+
+AnyVisitorRegistry<double()> MakeToDouble() {
+    AnyVisitorRegistry<double()> registry([](AnyRef) { return 0.0; });
+    registry.Register<int>([](const int & i) { return static_cast<double>(i); });
+    registry.Register<double>([](const double & d) { return d; });
+    registry.Register<std::string>(
+        [](const std::string & s) { return static_cast<double>(s.size()); });
+    registry.Register<Point>([](const Point & p) { return static_cast<double>(p.x + p.y); });
+    registry.Register<Point3>([](const Point3 & p) { return p.x + p.y + p.z; });
+    return registry;
+}
+
+AnyFormatter MakeFormatter() {
+    AnyFormatter formatter;
+    formatter.Register<int>();
+    formatter.Register<double>();
+    formatter.Register<std::string>();
+    formatter.Register<Point>();
+    formatter.Register<Point3>([](const Point3 & p, fmt::memory_buffer & out) {
+        fmt::format_to(std::back_inserter(out), "[{}, {}, {}]", p.x, p.y, p.z);
+    });
+    return formatter;
+}
+
+// 预先生成的属性值：构造阶段只计入容器本身的开销（拷贝值 + 存储），不含随机数与字符串生成
+struct Source {
+    explicit Source(size_t n) {
+        std::mt19937                       rng(11);
+        std::uniform_int_distribution<int> kind(0, 4);
+        for (size_t i = 0; i < n; ++i) {
+            int v = static_cast<int>(i % 1000);
+            int k = kind(rng);
+            kinds.push_back(k);
+            switch (k) {
+                case 0:
+                    ints.push_back(v);
+                    break;
+                case 1:
+                    doubles.push_back(v * 0.5);
+                    break;
+                case 2:
+                    strings.push_back("prop-" + std::to_string(v)); // 短字符串，SSO 不分配
+                    break;
+                case 3:
+                    points.push_back(Point{ v, -v });
+                    break;
+                default:
+                    points3.push_back(Point3{ 1.0, 2.0, static_cast<double>(v) });
+                    break;
+            }
+        }
+    }
+
+    // 按生成顺序把每个值（const 引用）交给 sink
+    template <typename Sink> void ForEach(Sink sink) const {
+        size_t next[5] = {};
+        for (int k : kinds) {
+            switch (k) {
+                case 0:
+                    sink(ints[next[0]++]);
+                    break;
+                case 1:
+                    sink(doubles[next[1]++]);
+                    break;
+                case 2:
+                    sink(strings[next[2]++]);
+                    break;
+                case 3:
+                    sink(points[next[3]++]);
+                    break;
+                default:
+                    sink(points3[next[4]++]);
+                    break;
+            }
+        }
+    }
+
+    std::vector<int>         kinds;
+    std::vector<int>         ints;
+    std::vector<double>      doubles;
+    std::vector<std::string> strings;
+    std::vector<Point>       points;
+    std::vector<Point3>      points3;
+};
+
+void PrintRow(const char * name, size_t n, double seconds, size_t allocations) {
+    fmt::print("  {:<26} {:>10.2f} {:>14.2f}\n", name, seconds / static_cast<double>(n) * 1e9,
+               static_cast<double>(allocations) / static_cast<double>(n));
+}
+
+void RunBenchmark(microbench::Report & report, size_t n) {
+    fmt::print("sizeof: std::any {} 字节, Any {} 字节 (内联缓冲区 {} 字节)\n", sizeof(std::any),
+               sizeof(Any), 32);
+    fmt::print("  std::string 放在 Any 内联缓冲区: {}, Point3: {}\n\n",
+               Any::kStoresInline<std::string>, Any::kStoresInline<Point3>);
+
+    Source                source(n);
+    size_t                a_construct = 0, b_construct = 0, c_construct = 0;
+    std::vector<std::any> std_values;
+    std::vector<Any>      any_values;
+    AnyVector             packed;
+
+    double t_std_construct = TimeCounting(report, "construct/std_any", &a_construct, [&] {
+        std_values.clear();
+        std_values.reserve(n);
+        source.ForEach([&](const auto & v) { std_values.emplace_back(v); });
+    });
+    double t_any_construct = TimeCounting(report, "construct/any", &b_construct, [&] {
+        any_values.clear();
+        any_values.reserve(n);
+        source.ForEach([&](const auto & v) { any_values.emplace_back(v); });
+    });
+    double t_vec_construct = TimeCounting(report, "construct/any_vector", &c_construct, [&] {
+        packed.Clear();
+        packed.Reserve(n, n * 24);
+        source.ForEach([&](const auto & v) { packed.PushBack(v); });
+    });
+
+    fmt::print("[1] 构造（从预先生成的值拷贝）\n");
+    fmt::print("  {:<26} {:>10} {:>14}\n", "容器", "ns/个", "堆分配/个");
+    PrintRow("std::vector<std::any>", n, t_std_construct, a_construct);
+    PrintRow("std::vector<Any>", n, t_any_construct, b_construct);
+    PrintRow("AnyVector", n, t_vec_construct, c_construct);
+    fmt::print("  AnyVector 数据区 {:.1f} 字节/个 + 槽位 16 字节/个\n\n",
+               static_cast<double>(packed.arena_bytes()) / static_cast<double>(n));
+
+    fmt::print("[2] 拷贝整个容器\n");
+    size_t a_copy = 0, b_copy = 0, c_copy = 0;
+    double t_std_copy = TimeCounting(report, "copy/std_any", &a_copy, [&] {
+        std::vector<std::any> copy(std_values);
+        g_allocations += copy.size() == n ? 0 : 1;
+    });
+    double t_any_copy = TimeCounting(report, "copy/any", &b_copy, [&] {
+        std::vector<Any> copy(any_values);
+        g_allocations += copy.size() == n ? 0 : 1;
+    });
+    double t_vec_copy = TimeCounting(report, "copy/any_vector", &c_copy, [&] {
+        AnyVector copy(packed);
+        g_allocations += copy.size() == n ? 0 : 1;
+    });
+    PrintRow("std::vector<std::any>", n, t_std_copy, a_copy);
+    PrintRow("std::vector<Any>", n, t_any_copy, b_copy);
+    PrintRow("AnyVector", n, t_vec_copy, c_copy);
+
+    fmt::print("\n[3] 访问：把每个值转成 double 求和\n");
+    AnyVisitorRegistry<double()> to_double = MakeToDouble();
+    double                       sum_std = 0, sum_any = 0, sum_vec = 0;
+    size_t                       unused  = 0;
+
+    double t_std_visit = TimeCounting(report, "visit/std_any", &unused, [&] {
+        sum_std = 0;
+        for (const std::any & v : std_values) {
+            sum_std += ToDoubleChain(v);
+        }
+    });
+    double t_any_visit = TimeCounting(report, "visit/any", &unused, [&] {
+        sum_any = 0;
+        for (const Any & v : any_values) {
+            sum_any += to_double.Visit(v);
+        }
+    });
+    double t_vec_visit = TimeCounting(report, "visit/any_vector", &unused, [&] {
+        sum_vec = 0;
+        for (size_t i = 0; i < packed.size(); ++i) {
+            sum_vec += to_double.Visit(packed[i]);
+        }
+    });
+    PrintRow("any_cast 链", n, t_std_visit, 0);
+    PrintRow("Any + 注册表", n, t_any_visit, 0);
+    PrintRow("AnyVector + 注册表", n, t_vec_visit, 0);
+    fmt::print("  结果一致: {}\n", sum_std == sum_any && sum_std == sum_vec ? "yes" : "NO");
+
+    fmt::print("\n[4] 格式化到 fmt::memory_buffer\n");
+    AnyFormatter       formatter = MakeFormatter();
+    fmt::memory_buffer out_std, out_any, out_vec;
+    out_std.reserve(n * 16);
+    out_any.reserve(n * 16);
+    out_vec.reserve(n * 16);
+    size_t a_format = 0, b_format = 0, c_format = 0;
+    double t_std_format = TimeCounting(report, "format/std_any", &a_format, [&] {
+        out_std.clear();
+        for (const std::any & v : std_values) {
+            FormatChain(v, out_std);
+        }
+    });
+    double t_any_format = TimeCounting(report, "format/any", &b_format, [&] {
+        out_any.clear();
+        for (const Any & v : any_values) {
+            formatter.Format(v, out_any);
+        }
+    });
+    double t_vec_format = TimeCounting(report, "format/any_vector", &c_format, [&] {
+        out_vec.clear();
+        for (size_t i = 0; i < packed.size(); ++i) {
+            formatter.Format(packed[i], out_vec);
+        }
+    });
+    PrintRow("any_cast 链", n, t_std_format, a_format);
+    PrintRow("AnyFormatter(Any)", n, t_any_format, b_format);
+    PrintRow("AnyFormatter(AnyVector)", n, t_vec_format, c_format);
+    bool same = fmt::to_string(out_std) == fmt::to_string(out_any) &&
+                fmt::to_string(out_std) == fmt::to_string(out_vec);
+    fmt::print("  结果一致: {} (前 3 个值: {}, {}, {})\n\n", same ? "yes" : "NO",
+               formatter.ToString(packed[0]), formatter.ToString(packed[1]),
+               formatter.ToString(packed[2]));
+}
+
+} // namespace basic
+} // namespace cpp_qa_lab
+
+int main(int argc, char * argv[]) {
+    microbench::Report report(argc, argv);
+    size_t             n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+    spdlog::info("小缓冲区 any 基准测试");
+    spdlog::info("=====================================");
+    cpp_qa_lab::basic::RunBenchmark(report, std::max<size_t>(3, n));
+
+    spdlog::info("关键学习点：");
+    spdlog::info("1. 内联缓冲区足够大时，常见属性值（字符串、小结构体）构造/拷贝都不分配内存");
+    spdlog::info("2. 类型编号索引的注册表：分派代价与登记了多少类型无关，不再逐个 any_cast");
+    spdlog::info("3. AnyVector 把值紧凑地放在一块连续内存里，遍历时顺序访问");
+    spdlog::info("4. 已知类型时 GetUnchecked<T> 在编译期确定存储位置，没有运行时分支");
+    return report.Finish();
+}
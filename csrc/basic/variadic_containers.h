@@ -0,0 +1,467 @@
+// ============================================================================
+// PackedTuple / FastVariant - variadic_examples.cpp 中 SimpleTuple / SimpleVariant 的生产版本
+// ============================================================================
+// SimpleTuple 按声明顺序递归继承存储成员，<char, double, char> 会在两个 char 后各填充
+// 7 个字节；SimpleVariant 只是示意，没有存储也没有访问方式。本文件提供：
+//
+//   - PackedTuple<Ts...>  : 编译期按对齐从大到小重排成员，消除内部填充；
+//                           对外仍按声明顺序编号，Get<I>() 的 I 与 std::get 一致
+//   - FastVariant<Ts...>  : 存储 + 最小的索引类型；Visit 通过编译期生成的函数指针表
+//                           一次间接调用完成分派，支持同时访问多个 variant
+// ============================================================================
+
+#ifndef CPP_QA_LAB_CSRC_BASIC_VARIADIC_CONTAINERS_H_
+#define CPP_QA_LAB_CSRC_BASIC_VARIADIC_CONTAINERS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace cpp_variadic {
+
+// ----------------------------------------------------------------------------
+// 1. 类型列表工具
+// ----------------------------------------------------------------------------
+
+// 参数包中第 I 个类型
+template <std::size_t I, typename... Ts> using NthType = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+// T 在参数包中的位置；不存在或出现多次时为 sizeof...(Ts)
+template <typename T, typename... Ts> constexpr std::size_t IndexOf() {
+    constexpr bool matches[] = { std::is_same_v<T, Ts>..., false };
+    std::size_t    index     = sizeof...(Ts);
+    std::size_t    count     = 0;
+    for (std::size_t i = 0; i < sizeof...(Ts); ++i) {
+        if (matches[i]) {
+            index = i;
+            ++count;
+        }
+    }
+    return count == 1 ? index : sizeof...(Ts);
+}
+
+// ----------------------------------------------------------------------------
+// 2. PackedTuple - 按对齐重排的元组
+// ----------------------------------------------------------------------------
+
+namespace tuple_detail {
+
+// 存储顺序：按 alignof 从大到小稳定排序（插入排序，编译期执行）
+// 返回 order[slot] = 声明序号
+template <typename... Ts> constexpr std::array<std::size_t, sizeof...(Ts)> StorageOrder() {
+    constexpr std::size_t                  kAlign[] = { alignof(Ts)..., 0 };
+    std::array<std::size_t, sizeof...(Ts)> order{};
+    for (std::size_t i = 0; i < sizeof...(Ts); ++i) {
+        std::size_t j = i;
+        while (j > 0 && kAlign[order[j - 1]] < kAlign[i]) {
+            order[j] = order[j - 1];
+            --j;
+        }
+        order[j] = i;
+    }
+    return order;
+}
+
+// 反向映射：slot[声明序号] = 存储位置
+template <typename... Ts> constexpr std::array<std::size_t, sizeof...(Ts)> StorageSlot() {
+    constexpr auto                         order = StorageOrder<Ts...>();
+    std::array<std::size_t, sizeof...(Ts)> slot{};
+    for (std::size_t s = 0; s < sizeof...(Ts); ++s) {
+        slot[order[s]] = s;
+    }
+    return slot;
+}
+
+// 每个成员包在一个以存储位置编号的叶子里；多重继承时基类按声明顺序布局
+template <std::size_t Slot, typename T> struct Leaf {
+    Leaf() = default;
+
+    template <typename Arg>
+    Leaf(std::in_place_t, Arg && arg) : value(std::forward<Arg>(arg)) {}
+
+    T value;
+};
+
+template <typename Slots, typename... Ts> struct Storage;
+
+template <std::size_t... Slots, typename... Ts>
+struct Storage<std::index_sequence<Slots...>, Ts...>
+    : Leaf<Slots, NthType<StorageOrder<Ts...>()[Slots], Ts...>>... {
+    Storage() = default;
+
+    // refs 是按声明顺序的参数引用元组；每个叶子直接用对应参数构造，
+    // 成员类型不需要默认构造或赋值
+    template <typename Refs>
+    Storage(std::in_place_t, Refs && refs) :
+        Leaf<Slots, NthType<StorageOrder<Ts...>()[Slots], Ts...>>(
+            std::in_place, std::get<StorageOrder<Ts...>()[Slots]>(std::move(refs)))... {}
+};
+
+// 单个参数且就是 PackedTuple 本身时，应当走拷贝/移动构造而不是逐成员构造
+template <typename Self, typename... Args> constexpr bool kIsSelf = false;
+
+template <typename Self, typename Arg>
+constexpr bool kIsSelf<Self, Arg> = std::is_same_v<std::decay_t<Arg>, Self>;
+
+} // namespace tuple_detail
+
+template <typename... Ts> class PackedTuple {
+    static constexpr auto kSlot = tuple_detail::StorageSlot<Ts...>();
+
+    using StorageType = tuple_detail::Storage<std::make_index_sequence<sizeof...(Ts)>, Ts...>;
+
+  public:
+    static constexpr std::size_t kSize = sizeof...(Ts);
+
+    PackedTuple() = default;
+
+    // 参数按声明顺序给出，内部放到重排后的位置
+    template <typename... Args,
+              typename = std::enable_if_t<sizeof...(Args) == sizeof...(Ts) && (sizeof...(Ts) > 0) &&
+                                          !tuple_detail::kIsSelf<PackedTuple, Args...>>>
+    explicit PackedTuple(Args &&... args) :
+        storage_(std::in_place, std::forward_as_tuple(std::forward<Args>(args)...)) {}
+
+    // 按声明序号访问
+    template <std::size_t I> NthType<I, Ts...> & Get() & {
+        return LeafOf<I>(storage_).value;
+    }
+
+    template <std::size_t I> const NthType<I, Ts...> & Get() const & {
+        return LeafOf<I>(storage_).value;
+    }
+
+    template <std::size_t I> NthType<I, Ts...> && Get() && {
+        return std::move(LeafOf<I>(storage_).value);
+    }
+
+    // 第 I 个成员在对象中的字节偏移（演示重排效果）
+    template <std::size_t I> static std::size_t OffsetOf() {
+        static const PackedTuple probe{};
+        return static_cast<std::size_t>(reinterpret_cast<const char *>(&probe.Get<I>()) -
+                                        reinterpret_cast<const char *>(&probe));
+    }
+
+    friend bool operator==(const PackedTuple & lhs, const PackedTuple & rhs) {
+        return Equal(lhs, rhs, std::index_sequence_for<Ts...>{});
+    }
+
+    friend bool operator!=(const PackedTuple & lhs, const PackedTuple & rhs) {
+        return !(lhs == rhs);
+    }
+
+  private:
+    template <std::size_t I, typename S> static auto & LeafOf(S & storage) {
+        using Leaf = tuple_detail::Leaf<kSlot[I], NthType<I, Ts...>>;
+        using Base = std::conditional_t<std::is_const_v<S>, const Leaf, Leaf>;
+        return static_cast<Base &>(storage);
+    }
+
+    template <std::size_t... Is>
+    static bool Equal(const PackedTuple & lhs, const PackedTuple & rhs,
+                      std::index_sequence<Is...>) {
+        return ((lhs.Get<Is>() == rhs.Get<Is>()) && ...);
+    }
+
+    StorageType storage_;
+};
+
+template <typename... Ts> PackedTuple(Ts...) -> PackedTuple<Ts...>;
+
+template <std::size_t I, typename... Ts> decltype(auto) Get(PackedTuple<Ts...> & t) {
+    return t.template Get<I>();
+}
+
+template <std::size_t I, typename... Ts> decltype(auto) Get(const PackedTuple<Ts...> & t) {
+    return t.template Get<I>();
+}
+
+// 结构化绑定要求名为 get 的函数（通过 ADL 查找）
+template <std::size_t I, typename... Ts> decltype(auto) get(PackedTuple<Ts...> & t) {
+    return t.template Get<I>();
+}
+
+template <std::size_t I, typename... Ts> decltype(auto) get(const PackedTuple<Ts...> & t) {
+    return t.template Get<I>();
+}
+
+namespace tuple_detail {
+
+template <typename F, typename Tuple, std::size_t... Is>
+decltype(auto) ApplyImpl(F && f, Tuple & t, std::index_sequence<Is...>) {
+    return std::invoke(std::forward<F>(f), t.template Get<Is>()...);
+}
+
+} // namespace tuple_detail
+
+// 以声明顺序展开成员调用 f
+template <typename F, typename... Ts> decltype(auto) Apply(F && f, PackedTuple<Ts...> & t) {
+    return tuple_detail::ApplyImpl(std::forward<F>(f), t, std::index_sequence_for<Ts...>{});
+}
+
+template <typename F, typename... Ts> decltype(auto) Apply(F && f, const PackedTuple<Ts...> & t) {
+    return tuple_detail::ApplyImpl(std::forward<F>(f), t, std::index_sequence_for<Ts...>{});
+}
+
+// ----------------------------------------------------------------------------
+// 3. FastVariant - 跳转表分派的 variant
+// ----------------------------------------------------------------------------
+
+namespace variant_detail {
+
+// 能表示 [0, N] 的最小无符号类型（N 表示 valueless）
+template <std::size_t N>
+using IndexType = std::conditional_t<(N < 255), uint8_t,
+                                     std::conditional_t<(N < 65535), uint16_t, uint32_t>>;
+
+template <typename... Ts> constexpr std::size_t MaxSize() {
+    std::size_t result = 1;
+    ((result = sizeof(Ts) > result ? sizeof(Ts) : result), ...);
+    return result;
+}
+
+template <typename... Ts> constexpr std::size_t MaxAlign() {
+    std::size_t result = 1;
+    ((result = alignof(Ts) > result ? alignof(Ts) : result), ...);
+    return result;
+}
+
+} // namespace variant_detail
+
+template <typename... Ts> class FastVariant {
+    static_assert(sizeof...(Ts) > 0, "FastVariant needs at least one alternative");
+
+    using Index = variant_detail::IndexType<sizeof...(Ts)>;
+
+  public:
+    static constexpr std::size_t kAlternatives = sizeof...(Ts);
+    static constexpr std::size_t kNpos         = sizeof...(Ts);
+
+    // 默认构造第一个备选类型
+    FastVariant() { Emplace<0>(); }
+
+    // 从某个备选类型构造；T 必须恰好匹配一个备选类型（去掉 cv/引用后）
+    template <typename T, typename U = std::decay_t<T>,
+              typename = std::enable_if_t<IndexOf<U, Ts...>() != sizeof...(Ts)>>
+    FastVariant(T && value) {
+        Emplace<IndexOf<U, Ts...>()>(std::forward<T>(value));
+    }
+
+    FastVariant(const FastVariant & other) { CopyFrom(other); }
+
+    FastVariant(FastVariant && other) noexcept(
+        (std::is_nothrow_move_constructible_v<Ts> && ...)) {
+        MoveFrom(std::move(other));
+    }
+
+    FastVariant & operator=(const FastVariant & other) {
+        if (this != &other) {
+            Reset();
+            CopyFrom(other);
+        }
+        return *this;
+    }
+
+    FastVariant & operator=(FastVariant && other) noexcept(
+        (std::is_nothrow_move_constructible_v<Ts> && ...)) {
+        if (this != &other) {
+            Reset();
+            MoveFrom(std::move(other));
+        }
+        return *this;
+    }
+
+    ~FastVariant() { Reset(); }
+
+    template <std::size_t I, typename... Args> NthType<I, Ts...> & Emplace(Args &&... args) {
+        Reset();
+        auto * p = ::new (static_cast<void *>(storage_))
+            NthType<I, Ts...>(std::forward<Args>(args)...);
+        index_ = static_cast<Index>(I);
+        return *p;
+    }
+
+    std::size_t index() const { return index_; }
+
+    bool valueless() const { return index_ == kNpos; }
+
+    template <typename T> bool HoldsAlternative() const {
+        // 与 std::holds_alternative 一致：否则 IndexOf 返回的 kNpos 会与 valueless 状态相等
+        static_assert(IndexOf<T, Ts...>() != sizeof...(Ts),
+                      "T must occur exactly once in the alternatives");
+        return index_ == IndexOf<T, Ts...>();
+    }
+
+    // 不检查索引的访问（调用者已确认 index() == I；Visit 的跳转表内部使用）
+    template <std::size_t I> NthType<I, Ts...> & GetUnchecked() {
+        return *std::launder(reinterpret_cast<NthType<I, Ts...> *>(storage_));
+    }
+
+    template <std::size_t I> const NthType<I, Ts...> & GetUnchecked() const {
+        return *std::launder(reinterpret_cast<const NthType<I, Ts...> *>(storage_));
+    }
+
+    template <std::size_t I> NthType<I, Ts...> & Get() {
+        if (index_ != I) {
+            throw std::bad_variant_access();
+        }
+        return GetUnchecked<I>();
+    }
+
+    template <std::size_t I> const NthType<I, Ts...> & Get() const {
+        if (index_ != I) {
+            throw std::bad_variant_access();
+        }
+        return GetUnchecked<I>();
+    }
+
+    template <typename T> T * GetIf() {
+        return HoldsAlternative<T>() ? &GetUnchecked<IndexOf<T, Ts...>()>() : nullptr;
+    }
+
+    template <typename T> const T * GetIf() const {
+        return HoldsAlternative<T>() ? &GetUnchecked<IndexOf<T, Ts...>()>() : nullptr;
+    }
+
+  private:
+    void Reset();
+    void CopyFrom(const FastVariant & other);
+    void MoveFrom(FastVariant && other);
+
+    static constexpr std::size_t kStorageSize  = variant_detail::MaxSize<Ts...>();
+    static constexpr std::size_t kStorageAlign = variant_detail::MaxAlign<Ts...>();
+
+    alignas(kStorageAlign) unsigned char storage_[kStorageSize];
+    Index                                index_ = static_cast<Index>(kNpos);
+};
+
+// ----------------------------------------------------------------------------
+// 3.1 Visit：编译期生成的跳转表
+// ----------------------------------------------------------------------------
+// 对 k 个 variant（备选数 N1..Nk）生成一张 N1*...*Nk 项的函数指针表，
+// 表项 flat = ((i1 * N2 + i2) * N3 + i3)...，每一项是针对一组具体类型实例化的函数。
+// 运行时只需计算 flat 并做一次间接调用，没有逐个比较类型的分支链。
+
+namespace variant_detail {
+
+template <typename V> struct AlternativeCount;
+
+template <typename... Ts> struct AlternativeCount<FastVariant<Ts...>> {
+    static constexpr std::size_t value = sizeof...(Ts);
+};
+
+template <typename V>
+constexpr std::size_t kAlternativeCount = AlternativeCount<std::decay_t<V>>::value;
+
+// 把扁平序号 Flat 拆成各 variant 的序号（混合进制，最后一个 variant 是最低位）
+template <std::size_t Flat, std::size_t... Counts> struct Digits;
+
+template <std::size_t Flat> struct Digits<Flat> {
+    using type = std::index_sequence<>;
+};
+
+template <std::size_t Flat, std::size_t First, std::size_t... Rest>
+struct Digits<Flat, First, Rest...> {
+    static constexpr std::size_t kStride = (Rest * ... * std::size_t(1));
+    template <std::size_t... Tail>
+    static std::index_sequence<Flat / kStride, Tail...> Prepend(std::index_sequence<Tail...>);
+    using type = decltype(Prepend(typename Digits<Flat % kStride, Rest...>::type{}));
+};
+
+template <std::size_t I, typename V> decltype(auto) GetForward(V && v) {
+    if constexpr (std::is_lvalue_reference_v<V>) {
+        return v.template GetUnchecked<I>();
+    } else {
+        return std::move(v.template GetUnchecked<I>());
+    }
+}
+
+template <typename F, typename... Vs> struct Dispatcher {
+    using Result = decltype(std::invoke(std::declval<F>(), GetForward<0>(std::declval<Vs>())...));
+
+    template <std::size_t... Is> static Result Call(F && f, Vs &&... vs) {
+        return std::invoke(std::forward<F>(f), GetForward<Is>(std::forward<Vs>(vs))...);
+    }
+
+    template <std::size_t... Is>
+    static constexpr auto Entry(std::index_sequence<Is...>) -> Result (*)(F &&, Vs &&...) {
+        return &Call<Is...>;
+    }
+
+    template <std::size_t... Flat>
+    static constexpr auto MakeTable(std::index_sequence<Flat...>) {
+        return std::array<Result (*)(F &&, Vs &&...), sizeof...(Flat)>{ Entry(
+            typename Digits<Flat, kAlternativeCount<Vs>...>::type{})... };
+    }
+
+    static constexpr auto kTable =
+        MakeTable(std::make_index_sequence<(kAlternativeCount<Vs> * ... * std::size_t(1))>{});
+};
+
+} // namespace variant_detail
+
+/**
+ * 访问一个或多个 FastVariant：f 需要能接受所有备选类型组合，且返回类型一致。
+ * 任一 variant 为 valueless 时抛 std::bad_variant_access。
+ */
+template <typename F, typename... Vs> decltype(auto) Visit(F && f, Vs &&... vs) {
+    using Dispatch = variant_detail::Dispatcher<F, Vs...>;
+    if (((vs.valueless()) || ...)) {
+        throw std::bad_variant_access();
+    }
+    std::size_t flat = 0;
+    ((flat = flat * variant_detail::kAlternativeCount<Vs> + vs.index()), ...);
+    return Dispatch::kTable[flat](std::forward<F>(f), std::forward<Vs>(vs)...);
+}
+
+// 生命周期管理同样通过 Visit 分派（析构 / 拷贝 / 移动对应的备选类型）
+template <typename... Ts> void FastVariant<Ts...>::Reset() {
+    if (!valueless()) {
+        Visit([](auto & value) {
+            using T = std::decay_t<decltype(value)>;
+            value.~T();
+        }, *this);
+        index_ = static_cast<Index>(kNpos);
+    }
+}
+
+template <typename... Ts> void FastVariant<Ts...>::CopyFrom(const FastVariant & other) {
+    if (!other.valueless()) {
+        Visit([this](const auto & value) {
+            using T = std::decay_t<decltype(value)>;
+            ::new (static_cast<void *>(storage_)) T(value);
+        }, other);
+        index_ = other.index_;
+    }
+}
+
+template <typename... Ts> void FastVariant<Ts...>::MoveFrom(FastVariant && other) {
+    if (!other.valueless()) {
+        Visit([this](auto && value) {
+            using T = std::decay_t<decltype(value)>;
+            ::new (static_cast<void *>(storage_)) T(std::move(value));
+        }, std::move(other));
+        index_ = other.index_;
+    }
+}
+
+} // namespace cpp_variadic
+
+// 结构化绑定支持：auto [a, b, c] = packed_tuple;
+namespace std {
+template <typename... Ts>
+struct tuple_size<cpp_variadic::PackedTuple<Ts...>>
+    : integral_constant<size_t, sizeof...(Ts)> {};
+
+template <size_t I, typename... Ts> struct tuple_element<I, cpp_variadic::PackedTuple<Ts...>> {
+    using type = cpp_variadic::NthType<I, Ts...>;
+};
+} // namespace std
+
+#endif // CPP_QA_LAB_CSRC_BASIC_VARIADIC_CONTAINERS_H_
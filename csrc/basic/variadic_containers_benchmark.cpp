@@ -0,0 +1,194 @@
+// ============================================================================
+// PackedTuple / FastVariant 基准测试
+// ============================================================================
+// 用法: variadic_containers_benchmark [元素个数] [--repetitions=<n>] [--json=<文件>]
+//
+// 1. 大小：std::tuple（声明顺序布局）vs PackedTuple（按对齐重排）
+// 2. 单 variant 访问吞吐：std::visit vs Visit（跳转表）vs GetIf 链
+// 3. 双 variant 访问吞吐：std::visit(f, a, b) vs Visit(f, a, b)
+// ============================================================================
+
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "microbench.h"
+#include "variadic_containers.h"
+
+namespace cpp_variadic {
+
+struct Point3 {
+    float x, y, z;
+};
+
+template <typename... Ts> void PrintSize(const char * name) {
+    fmt::print("  {:<44} {:>11} {:>13}\n", name, sizeof(std::tuple<Ts...>),
+               sizeof(PackedTuple<Ts...>));
+}
+
+void BenchmarkSizes(std::size_t n) {
+    fmt::print("[1] 大小（字节）\n");
+    fmt::print("  {:<44} {:>11} {:>13}\n", "成员类型", "std::tuple", "PackedTuple");
+    PrintSize<char, double, char>("char, double, char");
+    PrintSize<char, int64_t, char, int32_t, char, int16_t>("char, int64, char, int32, char, int16");
+    PrintSize<bool, double, bool, float, bool, double, bool>(
+        "bool, double, bool, float, bool, double, bool");
+    PrintSize<uint8_t, std::string, uint8_t, uint32_t>("uint8, std::string, uint8, uint32");
+    PrintSize<int, double, float>("int, double, float");
+
+    using Loose  = std::tuple<char, int64_t, char, int32_t, char, int16_t>;
+    using Packed = PackedTuple<char, int64_t, char, int32_t, char, int16_t>;
+    fmt::print("  {} 个元素的数组: std::tuple {:.1f} MiB, PackedTuple {:.1f} MiB\n", n,
+               static_cast<double>(n * sizeof(Loose)) / (1 << 20),
+               static_cast<double>(n * sizeof(Packed)) / (1 << 20));
+    fmt::print("  variant<int, double, float, int64, Point3>: std::variant {} / FastVariant {}\n\n",
+               sizeof(std::variant<int, double, float, int64_t, Point3>),
+               sizeof(FastVariant<int, double, float, int64_t, Point3>));
+}
+
+// 每种备选类型的"处理"：转换成 double 累加
+struct ToDouble {
+    double operator()(int v) const { return v; }
+
+    double operator()(double v) const { return v; }
+
+    double operator()(float v) const { return v; }
+
+    double operator()(int64_t v) const { return static_cast<double>(v); }
+
+    double operator()(const Point3 & p) const { return p.x + p.y + p.z; }
+};
+
+struct Product {
+    template <typename A, typename B> double operator()(const A & a, const B & b) const {
+        return ToDouble()(a) * ToDouble()(b);
+    }
+};
+
+void BenchmarkVisit(microbench::Report & report, std::size_t n) {
+    using StdV  = std::variant<int, double, float, int64_t, Point3>;
+    using FastV = FastVariant<int, double, float, int64_t, Point3>;
+
+    std::mt19937                       rng(3);
+    std::uniform_int_distribution<int> kind(0, 4);
+    std::vector<StdV>                  std_values;
+    std::vector<FastV>                 fast_values;
+    std_values.reserve(n);
+    fast_values.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        int v = static_cast<int>(i % 100);
+        switch (kind(rng)) {
+            case 0:
+                std_values.emplace_back(v);
+                fast_values.emplace_back(v);
+                break;
+            case 1:
+                std_values.emplace_back(v * 0.5);
+                fast_values.emplace_back(v * 0.5);
+                break;
+            case 2:
+                std_values.emplace_back(v * 0.25f);
+                fast_values.emplace_back(v * 0.25f);
+                break;
+            case 3:
+                std_values.emplace_back(int64_t{ v } * 2);
+                fast_values.emplace_back(int64_t{ v } * 2);
+                break;
+            default:
+                std_values.emplace_back(Point3{ 1.0f, 2.0f, float(v) });
+                fast_values.emplace_back(Point3{ 1.0f, 2.0f, float(v) });
+                break;
+        }
+    }
+
+    double sum_std = 0, sum_fast = 0, sum_if = 0;
+    double t_std = report.Time("visit/std_visit", [&] {
+        double s = 0;
+        for (const auto & v : std_values) {
+            s += std::visit(ToDouble(), v);
+        }
+        sum_std = s;
+    });
+
+    double t_fast = report.Time("visit/fast_variant", [&] {
+        double s = 0;
+        for (const auto & v : fast_values) {
+            s += Visit(ToDouble(), v);
+        }
+        sum_fast = s;
+    });
+
+    // 运行时逐个比较类型（SimpleVariant 若要实现访问只能这样写）
+    double t_if = report.Time("visit/get_if_chain", [&] {
+        double s = 0;
+        for (const auto & v : fast_values) {
+            if (const auto * p = v.GetIf<int>()) {
+                s += *p;
+            } else if (const auto * d = v.GetIf<double>()) {
+                s += *d;
+            } else if (const auto * f = v.GetIf<float>()) {
+                s += *f;
+            } else if (const auto * l = v.GetIf<int64_t>()) {
+                s += static_cast<double>(*l);
+            } else if (const auto * pt = v.GetIf<Point3>()) {
+                s += ToDouble()(*pt);
+            }
+        }
+        sum_if = s;
+    });
+
+    double pair_std = 0, pair_fast = 0;
+    double t_pair_std = report.Time("visit2/std_visit", [&] {
+        double s = 0;
+        for (std::size_t i = 1; i < n; ++i) {
+            s += std::visit(Product(), std_values[i - 1], std_values[i]);
+        }
+        pair_std = s;
+    });
+
+    double t_pair_fast = report.Time("visit2/fast_variant", [&] {
+        double s = 0;
+        for (std::size_t i = 1; i < n; ++i) {
+            s += Visit(Product(), fast_values[i - 1], fast_values[i]);
+        }
+        pair_fast = s;
+    });
+
+    auto ns = [&](double seconds) { return seconds / static_cast<double>(n) * 1e9; };
+    fmt::print("[2] 访问吞吐（{} 个随机类型的元素，5 种备选类型）\n", n);
+    fmt::print("  {:<34} {:>10}\n", "方式", "ns/元素");
+    fmt::print("  {:<34} {:>10.2f}\n", "std::visit", ns(t_std));
+    fmt::print("  {:<34} {:>10.2f}\n", "FastVariant Visit（跳转表）", ns(t_fast));
+    fmt::print("  {:<34} {:>10.2f}\n", "GetIf 链（运行时逐个比较）", ns(t_if));
+    fmt::print("  {:<34} {:>10.2f}\n", "std::visit(f, a, b)", ns(t_pair_std));
+    fmt::print("  {:<34} {:>10.2f}\n", "Visit(f, a, b)（25 项表）", ns(t_pair_fast));
+    fmt::print("  结果一致: {}\n\n",
+               sum_std == sum_fast && sum_std == sum_if && pair_std == pair_fast ? "yes" : "NO");
+}
+
+} // namespace cpp_variadic
+
+int main(int argc, char * argv[]) {
+    microbench::Report report(argc, argv);
+    std::size_t        n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+    n                    = std::max<std::size_t>(2, n);
+
+    spdlog::info("=== PackedTuple / FastVariant 基准测试 ===");
+    cpp_variadic::BenchmarkSizes(n);
+    cpp_variadic::BenchmarkVisit(report, n);
+
+    spdlog::info("关键学习点：");
+    spdlog::info("1. 成员按对齐从大到小排列时，只有末尾可能需要填充");
+    spdlog::info("2. 重排只影响存储位置，Get<I> 的编号在编译期映射，运行时没有额外开销");
+    spdlog::info("3. 跳转表把 N 路（或 N*M 路）类型分派变成一次下标 + 间接调用");
+    spdlog::info("4. 现代标准库的 std::visit 也使用类似技术，差距主要来自异常检查与内联");
+    return report.Finish();
+}
@@ -24,6 +24,9 @@
 #include <utility>
 #include <vector>
 
+#include "constexpr_hash.h"       // 编译期哈希 / FixedString / StaticHashMap（1.12 的延伸）
+#include "variadic_containers.h" // PackedTuple / FastVariant（1.8 的生产版本）
+
 // ============================================================================
 // 第一部分：C++ 可变参数模板 (Variadic Templates)
 // ============================================================================
@@ -232,6 +235,31 @@ template <int First, int... Rest> struct CompileTimeSum<First, Rest...> {
     static constexpr int value = First + CompileTimeSum<Rest...>::value;
 };
 
+// 编译期字符串查找：键集合固定，完美哈希表在编译期生成（见 constexpr_hash.h）
+constexpr StaticMapEntry<int> kHttpMethodEntries[] = {
+    { "GET", 1 }, { "HEAD", 2 }, { "POST", 3 }, { "PUT", 4 }, { "DELETE", 5 }, { "PATCH", 6 },
+};
+
+constexpr auto kHttpMethods = MakeStaticHashMap(kHttpMethodEntries);
+
+static_assert(kHttpMethods.At("POST") == 3, "lookup happens at compile time");
+
+// 用编译期哈希作为 case 标签，按名字分派
+inline const char * DescribeMethod(std::string_view method) {
+    using namespace literals;
+    switch (Fnv1a64(method)) {
+        case "GET"_fnv:
+        case "HEAD"_fnv:
+            return "只读";
+        case "POST"_fnv:
+        case "PUT"_fnv:
+        case "PATCH"_fnv:
+            return "写入";
+        default:
+            return "其他";
+    }
+}
+
 // ----------------------------------------------------------------------------
 // 1.13 混合可变参数：类型和非类型参数
 // ----------------------------------------------------------------------------
@@ -533,6 +561,13 @@ int main() {
     fmt::print("1.8 可变参数模板类:\n");
     cpp_variadic::SimpleTuple<int, double, std::string> tuple(42, 3.14, "data");
     fmt::print("    SimpleTuple 第一个值: {}\n", tuple.GetValue());
+    cpp_variadic::PackedTuple<char, double, char> packed('a', 2.5, 'z');
+    fmt::print("    PackedTuple<char, double, char>: sizeof = {} (std::tuple: {}), Get<1> = {}\n",
+               sizeof(packed), sizeof(std::tuple<char, double, char>),
+               cpp_variadic::Get<1>(packed));
+    cpp_variadic::FastVariant<int, double, std::string> variant(std::string("text"));
+    cpp_variadic::Visit([](const auto & v) { fmt::print("    FastVariant 当前值: {}\n", v); },
+                        variant);
 
     // 1.9 参数包索引访问
     fmt::print("1.9 参数包索引访问:\n");
@@ -553,6 +588,11 @@ int main() {
     fmt::print("1.12 编译期求和:\n");
     fmt::print("     CompileTimeSum<1, 2, 3, 4, 5>::value = {}\n",
                cpp_variadic::CompileTimeSum<1, 2, 3, 4, 5>::value);
+    constexpr auto name = CPP_VARIADIC_FIXED_STRING("PATCH");
+    fmt::print("     FixedString \"{}\" 的编译期哈希 = {:#x}, StaticHashMap 中的编号 = {}\n",
+               decltype(name)::kView, decltype(name)::kHash, cpp_variadic::kHttpMethods.At(name));
+    fmt::print("     DescribeMethod(\"PUT\") = {}, 未知方法 TRACE 存在: {}\n",
+               cpp_variadic::DescribeMethod("PUT"), cpp_variadic::kHttpMethods.Contains("TRACE"));
 
     // 1.13 非类型参数
     fmt::print("1.13 非类型参数:\n     ");
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <utility> // 实际上 std::forward 在 <utility> 中定义，但很多编译器在 <iostream> 中间接包含，建议显式包含
 
+#include "event_dispatcher.h"
+
 // 模板类 MyDelegate：用于封装“对象 + 成员函数指针”，形成可调用对象（Callable）
 // - T: 类类型（如 struct A）
 // - R: 成员函数的返回类型（如 void）
@@ -128,6 +130,18 @@ int main() {
     // 调用 d1(1, 2.5)，等价于 a.Fun1(1, 2.5)
     d4(1, 2.5); // 输出: Function Fun1 called with 1 and 2.5
 
+    //===================================================================
+    // 多播：把多个委托放进同一个事件分发器（生产版本见 event_dispatcher.h）
+    // Delegate 擦除了类类型 T，只保留签名 void(int)，因此不同类的成员函数可以放在一起
+    using cpp_qa_lab::basic::Delegate;
+    A                                       a2;
+    cpp_qa_lab::basic::EventDispatcher<int> on_value;
+    auto first = on_value.Subscribe(Delegate(&a, &A::Fun)); // 与 MyDelegate2 相同的推导方式
+    on_value.Subscribe(Delegate(&a2, &A::FunConst));       // const 成员函数
+    on_value.Emit(7);                                       // 依次调用两个委托
+    on_value.Unsubscribe(first);
+    on_value.Emit(8); // 只剩 a2.FunConst
+
     return 0;
 
     return 0;
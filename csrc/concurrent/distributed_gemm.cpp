@@ -0,0 +1,360 @@
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+#include "distributed_gemm.h"
+
+namespace concurrent {
+
+// ==================== 块划分辅助函数 ====================
+
+// 找到包含全局下标 k 的块编号（跳过长度为 0 的块）
+static size_t block_owner(size_t n, size_t parts, size_t k) {
+    for (size_t idx = 0; idx < parts; ++idx) {
+        size_t begin = block_begin(n, parts, idx);
+        if (k >= begin && k < begin + block_extent(n, parts, idx)) {
+            return idx;
+        }
+    }
+    return parts - 1;
+}
+
+// 从全局矩阵中拷贝一个子块 [r0, r0+rows) x [c0, c0+cols)
+static Matrix extract_block(const Matrix & src, size_t r0, size_t rows, size_t c0, size_t cols) {
+    Matrix block(rows, cols);
+    for (size_t i = 0; i < rows; ++i) {
+        std::memcpy(block.data() + i * cols, src.data() + (r0 + i) * src.cols() + c0,
+                    cols * sizeof(double));
+    }
+    return block;
+}
+
+// ==================== 共享内存传输层 ====================
+// 教学要点：进程间通过 MAP_SHARED 映射交换数据，屏障设置为 PTHREAD_PROCESS_SHARED
+
+/**
+ * 共享区布局（每段按 64 字节对齐）：
+ * ┌─────────┬──────────────┬────────────────┬────────────────┬──────────┐
+ * │ barrier │ stats[P]     │ A 面板槽[rows] │ B 面板槽[cols] │ C (MxN)  │
+ * └─────────┴──────────────┴────────────────┴────────────────┴──────────┘
+ * 每个进程行有一个 A 面板槽，每个进程列有一个 B 面板槽，不同行/列的广播互不干扰。
+ */
+class SharedRegion {
+  public:
+    SharedRegion(const ProcessGrid & grid, size_t max_m_local, size_t max_n_local,
+                 size_t panel_width, size_t M, size_t N) :
+        grid_(grid),
+        a_slot_elems_(max_m_local * panel_width),
+        b_slot_elems_(panel_width * max_n_local) {
+        size_t offset = 0;
+        barrier_off_  = take(offset, sizeof(pthread_barrier_t));
+        stats_off_    = take(offset, sizeof(SummaRankStats) * grid.size());
+        a_slots_off_  = take(offset, sizeof(double) * a_slot_elems_ * grid.rows);
+        b_slots_off_  = take(offset, sizeof(double) * b_slot_elems_ * grid.cols);
+        c_off_        = take(offset, sizeof(double) * M * N);
+        bytes_        = std::max<size_t>(offset, 1);
+
+        void * p = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::runtime_error("SharedRegion: mmap failed");
+        }
+        base_ = static_cast<char *>(p);
+
+        pthread_barrierattr_t attr;
+        pthread_barrierattr_init(&attr);
+        pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        int rc = pthread_barrier_init(barrier(), &attr, static_cast<unsigned>(grid.size()));
+        pthread_barrierattr_destroy(&attr);
+        if (rc != 0) {
+            munmap(base_, bytes_);
+            throw std::runtime_error("SharedRegion: pthread_barrier_init failed");
+        }
+    }
+
+    ~SharedRegion() {
+        pthread_barrier_destroy(barrier());
+        munmap(base_, bytes_);
+    }
+
+    SharedRegion(const SharedRegion &)             = delete;
+    SharedRegion & operator=(const SharedRegion &) = delete;
+
+    pthread_barrier_t * barrier() { return reinterpret_cast<pthread_barrier_t *>(base_); }
+
+    SummaRankStats * stats() { return reinterpret_cast<SummaRankStats *>(base_ + stats_off_); }
+
+    double * a_slot(size_t grid_row) {
+        return reinterpret_cast<double *>(base_ + a_slots_off_) + grid_row * a_slot_elems_;
+    }
+
+    double * b_slot(size_t grid_col) {
+        return reinterpret_cast<double *>(base_ + b_slots_off_) + grid_col * b_slot_elems_;
+    }
+
+    double * c() { return reinterpret_cast<double *>(base_ + c_off_); }
+
+    size_t a_slot_elems() const { return a_slot_elems_; }
+
+    size_t b_slot_elems() const { return b_slot_elems_; }
+
+    const ProcessGrid & grid() const { return grid_; }
+
+  private:
+    static size_t take(size_t & offset, size_t bytes) {
+        size_t start = offset;
+        offset += (bytes + 63) & ~size_t(63);
+        return start;
+    }
+
+    ProcessGrid grid_;
+    size_t      a_slot_elems_;
+    size_t      b_slot_elems_;
+    size_t      barrier_off_ = 0;
+    size_t      stats_off_   = 0;
+    size_t      a_slots_off_ = 0;
+    size_t      b_slots_off_ = 0;
+    size_t      c_off_       = 0;
+    size_t      bytes_       = 0;
+    char *      base_        = nullptr;
+};
+
+/**
+ * 基于共享内存的面板广播
+ * 广播 = 根进程写入槽位 -> 屏障 -> 其他进程读出 -> 屏障（保证槽位可被下一步复用）
+ */
+class ShmTransport : public PanelTransport {
+  public:
+    ShmTransport(SharedRegion & region, size_t rank) : region_(region), rank_(rank) {}
+
+    size_t rank() const override { return rank_; }
+
+    const ProcessGrid & grid() const override { return region_.grid(); }
+
+    void broadcast_row(size_t grid_row, size_t root_col, Matrix & panel) override {
+        bool is_root = grid().row_of(rank_) == grid_row && grid().col_of(rank_) == root_col;
+        exchange(region_.a_slot(grid_row), region_.a_slot_elems(), is_root,
+                 grid().row_of(rank_) == grid_row, panel);
+    }
+
+    void broadcast_col(size_t grid_col, size_t root_row, Matrix & panel) override {
+        bool is_root = grid().col_of(rank_) == grid_col && grid().row_of(rank_) == root_row;
+        exchange(region_.b_slot(grid_col), region_.b_slot_elems(), is_root,
+                 grid().col_of(rank_) == grid_col, panel);
+    }
+
+    void barrier() override { pthread_barrier_wait(region_.barrier()); }
+
+  private:
+    void exchange(double * slot, size_t slot_elems, bool is_root, bool participates,
+                  Matrix & panel) {
+        size_t count = panel.rows() * panel.cols();
+        if (count > slot_elems) {
+            throw std::length_error("ShmTransport: panel larger than shared slot");
+        }
+        if (is_root) {
+            std::memcpy(slot, panel.data(), count * sizeof(double));
+        }
+        barrier();
+        if (participates && !is_root) {
+            std::memcpy(panel.data(), slot, count * sizeof(double));
+        }
+        barrier();
+    }
+
+    SharedRegion & region_;
+    size_t         rank_;
+};
+
+// ==================== SUMMA 主循环（单进程视角）====================
+// 教学要点：每一步广播一个 K 方向面板，然后做一次本地秩-kb 更新
+
+SummaRankStats summa_rank(PanelTransport & transport, const Matrix & A_local,
+                          const Matrix & B_local, Matrix & C_local, size_t K, size_t panel_width) {
+    const ProcessGrid & grid  = transport.grid();
+    size_t              my_r  = grid.row_of(transport.rank());
+    size_t              my_c  = grid.col_of(transport.rank());
+    size_t              m_loc = C_local.rows(), n_loc = C_local.cols();
+    panel_width               = std::max<size_t>(1, panel_width);
+
+    SummaRankStats stats;
+    Matrix         A_panel(m_loc, 0), B_panel(0, n_loc);
+
+    for (size_t k = 0; k < K;) {
+        // A 的 K 维按进程列划分，B 的 K 维按进程行划分，二者边界不一定对齐
+        size_t a_owner = block_owner(K, grid.cols, k);
+        size_t b_owner = block_owner(K, grid.rows, k);
+        size_t a_begin = block_begin(K, grid.cols, a_owner);
+        size_t b_begin = block_begin(K, grid.rows, b_owner);
+        size_t a_end   = a_begin + block_extent(K, grid.cols, a_owner);
+        size_t b_end   = b_begin + block_extent(K, grid.rows, b_owner);
+        size_t kb      = std::min({ panel_width, a_end - k, b_end - k });
+
+        Timer comm_timer;
+        if (A_panel.cols() != kb) {
+            A_panel = Matrix(m_loc, kb);
+            B_panel = Matrix(kb, n_loc);
+        }
+        // 面板所有者打包本地数据
+        if (my_c == a_owner) {
+            for (size_t i = 0; i < m_loc; ++i) {
+                std::memcpy(A_panel.data() + i * kb,
+                            A_local.data() + i * A_local.cols() + (k - a_begin), kb * sizeof(double));
+            }
+        }
+        if (my_r == b_owner) {
+            std::memcpy(B_panel.data(), B_local.data() + (k - b_begin) * n_loc,
+                        kb * n_loc * sizeof(double));
+        }
+        transport.broadcast_row(my_r, a_owner, A_panel);
+        transport.broadcast_col(my_c, b_owner, B_panel);
+        stats.comm_seconds += comm_timer.elapsed();
+
+        // 本地更新：C_local += A_panel * B_panel（分块版本本身就是累加语义）
+        Timer compute_timer;
+        gemm_serial_blocked(A_panel, B_panel, C_local);
+        stats.compute_seconds += compute_timer.elapsed();
+
+        ++stats.steps;
+        k += kb;
+    }
+    return stats;
+}
+
+// ==================== 多进程驱动：fork + 共享内存 ====================
+
+ProcessGrid make_process_grid(size_t num_processes) {
+    size_t p    = std::max<size_t>(1, num_processes);
+    size_t rows = 1;
+    for (size_t r = 1; r * r <= p; ++r) {
+        if (p % r == 0) {
+            rows = r;
+        }
+    }
+    return ProcessGrid{ rows, p / rows };
+}
+
+SummaResult gemm_summa_shm(const Matrix & A, const Matrix & B, Matrix & C, const ProcessGrid & grid,
+                           size_t panel_width) {
+    size_t M = A.rows(), K = A.cols(), N = B.cols();
+    if (B.rows() != K || C.rows() != M || C.cols() != N) {
+        throw std::invalid_argument("gemm_summa_shm: matrix dimensions do not match");
+    }
+    if (grid.size() == 0) {
+        throw std::invalid_argument("gemm_summa_shm: process grid must not be empty");
+    }
+    panel_width = std::max<size_t>(1, panel_width);
+
+    Timer        total_timer;
+    size_t       P = grid.size();
+    SharedRegion region(grid, block_extent(M, grid.rows, 0), block_extent(N, grid.cols, 0),
+                        panel_width, M, N);
+
+    std::vector<pid_t> children;
+    children.reserve(P);
+    for (size_t rank = 0; rank < P; ++rank) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            // fork 失败：已启动的进程会卡在屏障上，必须全部终止
+            for (pid_t child : children) {
+                kill(child, SIGKILL);
+                waitpid(child, nullptr, 0);
+            }
+            throw std::runtime_error("gemm_summa_shm: fork failed");
+        }
+        if (pid == 0) {
+            // 子进程：只做计算，结束时用 _exit 避免重复刷新父进程的 stdio 缓冲
+            int code = 0;
+            try {
+                size_t r = grid.row_of(rank), c = grid.col_of(rank);
+                size_t m0 = block_begin(M, grid.rows, r), m = block_extent(M, grid.rows, r);
+                size_t n0 = block_begin(N, grid.cols, c), n = block_extent(N, grid.cols, c);
+                size_t ka0 = block_begin(K, grid.cols, c), ka = block_extent(K, grid.cols, c);
+                size_t kb0 = block_begin(K, grid.rows, r), kb = block_extent(K, grid.rows, r);
+
+                Matrix A_local = extract_block(A, m0, m, ka0, ka);
+                Matrix B_local = extract_block(B, kb0, kb, n0, n);
+                Matrix C_local(m, n, 0.0);
+
+                ShmTransport transport(region, rank);
+                region.stats()[rank] =
+                    summa_rank(transport, A_local, B_local, C_local, K, panel_width);
+
+                // 本地 C 块写回共享区（各进程写入不相交的区域，无需同步）
+                for (size_t i = 0; i < m; ++i) {
+                    std::memcpy(region.c() + (m0 + i) * N + n0, C_local.data() + i * n,
+                                n * sizeof(double));
+                }
+            } catch (...) {
+                code = 1;
+            }
+            _exit(code);
+        }
+        children.push_back(pid);
+    }
+
+    // 父进程：回收子进程；任一进程失败时终止其余进程（否则它们会永远等在屏障上）
+    bool   failed    = false;
+    size_t remaining = children.size();
+    while (remaining > 0) {
+        int   status = 0;
+        pid_t pid    = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            break;
+        }
+        if (std::find(children.begin(), children.end(), pid) == children.end()) {
+            continue;
+        }
+        --remaining;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            if (!failed) {
+                for (pid_t child : children) {
+                    kill(child, SIGKILL);
+                }
+            }
+            failed = true;
+        }
+    }
+    if (failed) {
+        throw std::runtime_error("gemm_summa_shm: worker process failed");
+    }
+
+    std::memcpy(C.data(), region.c(), M * N * sizeof(double));
+
+    SummaResult result;
+    result.grid          = grid;
+    result.panel_width   = panel_width;
+    result.total_seconds = total_timer.elapsed();
+    result.ranks.assign(region.stats(), region.stats() + P);
+    for (const auto & s : result.ranks) {
+        result.max_compute = std::max(result.max_compute, s.compute_seconds);
+        result.max_comm    = std::max(result.max_comm, s.comm_seconds);
+    }
+    double ops    = 2.0 * static_cast<double>(M) * static_cast<double>(N) * static_cast<double>(K);
+    result.gflops = (ops / 1e9) / result.total_seconds;
+    return result;
+}
+
+// ==================== 结果打印 ====================
+
+double SummaResult::comm_fraction() const {
+    double busy = max_compute + max_comm;
+    return busy > 0.0 ? max_comm / busy : 0.0;
+}
+
+void SummaResult::print() const {
+    std::cout << "SUMMA " << grid.rows << "x" << grid.cols << " (P=" << grid.size()
+              << ", panel=" << panel_width << "): time=" << total_seconds
+              << "s, GFLOPS=" << gflops << ", compute=" << max_compute << "s, comm=" << max_comm
+              << "s, comm%=" << std::fixed << std::setprecision(1) << comm_fraction() * 100.0
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+}
+
+} // namespace concurrent
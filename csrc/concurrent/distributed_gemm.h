@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "gemm_learning.h"
+
+namespace concurrent {
+
+/**
+ * ============================================================================
+ * 多进程分布式 GEMM - SUMMA 算法
+ * ============================================================================
+ *
+ * 在单机上用多个工作进程模拟多节点扩展：
+ * - P = grid_rows x grid_cols 个进程组成二维进程网格
+ * - A(MxK)、B(KxN)、C(MxN) 按二维块分布，每个进程持有一个本地块(Matrix)
+ * - 第 k 步：A 的列面板沿进程行广播，B 的行面板沿进程列广播，
+ *   每个进程执行本地更新 C_local += A_panel * B_panel
+ *
+ * 教学要点:
+ * - 进程间没有共享地址空间，数据交换必须显式通信
+ * - 通信层抽象为 PanelTransport，本地实现基于共享内存(ShmTransport)
+ * - 计算/通信时间分离统计，观察进程数增加时通信占比的变化
+ */
+
+/**
+ * @brief 二维进程网格中的坐标与块划分
+ */
+struct ProcessGrid {
+    size_t rows = 1;
+    size_t cols = 1;
+
+    size_t size() const { return rows * cols; }
+
+    size_t row_of(size_t rank) const { return rank / cols; }
+
+    size_t col_of(size_t rank) const { return rank % cols; }
+
+    size_t rank_of(size_t r, size_t c) const { return r * cols + c; }
+};
+
+/**
+ * @brief 将长度 n 均匀划分为 parts 段，返回第 idx 段的起点
+ *
+ * 与 gemm_thread_parallel 相同的负载均衡方式：前 n % parts 段多分 1 个
+ */
+inline size_t block_begin(size_t n, size_t parts, size_t idx) {
+    size_t base = n / parts, rem = n % parts;
+    return idx * base + std::min(idx, rem);
+}
+
+inline size_t block_extent(size_t n, size_t parts, size_t idx) {
+    return n / parts + (idx < n % parts ? 1 : 0);
+}
+
+/**
+ * @brief 面板通信接口 - 可替换的传输层
+ *
+ * SUMMA 只需要两种集合通信：沿进程行广播 A 面板、沿进程列广播 B 面板。
+ * 实现方可以是共享内存、socket 或 MPI；算法本身只依赖这个接口。
+ */
+class PanelTransport {
+  public:
+    virtual ~PanelTransport() = default;
+
+    virtual size_t rank() const = 0;
+
+    virtual const ProcessGrid & grid() const = 0;
+
+    /**
+     * @brief 行广播: 进程行 grid_row 内，由 root_col 列的进程发送 panel
+     *
+     * 调用时所有参与进程都必须传入同尺寸的 panel；非根进程的 panel 被覆盖。
+     */
+    virtual void broadcast_row(size_t grid_row, size_t root_col, Matrix & panel) = 0;
+
+    /**
+     * @brief 列广播: 进程列 grid_col 内，由 root_row 行的进程发送 panel
+     */
+    virtual void broadcast_col(size_t grid_col, size_t root_row, Matrix & panel) = 0;
+
+    // 所有进程同步
+    virtual void barrier() = 0;
+};
+
+/**
+ * @brief 单个进程的 SUMMA 统计
+ */
+struct SummaRankStats {
+    double compute_seconds = 0.0; // 本地 GEMM 更新耗时
+    double comm_seconds    = 0.0; // 面板打包/广播/同步耗时
+    size_t steps           = 0; // 面板步数
+};
+
+/**
+ * @brief 一次分布式 GEMM 的汇总结果
+ */
+struct SummaResult {
+    ProcessGrid                 grid;
+    size_t                      panel_width   = 0;
+    double                      total_seconds = 0.0; // 含 fork/收集结果的端到端时间
+    double                      max_compute   = 0.0; // 各进程计算时间最大值（关键路径）
+    double                      max_comm      = 0.0; // 各进程通信时间最大值
+    double                      gflops        = 0.0;
+    std::vector<SummaRankStats> ranks;
+
+    // 通信时间在(计算+通信)中的占比
+    double comm_fraction() const;
+
+    void print() const;
+};
+
+/**
+ * @brief 在一个进程内执行 SUMMA 主循环
+ *
+ * 与传输层解耦：同一份代码可以跑在共享内存、socket 或 MPI 上。
+ *
+ * @param A_local 本进程持有的 A 块 (m_local x k_local_a)
+ * @param B_local 本进程持有的 B 块 (k_local_b x n_local)
+ * @param C_local 本进程的 C 块，结果累加到其中 (m_local x n_local)
+ * @param K 全局的 K 维度（A 的 K 按进程列划分，B 的 K 按进程行划分）
+ */
+SummaRankStats summa_rank(PanelTransport & transport, const Matrix & A_local,
+                          const Matrix & B_local, Matrix & C_local, size_t K, size_t panel_width);
+
+/**
+ * @brief 共享内存 + fork 的多进程 SUMMA
+ *
+ * 教学要点:
+ * - 父进程创建匿名共享映射(MAP_SHARED)，其中包含进程间屏障和面板缓冲区
+ * - fork 出 P 个工作进程，每个进程从 A/B 中取出自己的块（写时复制，无需散发）
+ * - 各进程把本地 C 块写回共享区，父进程 waitpid 后收集结果
+ *
+ * @param grid 进程网格，进程数 = grid.rows * grid.cols
+ * @param panel_width SUMMA 面板宽度（每步广播的 K 方向列/行数）
+ */
+SummaResult gemm_summa_shm(const Matrix & A, const Matrix & B, Matrix & C, const ProcessGrid & grid,
+                           size_t panel_width = 64);
+
+/**
+ * @brief 为给定进程数挑选尽量接近正方形的网格（P = rows * cols, rows <= cols）
+ */
+ProcessGrid make_process_grid(size_t num_processes);
+
+} // namespace concurrent
@@ -0,0 +1,56 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "distributed_gemm.h"
+
+using namespace concurrent;
+
+// 用法: distributed_gemm_demo [矩阵规模M] [最大进程数] [面板宽度]
+int main(int argc, char * argv[]) {
+    size_t M           = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 512;
+    size_t max_procs   = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16;
+    size_t panel_width = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 64;
+
+    std::cout << "========== 多进程分布式 GEMM (SUMMA + 共享内存) ==========\n\n";
+    std::cout << "矩阵规模: " << M << "x" << M << ", 面板宽度: " << panel_width << "\n";
+
+    Matrix A(M, M), B(M, M), C_ref(M, M, 0.0);
+    A.randomize(-1.0, 1.0);
+    B.randomize(-1.0, 1.0);
+
+    // 单进程分块版本作为参考结果与基准时间
+    Timer t;
+    gemm_serial_blocked(A, B, C_ref);
+    double serial_time = t.elapsed();
+    std::cout << "串行分块参考: " << serial_time << "s\n\n";
+
+    std::cout << std::left << std::setw(8) << "P" << std::setw(8) << "grid" << std::setw(12)
+              << "total(s)" << std::setw(12) << "compute(s)" << std::setw(12) << "comm(s)"
+              << std::setw(10) << "comm%" << std::setw(10) << "speedup" << "correct\n";
+    std::cout << std::string(80, '-') << "\n";
+
+    for (size_t p = 1; p <= max_procs; p *= 2) {
+        ProcessGrid grid = make_process_grid(p);
+        Matrix      C(M, M);
+        SummaResult r    = gemm_summa_shm(A, B, C, grid, panel_width);
+
+        std::cout << std::left << std::setw(8) << p << std::setw(8)
+                  << (std::to_string(grid.rows) + "x" + std::to_string(grid.cols)) << std::fixed
+                  << std::setprecision(4) << std::setw(12) << r.total_seconds << std::setw(12)
+                  << r.max_compute << std::setw(12) << r.max_comm << std::setprecision(1)
+                  << std::setw(10) << r.comm_fraction() * 100.0 << std::setprecision(2)
+                  << std::setw(10) << serial_time / r.total_seconds
+                  << (C.equals(C_ref) ? "yes" : "NO") << "\n"
+                  << std::defaultfloat << std::setprecision(6);
+    }
+
+    std::cout << "\n关键学习点总结：\n";
+    std::cout << "1. 每个进程只持有本地块，面板通过传输层显式广播\n";
+    std::cout << "2. 进程数增加时本地计算量按 1/P 下降，而面板通信量按 1/sqrt(P) 下降\n";
+    std::cout << "3. 因此通信占比随进程数上升，这是多节点扩展的主要瓶颈\n";
+    std::cout << "4. 进程数超过物理核心数后，计算时间不再下降，屏障等待时间上升\n\n";
+
+    return 0;
+}
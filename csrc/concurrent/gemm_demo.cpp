@@ -1,95 +1,302 @@
+#include <cstdlib>
+#include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include "gemm_learning.h"
 
 using namespace concurrent;
 
-int main() {
+namespace {
+
+// 命令行配置
+struct DemoConfig {
+    std::vector<size_t>      sizes           = { 128, 256, 512 };
+    std::vector<std::string> variants        = { "all" };
+    size_t                   threads         = 4;
+    bool                     compare_checked = true;
+    BenchmarkOptions         options;
+    std::string              csv_path;
+};
+
+using VariantRunner =
+    std::function<PerformanceResult(const Matrix &, const Matrix &, const Matrix &)>;
+
+// 一个可测试的 GEMM 变体：key 用于命令行选择，run 执行行指针版本，
+// run_checked（可为空）执行同一算法的逐元素边界检查版本，用于前后对比
+struct GemmVariant {
+    std::string   key;
+    std::string   title;
+    VariantRunner run;
+    VariantRunner run_checked;
+    size_t        max_size = 0; // 0 表示不限制
+};
+
+std::vector<std::string> split_list(const std::string & s) {
+    std::vector<std::string> items;
+    std::stringstream        ss(s);
+    std::string              item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void print_usage(const char * prog) {
+    std::cout << "用法: " << prog << " [选项]\n"
+              << "  --sizes 128,256,512   矩阵规模列表\n"
+              << "  --variants a,b,...    naive,blocked,thread,thread_blocked,omp,omp_blocked,"
+                 "pool,race 或 all\n"
+              << "  --threads N           线程数（默认 4）\n"
+              << "  --repetitions=N       计时重复次数（默认 5）\n"
+              << "  --warmup N            预热次数（默认 1）\n"
+              << "  --no-flush            运行之间不清空缓存\n"
+              << "  --no-checked          不运行逐元素边界检查的对照版本\n"
+              << "  --json=FILE           输出 JSON 结果（microbench 格式）\n"
+              << "  --csv FILE            输出 CSV 结果\n";
+}
+
+bool parse_args(int argc, char * argv[], DemoConfig & cfg) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg  = argv[i];
+        auto        next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--sizes") {
+            cfg.sizes.clear();
+            for (const auto & v : split_list(next())) {
+                cfg.sizes.push_back(std::strtoul(v.c_str(), nullptr, 10));
+            }
+        } else if (arg == "--variants") {
+            cfg.variants = split_list(next());
+        } else if (arg == "--threads") {
+            cfg.threads = std::strtoul(next().c_str(), nullptr, 10);
+        } else if (arg == "--warmup") {
+            cfg.options.warmup_runs = std::strtoul(next().c_str(), nullptr, 10);
+        } else if (arg == "--no-flush") {
+            cfg.options.flush_cache = false;
+        } else if (arg == "--no-checked") {
+            cfg.compare_checked = false;
+        } else if (arg == "--csv") {
+            cfg.csv_path = next();
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    return true;
+}
+
+// 参考结果：最直接的三重循环 + 局部累加，不共用任何被测内核的代码，
+// 否则 naive 变体等于拿自己和自己比较
+Matrix reference_gemm(const Matrix & A, const Matrix & B) {
+    Matrix C(A.rows(), B.cols());
+    for (size_t i = 0; i < A.rows(); ++i) {
+        for (size_t j = 0; j < B.cols(); ++j) {
+            double sum = 0.0;
+            for (size_t k = 0; k < A.cols(); ++k) {
+                sum += A(i, k) * B(k, j);
+            }
+            C(i, j) = sum;
+        }
+    }
+    return C;
+}
+
+// 以 <变体>/<规模> 为名记入 Report，GFLOPS 和误差作为计数器
+void record(microbench::Report & report, const std::string & name, const PerformanceResult & r) {
+    microbench::Report::Entry & entry = report.Add(name + "/" + std::to_string(r.M),
+                                                   r.samples_seconds);
+    entry.counters["gflops"]        = r.gflops;
+    entry.counters["max_abs_error"] = r.max_abs_error;
+    entry.correct                   = r.is_correct;
+}
+
+bool is_selected(const DemoConfig & cfg, const std::string & key) {
+    for (const auto & v : cfg.variants) {
+        if (v == "all" || v == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    DemoConfig                        cfg;
+    std::optional<microbench::Report> report;
+    try {
+        report.emplace(argc, argv);
+        cfg.options.repetitions = report->repetitions();
+        if (!parse_args(argc, argv, cfg)) {
+            return 0;
+        }
+    } catch (const std::exception & e) {
+        std::cerr << e.what() << "\n";
+        print_usage(argv[0]);
+        return 1;
+    }
+
     std::cout << "========== 并发编程学习：矩阵乘法(GEMM)示例 ==========\n\n";
 
-    // 测试不同规模的矩阵
-    std::vector<size_t> sizes = { 128, 256, 512 };
+    BenchmarkMetadata meta = collect_benchmark_metadata();
+    std::cout << "CPU: " << meta.cpu_model << " (" << meta.cpu_mhz << " MHz), 硬件线程: "
+              << meta.hardware_threads << ", OpenMP 线程: " << meta.omp_max_threads << "\n";
+    std::cout << "预热: " << cfg.options.warmup_runs << " 次, 重复: " << cfg.options.repetitions
+              << " 次, 清空缓存: " << (cfg.options.flush_cache ? "是" : "否") << "\n";
+
+    const BenchmarkOptions & opt = cfg.options;
+    const size_t             T   = cfg.threads;
+    ThreadPool               pool(T);
+
+    // 线程池的函数签名与 benchmark 需要的签名不同（需要先传入 ThreadPool&），
+    // 因此包装成签名匹配的 lambda：(const Matrix&, const Matrix&, Matrix&, size_t)
+    auto pool_fast = [&](const Matrix & a, const Matrix & b, Matrix & c, size_t g) {
+        gemm_threadpool(pool, a, b, c, g);
+    };
+    auto pool_checked = [&](const Matrix & a, const Matrix & b, Matrix & c, size_t g) {
+        checked::gemm_threadpool(pool, a, b, c, g);
+    };
+    auto pool_granularity = [](const Matrix & A) { return std::max<size_t>(1, A.rows() / 8); };
+
+    using MatrixRef = const Matrix &;
+
+    std::vector<GemmVariant> variants = {
+        { "naive", "1. 串行基准版本（naive）",
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "Serial Naive", gemm_serial_naive, A, B, ref);
+          },
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "Serial Naive [checked]", checked::gemm_serial_naive, A,
+                                    B, ref);
+          } },
+        { "blocked", "2. 串行分块优化（cache-friendly）",
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "Serial Blocked", gemm_serial_blocked, A, B, ref,
+                                    (size_t) 64);
+          },
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "Serial Blocked [checked]", checked::gemm_serial_blocked,
+                                    A, B, ref, (size_t) 64);
+          } },
+        { "thread", "3. std::thread 并行",
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "Thread Parallel", gemm_thread_parallel, A, B, ref, T);
+          },
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "Thread Parallel [checked]",
+                                    checked::gemm_thread_parallel, A, B, ref, T);
+          } },
+        { "thread_blocked", "4. std::thread + 分块优化",
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "Thread Blocked", gemm_thread_blocked, A, B, ref, T,
+                                    (size_t) 64);
+          },
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "Thread Blocked [checked]", checked::gemm_thread_blocked,
+                                    A, B, ref, T, (size_t) 64);
+          } },
+        { "omp", "5. OpenMP 并行",
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "OpenMP Simple", gemm_openmp_simple, A, B, ref,
+                                    std::string("static"));
+          },
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "OpenMP Simple [checked]", checked::gemm_openmp_simple, A,
+                                    B, ref, std::string("static"));
+          } },
+        { "omp_blocked", "6. OpenMP + 分块",
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "OpenMP Blocked", gemm_openmp_blocked, A, B, ref,
+                                    (size_t) 64);
+          },
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "OpenMP Blocked [checked]", checked::gemm_openmp_blocked,
+                                    A, B, ref, (size_t) 64);
+          } },
+        { "pool", "7. 线程池实现",
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "ThreadPool", pool_fast, A, B, ref, pool_granularity(A));
+          },
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "ThreadPool [checked]", pool_checked, A, B, ref,
+                                    pool_granularity(A));
+          } },
+        // 数据竞争演示（仅小矩阵，无对照版本）
+        { "race", "8. 数据竞争演示（错误示范）",
+          [&](MatrixRef A, MatrixRef B, MatrixRef ref) {
+              return benchmark_gemm(opt, "Race Condition (BUGGY)", gemm_thread_race_condition_demo,
+                                    A, B, ref, T);
+          },
+          nullptr, 128 },
+    };
 
-    for (auto M : sizes) {
+    std::vector<PerformanceResult> all_results;
+
+    for (auto M : cfg.sizes) {
         std::cout << "\n测试矩阵规模: " << M << "x" << M << "\n";
         std::cout << std::string(60, '-') << "\n";
 
-        // 初始化矩阵
-        Matrix A(M, M), B(M, M), C_ref(M, M);
+        // 初始化矩阵；参考结果由独立的三重循环计算，不与任何被测内核共用代码
+        Matrix A(M, M), B(M, M);
         A.randomize(-1.0, 1.0);
         B.randomize(-1.0, 1.0);
+        Matrix C_ref = reference_gemm(A, B);
 
-        // 1. 串行基准版本（用于正确性验证）
-        std::cout << "1. 串行基准版本（naive）...\n";
-        // 先计算参考结果（一次），用于后续正确性验证
-        gemm_serial_naive(A, B, C_ref);
-        // 基准测试：传入函数指针（匹配签名），以及 A,B,reference
-        auto result_serial = benchmark_gemm("Serial Naive", gemm_serial_naive, A, B, C_ref);
-        result_serial.print();
-
-        // 2. 串行分块优化
-        std::cout << "\n2. 串行分块优化（cache-friendly）...\n";
-        Matrix C_blocked(M, M);
-        auto   result_blocked =
-            benchmark_gemm("Serial Blocked", gemm_serial_blocked, A, B, C_blocked, (size_t) 64);
-        result_blocked.print();
-        std::cout << "   加速比: " << std::fixed << std::setprecision(2)
-                  << result_serial.time_seconds / result_blocked.time_seconds << "x\n";
-
-        // 3. std::thread并行
-        std::cout << "\n3. std::thread 并行（4线程）...\n";
-        Matrix C_thread(M, M);
-        auto   result_thread =
-            benchmark_gemm("Thread Parallel", gemm_thread_parallel, A, B, C_thread, (size_t) 4);
-        result_thread.print();
-        std::cout << "   加速比: " << result_serial.time_seconds / result_thread.time_seconds
-                  << "x\n";
-
-        // 4. std::thread + 分块
-        std::cout << "\n4. std::thread + 分块优化（4线程）...\n";
-        Matrix C_thread_blocked(M, M);
-        auto   result_tb = benchmark_gemm("Thread Blocked", gemm_thread_blocked, A, B,
-                                          C_thread_blocked, (size_t) 4, (size_t) 64);
-        result_tb.print();
-        std::cout << "   加速比: " << result_serial.time_seconds / result_tb.time_seconds << "x\n";
-
-        // 5. OpenMP简单版本
-        std::cout << "\n5. OpenMP 并行...\n";
-        Matrix C_omp(M, M);
-        auto   result_omp =
-            benchmark_gemm("OpenMP Simple", gemm_openmp_simple, A, B, C_omp, std::string("static"));
-        result_omp.print();
-        std::cout << "   加速比: " << result_serial.time_seconds / result_omp.time_seconds << "x\n";
-
-        // 6. 线程池版本
-        std::cout << "\n6. 线程池实现（4线程）...\n";
-        ThreadPool pool(4);
-        Matrix     C_pool(M, M);
-        // 线程池的函数签名与benchmark需要的签名不同（需要先传入 ThreadPool&），
-        // 因此传入一个签名匹配的 lambda：(const Matrix&, const Matrix&, Matrix&, size_t)
-        auto       pool_lambda = [&](const Matrix & a, const Matrix & b, Matrix & c, size_t gran) {
-            gemm_threadpool(pool, a, b, c, gran);
-        };
-        auto result_pool =
-            benchmark_gemm("ThreadPool", pool_lambda, A, B, C_pool, (size_t) (M / 8));
-        result_pool.print();
-        std::cout << "   加速比: " << result_serial.time_seconds / result_pool.time_seconds
-                  << "x\n";
-
-        // 7. 数据竞争演示（仅小矩阵）
-        if (M <= 128) {
-            std::cout << "\n7. 数据竞争演示（错误示范）...\n";
-            Matrix C_race(M, M);
-            auto   result_race =
-                benchmark_gemm("Race Condition (BUGGY)", gemm_thread_race_condition_demo, A, B,
-                               C_race, (size_t) 4);
-            result_race.print();
-            std::cout << "   ⚠️  注意：此版本存在数据竞争，结果不正确！\n";
+        double baseline = 0.0;
+        for (const auto & v : variants) {
+            if (!is_selected(cfg, v.key) || (v.max_size != 0 && M > v.max_size)) {
+                continue;
+            }
+            std::cout << "\n" << v.title << "...\n";
+            PerformanceResult r = v.run(A, B, C_ref);
+            r.print();
+            if (v.key == "naive") {
+                baseline = r.time_seconds;
+            } else if (baseline > 0.0) {
+                std::cout << "   加速比(中位数): " << std::fixed << std::setprecision(2)
+                          << baseline / r.time_seconds << "x\n"
+                          << std::defaultfloat << std::setprecision(6);
+            }
+            if (cfg.compare_checked && v.run_checked) {
+                PerformanceResult before = v.run_checked(A, B, C_ref);
+                std::cout << "   对照（逐元素 at() 检查）: " << before.time_seconds
+                          << "s -> 行指针: " << r.time_seconds << "s, 提速 " << std::fixed
+                          << std::setprecision(2) << before.time_seconds / r.time_seconds << "x"
+                          << (before.is_correct ? "" : " (对照结果不正确!)") << "\n"
+                          << std::defaultfloat << std::setprecision(6);
+                all_results.push_back(before);
+                record(*report, v.key + "_checked", before);
+            }
+            if (v.key == "race") {
+                // 故意错误的演示不进入 Report，否则结果校验会让整个运行失败
+                std::cout << "   ⚠️  注意：此版本存在数据竞争，结果不正确！\n";
+            } else {
+                record(*report, v.key, r);
+            }
+            all_results.push_back(r);
         }
     }
 
+    if (!cfg.csv_path.empty()) {
+        std::ofstream out(cfg.csv_path);
+        write_results_csv(out, meta, all_results);
+        std::cout << "CSV 结果已写入: " << cfg.csv_path << "\n";
+    }
+
     std::cout << "\n========== 测试完成 ==========\n";
     std::cout << "\n关键学习点总结：\n";
     std::cout << "1. 缓存优化：分块可显著提升性能（减少cache miss）\n";
@@ -97,7 +304,9 @@ int main() {
     std::cout << "3. 线程开销：小规模任务可能因开销反而变慢\n";
     std::cout << "4. 数据竞争：无同步的共享写入会导致错误结果\n";
     std::cout << "5. OpenMP：更简洁，编译器优化好\n";
-    std::cout << "6. 线程池：避免重复创建线程，适合多任务场景\n\n";
+    std::cout << "6. 线程池：避免重复创建线程，适合多任务场景\n";
+    std::cout << "7. 测量方法：预热 + 多次重复取中位数，单次计时不可信\n";
+    std::cout << "8. 内层循环：去掉逐元素边界检查、改用行指针自增，编译器才能向量化\n\n";
 
-    return 0;
+    return report->Finish();
 }
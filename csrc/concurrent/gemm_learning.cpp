@@ -1,9 +1,21 @@
 #include <algorithm>
+#include <cerrno>
 #include <cmath>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
-#include <random>
+#include <limits>
+#include <numeric>
+#include <sstream>
 
 #include "gemm_learning.h"
+#include "philox.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #ifdef _OPENMP
 #    include <omp.h>
@@ -18,19 +30,80 @@ Matrix::Matrix(size_t rows, size_t cols, double init_val) :
     cols_(cols),
     data_(rows * cols, init_val) {}
 
-double & Matrix::operator()(size_t i, size_t j) {
-    return data_[i * cols_ + j];
+// ==================== 并行初始化 / 比较 / 读写 ====================
+// 教学要点：大矩阵的准备和校验本身就是 O(N^2) 的内存带宽密集型工作，
+// 串行执行时可能比并行 GEMM 还慢；并行时要保证结果与线程数无关
+
+namespace {
+
+// 固定分段大小：求和类归约按段独立累加再按顺序合并，浮点结果不随线程数变化
+constexpr size_t kReduceChunk = size_t(1) << 16;
+
+// 并行读写时每个线程一次处理的字节数
+constexpr size_t kIoChunkBytes = size_t(8) << 20;
+
+constexpr char     kMatrixMagic[4]    = { 'C', 'Q', 'L', 'M' };
+constexpr uint32_t kMatrixFileVersion = 1;
+
+struct MatrixFileHeader {
+    char     magic[4];
+    uint32_t version;
+    uint64_t rows;
+    uint64_t cols;
+};
+
+[[noreturn]] void throw_io_error(const std::string & what, const std::string & path) {
+    throw std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
 }
 
-const double & Matrix::operator()(size_t i, size_t j) const {
-    return data_[i * cols_ + j];
+// 用 pwrite/pread 在多个线程中分段读写 [offset, offset + bytes)
+template <bool Write> void parallel_io(int fd, char * buf, size_t bytes, off_t offset) {
+    int64_t chunks = static_cast<int64_t>((bytes + kIoChunkBytes - 1) / kIoChunkBytes);
+    bool    failed = false;
+
+#pragma omp parallel for schedule(dynamic) reduction(|| : failed)
+    for (int64_t c = 0; c < chunks; ++c) {
+        size_t begin = static_cast<size_t>(c) * kIoChunkBytes;
+        size_t len   = std::min(kIoChunkBytes, bytes - begin);
+        while (len > 0) {
+            ssize_t n = Write ? ::pwrite(fd, buf + begin, len, offset + begin)
+                              : ::pread(fd, buf + begin, len, offset + begin);
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                failed = true;
+                break;
+            }
+            begin += static_cast<size_t>(n);
+            len -= static_cast<size_t>(n);
+        }
+    }
+    if (failed) {
+        // errno 是线程局部的，出错线程的 errno 在这里不可见，只报告失败方向
+        throw std::runtime_error(Write ? "matrix write failed"
+                                       : "matrix read failed (file truncated?)");
+    }
 }
 
-void Matrix::randomize(double min, double max) {
-    std::mt19937_64                        rng(12345);
-    std::uniform_real_distribution<double> dist(min, max);
-    for (auto & v : data_) {
-        v = dist(rng);
+} // namespace
+
+void Matrix::randomize(double min, double max, uint64_t seed) {
+    Philox4x32 rng(seed);
+    double     span  = max - min;
+    int64_t    n     = static_cast<int64_t>(data_.size());
+    int64_t    pairs = (n + 1) / 2;
+    double *   out   = data_.data();
+
+    // 第 p 次 Philox 调用产生 4 个 uint32，拼成元素 2p 与 2p+1 两个 double
+#pragma omp parallel for schedule(static)
+    for (int64_t p = 0; p < pairs; ++p) {
+        Philox4x32::Result r   = rng(static_cast<uint64_t>(p));
+        int64_t            idx = 2 * p;
+        out[idx]               = min + span * Philox4x32::to_unit_double(r[0], r[1]);
+        if (idx + 1 < n) {
+            out[idx + 1] = min + span * Philox4x32::to_unit_double(r[2], r[3]);
+        }
     }
 }
 
@@ -38,86 +111,246 @@ bool Matrix::equals(const Matrix & other, double epsilon) const {
     if (rows_ != other.rows() || cols_ != other.cols()) {
         return false;
     }
-    for (size_t i = 0; i < data_.size(); ++i) {
-        if (std::fabs(data_[i] - other.data()[i]) > epsilon) {
-            return false;
+    const double * GEMM_RESTRICT a = data_.data();
+    const double * GEMM_RESTRICT b = other.data();
+    int64_t                      n = static_cast<int64_t>(data_.size());
+
+    // 不提前退出：无分支的计数循环可以向量化，整体比逐个比较更快
+    int64_t mismatches = 0;
+#pragma omp parallel for simd schedule(static) reduction(+ : mismatches)
+    for (int64_t i = 0; i < n; ++i) {
+        mismatches += std::fabs(a[i] - b[i]) > epsilon ? 1 : 0;
+    }
+    return mismatches == 0;
+}
+
+double Matrix::max_abs_diff(const Matrix & other) const {
+    if (rows_ != other.rows() || cols_ != other.cols()) {
+        return std::numeric_limits<double>::infinity();
+    }
+    const double * GEMM_RESTRICT a = data_.data();
+    const double * GEMM_RESTRICT b = other.data();
+    int64_t                      n = static_cast<int64_t>(data_.size());
+
+    // max 与求值顺序无关，可以直接用 OpenMP 归约
+    double max_diff = 0.0;
+#pragma omp parallel for simd schedule(static) reduction(max : max_diff)
+    for (int64_t i = 0; i < n; ++i) {
+        max_diff = std::max(max_diff, std::fabs(a[i] - b[i]));
+    }
+    return max_diff;
+}
+
+double Matrix::frobenius_norm() const {
+    const double * GEMM_RESTRICT x      = data_.data();
+    size_t                       n      = data_.size();
+    int64_t                      chunks = static_cast<int64_t>((n + kReduceChunk - 1) /
+                                                               kReduceChunk);
+    std::vector<double>          partial(chunks, 0.0);
+
+    // 浮点加法不满足结合律：按固定分段求和，再按段顺序合并，结果与线程数无关
+#pragma omp parallel for schedule(static)
+    for (int64_t c = 0; c < chunks; ++c) {
+        size_t begin = static_cast<size_t>(c) * kReduceChunk;
+        size_t end   = std::min(begin + kReduceChunk, n);
+        double sum   = 0.0;
+#pragma omp simd reduction(+ : sum)
+        for (size_t i = begin; i < end; ++i) {
+            sum += x[i] * x[i];
         }
+        partial[c] = sum;
     }
-    return true;
+    return std::sqrt(std::accumulate(partial.begin(), partial.end(), 0.0));
 }
 
-// ==================== 串行版本：基础实现 ====================
-// 教学要点：最直接的三层循环，性能基准
-// 时间复杂度：O(M*N*K)，无优化
-void gemm_serial_naive(const Matrix & A, const Matrix & B, Matrix & C) {
-    size_t M = A.rows(), K = A.cols(), N = B.cols();
+double Matrix::max_norm() const {
+    const double * GEMM_RESTRICT x = data_.data();
+    int64_t                      n = static_cast<int64_t>(data_.size());
 
-    // 标准的矩阵乘法：C[i][j] = sum(A[i][k] * B[k][j])
-    for (size_t i = 0; i < M; ++i) { // 遍历A的行
-        for (size_t j = 0; j < N; ++j) { // 遍历B的列
-            double sum = 0.0;
-            for (size_t k = 0; k < K; ++k) { // 内积计算
-                sum += A(i, k) * B(k, j);
-            }
-            C(i, j) = sum;
+    double m = 0.0;
+#pragma omp parallel for simd schedule(static) reduction(max : m)
+    for (int64_t i = 0; i < n; ++i) {
+        m = std::max(m, std::fabs(x[i]));
+    }
+    return m;
+}
+
+void Matrix::save(const std::string & path) const {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw_io_error("cannot open for writing", path);
+    }
+    MatrixFileHeader header{};
+    std::memcpy(header.magic, kMatrixMagic, sizeof(kMatrixMagic));
+    header.version = kMatrixFileVersion;
+    header.rows    = rows_;
+    header.cols    = cols_;
+
+    size_t payload = data_.size() * sizeof(double);
+    try {
+        // 先定长再并行写：各线程写入互不重叠的区间
+        if (::ftruncate(fd, static_cast<off_t>(sizeof(header) + payload)) != 0) {
+            throw_io_error("cannot resize", path);
         }
+        parallel_io<true>(fd, reinterpret_cast<char *>(&header), sizeof(header), 0);
+        parallel_io<true>(fd, reinterpret_cast<char *>(const_cast<double *>(data_.data())),
+                          payload, sizeof(header));
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0) {
+        throw_io_error("cannot close", path);
     }
-    // 问题：内层循环访问B是列优先，导致大量cache miss
 }
 
-// ==================== 串行版本：分块优化（缓存友好）====================
-// 教学要点：提高数据局部性，减少cache miss
-// 优化原理：将大矩阵分成小块，每块能装入CPU缓存
-void gemm_serial_blocked(const Matrix & A, const Matrix & B, Matrix & C, size_t block_size) {
-    size_t M = A.rows(), K = A.cols(), N = B.cols();
+Matrix Matrix::load(const std::string & path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw_io_error("cannot open for reading", path);
+    }
+    try {
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            throw_io_error("cannot stat", path);
+        }
+        uint64_t file_size = static_cast<uint64_t>(st.st_size);
+        if (file_size < sizeof(MatrixFileHeader)) {
+            throw std::runtime_error("not a matrix file: '" + path + "'");
+        }
+        MatrixFileHeader header{};
+        parallel_io<false>(fd, reinterpret_cast<char *>(&header), sizeof(header), 0);
+        if (std::memcmp(header.magic, kMatrixMagic, sizeof(kMatrixMagic)) != 0 ||
+            header.version != kMatrixFileVersion) {
+            throw std::runtime_error("not a matrix file: '" + path + "'");
+        }
+        // 头部的行列数不可信：先排除乘法溢出，再与文件实际大小核对，然后才分配内存
+        uint64_t max_elems = std::numeric_limits<size_t>::max() / sizeof(double);
+        if (header.cols != 0 && header.rows > max_elems / header.cols) {
+            throw std::runtime_error("matrix dimensions overflow in '" + path + "'");
+        }
+        uint64_t payload = header.rows * header.cols * sizeof(double);
+        if (file_size - sizeof(header) != payload) {
+            throw std::runtime_error("matrix file size does not match its header: '" + path +
+                                     "'");
+        }
+        Matrix m(header.rows, header.cols);
+        parallel_io<false>(fd, reinterpret_cast<char *>(m.data()),
+                           m.data_.size() * sizeof(double), sizeof(header));
+        ::close(fd);
+        return m;
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+}
+
+void Matrix::fill(double value) {
+    std::fill(data_.begin(), data_.end(), value);
+}
 
-    // 外层三重循环：按块遍历
-    for (size_t ii = 0; ii < M; ii += block_size) { // A的行块
-        for (size_t kk = 0; kk < K; kk += block_size) { // A的列块/B的行块
-            for (size_t jj = 0; jj < N; jj += block_size) { // B的列块
+// ==================== 内核实现（编译期选择访问方式）====================
+// 教学要点：同一套循环结构写成模板，Checked=true 时逐元素走 Matrix::at()（每次访问都做
+// 边界检查，作为对照组）；Checked=false 时取行指针、指针自增遍历，内层循环无分支，
+// 配合 GEMM_RESTRICT 编译器可以向量化。
+namespace {
 
-                // 计算当前块的实际大小（处理边界）
-                size_t i_max = std::min(ii + block_size, M);
-                size_t k_max = std::min(kk + block_size, K);
-                size_t j_max = std::min(jj + block_size, N);
+// 计算C矩阵的[row_begin, row_end)行，i-j-k 顺序（naive 及其并行版本共用）
+template <bool Checked>
+void naive_rows(const Matrix & A, const Matrix & B, Matrix & C, size_t row_begin,
+                size_t row_end) {
+    size_t K = A.cols(), N = B.cols();
+
+    for (size_t i = row_begin; i < row_end; ++i) {
+        if constexpr (Checked) {
+            for (size_t j = 0; j < N; ++j) {
+                double sum = 0.0;
+                for (size_t k = 0; k < K; ++k) {
+                    sum += A.at(i, k) * B.at(k, j);
+                }
+                C.at(i, j) = sum;
+            }
+        } else {
+            const double * GEMM_RESTRICT a_row = A.row_ptr(i);
+            const double * GEMM_RESTRICT a_end = a_row + K;
+            double * GEMM_RESTRICT       c     = C.row_ptr(i);
+            for (size_t j = 0; j < N; ++j) {
+                const double * GEMM_RESTRICT b   = B.data() + j; // B 的第 j 列，步长 N
+                double                       sum = 0.0;
+                for (const double * a = a_row; a != a_end; ++a, b += N) {
+                    sum += *a * *b;
+                }
+                *c++ = sum;
+            }
+        }
+    }
+}
+
+// 在[ii, i_max)行范围内做 k/j 分块累加（分块版本及其并行版本共用）
+template <bool Checked>
+void blocked_rows(const Matrix & A, const Matrix & B, Matrix & C, size_t ii, size_t i_max,
+                  size_t block_size) {
+    size_t K = A.cols(), N = B.cols();
+
+    for (size_t kk = 0; kk < K; kk += block_size) {
+        for (size_t jj = 0; jj < N; jj += block_size) {
+            size_t k_max = std::min(kk + block_size, K);
+            size_t j_max = std::min(jj + block_size, N);
 
-                // 内层三重循环：在块内计算
-                for (size_t i = ii; i < i_max; ++i) {
+            for (size_t i = ii; i < i_max; ++i) {
+                if constexpr (Checked) {
                     for (size_t k = kk; k < k_max; ++k) {
-                        double a_ik = A(i, k); // 复用A元素
+                        double a_ik = A.at(i, k); // 复用A元素
                         for (size_t j = jj; j < j_max; ++j) {
-                            C(i, j) += a_ik * B(k, j); // 累加到C
+                            C.at(i, j) += a_ik * B.at(k, j); // 累加到C
+                        }
+                    }
+                } else {
+                    const double * GEMM_RESTRICT a_row   = A.row_ptr(i);
+                    double * GEMM_RESTRICT       c_begin = C.row_ptr(i) + jj;
+                    double * GEMM_RESTRICT       c_end   = C.row_ptr(i) + j_max;
+                    for (size_t k = kk; k < k_max; ++k) {
+                        double                       a_ik = a_row[k];
+                        const double * GEMM_RESTRICT b    = B.row_ptr(k) + jj;
+                        // 连续、无别名、无分支：这是编译器最容易向量化的形状
+                        for (double * c = c_begin; c != c_end; ++c, ++b) {
+                            *c += a_ik * *b;
                         }
                     }
                 }
             }
         }
     }
-    // 优化效果：减少内存访问延迟，典型提速2-5倍
 }
 
-// ==================== 并行版本1：std::thread 行分块 ====================
-// 教学要点：手动创建线程、负载均衡、线程同步开销
+// ==================== 串行版本：基础实现 ====================
+// 教学要点：最直接的三层循环，性能基准
+// 时间复杂度：O(M*N*K)，无优化
+template <bool Checked> void serial_naive_impl(const Matrix & A, const Matrix & B, Matrix & C) {
+    // 标准的矩阵乘法：C[i][j] = sum(A[i][k] * B[k][j])
+    naive_rows<Checked>(A, B, C, 0, A.rows());
+    // 问题：内层循环访问B是列优先，导致大量cache miss
+}
 
-// 工作线程函数：计算C矩阵的[row_begin, row_end)行
-static void gemm_worker_rows(const Matrix & A, const Matrix & B, Matrix & C, size_t row_begin,
-                             size_t row_end) {
-    size_t K = A.cols(), N = B.cols();
+// ==================== 串行版本：分块优化（缓存友好）====================
+// 教学要点：提高数据局部性，减少cache miss
+// 优化原理：将大矩阵分成小块，每块能装入CPU缓存
+template <bool Checked>
+void serial_blocked_impl(const Matrix & A, const Matrix & B, Matrix & C, size_t block_size) {
+    size_t M = A.rows();
 
-    // 每个线程独立计算分配给它的行，无数据竞争
-    for (size_t i = row_begin; i < row_end; ++i) {
-        for (size_t j = 0; j < N; ++j) {
-            double sum = 0.0;
-            for (size_t k = 0; k < K; ++k) {
-                sum += A(i, k) * B(k, j);
-            }
-            C(i, j) = sum;
-        }
+    // 外层按行块遍历，块内的 k/j 分块由 blocked_rows 完成
+    for (size_t ii = 0; ii < M; ii += block_size) {
+        blocked_rows<Checked>(A, B, C, ii, std::min(ii + block_size, M), block_size);
     }
+    // 优化效果：减少内存访问延迟，典型提速2-5倍
 }
 
-void gemm_thread_parallel(const Matrix & A, const Matrix & B, Matrix & C, size_t num_threads) {
-    size_t M    = A.rows();
+// ==================== 并行版本1/2：std::thread 行分块 ====================
+// 教学要点：手动创建线程、负载均衡、线程同步开销
+// 把[0, M)按行均分给 num_threads 个线程，每个线程对自己的行调用 worker
+template <typename Worker>
+void split_rows_across_threads(size_t M, size_t num_threads, Worker worker) {
     num_threads = std::max<size_t>(1, std::min(num_threads, M));
 
     std::vector<std::thread> threads;
@@ -131,8 +364,8 @@ void gemm_thread_parallel(const Matrix & A, const Matrix & B, Matrix & C, size_t
         size_t begin = offset;
         size_t end   = begin + rows;
 
-        // 创建线程，传递只读的A、B和可写的C
-        threads.emplace_back(gemm_worker_rows, std::cref(A), std::cref(B), std::ref(C), begin, end);
+        // 每个线程写入独立的C行，无数据竞争
+        threads.emplace_back(worker, begin, end);
         offset = end;
     }
 
@@ -143,72 +376,108 @@ void gemm_thread_parallel(const Matrix & A, const Matrix & B, Matrix & C, size_t
     // 注意：创建/销毁线程有开销，小矩阵可能不如串行快
 }
 
-// ==================== 并行版本2：std::thread + 分块优化 ====================
+template <bool Checked>
+void thread_parallel_impl(const Matrix & A, const Matrix & B, Matrix & C, size_t num_threads) {
+    split_rows_across_threads(A.rows(), num_threads, [&](size_t begin, size_t end) {
+        naive_rows<Checked>(A, B, C, begin, end);
+    });
+}
+
 // 教学要点：结合缓存优化和并行化
+template <bool Checked>
+void thread_blocked_impl(const Matrix & A, const Matrix & B, Matrix & C, size_t num_threads,
+                         size_t block_size) {
+    split_rows_across_threads(A.rows(), num_threads, [&](size_t begin, size_t end) {
+        blocked_rows<Checked>(A, B, C, begin, end, block_size);
+    });
+}
 
-static void gemm_worker_block(const Matrix & A, const Matrix & B, Matrix & C, size_t ii,
-                              size_t i_max, size_t block_size) {
-    size_t K = A.cols(), N = B.cols();
+// ==================== 并行版本3：OpenMP简单实现 ====================
+// 教学要点：编译器自动并行化，更简洁的代码
+template <bool Checked> void openmp_simple_impl(const Matrix & A, const Matrix & B, Matrix & C) {
+#ifdef _OPENMP
+    int M = (int) A.rows();
 
-    // 每个线程在自己的行范围内做分块计算
-    for (size_t kk = 0; kk < K; kk += block_size) {
-        for (size_t jj = 0; jj < N; jj += block_size) {
-            size_t k_max = std::min(kk + block_size, K);
-            size_t j_max = std::min(jj + block_size, N);
+// OpenMP并行for：自动分配迭代到线程
+// schedule(static): 编译时静态分配，适合负载均匀的循环
+#    pragma omp parallel for schedule(static)
+    for (int i = 0; i < M; ++i) {
+        naive_rows<Checked>(A, B, C, i, i + 1);
+    }
+    // 优点：代码简洁，编译器优化，开销小
+    // 注意：需要编译时加 -fopenmp 标志
+#else
+    // 未启用OpenMP时回退到串行版本
+    serial_naive_impl<Checked>(A, B, C);
+#endif
+}
 
-            for (size_t i = ii; i < i_max; ++i) {
-                for (size_t k = kk; k < k_max; ++k) {
-                    double a_ik = A(i, k);
-                    for (size_t j = jj; j < j_max; ++j) {
-                        C(i, j) += a_ik * B(k, j);
-                    }
-                }
-            }
-        }
+// ==================== 并行版本4：OpenMP + 分块 ====================
+template <bool Checked>
+void openmp_blocked_impl(const Matrix & A, const Matrix & B, Matrix & C, size_t block_size) {
+#ifdef _OPENMP
+    int M = (int) A.rows();
+
+// 并行化外层块循环
+#    pragma omp parallel for schedule(static)
+    for (int ii = 0; ii < M; ii += (int) block_size) {
+        size_t i_max = std::min<size_t>(ii + block_size, M);
+        blocked_rows<Checked>(A, B, C, ii, i_max, block_size);
     }
+#else
+    serial_blocked_impl<Checked>(A, B, C, block_size);
+#endif
 }
 
-void gemm_thread_blocked(const Matrix & A, const Matrix & B, Matrix & C, size_t num_threads,
-                         size_t block_size) {
-    size_t M    = A.rows();
-    num_threads = std::max<size_t>(1, std::min(num_threads, M));
+} // namespace
 
-    std::vector<std::thread> threads;
-    size_t                   base   = M / num_threads;
-    size_t                   rem    = M % num_threads;
-    size_t                   offset = 0;
+void gemm_serial_naive(const Matrix & A, const Matrix & B, Matrix & C) {
+    serial_naive_impl<false>(A, B, C);
+}
 
-    for (size_t t = 0; t < num_threads; ++t) {
-        size_t rows  = base + (t < rem ? 1 : 0);
-        size_t begin = offset;
-        size_t end   = begin + rows;
+void gemm_serial_blocked(const Matrix & A, const Matrix & B, Matrix & C, size_t block_size) {
+    serial_blocked_impl<false>(A, B, C, block_size);
+}
 
-        threads.emplace_back(gemm_worker_block, std::cref(A), std::cref(B), std::ref(C), begin, end,
-                             block_size);
-        offset = end;
-    }
+void gemm_thread_parallel(const Matrix & A, const Matrix & B, Matrix & C, size_t num_threads) {
+    thread_parallel_impl<false>(A, B, C, num_threads);
+}
 
-    for (auto & th : threads) {
-        th.join();
-    }
+void gemm_thread_blocked(const Matrix & A, const Matrix & B, Matrix & C, size_t num_threads,
+                         size_t block_size) {
+    thread_blocked_impl<false>(A, B, C, num_threads, block_size);
+}
+
+void gemm_openmp_simple(const Matrix & A, const Matrix & B, Matrix & C,
+                        const std::string & schedule_type) {
+    (void) schedule_type;
+    openmp_simple_impl<false>(A, B, C);
+}
+
+void gemm_openmp_blocked(const Matrix & A, const Matrix & B, Matrix & C, size_t block_size) {
+    openmp_blocked_impl<false>(A, B, C, block_size);
 }
 
 // ==================== 数据竞争演示（错误示范）====================
 // 教学要点：展示不加同步保护时的并发错误
 void gemm_thread_race_condition_demo(const Matrix & A, const Matrix & B, Matrix & C,
                                      size_t num_threads) {
-    size_t M = A.rows(), N = B.cols();
+    size_t M = A.rows(), N = B.cols(), K = A.cols();
     num_threads = std::max<size_t>(1, std::min(num_threads, M * N));
 
     std::vector<std::thread> threads;
 
     // 危险操作：多个线程同时修改同一个C(i,j)
     auto race_task = [&](size_t tid) {
+        (void) tid;
         for (size_t i = 0; i < M; ++i) {
+            const double * a_row = A.row_ptr(i);
+            double *       c_row = C.row_ptr(i);
             for (size_t j = 0; j < N; ++j) {
-                for (size_t k = 0; k < A.cols(); ++k) {
+                const double * b = B.data() + j;
+                for (size_t k = 0; k < K; ++k, b += N) {
                     // 数据竞争：读-改-写操作不是原子的
-                    C(i, j) += A(i, k) * B(k, j);
+                    c_row[j] += a_row[k] * *b;
                     // 可能导致：部分更新丢失，结果错误
                 }
             }
@@ -225,63 +494,6 @@ void gemm_thread_race_condition_demo(const Matrix & A, const Matrix & B, Matrix
     // 预期结果：C的值不正确，验证会失败
 }
 
-// ==================== 并行版本3：OpenMP简单实现 ====================
-// 教学要点：编译器自动并行化，更简洁的代码
-void gemm_openmp_simple(const Matrix & A, const Matrix & B, Matrix & C,
-                        const std::string & schedule_type) {
-#ifdef _OPENMP
-    size_t M = A.rows(), N = B.cols(), K = A.cols();
-
-// OpenMP并行for：自动分配迭代到线程
-// schedule(static): 编译时静态分配，适合负载均匀的循环
-#    pragma omp parallel for schedule(static)
-    for (int i = 0; i < (int) M; ++i) {
-        for (size_t j = 0; j < N; ++j) {
-            double sum = 0.0;
-            for (size_t k = 0; k < K; ++k) {
-                sum += A(i, k) * B(k, j);
-            }
-            C(i, j) = sum;
-        }
-    }
-    // 优点：代码简洁，编译器优化，开销小
-    // 注意：需要编译时加 -fopenmp 标志
-#else
-    // 未启用OpenMP时回退到串行版本
-    gemm_serial_naive(A, B, C);
-#endif
-}
-
-// ==================== 并行版本4：OpenMP + 分块 ====================
-void gemm_openmp_blocked(const Matrix & A, const Matrix & B, Matrix & C, size_t block_size) {
-#ifdef _OPENMP
-    size_t M = A.rows(), K = A.cols(), N = B.cols();
-
-// 并行化外层块循环
-#    pragma omp parallel for schedule(static)
-    for (int ii = 0; ii < (int) M; ii += (int) block_size) {
-        for (size_t kk = 0; kk < K; kk += block_size) {
-            for (size_t jj = 0; jj < N; jj += block_size) {
-                size_t i_max = std::min<size_t>(ii + block_size, M);
-                size_t k_max = std::min(kk + block_size, K);
-                size_t j_max = std::min(jj + block_size, N);
-
-                for (size_t i = ii; i < i_max; ++i) {
-                    for (size_t k = kk; k < k_max; ++k) {
-                        double a_ik = A(i, k);
-                        for (size_t j = jj; j < j_max; ++j) {
-                            C(i, j) += a_ik * B(k, j);
-                        }
-                    }
-                }
-            }
-        }
-    }
-#else
-    gemm_serial_blocked(A, B, C, block_size);
-#endif
-}
-
 // ==================== 简单线程池实现 ====================
 // 教学要点：任务队列、工作线程、避免重复创建线程开销
 
@@ -358,8 +570,9 @@ template void ThreadPool::enqueue<std::function<void()>>(std::function<void()> &
 
 // ==================== 使用线程池的GEMM ====================
 // 教学要点：任务粒度控制、避免线程创建开销
-void gemm_threadpool(ThreadPool & pool, const Matrix & A, const Matrix & B, Matrix & C,
-                     size_t task_granularity) {
+template <bool Checked>
+static void threadpool_impl(ThreadPool & pool, const Matrix & A, const Matrix & B, Matrix & C,
+                            size_t task_granularity) {
     size_t M    = A.rows();
     size_t base = std::max<size_t>(1, task_granularity);
 
@@ -368,7 +581,7 @@ void gemm_threadpool(ThreadPool & pool, const Matrix & A, const Matrix & B, Matr
         size_t i_end = std::min(i + base, M);
 
         // 提交任务到线程池（lambda捕获）
-        pool.enqueue([=, &A, &B, &C]() { gemm_worker_block(A, B, C, i, i_end, 64); });
+        pool.enqueue([=, &A, &B, &C]() { blocked_rows<Checked>(A, B, C, i, i_end, 64); });
     }
 
     // 等待所有任务完成
@@ -376,10 +589,166 @@ void gemm_threadpool(ThreadPool & pool, const Matrix & A, const Matrix & B, Matr
     // 优势：线程复用，减少创建/销毁开销
 }
 
+void gemm_threadpool(ThreadPool & pool, const Matrix & A, const Matrix & B, Matrix & C,
+                     size_t task_granularity) {
+    threadpool_impl<false>(pool, A, B, C, task_granularity);
+}
+
+// ==================== 对照组：逐元素边界检查版本 ====================
+namespace checked {
+
+void gemm_serial_naive(const Matrix & A, const Matrix & B, Matrix & C) {
+    serial_naive_impl<true>(A, B, C);
+}
+
+void gemm_serial_blocked(const Matrix & A, const Matrix & B, Matrix & C, size_t block_size) {
+    serial_blocked_impl<true>(A, B, C, block_size);
+}
+
+void gemm_thread_parallel(const Matrix & A, const Matrix & B, Matrix & C, size_t num_threads) {
+    thread_parallel_impl<true>(A, B, C, num_threads);
+}
+
+void gemm_thread_blocked(const Matrix & A, const Matrix & B, Matrix & C, size_t num_threads,
+                         size_t block_size) {
+    thread_blocked_impl<true>(A, B, C, num_threads, block_size);
+}
+
+void gemm_openmp_simple(const Matrix & A, const Matrix & B, Matrix & C,
+                        const std::string & schedule_type) {
+    (void) schedule_type;
+    openmp_simple_impl<true>(A, B, C);
+}
+
+void gemm_openmp_blocked(const Matrix & A, const Matrix & B, Matrix & C, size_t block_size) {
+    openmp_blocked_impl<true>(A, B, C, block_size);
+}
+
+void gemm_threadpool(ThreadPool & pool, const Matrix & A, const Matrix & B, Matrix & C,
+                     size_t task_granularity) {
+    threadpool_impl<true>(pool, A, B, C, task_granularity);
+}
+
+} // namespace checked
+
+// ==================== 基准测试工具 ====================
+// 教学要点：可重复的测量 = 预热 + 多次采样 + 稳健统计量 + 记录运行环境
+
+SampleStats summarize_samples(std::vector<double> samples) {
+    SampleStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t n     = samples.size();
+    stats.min    = samples.front();
+    stats.max    = samples.back();
+    stats.mean   = std::accumulate(samples.begin(), samples.end(), 0.0) / n;
+    stats.median = (n % 2 == 1) ? samples[n / 2] : 0.5 * (samples[n / 2 - 1] + samples[n / 2]);
+    if (n > 1) {
+        double sq = 0.0;
+        for (double v : samples) {
+            sq += (v - stats.mean) * (v - stats.mean);
+        }
+        stats.stddev = std::sqrt(sq / (n - 1));
+    }
+    return stats;
+}
+
+void flush_cache(size_t bytes) {
+    // 静态缓冲区只分配一次；每次写入不同的值，防止编译器把写操作优化掉
+    static std::vector<unsigned char> buffer;
+    static unsigned char              round = 0;
+    if (buffer.size() < bytes) {
+        buffer.resize(bytes);
+    }
+    ++round;
+    for (size_t i = 0; i < bytes; i += 64) {
+        buffer[i] = static_cast<unsigned char>(buffer[i] + round);
+    }
+    volatile unsigned char sink = buffer[bytes > 0 ? bytes - 1 : 0];
+    (void) sink;
+}
+
+// 读取 /proc/cpuinfo 中第一个匹配 key 的字段值
+static std::string read_cpuinfo_field(const std::string & key) {
+    std::ifstream in("/proc/cpuinfo");
+    std::string   line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, key.size(), key) == 0) {
+            auto pos = line.find(':');
+            auto start =
+                (pos == std::string::npos) ? pos : line.find_first_not_of(" \t", pos + 1);
+            return start == std::string::npos ? "" : line.substr(start);
+        }
+    }
+    return "";
+}
+
+BenchmarkMetadata collect_benchmark_metadata() {
+    BenchmarkMetadata meta;
+    meta.cpu_model = read_cpuinfo_field("model name");
+    if (meta.cpu_model.empty()) {
+        meta.cpu_model = "unknown";
+    }
+    std::string mhz = read_cpuinfo_field("cpu MHz");
+    if (!mhz.empty()) {
+        meta.cpu_mhz = std::strtod(mhz.c_str(), nullptr);
+    }
+    std::ifstream max_freq("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq");
+    double        khz = 0.0;
+    if (max_freq >> khz) {
+        meta.cpu_max_mhz = khz / 1000.0;
+    }
+    meta.hardware_threads = std::thread::hardware_concurrency();
+#ifdef _OPENMP
+    meta.omp_max_threads = static_cast<size_t>(omp_get_max_threads());
+#endif
+#if defined(__clang__)
+    meta.compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    meta.compiler = "gcc " __VERSION__;
+#else
+    meta.compiler = "unknown";
+#endif
+#ifdef NDEBUG
+    meta.optimized_build = true;
+#endif
+    std::time_t now = std::time(nullptr);
+    char        buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    meta.timestamp = buf;
+    return meta;
+}
+
 // ==================== 性能结果打印 ====================
 void PerformanceResult::print() const {
-    std::cout << method_name << ": time=" << time_seconds << "s, " << "GFLOPS=" << gflops << ", "
-              << "correct=" << (is_correct ? "yes" : "NO") << std::endl;
+    std::cout << method_name << ": median=" << time_seconds << "s, min=" << min_seconds
+              << "s, stddev=" << stddev_seconds << "s (n=" << repetitions << "), "
+              << "GFLOPS=" << gflops << ", correct=" << (is_correct ? "yes" : "NO")
+              << " (max_err=" << max_abs_error << ")" << std::endl;
+}
+
+// ==================== 结构化输出（CSV）====================
+
+void write_results_csv(std::ostream & os, const BenchmarkMetadata & meta,
+                       const std::vector<PerformanceResult> & results) {
+    std::ostringstream out;
+    out << std::setprecision(9);
+    // 元数据以注释行写在表头之前，常见 CSV 解析器可通过 comment='#' 跳过
+    out << "# cpu_model=" << meta.cpu_model << ", cpu_mhz=" << meta.cpu_mhz
+        << ", hardware_threads=" << meta.hardware_threads
+        << ", omp_max_threads=" << meta.omp_max_threads << ", timestamp=" << meta.timestamp
+        << "\n";
+    out << "name,M,N,K,repetitions,median_s,min_s,mean_s,stddev_s,gflops,peak_gflops,"
+           "max_abs_error,correct\n";
+    for (const auto & r : results) {
+        out << '"' << r.method_name << '"' << ',' << r.M << ',' << r.N << ',' << r.K << ','
+            << r.repetitions << ',' << r.time_seconds << ',' << r.min_seconds << ','
+            << r.mean_seconds << ',' << r.stddev_seconds << ',' << r.gflops << ','
+            << r.peak_gflops << ',' << r.max_abs_error << ',' << (r.is_correct ? 1 : 0) << "\n";
+    }
+    os << out.str();
 }
 
 } // namespace concurrent
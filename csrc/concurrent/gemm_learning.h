@@ -1,15 +1,51 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <iosfwd>
 #include <mutex>
 #include <queue>
+#include <stdexcept>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "microbench.h"
+
+/**
+ * ============================================================================
+ * 元素访问策略（编译期选择）
+ * ============================================================================
+ *
+ * GEMM_CHECKED_ACCESS=1 时 operator() 做边界检查（越界抛 std::out_of_range），
+ * =0 时直接索引。默认跟随构建类型：Debug 检查，Release(NDEBUG) 不检查。
+ * 可通过 -DGEMM_CHECKED_ACCESS=0/1 显式覆盖。
+ *
+ * 教学要点:
+ * - 逐元素边界检查会在最内层循环引入比较+分支，阻止编译器向量化
+ * - 性能关键的内核不走 operator()，而是取行指针(row_ptr)并用指针自增遍历
+ * - GEMM_RESTRICT 向编译器承诺指针之间无别名，使其敢于生成 SIMD 代码
+ */
+#ifndef GEMM_CHECKED_ACCESS
+#    ifdef NDEBUG
+#        define GEMM_CHECKED_ACCESS 0
+#    else
+#        define GEMM_CHECKED_ACCESS 1
+#    endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#    define GEMM_RESTRICT __restrict__
+#elif defined(_MSC_VER)
+#    define GEMM_RESTRICT __restrict
+#else
+#    define GEMM_RESTRICT
+#endif
+
 namespace concurrent {
 
 /**
@@ -22,9 +58,37 @@ class Matrix {
   public:
     Matrix(size_t rows, size_t cols, double init_val = 0.0);
 
-    // 访问元素 - 提供边界检查
-    double &       operator()(size_t i, size_t j);
-    const double & operator()(size_t i, size_t j) const;
+    // 访问元素 - 是否做边界检查由 GEMM_CHECKED_ACCESS 在编译期决定
+    double & operator()(size_t i, size_t j) {
+#if GEMM_CHECKED_ACCESS
+        return at(i, j);
+#else
+        return data_[i * cols_ + j];
+#endif
+    }
+
+    const double & operator()(size_t i, size_t j) const {
+#if GEMM_CHECKED_ACCESS
+        return at(i, j);
+#else
+        return data_[i * cols_ + j];
+#endif
+    }
+
+    // 始终检查边界的访问
+    double & at(size_t i, size_t j) { return data_[checked_index(i, j)]; }
+
+    const double & at(size_t i, size_t j) const { return data_[checked_index(i, j)]; }
+
+    // 始终不检查边界的访问
+    double & unchecked(size_t i, size_t j) { return data_[i * cols_ + j]; }
+
+    const double & unchecked(size_t i, size_t j) const { return data_[i * cols_ + j]; }
+
+    // 第 i 行首元素指针，内核中配合 GEMM_RESTRICT 局部变量使用
+    double * row_ptr(size_t i) { return data_.data() + i * cols_; }
+
+    const double * row_ptr(size_t i) const { return data_.data() + i * cols_; }
 
     // 获取矩阵维度
     size_t rows() const { return rows_; }
@@ -36,13 +100,48 @@ class Matrix {
 
     const double * data() const { return data_.data(); }
 
-    // 随机初始化矩阵
-    void randomize(double min = 0.0, double max = 1.0);
+    /**
+     * @brief 随机初始化矩阵（OpenMP 并行）
+     *
+     * 使用计数器型 Philox 生成器：元素下标即计数器，各线程独立生成自己的区间，
+     * 同一 seed 的结果与线程数无关。
+     */
+    void randomize(double min = 0.0, double max = 1.0, uint64_t seed = 12345);
 
-    // 验证两个矩阵是否相等（用于正确性检查）
+    // 验证两个矩阵是否相等（用于正确性检查，并行 + SIMD）
     bool equals(const Matrix & other, double epsilon = 1e-6) const;
 
+    // 逐元素最大绝对误差；维度不一致时返回 +inf（并行 + SIMD）
+    double max_abs_diff(const Matrix & other) const;
+
+    // Frobenius 范数 sqrt(sum(x^2))；按固定大小分段求和，结果与线程数无关
+    double frobenius_norm() const;
+
+    // 最大绝对值 max(|x|)
+    double max_norm() const;
+
+    /**
+     * @brief 二进制保存/加载（多线程 pwrite/pread 分段并行读写）
+     *
+     * 文件格式: "CQLM" | uint32 版本 | uint64 rows | uint64 cols | rows*cols 个 double（本机字节序）
+     * load 先用文件大小核对头部的 rows*cols，再分配内存
+     * @throws std::runtime_error 打开/读写失败或文件格式不符
+     */
+    void save(const std::string & path) const;
+
+    static Matrix load(const std::string & path);
+
+    // 将所有元素置为 value（基准测试每次运行前清零输出）
+    void fill(double value);
+
   private:
+    size_t checked_index(size_t i, size_t j) const {
+        if (i >= rows_ || j >= cols_) {
+            throw std::out_of_range("Matrix index out of range");
+        }
+        return i * cols_ + j;
+    }
+
     size_t              rows_;
     size_t              cols_;
     std::vector<double> data_;
@@ -213,6 +312,30 @@ class ThreadPool {
 void gemm_threadpool(ThreadPool & pool, const Matrix & A, const Matrix & B, Matrix & C,
                      size_t task_granularity = 16);
 
+/**
+ * ============================================================================
+ * 对照组：逐元素边界检查版本
+ * ============================================================================
+ *
+ * 与上面各函数的循环结构、并行方式完全相同，唯一区别是内层循环通过
+ * Matrix::at() 逐元素访问（每次都做边界检查），不使用行指针。
+ * 用于在 gemm_demo 中量化“去掉逐元素检查 + 指针自增”带来的加速。
+ */
+namespace checked {
+
+void gemm_serial_naive(const Matrix & A, const Matrix & B, Matrix & C);
+void gemm_serial_blocked(const Matrix & A, const Matrix & B, Matrix & C, size_t block_size = 64);
+void gemm_thread_parallel(const Matrix & A, const Matrix & B, Matrix & C, size_t num_threads = 4);
+void gemm_thread_blocked(const Matrix & A, const Matrix & B, Matrix & C, size_t num_threads = 4,
+                         size_t block_size = 64);
+void gemm_openmp_simple(const Matrix & A, const Matrix & B, Matrix & C,
+                        const std::string & schedule_type = "static");
+void gemm_openmp_blocked(const Matrix & A, const Matrix & B, Matrix & C, size_t block_size = 64);
+void gemm_threadpool(ThreadPool & pool, const Matrix & A, const Matrix & B, Matrix & C,
+                     size_t task_granularity = 16);
+
+} // namespace checked
+
 /**
  * ============================================================================
  * 性能测试和验证工具
@@ -237,39 +360,158 @@ class Timer {
     std::chrono::high_resolution_clock::time_point start_;
 };
 
+/**
+ * @brief 基准测试选项
+ *
+ * 教学要点:
+ * - 预热(warm-up)：让页表、缓存、CPU 频率进入稳定状态，首轮结果不计入
+ * - 多次重复：单次计时受调度、中断影响，取中位数比平均值更稳健
+ * - 清空缓存：避免上一次运行把 A/B 留在缓存里，使各变体处于相同起点
+ */
+struct BenchmarkOptions {
+    size_t warmup_runs = 1;
+    size_t repetitions = 5;
+    bool   flush_cache = true;
+    size_t flush_bytes = size_t(64) << 20; // 应大于末级缓存(LLC)
+    double tolerance   = 1e-6; // 与参考结果的最大允许绝对误差
+};
+
+/**
+ * @brief 一组计时样本的统计量
+ */
+struct SampleStats {
+    double min    = 0.0;
+    double max    = 0.0;
+    double mean   = 0.0;
+    double median = 0.0;
+    double stddev = 0.0; // 样本标准差(n-1)
+};
+
+SampleStats summarize_samples(std::vector<double> samples);
+
+/**
+ * @brief 通过顺序写一块大缓冲区把 A/B/C 挤出缓存
+ */
+void flush_cache(size_t bytes);
+
+/**
+ * @brief 运行环境元数据，随结果一起输出，便于跨机器/跨版本对比
+ */
+struct BenchmarkMetadata {
+    std::string cpu_model;
+    double      cpu_mhz          = 0.0; // /proc/cpuinfo 中的当前频率
+    double      cpu_max_mhz      = 0.0; // cpufreq 报告的最大频率（不可用时为 0）
+    size_t      hardware_threads = 0;
+    size_t      omp_max_threads  = 1;
+    std::string compiler;
+    bool        optimized_build = false; // 是否定义了 NDEBUG
+    std::string timestamp;
+};
+
+BenchmarkMetadata collect_benchmark_metadata();
+
 /**
  * @brief 性能统计结构
+ *
+ * time_seconds / gflops 取自中位数样本，min/stddev 用于判断测量噪声
  */
 struct PerformanceResult {
     std::string method_name;
-    double      time_seconds;
-    double      gflops; // 十亿次浮点运算/秒
-    bool        is_correct;
+    double      time_seconds = 0.0; // 中位数耗时
+    double      gflops       = 0.0; // 十亿次浮点运算/秒（按中位数计算）
+    bool        is_correct   = false;
+
+    size_t M = 0, N = 0, K = 0;
+    size_t repetitions    = 0;
+    double min_seconds    = 0.0;
+    double mean_seconds   = 0.0;
+    double stddev_seconds = 0.0;
+    double peak_gflops    = 0.0; // 按最快一次计算
+    double max_abs_error  = 0.0;
+
+    std::vector<double> samples_seconds; // 每次计时重复的原始耗时，供回归对比做统计检验
 
     void print() const;
 };
 
+/**
+ * @brief 以 CSV 输出一组结果（带元数据注释行），便于导入表格；
+ *        回归跟踪用的 JSON 由 microbench::Report 统一写出
+ */
+void write_results_csv(std::ostream & os, const BenchmarkMetadata & meta,
+                       const std::vector<PerformanceResult> & results);
+
 /**
  * @brief 运行单个GEMM测试并返回性能结果
+ *
+ * 每次运行使用独立的输出矩阵并在计时前清零（分块版本是累加语义），
+ * 结果与 reference（应由参考内核单独计算）逐元素比较。
  */
 template <typename GemmFunc, typename... Args>
+PerformanceResult benchmark_gemm(const BenchmarkOptions & options, const std::string & name,
+                                 GemmFunc && func, const Matrix & A, const Matrix & B,
+                                 const Matrix & reference, Args &&... args);
+
+// 使用默认选项的简化版本
+template <typename GemmFunc, typename... Args>
 PerformanceResult benchmark_gemm(const std::string & name, GemmFunc && func, const Matrix & A,
                                  const Matrix & B, const Matrix & reference, Args &&... args);
 
 // Template implementation must be visible to users of the header (define here)
 template <typename GemmFunc, typename... Args>
-PerformanceResult benchmark_gemm(const std::string & name, GemmFunc && func, const Matrix & A,
-                                 const Matrix & B, const Matrix & reference, Args &&... args) {
-    Timer  t;
+PerformanceResult benchmark_gemm(const BenchmarkOptions & options, const std::string & name,
+                                 GemmFunc && func, const Matrix & A, const Matrix & B,
+                                 const Matrix & reference, Args &&... args) {
     Matrix C(A.rows(), B.cols(), 0.0);
-    // Call the provided GEMM implementation (may accept extra args)
-    func(A, B, C, std::forward<Args>(args)...);
-    double elapsed = t.elapsed();
-    double ops     = 2.0 * static_cast<double>(A.rows()) * static_cast<double>(A.cols()) *
+
+    // 单次运行：清零输出、清空缓存（均不计时），然后只计时内核本身
+    auto run_once = [&]() {
+        C.fill(0.0);
+        if (options.flush_cache) {
+            flush_cache(options.flush_bytes);
+        }
+        return microbench::Seconds([&] { func(A, B, C, args...); });
+    };
+
+    for (size_t i = 0; i < options.warmup_runs; ++i) {
+        run_once();
+    }
+
+    std::vector<double> samples;
+    size_t              reps = std::max<size_t>(1, options.repetitions);
+    samples.reserve(reps);
+    for (size_t i = 0; i < reps; ++i) {
+        samples.push_back(run_once());
+    }
+
+    SampleStats stats = summarize_samples(samples);
+    double      ops   = 2.0 * static_cast<double>(A.rows()) * static_cast<double>(A.cols()) *
                  static_cast<double>(B.cols());
-    double gflops = (ops / 1e9) / elapsed;
-    bool   ok     = C.equals(reference);
-    return PerformanceResult{ name, elapsed, gflops, ok };
+
+    PerformanceResult result;
+    result.method_name    = name;
+    result.M              = A.rows();
+    result.N              = B.cols();
+    result.K              = A.cols();
+    result.repetitions    = reps;
+    result.time_seconds   = stats.median;
+    result.min_seconds    = stats.min;
+    result.mean_seconds   = stats.mean;
+    result.stddev_seconds = stats.stddev;
+    result.gflops         = (ops / 1e9) / stats.median;
+    result.peak_gflops    = (ops / 1e9) / stats.min;
+    result.max_abs_error  = C.max_abs_diff(reference);
+    result.is_correct     = result.max_abs_error <= options.tolerance;
+
+    result.samples_seconds = std::move(samples);
+    return result;
+}
+
+template <typename GemmFunc, typename... Args>
+PerformanceResult benchmark_gemm(const std::string & name, GemmFunc && func, const Matrix & A,
+                                 const Matrix & B, const Matrix & reference, Args &&... args) {
+    return benchmark_gemm(BenchmarkOptions{}, name, std::forward<GemmFunc>(func), A, B, reference,
+                          std::forward<Args>(args)...);
 }
 
 } // namespace concurrent
@@ -0,0 +1,125 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "gemm_learning.h"
+
+#ifdef _OPENMP
+#    include <omp.h>
+#endif
+
+using namespace concurrent;
+
+namespace {
+
+int max_threads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+void set_threads(int n) {
+#ifdef _OPENMP
+    omp_set_num_threads(n);
+#else
+    (void) n;
+#endif
+}
+
+bool bitwise_equal(const Matrix & a, const Matrix & b) {
+    return a.rows() == b.rows() && a.cols() == b.cols() &&
+           std::memcmp(a.data(), b.data(), a.rows() * a.cols() * sizeof(double)) == 0;
+}
+
+} // namespace
+
+// 用法: matrix_utils_demo [矩阵规模N] [临时文件路径]
+int main(int argc, char * argv[]) {
+    size_t      N     = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    std::string path  = argc > 2 ? argv[2] : "/tmp/matrix_utils_demo.bin";
+    int         T     = max_threads();
+    double      bytes = double(N) * N * sizeof(double);
+
+    std::cout << "========== 并行矩阵初始化 / 校验 / 读写 ==========\n\n";
+    std::cout << "矩阵规模: " << N << "x" << N << " (" << bytes / (1 << 20) << " MiB), 线程: " << T
+              << "\n\n";
+
+    // 1. 初始化：旧的单个 mt19937_64 串行填充 vs Philox 并行填充
+    Matrix A(N, N), A1(N, N);
+    Timer  t;
+    {
+        std::mt19937_64                        rng(12345);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        for (size_t i = 0; i < N * N; ++i) {
+            A.data()[i] = dist(rng);
+        }
+    }
+    double t_mt = t.elapsed();
+
+    set_threads(1);
+    t.reset();
+    A1.randomize(-1.0, 1.0, 42);
+    double t_philox1 = t.elapsed();
+
+    set_threads(T);
+    t.reset();
+    A.randomize(-1.0, 1.0, 42);
+    double t_philox = t.elapsed();
+
+    std::cout << "初始化:\n";
+    std::cout << "  mt19937_64 串行      : " << t_mt << "s\n";
+    std::cout << "  Philox 1 线程        : " << t_philox1 << "s\n";
+    std::cout << "  Philox " << T << " 线程        : " << t_philox << "s\n";
+    std::cout << "  不同线程数结果逐位一致: " << (bitwise_equal(A, A1) ? "yes" : "NO") << "\n\n";
+
+    // 2. 比较与范数：1 线程 vs 全部线程
+    Matrix B = A;
+    B.data()[N * N / 2] += 1e-3;
+
+    std::cout << std::left << std::setw(22) << "校验" << std::setw(14) << "1 线程(s)" << std::setw(14)
+              << (std::to_string(T) + " 线程(s)") << "结果一致\n";
+    auto compare = [&](const char * name, auto && op) {
+        set_threads(1);
+        Timer t1;
+        auto  r1  = op();
+        double s1 = t1.elapsed();
+        set_threads(T);
+        Timer tn;
+        auto  rn  = op();
+        double sn = tn.elapsed();
+        std::cout << std::setw(22) << name << std::setw(14) << s1 << std::setw(14) << sn
+                  << (r1 == rn ? "yes" : "NO") << "  (" << rn << ")\n";
+    };
+    compare("equals", [&] { return A.equals(B); });
+    compare("max_abs_diff", [&] { return A.max_abs_diff(B); });
+    compare("frobenius_norm", [&] { return A.frobenius_norm(); });
+    compare("max_norm", [&] { return A.max_norm(); });
+
+    // 3. 二进制保存 / 加载
+    t.reset();
+    A.save(path);
+    double t_save = t.elapsed();
+    t.reset();
+    Matrix L = Matrix::load(path);
+    double t_load = t.elapsed();
+    std::remove(path.c_str());
+
+    std::cout << "\n读写 (" << path << "):\n";
+    std::cout << "  save: " << t_save << "s, " << bytes / t_save / 1e9 << " GB/s\n";
+    std::cout << "  load: " << t_load << "s, " << bytes / t_load / 1e9 << " GB/s\n";
+    std::cout << "  往返结果逐位一致: " << (bitwise_equal(A, L) ? "yes" : "NO") << "\n";
+
+    std::cout << "\n关键学习点总结：\n";
+    std::cout << "1. 计数器型 RNG 没有串行依赖，第 n 个数可直接计算，天然可并行且结果可复现\n";
+    std::cout << "2. max 归约与顺序无关；求和归约按固定分段合并，避免结果随线程数变化\n";
+    std::cout << "3. 无分支的计数/最大值循环可以被 SIMD 向量化，比提前退出的循环更快\n";
+    std::cout << "4. pwrite/pread 带偏移量，多个线程可以无锁地并行读写同一文件的不同区间\n\n";
+
+    return 0;
+}
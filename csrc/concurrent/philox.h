@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace concurrent {
+
+/**
+ * @brief Philox4x32-10 计数器型随机数生成器
+ *
+ * 教学要点:
+ * - 输出只取决于 (counter, key)，没有内部状态：第 n 个随机数可以直接算出，
+ *   不需要先生成前 n-1 个，因此可以任意切分给线程并行生成
+ * - 结果与线程数、调度方式无关，同一 seed 总是得到同一矩阵
+ * - 10 轮“乘法 + 异或”足以通过 BigCrush 统计测试（Salmon et al., SC'11）
+ */
+class Philox4x32 {
+  public:
+    using Result = std::array<uint32_t, 4>;
+
+    explicit Philox4x32(uint64_t seed) :
+        key_{ static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) } {}
+
+    // 返回计数器 counter 对应的 4 个 32 位随机数
+    Result operator()(uint64_t counter) const {
+        Result   ctr = { static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), 0,
+                         0 };
+        uint32_t k0 = key_[0], k1 = key_[1];
+        for (int round = 0; round < 10; ++round) {
+            ctr = single_round(ctr, k0, k1);
+            k0 += kWeyl0;
+            k1 += kWeyl1;
+        }
+        return ctr;
+    }
+
+    // 把两个 32 位随机数拼成 [0, 1) 上的 double（取高 53 位）
+    static double to_unit_double(uint32_t hi, uint32_t lo) {
+        uint64_t bits = (uint64_t(hi) << 32 | lo) >> 11;
+        return static_cast<double>(bits) * (1.0 / 9007199254740992.0); // 2^-53
+    }
+
+  private:
+    static constexpr uint32_t kMul0  = 0xD2511F53u;
+    static constexpr uint32_t kMul1  = 0xCD9E8D57u;
+    static constexpr uint32_t kWeyl0 = 0x9E3779B9u;
+    static constexpr uint32_t kWeyl1 = 0xBB67AE85u;
+
+    static Result single_round(const Result & c, uint32_t k0, uint32_t k1) {
+        uint64_t p0 = uint64_t(kMul0) * c[0];
+        uint64_t p1 = uint64_t(kMul1) * c[2];
+        return { static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k0, static_cast<uint32_t>(p1),
+                 static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k1, static_cast<uint32_t>(p0) };
+    }
+
+    std::array<uint32_t, 2> key_;
+};
+
+} // namespace concurrent
@@ -0,0 +1,348 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "quantized_gemm.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#    define QGEMM_HAVE_X86 1
+#    include <immintrin.h>
+#else
+#    define QGEMM_HAVE_X86 0
+#endif
+
+namespace concurrent {
+
+// ==================== 量化 / 反量化 ====================
+// 教学要点：先按通道统计取值范围，再由范围得到 scale / zero_point，最后逐元素取整并截断
+
+namespace {
+
+template <typename T>
+QuantizedMatrix<T> quantize_impl(const Matrix & m, QuantScheme scheme, QuantAxis axis,
+                                 bool reduce_range) {
+    int32_t qmin = std::numeric_limits<T>::min();
+    int32_t qmax = std::numeric_limits<T>::max();
+    if (reduce_range) {
+        qmin /= 2;
+        qmax /= 2;
+    }
+
+    QuantizedMatrix<T> q;
+    q.rows         = m.rows();
+    q.cols         = m.cols();
+    q.scheme       = scheme;
+    q.axis         = axis;
+    q.reduce_range = reduce_range;
+    q.data.resize(q.rows * q.cols);
+
+    size_t channels = axis == QuantAxis::PerRow ? q.rows : q.cols;
+    q.scales.assign(channels, 1.0f);
+    q.zero_points.assign(channels, 0);
+
+    // 1. 统计每个通道的 [lo, hi]，并把 0 包含进来，保证 0.0 可以被精确表示
+    std::vector<double> lo(channels, 0.0), hi(channels, 0.0);
+    for (size_t i = 0; i < q.rows; ++i) {
+        const double * row = m.row_ptr(i);
+        for (size_t j = 0; j < q.cols; ++j) {
+            size_t c = q.channel(i, j);
+            lo[c]    = std::min(lo[c], row[j]);
+            hi[c]    = std::max(hi[c], row[j]);
+        }
+    }
+
+    // 2. 由范围计算 scale / zero_point
+    for (size_t c = 0; c < channels; ++c) {
+        double scale = 1.0;
+        if (scheme == QuantScheme::Symmetric) {
+            // 对称：零点在区间中点，正负两侧使用相同的整数个数
+            int32_t half     = (qmax - qmin) / 2;
+            double  max_abs  = std::max(-lo[c], hi[c]);
+            scale            = max_abs > 0.0 ? max_abs / half : 1.0;
+            q.zero_points[c] = qmin + (qmax - qmin + 1) / 2;
+        } else {
+            // 非对称：[lo, hi] 线性映射到 [qmin, qmax]
+            double range     = hi[c] - lo[c];
+            scale            = range > 0.0 ? range / (qmax - qmin) : 1.0;
+            double zp        = std::nearbyint(qmin - lo[c] / scale);
+            q.zero_points[c] = static_cast<int32_t>(std::clamp<double>(zp, qmin, qmax));
+        }
+        q.scales[c] = static_cast<float>(scale);
+    }
+
+    // 3. 逐元素量化：q = clamp(round(x / scale) + zero_point)
+    for (size_t i = 0; i < q.rows; ++i) {
+        const double * row = m.row_ptr(i);
+        T *            out = q.data.data() + i * q.cols;
+        for (size_t j = 0; j < q.cols; ++j) {
+            size_t c = q.channel(i, j);
+            double v = std::nearbyint(row[j] / q.scales[c]) + q.zero_points[c];
+            out[j]   = static_cast<T>(std::clamp<double>(v, qmin, qmax));
+        }
+    }
+    return q;
+}
+
+template <typename T> Matrix dequantize_impl(const QuantizedMatrix<T> & q) {
+    Matrix m(q.rows, q.cols);
+    for (size_t i = 0; i < q.rows; ++i) {
+        double * row = m.row_ptr(i);
+        for (size_t j = 0; j < q.cols; ++j) {
+            size_t c = q.channel(i, j);
+            row[j]   = double(q.scales[c]) * (int32_t(q.value(i, j)) - q.zero_points[c]);
+        }
+    }
+    return m;
+}
+
+} // namespace
+
+QuantizedMatrixS8 quantize_s8(const Matrix & m, QuantScheme scheme, QuantAxis axis,
+                              bool reduce_range) {
+    return quantize_impl<int8_t>(m, scheme, axis, reduce_range);
+}
+
+QuantizedMatrixU8 quantize_u8(const Matrix & m, QuantScheme scheme, QuantAxis axis,
+                              bool reduce_range) {
+    return quantize_impl<uint8_t>(m, scheme, axis, reduce_range);
+}
+
+Matrix dequantize(const QuantizedMatrixS8 & q) {
+    return dequantize_impl(q);
+}
+
+Matrix dequantize(const QuantizedMatrixU8 & q) {
+    return dequantize_impl(q);
+}
+
+QuantizedMatrixU8 to_unsigned(const QuantizedMatrixS8 & q) {
+    QuantizedMatrixU8 u;
+    u.rows         = q.rows;
+    u.cols         = q.cols;
+    u.scheme       = q.scheme;
+    u.axis         = q.axis;
+    u.reduce_range = false; // 平移后取值为 [64, 191]，不再是 7 位
+    u.scales       = q.scales;
+    u.data.resize(q.data.size());
+    for (size_t i = 0; i < q.data.size(); ++i) {
+        u.data[i] = static_cast<uint8_t>(int32_t(q.data[i]) + 128);
+    }
+    u.zero_points.resize(q.zero_points.size());
+    for (size_t c = 0; c < q.zero_points.size(); ++c) {
+        u.zero_points[c] = q.zero_points[c] + 128;
+    }
+    return u;
+}
+
+// ==================== 整数点积内核 ====================
+// 教学要点：A 的行与 B 的列都打包成 K 方向连续的字节数组（B 预先转置），
+// 每个 C[i][j] 就是两段连续内存的 u8 x s8 点积，K 补零到 64 的倍数，SIMD 无需尾部处理
+
+namespace {
+
+constexpr size_t kQGemmKAlign = 64;
+
+using DotKernel = int32_t (*)(const uint8_t *, const int8_t *, size_t);
+
+int32_t dot_portable(const uint8_t * a, const int8_t * b, size_t k_padded) {
+    int32_t acc = 0;
+    for (size_t k = 0; k < k_padded; ++k) {
+        acc += int32_t(a[k]) * int32_t(b[k]);
+    }
+    return acc;
+}
+
+#if QGEMM_HAVE_X86
+
+__attribute__((target("avx2"))) int32_t hsum_epi32_avx2(__m256i v) {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s         = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s         = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+// 先把 16 个 u8 / s8 扩展为 int16，再用 vpmaddwd 相邻两项相乘相加到 int32：无饱和，结果精确
+__attribute__((target("avx2"))) int32_t dot_avx2_madd(const uint8_t * a, const int8_t * b,
+                                                      size_t k_padded) {
+    __m256i acc = _mm256_setzero_si256();
+    for (size_t k = 0; k < k_padded; k += 16) {
+        __m256i va = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (a + k)));
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *) (b + k)));
+        acc        = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+    return hsum_epi32_avx2(acc);
+}
+
+// vpmaddubsw: 32 对 u8*s8，相邻两项相加并饱和到 int16；再与 1 做 vpmaddwd 得到 int32。
+// 每条指令处理的字节数是上面的两倍，但要求 A 只用 7 位，否则 int16 会饱和
+__attribute__((target("avx2"))) int32_t dot_avx2_maddubs(const uint8_t * a, const int8_t * b,
+                                                         size_t k_padded) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i       acc  = _mm256_setzero_si256();
+    for (size_t k = 0; k < k_padded; k += 32) {
+        __m256i va  = _mm256_loadu_si256((const __m256i *) (a + k));
+        __m256i vb  = _mm256_loadu_si256((const __m256i *) (b + k));
+        __m256i p16 = _mm256_maddubs_epi16(va, vb);
+        acc         = _mm256_add_epi32(acc, _mm256_madd_epi16(p16, ones));
+    }
+    return hsum_epi32_avx2(acc);
+}
+
+// vpdpbusd: 每个 int32 通道累加 4 组 u8*s8，中间结果不经过 int16，不会饱和
+__attribute__((target("avx512f,avx512bw,avx512vnni"))) int32_t
+dot_avx512_vnni(const uint8_t * a, const int8_t * b, size_t k_padded) {
+    __m512i acc = _mm512_setzero_si512();
+    for (size_t k = 0; k < k_padded; k += 64) {
+        acc = _mm512_dpbusd_epi32(acc, _mm512_loadu_si512(a + k), _mm512_loadu_si512(b + k));
+    }
+    // 手工折半归约。GCC 12 的 _mm512_reduce_add_epi32、_mm512_castsi512_si256 和
+    // _mm512_extracti64x4_epi64 都以 _mm256_undefined_si256() 作直通值，会误报
+    // -Wuninitialized；全掩码的 maskz 版本直通值是零，结果相同
+    __m256i lo = _mm512_maskz_extracti64x4_epi64(0xFF, acc, 0);
+    __m256i hi = _mm512_maskz_extracti64x4_epi64(0xFF, acc, 1);
+    return hsum_epi32_avx2(_mm256_add_epi32(lo, hi));
+}
+
+#endif // QGEMM_HAVE_X86
+
+DotKernel select_dot_kernel(QGemmKernel kernel) {
+    switch (kernel) {
+#if QGEMM_HAVE_X86
+        case QGemmKernel::Avx2Madd:
+            return dot_avx2_madd;
+        case QGemmKernel::Avx2Maddubs:
+            return dot_avx2_maddubs;
+        case QGemmKernel::Avx512Vnni:
+            return dot_avx512_vnni;
+#endif
+        default:
+            return dot_portable;
+    }
+}
+
+} // namespace
+
+const char * to_string(QGemmKernel kernel) {
+    switch (kernel) {
+        case QGemmKernel::Auto:
+            return "auto";
+        case QGemmKernel::Portable:
+            return "portable";
+        case QGemmKernel::Avx2Madd:
+            return "avx2-vpmaddwd";
+        case QGemmKernel::Avx2Maddubs:
+            return "avx2-vpmaddubsw";
+        case QGemmKernel::Avx512Vnni:
+            return "avx512-vnni";
+    }
+    return "unknown";
+}
+
+bool qgemm_kernel_available(QGemmKernel kernel) {
+    switch (kernel) {
+        case QGemmKernel::Auto:
+        case QGemmKernel::Portable:
+            return true;
+#if QGEMM_HAVE_X86
+        case QGemmKernel::Avx2Madd:
+        case QGemmKernel::Avx2Maddubs:
+            return __builtin_cpu_supports("avx2");
+        case QGemmKernel::Avx512Vnni:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                   __builtin_cpu_supports("avx512vnni");
+#endif
+        default:
+            return false;
+    }
+}
+
+// ==================== 量化 GEMM ====================
+
+QGemmKernel gemm_quantized(const QuantizedMatrixU8 & A, const QuantizedMatrixS8 & B, Matrix & C,
+                           QGemmKernel kernel) {
+    size_t M = A.rows, K = A.cols, N = B.cols;
+    if (B.rows != K || C.rows() != M || C.cols() != N) {
+        throw std::invalid_argument("gemm_quantized: dimension mismatch");
+    }
+    if (A.axis != QuantAxis::PerRow || B.axis != QuantAxis::PerColumn) {
+        throw std::invalid_argument("gemm_quantized: A must be per-row and B per-column");
+    }
+
+    // 选择内核：VNNI > vpmaddubsw(仅 7 位 A) > vpmaddwd > 标量
+    if (kernel == QGemmKernel::Auto) {
+        if (qgemm_kernel_available(QGemmKernel::Avx512Vnni)) {
+            kernel = QGemmKernel::Avx512Vnni;
+        } else if (A.reduce_range && qgemm_kernel_available(QGemmKernel::Avx2Maddubs)) {
+            kernel = QGemmKernel::Avx2Maddubs;
+        } else if (qgemm_kernel_available(QGemmKernel::Avx2Madd)) {
+            kernel = QGemmKernel::Avx2Madd;
+        } else {
+            kernel = QGemmKernel::Portable;
+        }
+    }
+    if (!qgemm_kernel_available(kernel)) {
+        throw std::invalid_argument(std::string("gemm_quantized: kernel not available: ") +
+                                    to_string(kernel));
+    }
+    if (kernel == QGemmKernel::Avx2Maddubs && !A.reduce_range) {
+        throw std::invalid_argument("gemm_quantized: vpmaddubsw requires reduce_range A");
+    }
+    DotKernel dot = select_dot_kernel(kernel);
+
+    // 打包：A 按行、B 转置后按列，K 方向补零对齐；同时计算零点修正需要的行/列和
+    size_t               Kp = (K + kQGemmKAlign - 1) / kQGemmKAlign * kQGemmKAlign;
+    std::vector<uint8_t> a_pack(M * Kp, 0);
+    std::vector<int8_t>  b_pack(N * Kp, 0);
+    std::vector<int32_t> rowsum_a(M, 0), colsum_b(N, 0);
+    for (size_t i = 0; i < M; ++i) {
+        std::copy_n(A.data.data() + i * K, K, a_pack.data() + i * Kp);
+        for (size_t k = 0; k < K; ++k) {
+            rowsum_a[i] += A.value(i, k);
+        }
+    }
+    for (size_t k = 0; k < K; ++k) {
+        for (size_t j = 0; j < N; ++j) {
+            int8_t v = B.value(k, j);
+            b_pack[j * Kp + k] = v;
+            colsum_b[j] += v;
+        }
+    }
+
+    // 主循环：按行块并行，列方向分块让一块打包后的 B 留在 L2 中
+    constexpr size_t kRowBlock  = 16;
+    constexpr size_t kColBlock  = 128;
+    const int32_t    Ki         = static_cast<int32_t>(K);
+    const int        row_blocks = static_cast<int>((M + kRowBlock - 1) / kRowBlock);
+
+#pragma omp parallel for schedule(static)
+    for (int rb = 0; rb < row_blocks; ++rb) {
+        size_t i_begin = rb * kRowBlock;
+        size_t i_end   = std::min(i_begin + kRowBlock, M);
+        for (size_t jj = 0; jj < N; jj += kColBlock) {
+            size_t j_end = std::min(jj + kColBlock, N);
+            for (size_t i = i_begin; i < i_end; ++i) {
+                const uint8_t * a_row = a_pack.data() + i * Kp;
+                int32_t         za    = A.zero_points[i];
+                double          sa    = A.scales[i];
+                double *        c_row = C.row_ptr(i);
+                for (size_t j = jj; j < j_end; ++j) {
+                    int32_t acc = dot(a_row, b_pack.data() + j * Kp, Kp);
+                    // epilogue：零点修正 + 反量化
+                    int32_t zb        = B.zero_points[j];
+                    int64_t corrected = int64_t(acc) - int64_t(za) * colsum_b[j] -
+                                        int64_t(zb) * rowsum_a[i] + int64_t(Ki) * za * zb;
+                    c_row[j]          = sa * double(B.scales[j]) * double(corrected);
+                }
+            }
+        }
+    }
+    return kernel;
+}
+
+QGemmKernel gemm_quantized(const QuantizedMatrixS8 & A, const QuantizedMatrixS8 & B, Matrix & C,
+                           QGemmKernel kernel) {
+    return gemm_quantized(to_unsigned(A), B, C, kernel);
+}
+
+} // namespace concurrent
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gemm_learning.h"
+
+namespace concurrent {
+
+/**
+ * ============================================================================
+ * 低精度量化 GEMM (int8 x int8 -> int32)
+ * ============================================================================
+ *
+ * 仿射量化: real = scale * (q - zero_point)
+ *
+ * 教学要点:
+ * - 对称量化: zero_point 固定（int8 为 0，uint8 为 128），只需一个 scale
+ * - 非对称量化: 用 [min, max] 计算 scale 与 zero_point，充分利用整数区间
+ * - 逐通道(per-row / per-column)量化: 每行/列一个 scale，比整张矩阵一个 scale 精度高
+ * - 整数乘加在 int32 中累加，零点修正与 scale 缩放放在尾部(epilogue)一次完成
+ */
+
+// 量化方式
+enum class QuantScheme {
+    Symmetric, // zero_point 固定在整数区间中点
+    Asymmetric, // 由 min/max 计算 zero_point
+};
+
+// 量化参数(scale/zero_point)沿哪个方向变化
+enum class QuantAxis {
+    PerRow, // 每行一组参数（GEMM 中用于 A）
+    PerColumn, // 每列一组参数（GEMM 中用于 B）
+};
+
+/**
+ * @brief 量化后的矩阵（行主序），T 为 int8_t 或 uint8_t
+ */
+template <typename T> struct QuantizedMatrix {
+    size_t               rows         = 0;
+    size_t               cols         = 0;
+    QuantScheme          scheme       = QuantScheme::Symmetric;
+    QuantAxis            axis         = QuantAxis::PerRow;
+    bool                 reduce_range = false; // 是否只使用 7 位(见 quantize 说明)
+    std::vector<T>       data;
+    std::vector<float>   scales; // 长度为 rows(PerRow) 或 cols(PerColumn)
+    std::vector<int32_t> zero_points;
+
+    T value(size_t i, size_t j) const { return data[i * cols + j]; }
+
+    // 元素(i,j)对应的参数下标
+    size_t channel(size_t i, size_t j) const { return axis == QuantAxis::PerRow ? i : j; }
+};
+
+using QuantizedMatrixS8 = QuantizedMatrix<int8_t>;
+using QuantizedMatrixU8 = QuantizedMatrix<uint8_t>;
+
+/**
+ * @brief 将 double 矩阵量化为 int8 / uint8
+ *
+ * @param reduce_range 只使用一半整数区间(uint8: [0,127]，int8: [-64,63])。
+ *        u8 x s8 的 vpmaddubsw 会把相邻两个乘积相加并饱和到 int16，
+ *        全区间输入时 255*127*2 会溢出；限制到 7 位后结果是精确的。
+ */
+QuantizedMatrixS8 quantize_s8(const Matrix & m, QuantScheme scheme, QuantAxis axis,
+                              bool reduce_range = false);
+QuantizedMatrixU8 quantize_u8(const Matrix & m, QuantScheme scheme, QuantAxis axis,
+                              bool reduce_range = false);
+
+// 反量化，用于检查量化误差
+Matrix dequantize(const QuantizedMatrixS8 & q);
+Matrix dequantize(const QuantizedMatrixU8 & q);
+
+/**
+ * @brief int8 -> uint8 的无损转换: q + 128, zero_point + 128
+ *
+ * u8 x s8 是 x86 整数点积指令的原生格式，int8 的 A 先转成 uint8 再计算。
+ */
+QuantizedMatrixU8 to_unsigned(const QuantizedMatrixS8 & q);
+
+// 整数 GEMM 内核实现
+enum class QGemmKernel {
+    Auto, // 运行时选择可用的最快实现
+    Portable, // 纯 C++ 标量实现，所有平台可用
+    Avx2Madd, // AVX2: 扩展到 int16 后 vpmaddwd，结果精确
+    Avx2Maddubs, // AVX2: vpmaddubsw + vpmaddwd，要求 A 为 reduce_range
+    Avx512Vnni, // AVX-512 VNNI: vpdpbusd 一条指令完成 4 组 u8*s8 并累加到 int32
+};
+
+const char * to_string(QGemmKernel kernel);
+
+// 当前 CPU 与编译器是否支持该内核（Auto / Portable 总是可用）
+bool qgemm_kernel_available(QGemmKernel kernel);
+
+/**
+ * @brief 量化 GEMM: C = dequant(A) * dequant(B)
+ *
+ * 教学要点:
+ * - A(MxK) 必须逐行量化，B(KxN) 必须逐列量化，scale 才能从 K 方向的求和中提出
+ * - 内核只做 int32 累加: acc = sum_k qa[i,k] * qb[k,j]
+ * - epilogue 做零点修正与反量化:
+ *     C[i,j] = sa_i * sb_j * (acc - za_i * colsum_b[j] - zb_j * rowsum_a[i] + K * za_i * zb_j)
+ *
+ * @return 实际使用的内核
+ * @throws std::invalid_argument 维度/量化方向不匹配，或请求的内核不可用
+ */
+QGemmKernel gemm_quantized(const QuantizedMatrixU8 & A, const QuantizedMatrixS8 & B, Matrix & C,
+                           QGemmKernel kernel = QGemmKernel::Auto);
+
+// int8 的 A 先无损转换为 uint8
+QGemmKernel gemm_quantized(const QuantizedMatrixS8 & A, const QuantizedMatrixS8 & B, Matrix & C,
+                           QGemmKernel kernel = QGemmKernel::Auto);
+
+} // namespace concurrent
@@ -0,0 +1,122 @@
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "quantized_gemm.h"
+
+using namespace concurrent;
+
+namespace {
+
+// 相对 Frobenius 误差 ||C - ref|| / ||ref||
+double relative_error(const Matrix & C, const Matrix & ref) {
+    double num = 0.0, den = 0.0;
+    for (size_t i = 0; i < C.rows() * C.cols(); ++i) {
+        double d = C.data()[i] - ref.data()[i];
+        num += d * d;
+        den += ref.data()[i] * ref.data()[i];
+    }
+    return den > 0.0 ? std::sqrt(num / den) : std::sqrt(num);
+}
+
+// 运行 reps 次取中位数耗时
+template <typename Func> double median_seconds(size_t reps, Func && func) {
+    func(); // 预热
+    std::vector<double> samples;
+    for (size_t r = 0; r < reps; ++r) {
+        Timer t;
+        func();
+        samples.push_back(t.elapsed());
+    }
+    return summarize_samples(samples).median;
+}
+
+} // namespace
+
+// 用法: quantized_gemm_demo [矩阵规模M] [重复次数]
+int main(int argc, char * argv[]) {
+    size_t M    = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 512;
+    size_t reps = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+    double ops  = 2.0 * M * M * M;
+
+    std::cout << "========== 低精度量化 GEMM (int8 -> int32) ==========\n\n";
+    std::cout << "矩阵规模: " << M << "x" << M << ", 重复: " << reps << " 次\n\n";
+
+    Matrix A(M, M), B(M, M), C_ref(M, M);
+    A.randomize(-1.0, 1.0);
+    B.randomize(-1.0, 1.0);
+
+    // double 参考结果与基准吞吐
+    double t_ref = median_seconds(reps, [&] {
+        C_ref.fill(0.0);
+        gemm_serial_blocked(A, B, C_ref);
+    });
+    std::cout << "double 分块参考: " << t_ref << "s, " << ops / t_ref / 1e9 << " GFLOPS\n\n";
+
+    // 1. 量化误差：激活(A)逐行非对称，权重(B)逐列对称
+    QuantizedMatrixU8 qa      = quantize_u8(A, QuantScheme::Asymmetric, QuantAxis::PerRow);
+    QuantizedMatrixU8 qa_7bit = quantize_u8(A, QuantScheme::Asymmetric, QuantAxis::PerRow, true);
+    QuantizedMatrixS8 qa_s8   = quantize_s8(A, QuantScheme::Symmetric, QuantAxis::PerRow);
+    QuantizedMatrixS8 qb      = quantize_s8(B, QuantScheme::Symmetric, QuantAxis::PerColumn);
+
+    std::cout << "量化误差 (max |x - dequant(q)|):\n";
+    std::cout << "  A u8 非对称 逐行      : " << dequantize(qa).max_abs_diff(A) << "\n";
+    std::cout << "  A u8 非对称 逐行 7位  : " << dequantize(qa_7bit).max_abs_diff(A) << "\n";
+    std::cout << "  A s8 对称   逐行      : " << dequantize(qa_s8).max_abs_diff(A) << "\n";
+    std::cout << "  B s8 对称   逐列      : " << dequantize(qb).max_abs_diff(B) << "\n\n";
+
+    // 2. 各内核的吞吐与精度
+    struct Case {
+        std::string               label;
+        const QuantizedMatrixU8 * a;
+        QGemmKernel               kernel;
+    };
+
+    std::vector<Case> cases = {
+        { "u8 x s8", &qa, QGemmKernel::Portable },
+        { "u8 x s8", &qa, QGemmKernel::Avx2Madd },
+        { "u8(7位) x s8", &qa_7bit, QGemmKernel::Avx2Maddubs },
+        { "u8 x s8", &qa, QGemmKernel::Avx512Vnni },
+        { "u8 x s8", &qa, QGemmKernel::Auto },
+    };
+
+    std::cout << std::left << std::setw(18) << "内核" << std::setw(16) << "输入" << std::setw(12)
+              << "time(s)" << std::setw(10) << "GOPS" << std::setw(12) << "vs double"
+              << std::setw(14) << "max_abs_err" << "rel_err\n";
+    std::cout << std::string(90, '-') << "\n";
+
+    for (const auto & c : cases) {
+        if (!qgemm_kernel_available(c.kernel)) {
+            std::cout << std::setw(18) << to_string(c.kernel) << "(当前 CPU 不支持，跳过)\n";
+            continue;
+        }
+        Matrix      C(M, M);
+        QGemmKernel used = c.kernel;
+        double      t    = median_seconds(reps, [&] {
+            used = gemm_quantized(*c.a, qb, C, c.kernel);
+        });
+
+        std::string name = c.kernel == QGemmKernel::Auto
+                               ? std::string("auto->") + to_string(used)
+                               : std::string(to_string(c.kernel));
+        std::cout << std::setw(18) << name << std::setw(16) << c.label << std::setw(12) << t
+                  << std::setw(10) << ops / t / 1e9 << std::setw(12) << t_ref / t
+                  << std::setw(14) << C.max_abs_diff(C_ref) << relative_error(C, C_ref) << "\n";
+    }
+
+    // 3. int8 激活：无损平移为 uint8 后复用同一内核
+    Matrix C_s8(M, M);
+    gemm_quantized(qa_s8, qb, C_s8);
+    std::cout << "\ns8 x s8 (平移为 u8): rel_err = " << relative_error(C_s8, C_ref) << "\n";
+
+    std::cout << "\n关键学习点总结：\n";
+    std::cout << "1. int8 的一条 SIMD 指令处理的元素数是 double 的 8 倍，整数乘加吞吐更高\n";
+    std::cout << "2. 逐通道 scale 可以从 K 方向求和中提出，反量化只需在尾部做一次\n";
+    std::cout << "3. vpmaddubsw 的 int16 中间结果会饱和，需要 7 位输入；VNNI 直接累加到 int32\n";
+    std::cout << "4. 量化误差随 K 增长而累积，需对照 double 结果评估精度\n\n";
+
+    return 0;
+}
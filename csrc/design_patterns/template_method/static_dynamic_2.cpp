@@ -3,6 +3,7 @@
  */
 
 #include "common.h"
+#include "microbench.h"
 
 // === 动态多态接口 ===
 class DataProcessor {
@@ -222,25 +223,25 @@ void mixed_polymorphism_example() {
     const int           iters = 2000;
     std::vector<double> out;
 
-    // 动态分派计时
-    auto t0 = std::chrono::high_resolution_clock::now();
-    for (int i = 0; i < iters; ++i) {
-        processors[0]->processData(inputData, out);
-    }
-    auto t1     = std::chrono::high_resolution_clock::now();
-    auto dyn_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+    // 动态分派计时；DoNotOptimize 防止编译器把结果没人用的调用整个删掉
+    double dyn_ms = microbench::Seconds([&] {
+        for (int i = 0; i < iters; ++i) {
+            processors[0]->processData(inputData, out);
+            microbench::DoNotOptimize(out.data());
+        }
+    }) * 1e3;
 
     // 静态多态计时（直接使用模板类）
     OptimizedProcessor<FFTAlgorithm> localFFT;
-    auto                             t2 = std::chrono::high_resolution_clock::now();
-    for (int i = 0; i < iters; ++i) {
-        localFFT.processData(inputData, out);
-    }
-    auto t3      = std::chrono::high_resolution_clock::now();
-    auto stat_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t3 - t2).count();
+    double                           stat_ms = microbench::Seconds([&] {
+        for (int i = 0; i < iters; ++i) {
+            localFFT.processData(inputData, out);
+            microbench::DoNotOptimize(out.data());
+        }
+    }) * 1e3;
 
-    spdlog::info("Dynamic dispatch time (ms): {}", dyn_ms);
-    spdlog::info("Static template time (ms): {}", stat_ms);
+    spdlog::info("Dynamic dispatch time (ms): {:.3f}", dyn_ms);
+    spdlog::info("Static template time (ms): {:.3f}", stat_ms);
 
     // 简单流水线示例：FFT -> Normalize -> Filter
     spdlog::info("=== Simple pipeline: FFT -> Normalize -> Filter ===");
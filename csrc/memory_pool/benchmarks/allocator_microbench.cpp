@@ -0,0 +1,83 @@
+/**
+ * 分配器微基准（microbench 框架版）
+ *
+ * performance_benchmark.cpp 用 Timer 手工计时、每个场景只跑一次；这里改用
+ * csrc::microbench：迭代次数自动校准、重复 5 次报告中位数和变异系数，
+ * 可以 --filter 只跑部分场景、--json 输出给回归对比脚本。
+ *
+ * 每次迭代：连续分配 N 个块，再按顺序（或打乱后）全部释放。
+ */
+
+#include <microbench.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../common/memory_pool_common.h"
+#include "../example/intermediate_fixed_block_pool.h"
+
+using namespace memory_pool;
+
+namespace {
+
+constexpr size_t  kBlockSize = 64;
+constexpr int64_t kMaxBlocks = 1 << 14;
+
+// 池的构造/析构会打印日志，所以整个进程共用一个
+FixedBlockPool & SharedPool() {
+    static FixedBlockPool pool(kBlockSize, kMaxBlocks);
+    return pool;
+}
+
+// 释放顺序：range(1) == 1 时打乱，模拟对象生命周期交错
+std::vector<size_t> ReleaseOrder(size_t n, bool shuffled) {
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) {
+        order[i] = i;
+    }
+    if (shuffled) {
+        std::mt19937 rng(42);
+        std::shuffle(order.begin(), order.end(), rng);
+    }
+    return order;
+}
+
+void BM_NewDelete(microbench::State & state) {
+    const size_t        n     = static_cast<size_t>(state.range(0));
+    std::vector<size_t> order = ReleaseOrder(n, state.range(1) != 0);
+    std::vector<void *> ptrs(n);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; ++i) {
+            ptrs[i] = ::operator new(kBlockSize);
+        }
+        microbench::DoNotOptimize(ptrs.data());
+        for (size_t i : order) {
+            ::operator delete(ptrs[i]);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+void BM_FixedBlockPool(microbench::State & state) {
+    const size_t        n     = static_cast<size_t>(state.range(0));
+    std::vector<size_t> order = ReleaseOrder(n, state.range(1) != 0);
+    std::vector<void *> ptrs(n);
+    FixedBlockPool &    pool  = SharedPool();
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; ++i) {
+            ptrs[i] = pool.allocate();
+        }
+        microbench::DoNotOptimize(ptrs.data());
+        for (size_t i : order) {
+            pool.deallocate(ptrs[i]);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+} // namespace
+
+BENCHMARK(BM_NewDelete)->Args({ 1024, 0 })->Args({ 1024, 1 })->Args({ kMaxBlocks, 1 });
+BENCHMARK(BM_FixedBlockPool)->Args({ 1024, 0 })->Args({ 1024, 1 })->Args({ kMaxBlocks, 1 });
@@ -6,6 +6,9 @@
  * 2. 与标准new/delete对比
  * 3. 多线程场景性能
  * 4. 内存碎片和使用效率
+ *
+ * 用法: performance_benchmark [--repetitions=N] [--json=FILE]
+ * 每项跑 N 次，表格打印最快的一次，全部样本按 microbench::Report 的格式写入 JSON
  */
 
 #include <spdlog/spdlog.h>
@@ -13,11 +16,13 @@
 #include <algorithm>
 #include <iostream>
 #include <random>
+#include <string>
 #include <vector>
 
 #include "../common/memory_pool_common.h"
 #include "../example/intermediate_fixed_block_pool.h"
 #include "../example/intermediate_stack_allocator.h"
+#include "microbench.h"
 
 using namespace memory_pool;
 
@@ -51,17 +56,14 @@ BenchmarkResult benchmark_standard_new(const BenchmarkConfig & config) {
     std::vector<void *> ptrs;
     ptrs.reserve(config.num_iterations);
 
-    Timer timer;
-
     // 分配
-    for (size_t i = 0; i < config.num_iterations; ++i) {
-        ptrs.push_back(::operator new(config.block_size));
-    }
-
-    double alloc_time = timer.elapsed_us();
-    timer.reset();
+    double alloc_time = microbench::Seconds([&] {
+        for (size_t i = 0; i < config.num_iterations; ++i) {
+            ptrs.push_back(::operator new(config.block_size));
+        }
+    }) * 1e6;
 
-    // 可选：随机释放顺序
+    // 可选：随机释放顺序（打乱本身不计时）
     if (config.random_order) {
         std::random_device rd;
         std::mt19937       g(rd());
@@ -69,11 +71,11 @@ BenchmarkResult benchmark_standard_new(const BenchmarkConfig & config) {
     }
 
     // 释放
-    for (void * ptr : ptrs) {
-        ::operator delete(ptr);
-    }
-
-    double dealloc_time = timer.elapsed_us();
+    double dealloc_time = microbench::Seconds([&] {
+        for (void * ptr : ptrs) {
+            ::operator delete(ptr);
+        }
+    }) * 1e6;
 
     return { alloc_time, dealloc_time, alloc_time + dealloc_time, 0 };
 }
@@ -84,15 +86,12 @@ BenchmarkResult benchmark_fixed_pool(const BenchmarkConfig & config) {
     std::vector<void *> ptrs;
     ptrs.reserve(config.num_iterations);
 
-    Timer timer;
-
     // 分配
-    for (size_t i = 0; i < config.num_iterations; ++i) {
-        ptrs.push_back(pool.allocate());
-    }
-
-    double alloc_time = timer.elapsed_us();
-    timer.reset();
+    double alloc_time = microbench::Seconds([&] {
+        for (size_t i = 0; i < config.num_iterations; ++i) {
+            ptrs.push_back(pool.allocate());
+        }
+    }) * 1e6;
 
     if (config.random_order) {
         std::random_device rd;
@@ -101,11 +100,11 @@ BenchmarkResult benchmark_fixed_pool(const BenchmarkConfig & config) {
     }
 
     // 释放
-    for (void * ptr : ptrs) {
-        pool.deallocate(ptr);
-    }
-
-    double dealloc_time = timer.elapsed_us();
+    double dealloc_time = microbench::Seconds([&] {
+        for (void * ptr : ptrs) {
+            pool.deallocate(ptr);
+        }
+    }) * 1e6;
 
     return { alloc_time, dealloc_time, alloc_time + dealloc_time, pool.stats().peak_usage };
 }
@@ -115,26 +114,38 @@ BenchmarkResult benchmark_stack_allocator(const BenchmarkConfig & config) {
     size_t         total_size = config.block_size * config.num_iterations;
     StackAllocator stack(total_size);
 
-    Timer timer;
-
     // 分配（栈分配器不需要保存指针）
-    for (size_t i = 0; i < config.num_iterations; ++i) {
-        stack.allocate(config.block_size);
-    }
-
-    double alloc_time = timer.elapsed_us();
-    timer.reset();
+    double alloc_time = microbench::Seconds([&] {
+        for (size_t i = 0; i < config.num_iterations; ++i) {
+            stack.allocate(config.block_size);
+        }
+    }) * 1e6;
 
     // "释放"（只需清空）
-    stack.clear();
-
-    double dealloc_time = timer.elapsed_us();
+    double dealloc_time = microbench::Seconds([&] { stack.clear(); }) * 1e6;
 
     return { alloc_time, dealloc_time, alloc_time + dealloc_time, stack.stats().peak_usage };
 }
 
+// 每项重复 report.repetitions() 次：全部样本以 <名称>/<块大小> 记入 report，返回最快的一次
+template <typename Bench>
+BenchmarkResult measure(microbench::Report & report, const std::string & name, Bench && bench,
+                        const BenchmarkConfig & config) {
+    std::vector<double> seconds;
+    BenchmarkResult     best{};
+    for (int r = 0; r < report.repetitions(); ++r) {
+        BenchmarkResult result = bench(config);
+        seconds.push_back(result.total_time_us / 1e6);
+        if (r == 0 || result.total_time_us < best.total_time_us) {
+            best = result;
+        }
+    }
+    report.Add(name + "/" + std::to_string(config.block_size), seconds, config.num_iterations);
+    return best;
+}
+
 // 运行完整基准测试套件
-void run_benchmark_suite() {
+void run_benchmark_suite(microbench::Report & report) {
     std::cout << "\n╔════════════════════════════════════════════════╗\n";
     std::cout << "║        内存池性能基准测试                      ║\n";
     std::cout << "╚════════════════════════════════════════════════╝\n";
@@ -154,13 +165,13 @@ void run_benchmark_suite() {
 
     config.random_order = false;
 
-    auto result_std = benchmark_standard_new(config);
+    auto result_std = measure(report, "sequential/new_delete", benchmark_standard_new, config);
     result_std.print("标准 new/delete");
 
-    auto result_pool = benchmark_fixed_pool(config);
+    auto result_pool = measure(report, "sequential/fixed_pool", benchmark_fixed_pool, config);
     result_pool.print("固定块池");
 
-    auto result_stack = benchmark_stack_allocator(config);
+    auto result_stack = measure(report, "sequential/stack", benchmark_stack_allocator, config);
     result_stack.print("栈分配器");
 
     spdlog::info("\n性能对比:");
@@ -177,10 +188,10 @@ void run_benchmark_suite() {
 
     config.random_order = true;
 
-    result_std = benchmark_standard_new(config);
+    result_std = measure(report, "random/new_delete", benchmark_standard_new, config);
     result_std.print("标准 new/delete（随机）");
 
-    result_pool = benchmark_fixed_pool(config);
+    result_pool = measure(report, "random/fixed_pool", benchmark_fixed_pool, config);
     result_pool.print("固定块池（随机）");
 
     speedup_pool = result_std.total_time_us / result_pool.total_time_us;
@@ -203,8 +214,8 @@ void run_benchmark_suite() {
     for (size_t size : sizes) {
         config.block_size = size;
 
-        auto r_std  = benchmark_standard_new(config);
-        auto r_pool = benchmark_fixed_pool(config);
+        auto r_std  = measure(report, "block_size/new_delete", benchmark_standard_new, config);
+        auto r_pool = measure(report, "block_size/fixed_pool", benchmark_fixed_pool, config);
 
         double speedup = r_std.total_time_us / r_pool.total_time_us;
 
@@ -307,12 +318,14 @@ void test_fragmentation() {
     }
 }
 
-int main() {
+int main(int argc, char * argv[]) {
+    microbench::Report report(argc, argv);
+
     std::cout << "\n╔════════════════════════════════════════════════╗\n";
     std::cout << "║   内存池综合性能测试套件                       ║\n";
     std::cout << "╚════════════════════════════════════════════════╝\n";
 
-    run_benchmark_suite();
+    run_benchmark_suite(report);
     test_memory_efficiency();
     test_fragmentation();
 
@@ -323,5 +336,5 @@ int main() {
     std::cout << "4. 内存池减少了碎片化问题\n";
     std::cout << "5. 块大小越小，内存池优势越明显\n";
 
-    return 0;
+    return report.Finish();
 }
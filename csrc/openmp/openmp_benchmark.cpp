@@ -0,0 +1,562 @@
+/**
+ * @file openmp_benchmark.cpp
+ * @brief 把 openmp_*_examples.cpp 里的计时演示整理成可参数化的基准测试
+ *
+ * 三组负载：
+ * 1. sum      - 求和（demo_performance_comparison 与 race prevention 方法 1~5）：
+ *               reduction / 每线程部分和（填充 vs 相邻，演示伪共享）/ atomic / critical / lock / ordered
+ * 2. even_odd - 奇偶分别求和（命名 critical 示例）：命名 critical / atomic / 两个变量的 reduction
+ * 3. schedule - 三角形不均衡循环，schedule(runtime) 依次取 static / dynamic / guided
+ *
+ * 示例里故意写出的数据竞争（default(shared) 下直接 += 共享变量）不计时：结果本来就不对，
+ * 这里只测它们的正确替代写法，并逐项校验结果。
+ *
+ * 线程绑定：OMP_PROC_BIND / OMP_PLACES 只在运行时库初始化时读取，main 里再 setenv 已经晚了，
+ * 所以未设置时按 --bind / --places 写入环境变量后 exec 自己一次（仅 Linux）。
+ *
+ * 用法: openmp_benchmark [--n N] [--threads 1,2,4] [--schedules static,dynamic,guided] ...
+ *       [--repetitions=N] [--json=FILE]（microbench::Report 的 JSON 格式，供 bench 目标读取）
+ */
+
+#include <fmt/core.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "microbench.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr const char * kReexecGuard = "OPENMP_BENCHMARK_REEXEC";
+
+struct BenchConfig {
+    std::size_t              n       = 4000000;
+    std::size_t              sync_n  = 0; // 0 表示 n / 16：逐元素同步的写法太慢，用更小的规模
+    std::vector<int>         threads = { 1, 2, 4 };
+    std::vector<std::string> schedules = { "static", "dynamic", "guided" };
+    int                      chunk   = 0; // 0 表示运行时默认块大小
+    std::vector<std::string> groups  = { "sum", "even_odd", "schedule" };
+    int                      reps    = 5;
+    int                      warmup  = 1;
+    std::string              bind    = "close";
+    std::string              places  = "cores";
+};
+
+struct BenchResult {
+    std::string         group;
+    std::string         variant;
+    std::string         schedule; // 只有 schedule 组使用
+    int                 threads = 1;
+    std::size_t         n       = 0;
+    std::vector<double> samples_seconds;
+    bool                correct = true;
+
+    std::string name() const {
+        std::string s = group + "/" + variant;
+        if (!schedule.empty()) {
+            s += "/" + schedule;
+        }
+        return s + "/t" + std::to_string(threads);
+    }
+
+    double median() const {
+        std::vector<double> sorted = samples_seconds;
+        std::sort(sorted.begin(), sorted.end());
+        std::size_t mid = sorted.size() / 2;
+        return sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+    }
+};
+
+std::vector<std::string> split_list(const std::string & s) {
+    std::vector<std::string> items;
+    std::stringstream        ss(s);
+    std::string              item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void print_usage(const char * prog) {
+    fmt::print("用法: {} [选项]\n"
+               "  --n N                    求和/调度负载的元素数（默认 4000000）\n"
+               "  --sync-n N               逐元素同步写法（atomic/critical/lock/ordered）的元素数，"
+               "默认 n/16\n"
+               "  --threads 1,2,4          线程数列表\n"
+               "  --schedules a,b,...      static,dynamic,guided,auto\n"
+               "  --chunk N                schedule 的块大小（默认由运行时决定）\n"
+               "  --groups a,b,...         sum,even_odd,schedule\n"
+               "  --repetitions=N          计时重复次数（默认 5）\n"
+               "  --warmup N               预热次数（默认 1）\n"
+               "  --bind KIND              OMP_PROC_BIND 未设置时使用：close/spread/primary/false，"
+               "none 表示不设置\n"
+               "  --places P               OMP_PLACES 未设置时使用（默认 cores）\n"
+               "  --json=FILE              输出 JSON 结果\n",
+               prog);
+}
+
+bool parse_args(int argc, char * argv[], BenchConfig & cfg) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg  = argv[i];
+        auto        next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--n") {
+            cfg.n = std::strtoul(next().c_str(), nullptr, 10);
+        } else if (arg == "--sync-n") {
+            cfg.sync_n = std::strtoul(next().c_str(), nullptr, 10);
+        } else if (arg == "--threads") {
+            cfg.threads.clear();
+            for (const auto & v : split_list(next())) {
+                cfg.threads.push_back(std::max(1, std::atoi(v.c_str())));
+            }
+        } else if (arg == "--schedules") {
+            cfg.schedules = split_list(next());
+        } else if (arg == "--chunk") {
+            cfg.chunk = std::atoi(next().c_str());
+        } else if (arg == "--groups") {
+            cfg.groups = split_list(next());
+        } else if (arg == "--warmup") {
+            cfg.warmup = std::max(0, std::atoi(next().c_str()));
+        } else if (arg == "--bind") {
+            cfg.bind = next();
+        } else if (arg == "--places") {
+            cfg.places = next();
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    cfg.n = std::max<std::size_t>(cfg.n, 64);
+    if (cfg.sync_n == 0) {
+        cfg.sync_n = std::max<std::size_t>(cfg.n / 16, 64);
+    }
+    return true;
+}
+
+// OMP_PROC_BIND / OMP_PLACES 未设置时写入并重新 exec，让运行时库在初始化时读到它们。
+// 用户已经设置的值一律尊重；exec 失败则不绑定继续运行。
+void apply_binding(const BenchConfig & cfg, char * argv[]) {
+#if defined(__linux__)
+    if (cfg.bind == "none" || std::getenv(kReexecGuard) != nullptr) {
+        return;
+    }
+    bool changed = false;
+    if (std::getenv("OMP_PROC_BIND") == nullptr) {
+        setenv("OMP_PROC_BIND", cfg.bind.c_str(), 1);
+        changed = true;
+    }
+    if (std::getenv("OMP_PLACES") == nullptr) {
+        setenv("OMP_PLACES", cfg.places.c_str(), 1);
+        changed = true;
+    }
+    if (changed) {
+        setenv(kReexecGuard, "1", 1);
+        execv("/proc/self/exe", argv);
+    }
+#else
+    (void)cfg;
+    (void)argv;
+#endif
+}
+
+const char * proc_bind_name(omp_proc_bind_t bind) {
+    switch (bind) {
+    case omp_proc_bind_false:
+        return "false";
+    case omp_proc_bind_true:
+        return "true";
+    case omp_proc_bind_master:
+        return "primary";
+    case omp_proc_bind_close:
+        return "close";
+    case omp_proc_bind_spread:
+        return "spread";
+    }
+    return "unknown";
+}
+
+bool parse_schedule(const std::string & name, omp_sched_t & kind) {
+    if (name == "static") {
+        kind = omp_sched_static;
+    } else if (name == "dynamic") {
+        kind = omp_sched_dynamic;
+    } else if (name == "guided") {
+        kind = omp_sched_guided;
+    } else if (name == "auto") {
+        kind = omp_sched_auto;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// 预热后计时 reps 次；body 返回结果，与 expected 比较
+template <typename Body>
+BenchResult measure(const BenchConfig & cfg, BenchResult r, std::int64_t expected, Body body) {
+    for (int w = 0; w < cfg.warmup; ++w) {
+        r.correct = r.correct && body() == expected;
+    }
+    for (int rep = 0; rep < cfg.reps; ++rep) {
+        std::int64_t value = 0;
+        r.samples_seconds.push_back(microbench::Seconds([&] { value = body(); }));
+        r.correct = r.correct && value == expected;
+    }
+    return r;
+}
+
+// ========== 1. sum ==========
+
+// 每线程一个缓存行，避免部分和之间的伪共享
+struct alignas(64) PaddedSum {
+    std::int64_t value = 0;
+};
+
+void bench_sum(const BenchConfig & cfg, std::vector<BenchResult> & out) {
+    // 整数数据：不同的累加顺序结果完全相同，可以直接比较
+    std::vector<std::int64_t> data(cfg.n);
+    for (std::size_t i = 0; i < cfg.n; ++i) {
+        data[i] = static_cast<std::int64_t>(i % 1000) + 1;
+    }
+    const std::int64_t * d      = data.data();
+    const std::int64_t   n      = static_cast<std::int64_t>(cfg.n);
+    const std::int64_t   sync_n = static_cast<std::int64_t>(cfg.sync_n);
+    std::int64_t         expected = 0;
+    std::int64_t         expected_sync = 0;
+    for (std::int64_t i = 0; i < n; ++i) {
+        expected += d[i];
+        expected_sync += i < sync_n ? d[i] : 0;
+    }
+
+    for (int t : cfg.threads) {
+        auto base = [&](const char * variant, std::size_t size) {
+            BenchResult r;
+            r.group   = "sum";
+            r.variant = variant;
+            r.threads = t;
+            r.n       = size;
+            return r;
+        };
+
+        out.push_back(measure(cfg, base("reduction", cfg.n), expected, [&] {
+            std::int64_t sum = 0;
+#pragma omp parallel for num_threads(t) reduction(+ : sum)
+            for (std::int64_t i = 0; i < n; ++i) {
+                sum += d[i];
+            }
+            return sum;
+        }));
+
+        // 手写的"每线程部分和"：每次迭代都写回内存（int64 指针可能与 d 别名，编译器不能
+        // 把它提升到寄存器），相邻存放时多个线程反复写同一缓存行
+        std::vector<PaddedSum>    padded(static_cast<std::size_t>(t));
+        std::vector<std::int64_t> adjacent(static_cast<std::size_t>(t));
+        out.push_back(measure(cfg, base("padded_partials", cfg.n), expected, [&] {
+            std::fill(padded.begin(), padded.end(), PaddedSum{});
+#pragma omp parallel num_threads(t)
+            {
+                std::int64_t * mine = &padded[static_cast<std::size_t>(omp_get_thread_num())].value;
+#pragma omp for
+                for (std::int64_t i = 0; i < n; ++i) {
+                    *mine += d[i];
+                }
+            }
+            std::int64_t sum = 0;
+            for (const PaddedSum & p : padded) {
+                sum += p.value;
+            }
+            return sum;
+        }));
+        out.push_back(measure(cfg, base("adjacent_partials", cfg.n), expected, [&] {
+            std::fill(adjacent.begin(), adjacent.end(), 0);
+#pragma omp parallel num_threads(t)
+            {
+                std::int64_t * mine = &adjacent[static_cast<std::size_t>(omp_get_thread_num())];
+#pragma omp for
+                for (std::int64_t i = 0; i < n; ++i) {
+                    *mine += d[i];
+                }
+            }
+            std::int64_t sum = 0;
+            for (std::int64_t p : adjacent) {
+                sum += p;
+            }
+            return sum;
+        }));
+
+        // 以下是逐元素同步的写法，规模为 sync_n
+        out.push_back(measure(cfg, base("atomic", cfg.sync_n), expected_sync, [&] {
+            std::int64_t sum = 0;
+#pragma omp parallel for num_threads(t)
+            for (std::int64_t i = 0; i < sync_n; ++i) {
+#pragma omp atomic
+                sum += d[i];
+            }
+            return sum;
+        }));
+        out.push_back(measure(cfg, base("critical", cfg.sync_n), expected_sync, [&] {
+            std::int64_t sum = 0;
+#pragma omp parallel for num_threads(t)
+            for (std::int64_t i = 0; i < sync_n; ++i) {
+#pragma omp critical
+                { sum += d[i]; }
+            }
+            return sum;
+        }));
+        omp_lock_t lock;
+        omp_init_lock(&lock);
+        out.push_back(measure(cfg, base("lock", cfg.sync_n), expected_sync, [&] {
+            std::int64_t sum = 0;
+#pragma omp parallel for num_threads(t)
+            for (std::int64_t i = 0; i < sync_n; ++i) {
+                omp_set_lock(&lock);
+                sum += d[i];
+                omp_unset_lock(&lock);
+            }
+            return sum;
+        }));
+        omp_destroy_lock(&lock);
+        out.push_back(measure(cfg, base("ordered", cfg.sync_n), expected_sync, [&] {
+            std::int64_t sum = 0;
+#pragma omp parallel for num_threads(t) ordered
+            for (std::int64_t i = 0; i < sync_n; ++i) {
+#pragma omp ordered
+                { sum += d[i]; }
+            }
+            return sum;
+        }));
+    }
+}
+
+// ========== 2. even_odd ==========
+
+void bench_even_odd(const BenchConfig & cfg, std::vector<BenchResult> & out) {
+    const std::int64_t n = static_cast<std::int64_t>(cfg.sync_n);
+    // 结果编码为 even * 3 + odd，两个和都参与校验
+    std::int64_t even = 0;
+    std::int64_t odd  = 0;
+    for (std::int64_t i = 1; i <= n; ++i) {
+        (i % 2 == 0 ? even : odd) += i;
+    }
+    const std::int64_t expected = even * 3 + odd;
+
+    for (int t : cfg.threads) {
+        auto base = [&](const char * variant) {
+            BenchResult r;
+            r.group   = "even_odd";
+            r.variant = variant;
+            r.threads = t;
+            r.n       = cfg.sync_n;
+            return r;
+        };
+
+        out.push_back(measure(cfg, base("named_critical"), expected, [&] {
+            std::int64_t sum_even = 0;
+            std::int64_t sum_odd  = 0;
+#pragma omp parallel for num_threads(t)
+            for (std::int64_t i = 1; i <= n; ++i) {
+                if (i % 2 == 0) {
+#pragma omp critical(even)
+                    sum_even += i;
+                } else {
+#pragma omp critical(odd)
+                    sum_odd += i;
+                }
+            }
+            return sum_even * 3 + sum_odd;
+        }));
+        out.push_back(measure(cfg, base("atomic"), expected, [&] {
+            std::int64_t sum_even = 0;
+            std::int64_t sum_odd  = 0;
+#pragma omp parallel for num_threads(t)
+            for (std::int64_t i = 1; i <= n; ++i) {
+                if (i % 2 == 0) {
+#pragma omp atomic
+                    sum_even += i;
+                } else {
+#pragma omp atomic
+                    sum_odd += i;
+                }
+            }
+            return sum_even * 3 + sum_odd;
+        }));
+        out.push_back(measure(cfg, base("reduction"), expected, [&] {
+            std::int64_t sum_even = 0;
+            std::int64_t sum_odd  = 0;
+#pragma omp parallel for num_threads(t) reduction(+ : sum_even, sum_odd)
+            for (std::int64_t i = 1; i <= n; ++i) {
+                if (i % 2 == 0) {
+                    sum_even += i;
+                } else {
+                    sum_odd += i;
+                }
+            }
+            return sum_even * 3 + sum_odd;
+        }));
+    }
+}
+
+// ========== 3. schedule ==========
+
+// 第 i 行做 1 + 256 * i / rows 次 LCG：越往后越重，static 的最后一个线程分到最多的工作
+std::int64_t row_work(std::int64_t i, std::int64_t rows) {
+    std::uint64_t h     = static_cast<std::uint64_t>(i);
+    std::int64_t  steps = 1 + 256 * i / rows;
+    for (std::int64_t k = 0; k < steps; ++k) {
+        h = h * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    return static_cast<std::int64_t>(h >> 40);
+}
+
+void bench_schedule(const BenchConfig & cfg, std::vector<BenchResult> & out) {
+    const std::int64_t rows     = static_cast<std::int64_t>(std::max<std::size_t>(cfg.n / 64, 1));
+    std::int64_t       expected = 0;
+    for (std::int64_t i = 0; i < rows; ++i) {
+        expected += row_work(i, rows);
+    }
+
+    for (int t : cfg.threads) {
+        for (const std::string & name : cfg.schedules) {
+            omp_sched_t kind;
+            if (!parse_schedule(name, kind)) {
+                fmt::print("忽略未知 schedule: {}\n", name);
+                continue;
+            }
+            BenchResult r;
+            r.group    = "schedule";
+            r.variant  = "triangular";
+            r.schedule = cfg.chunk > 0 ? name + "," + std::to_string(cfg.chunk) : name;
+            r.threads  = t;
+            r.n        = static_cast<std::size_t>(rows);
+            omp_set_schedule(kind, cfg.chunk);
+            out.push_back(measure(cfg, r, expected, [&] {
+                std::int64_t sum = 0;
+#pragma omp parallel for num_threads(t) schedule(runtime) reduction(+ : sum)
+                for (std::int64_t i = 0; i < rows; ++i) {
+                    sum += row_work(i, rows);
+                }
+                return sum;
+            }));
+        }
+    }
+}
+
+// ========== 输出 ==========
+
+// 每组一张表：相对值以同组、同线程数的第一个变体为基准
+void print_group(const std::vector<BenchResult> & results, const std::string & group,
+                 const char * title) {
+    fmt::print("\n[{}] {}\n", group, title);
+    fmt::print("  {:<30} {:>6} {:>10} {:>14} {:>12} {:>8}\n", "变体", "线程", "元素数",
+               "中位数 ns/元素", "相对基准", "结果");
+    const BenchResult * baseline = nullptr;
+    for (const BenchResult & r : results) {
+        if (r.group != group) {
+            continue;
+        }
+        if (baseline == nullptr || baseline->threads != r.threads) {
+            baseline = &r;
+        }
+        double      per_element = r.median() / static_cast<double>(r.n) * 1e9;
+        double      base_per    = baseline->median() / static_cast<double>(baseline->n) * 1e9;
+        std::string variant     = r.schedule.empty() ? r.variant : r.variant + " " + r.schedule;
+        fmt::print("  {:<30} {:>6} {:>10} {:>14.2f} {:>11.2f}x {:>8}\n", variant, r.threads, r.n,
+                   per_element, base_per / per_element, r.correct ? "正确" : "错误");
+    }
+}
+
+bool has_group(const BenchConfig & cfg, const std::string & group) {
+    return std::find(cfg.groups.begin(), cfg.groups.end(), group) != cfg.groups.end();
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    // Report 会从 argv 里取走自己的参数，重新 exec 时要用原始的参数表
+    std::vector<char *>               original(argv, argv + argc + 1);
+    BenchConfig                       cfg;
+    std::optional<microbench::Report> report;
+    try {
+        report.emplace(argc, argv);
+        cfg.reps = report->repetitions();
+        if (!parse_args(argc, argv, cfg)) {
+            return 0;
+        }
+    } catch (const std::exception & e) {
+        fmt::print(stderr, "参数错误: {}\n", e.what());
+        print_usage(argv[0]);
+        return 1;
+    }
+    apply_binding(cfg, original.data());
+
+    const char * places = std::getenv("OMP_PLACES");
+    fmt::print("OpenMP 基准测试（OpenMP {}）\n", _OPENMP);
+    fmt::print("=====================================\n");
+    fmt::print("OMP_PROC_BIND = {}, OMP_PLACES = {}（{} 个 place），硬件线程 {}\n",
+               proc_bind_name(omp_get_proc_bind()), places ? places : "(未设置)",
+               omp_get_num_places(), std::thread::hardware_concurrency());
+    for (int t : cfg.threads) {
+        std::vector<int> place_of(static_cast<std::size_t>(t), -1);
+#pragma omp parallel num_threads(t)
+        place_of[static_cast<std::size_t>(omp_get_thread_num())] = omp_get_place_num();
+        std::string mapping;
+        for (int p : place_of) {
+            mapping += (mapping.empty() ? "" : ",") + std::to_string(p);
+        }
+        fmt::print("  {} 线程 -> place [{}]\n", t, mapping);
+    }
+
+    std::vector<BenchResult> results;
+    if (has_group(cfg, "sum")) {
+        bench_sum(cfg, results);
+        print_group(results, "sum", "求和：reduction 为基准；atomic 及以下为逐元素同步，规模 sync_n");
+    }
+    if (has_group(cfg, "even_odd")) {
+        bench_even_odd(cfg, results);
+        print_group(results, "even_odd", "奇偶分别求和：命名 critical 为基准");
+    }
+    if (has_group(cfg, "schedule")) {
+        bench_schedule(cfg, results);
+        print_group(results, "schedule", "三角形不均衡循环：第一个 schedule 为基准");
+    }
+
+    bool all_correct = std::all_of(results.begin(), results.end(),
+                                   [](const BenchResult & r) { return r.correct; });
+    fmt::print("\n结果一致: {}\n", all_correct ? "yes" : "NO");
+    // 样本按元素数折算成 ns/元素；实际生效的绑定方式记在 label 里
+    std::string binding = fmt::format("bind={} places={}", proc_bind_name(omp_get_proc_bind()),
+                                      places ? places : "");
+    for (const BenchResult & r : results) {
+        microbench::Report::Entry & entry = report->Add(r.name(), r.samples_seconds, r.n);
+        entry.label                       = binding;
+        entry.correct                     = r.correct;
+    }
+    int status = report->Finish();
+
+    fmt::print("\n关键学习点：\n");
+    fmt::print("1. reduction 让每个线程累加私有副本，只在结束时合并一次；逐元素 atomic/critical/lock "
+               "都把并行循环变成了排队\n");
+    fmt::print("2. 手写部分和要按缓存行填充，相邻存放的计数器会在线程间来回失效（伪共享）\n");
+    fmt::print("3. 工作量不均时 static 由最慢的线程决定总时间，dynamic/guided 用调度开销换负载均衡\n");
+    fmt::print("4. 线程绑定必须在运行时库初始化前通过 OMP_PROC_BIND/OMP_PLACES 设置，结果里记录实际生效的值\n");
+    return status;
+}
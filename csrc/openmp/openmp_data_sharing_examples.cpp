@@ -19,6 +19,8 @@
 #include <thread>
 #include <vector>
 
+#include "microbench.h"
+
 // ============================================================================
 // 1. THREADPRIVATE 示例
 // ============================================================================
@@ -134,8 +136,6 @@ void demo_copyprivate() {
     std::cout << "3. COPYPRIVATE 示例\n";
     std::cout << "========================================\n";
 
-    int shared_data = 0;
-
 #pragma omp parallel num_threads(4)
     {
         int tid           = omp_get_thread_num();
@@ -524,28 +524,27 @@ void demo_performance_comparison() {
     }
 
     // 方法 1: 使用 reduction（推荐）
-    double sum1   = 0.0;
-    double start1 = omp_get_wtime();
+    double sum1  = 0.0;
+    double time1 = microbench::Seconds([&] {
 #pragma omp parallel for reduction(+ : sum1)
-    for (int i = 0; i < N; i++) {
-        sum1 += data[i];
-    }
-    double end1 = omp_get_wtime();
-    std::cout << "使用 reduction: sum = " << sum1 << ", 耗时: " << (end1 - start1) * 1000
-              << " ms\n";
+        for (int i = 0; i < N; i++) {
+            sum1 += data[i];
+        }
+    });
+    std::cout << "使用 reduction: sum = " << sum1 << ", 耗时: " << time1 * 1000 << " ms\n";
 
     // 方法 2: 使用 critical（不推荐，性能差）
-    double sum2   = 0.0;
-    double start2 = omp_get_wtime();
+    double sum2  = 0.0;
+    double time2 = microbench::Seconds([&] {
 #pragma omp parallel for
-    for (int i = 0; i < N; i++) {
+        for (int i = 0; i < N; i++) {
 #pragma omp critical
-        { sum2 += data[i]; }
-    }
-    double end2 = omp_get_wtime();
-    std::cout << "使用 critical: sum = " << sum2 << ", 耗时: " << (end2 - start2) * 1000 << " ms\n";
+            { sum2 += data[i]; }
+        }
+    });
+    std::cout << "使用 critical: sum = " << sum2 << ", 耗时: " << time2 * 1000 << " ms\n";
 
-    std::cout << "\n性能提升: " << (end2 - start2) / (end1 - start1) << " 倍\n";
+    std::cout << "\n性能提升: " << time2 / time1 << " 倍\n";
     std::cout << "结论: reduction 比 critical 快得多，应优先使用 reduction\n";
 }
 
@@ -3,7 +3,7 @@
 
 namespace {
 
-void example_num_threads() {
+[[maybe_unused]] void example_num_threads() {
     int thread_id, num_threads;
     thread_id   = omp_get_thread_num();
     num_threads = omp_get_num_threads();
@@ -19,7 +19,7 @@ void example_num_threads() {
     printf("After hello from thread %d out of %d threads\n", thread_id, num_threads);
 }
 
-void example_set_num_threads() {
+[[maybe_unused]] void example_set_num_threads() {
     int thread_id, num_threads;
     thread_id   = omp_get_thread_num();
     num_threads = omp_get_num_threads();
@@ -42,7 +42,8 @@ void example_set_num_threads() {
 // critical 创建一个临界区，同一时间只允许一个线程执行该区域的代码
 // 优点：简单易用，适用于任何代码块
 // 缺点：性能开销较大，所有线程都需要排队等待
-void example_critical() {
+// 共享容器（如哈希表）不必整个放进 critical，见 csrc/parallel/concurrent_hash_map.h
+[[maybe_unused]] void example_critical() {
     int shared_sum = 0;
     int n          = 100;
 
@@ -65,7 +66,7 @@ void example_critical() {
 // atomic 用于保护单个内存操作，比 critical 更轻量级
 // 优点：性能优于 critical，开销小
 // 缺点：只能用于简单的数学运算（+, -, *, /, &, |, ^, <<, >>）
-void example_atomic() {
+[[maybe_unused]] void example_atomic() {
     int shared_sum = 0;
     int n          = 100;
 
@@ -86,7 +87,7 @@ void example_atomic() {
 // reduction 是最推荐的方法，让每个线程维护私有副本，最后自动合并
 // 优点：性能最好，自动处理规约操作，代码简洁
 // 缺点：只适用于特定的规约操作（+, -, *, &, |, ^, &&, ||, max, min）
-void example_reduction() {
+[[maybe_unused]] void example_reduction() {
     int shared_sum = 0;
     int n          = 100;
 
@@ -109,7 +110,7 @@ void example_reduction() {
 // 锁提供了更细粒度的控制，可以手动控制锁的获取和释放
 // 优点：灵活性高，可以跨多个代码块使用
 // 缺点：需要手动管理，容易出错（忘记释放锁会导致死锁）
-void example_lock() {
+[[maybe_unused]] void example_lock() {
     int        shared_sum = 0;
     int        n          = 100;
     omp_lock_t lock;
@@ -142,7 +143,7 @@ void example_lock() {
 // ordered 确保代码块按照串行顺序执行（按迭代顺序）
 // 优点：保证执行顺序，适用于需要按序输出或处理的场景
 // 缺点：严重限制并行性，性能较差
-void example_ordered() {
+[[maybe_unused]] void example_ordered() {
     int shared_sum = 0;
     int n          = 20; // 使用较小的 n 以便观察顺序
 
@@ -167,7 +168,8 @@ void example_ordered() {
 // 可以为不同的 critical 区域命名，不同名称的临界区可以并发执行
 // 优点：允许多个互不干扰的临界区并发执行
 // 缺点：需要正确规划临界区的命名
-void example_named_critical() {
+// 把"按名字分区"推广到按键的哈希分成很多条带锁，就是 concurrent_hash_map.h 的写路径
+[[maybe_unused]] void example_named_critical() {
     int sum_even = 0;
     int sum_odd  = 0;
     int n        = 100;
@@ -198,7 +200,7 @@ void example_named_critical() {
 // barrier 让所有线程在某个点同步，等待所有线程都到达该点后再继续
 // 优点：可以分阶段处理数据，确保阶段间的数据一致性
 // 缺点：不直接防止竞争，需要配合其他方法使用
-void example_barrier() {
+[[maybe_unused]] void example_barrier() {
     const int n = 10;
     int       data[n];
     int       result[n];
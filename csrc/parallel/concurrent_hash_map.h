@@ -0,0 +1,456 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+/**
+ * ============================================================================
+ * 并发哈希表：开放寻址 + 每槽 seqlock + 条带锁，读无锁，扩容时读者不停
+ * ============================================================================
+ *
+ * openmp_race_prevention_examples.cpp 里的 critical / named critical 把所有更新串成一条队；
+ * 这里把"一把大锁"拆成三层：
+ *   读者   不拿任何锁。每个槽带一个 meta 字（版本号 << 2 | 状态），按 seqlock 的方式
+ *          "读 meta -> 读键值 -> 再读 meta"，两次不同就重读这个槽
+ *   写者   按键的哈希拿 kStripes 把条带锁中的一把：同一个键的写操作互斥，不同条带的写者
+ *          只在抢同一个空槽时用 CAS 决出胜负
+ *   扩容   按顺序拿全部条带锁（写者暂停），迁移到新表后换掉表指针，再等一个宽限期：
+ *          每个读者计数都归零过一次，说明没人还在读旧表，这时才释放旧表
+ *
+ * 删除留下墓碑（探测链不能断），墓碑可以被之后的插入复用；墓碑太多时扩容按原容量
+ * 重建一次就能清掉。
+ *
+ * 限制：
+ *   - Key / Value 必须可平凡复制且可默认构造（seqlock 读者会和写者并发读同一块内存，
+ *     内部按 8 字节原子字拷贝）
+ *   - upsert 的回调在条带锁内执行，回调里不要再访问同一个 map
+ */
+
+namespace parallel {
+
+namespace detail {
+
+// splitmix64 的终结函数：libstdc++ 的 std::hash<整数> 是恒等映射，直接取低位会聚集
+inline std::uint64_t mix_hash(std::uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+// 自旋等待：x86 上用 pause 降低功耗，转久了就让出时间片（线程数多于核数时尤其重要）
+inline void spin_pause(unsigned & spins) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+    if (++spins % 64 == 0) {
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief 把可平凡复制的 T 存成若干 atomic<uint64_t>
+ *
+ * seqlock 的读者和写者会同时访问数据，用 relaxed 原子字读写既不算数据竞争，
+ * 也不依赖 libatomic（std::atomic<大结构体> 会退化成加锁实现）
+ */
+template <typename T> class AtomicWords {
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+    static_assert(std::is_default_constructible<T>::value, "T must be default constructible");
+
+  public:
+    void store(const T & value) {
+        std::uint64_t buf[kWords] = {};
+        std::memcpy(buf, &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buf[i], std::memory_order_relaxed);
+        }
+    }
+
+    T load() const {
+        std::uint64_t buf[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            buf[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        T value;
+        std::memcpy(&value, buf, sizeof(T));
+        return value;
+    }
+
+  private:
+    static constexpr size_t kWords = (sizeof(T) + 7) / 8;
+
+    std::atomic<std::uint64_t> words_[kWords] = {};
+};
+
+} // namespace detail
+
+/**
+ * @brief 开放寻址（线性探测）的并发哈希表
+ *
+ * find 无锁；insert_or_assign / upsert / erase 只锁键所在的条带；表的负载超过 3/4 时扩容
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class ConcurrentHashMap {
+  public:
+    explicit ConcurrentHashMap(size_t initial_capacity = 1024) {
+        size_t capacity = kMinCapacity;
+        while (capacity < initial_capacity) {
+            capacity *= 2;
+        }
+        current_.reset(new Table(capacity));
+        table_.store(current_.get(), std::memory_order_release);
+    }
+
+    ConcurrentHashMap(const ConcurrentHashMap &)             = delete;
+    ConcurrentHashMap & operator=(const ConcurrentHashMap &) = delete;
+
+    /**
+     * @brief 查找键，返回值的一份拷贝；不拿锁，也不会被扩容阻塞
+     */
+    std::optional<Value> find(const Key & key) const {
+        const std::uint64_t h = hash_of(key);
+        ReaderGuard         guard(*this);
+        const Table &       t = *table_.load(std::memory_order_seq_cst);
+        for (size_t i = h & t.mask, probes = 0; probes <= t.mask; ++probes, i = (i + 1) & t.mask) {
+            const Slot & s     = t.slots[i];
+            unsigned     spins = 0;
+            for (;;) {
+                const std::uint64_t m     = s.meta.load(std::memory_order_acquire);
+                const std::uint64_t state = m & kStateMask;
+                if (state == kBusy) {
+                    detail::spin_pause(spins);
+                    continue;
+                }
+                if (state == kEmpty) {
+                    return std::nullopt;
+                }
+                if (state == kTombstone) {
+                    break;
+                }
+                const Key            k = s.key.load();
+                std::optional<Value> v;
+                if (equal_(k, key)) {
+                    v = s.value.load();
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.meta.load(std::memory_order_relaxed) != m) {
+                    continue; // 读的过程中槽被改写，重读
+                }
+                if (v) {
+                    return v;
+                }
+                break;
+            }
+        }
+        return std::nullopt;
+    }
+
+    bool contains(const Key & key) const { return find(key).has_value(); }
+
+    /**
+     * @brief 插入或覆盖；返回 true 表示插入了新键
+     */
+    bool insert_or_assign(const Key & key, const Value & value) {
+        return write(key, [&](Value & v) { v = value; }, value);
+    }
+
+    /**
+     * @brief 键存在时在条带锁内调用 fn(value&) 原地修改，否则插入 init；返回 true 表示插入
+     *
+     * 例：计数器 map.upsert(k, [](long & c) { ++c; }, 1)。fn 抛异常时表不变
+     */
+    template <typename F> bool upsert(const Key & key, F && fn, const Value & init) {
+        return write(key, fn, init);
+    }
+
+    /**
+     * @brief 删除键；返回 true 表示确实删掉了
+     */
+    bool erase(const Key & key) {
+        const std::uint64_t         h = hash_of(key);
+        std::lock_guard<std::mutex> lock(stripe_for(h));
+        Table &                     t = *table_.load(std::memory_order_acquire);
+        const size_t                i = locate(t, key, h).found;
+        if (i == kNotFound) {
+            return false;
+        }
+        Slot & s = t.slots[i];
+        s.meta.store(next_meta(s.meta.load(std::memory_order_relaxed), kTombstone),
+                     std::memory_order_release);
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+    size_t capacity() const {
+        ReaderGuard guard(*this);
+        return table_.load(std::memory_order_seq_cst)->mask + 1;
+    }
+
+  private:
+    // meta 的低 2 位是状态，其余是版本号；任何状态变化都让版本号加一
+    static constexpr std::uint64_t kEmpty       = 0;
+    static constexpr std::uint64_t kFull        = 1;
+    static constexpr std::uint64_t kTombstone   = 2;
+    static constexpr std::uint64_t kBusy        = 3; // 写者正在改这个槽（seqlock 的"奇数"）
+    static constexpr std::uint64_t kStateMask   = 3;
+    static constexpr std::uint64_t kVersionStep = 4;
+
+    static constexpr size_t kMinCapacity = 16;
+    static constexpr size_t kStripes     = 64;  // 2 的幂：用哈希高位选条带
+    static constexpr size_t kReaderSlots = 128; // 线程数超过它时几个线程共用一个读者计数
+    static constexpr size_t kNotFound    = ~size_t{ 0 };
+
+    struct Slot {
+        std::atomic<std::uint64_t> meta{ kEmpty };
+        detail::AtomicWords<Key>   key;
+        detail::AtomicWords<Value> value;
+    };
+
+    struct Table {
+        explicit Table(size_t capacity)
+            : mask(capacity - 1), max_used(capacity / 4 * 3), slots(new Slot[capacity]) {}
+
+        size_t                  mask;
+        size_t                  max_used; // used 的上限，保证表里永远有空槽，探测一定能停下
+        std::atomic<size_t>     used{ 0 }; // 离开过 EMPTY 状态的槽数（含墓碑）
+        std::unique_ptr<Slot[]> slots;
+    };
+
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+    };
+
+    struct alignas(64) ReaderCount {
+        std::atomic<size_t> active{ 0 };
+    };
+
+    // 读者进入/离开时增减自己线程的计数；和 grow 里的"换指针 -> 检查计数"都用 seq_cst，
+    // 保证要么读者看到新表，要么 grow 看到读者还在
+    class ReaderGuard {
+      public:
+        explicit ReaderGuard(const ConcurrentHashMap & map)
+            : count_(map.readers_[reader_slot()].active) {
+            count_.fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        ~ReaderGuard() { count_.fetch_sub(1, std::memory_order_release); }
+
+        ReaderGuard(const ReaderGuard &)             = delete;
+        ReaderGuard & operator=(const ReaderGuard &) = delete;
+
+      private:
+        std::atomic<size_t> & count_;
+    };
+
+    // 扩容期间持有全部条带锁，固定顺序加锁避免两个扩容者互相等待
+    class AllStripesLock {
+      public:
+        explicit AllStripesLock(ConcurrentHashMap & map) : map_(map) {
+            for (Stripe & s : map_.stripes_) {
+                s.mutex.lock();
+            }
+        }
+
+        ~AllStripesLock() {
+            for (Stripe & s : map_.stripes_) {
+                s.mutex.unlock();
+            }
+        }
+
+        AllStripesLock(const AllStripesLock &)             = delete;
+        AllStripesLock & operator=(const AllStripesLock &) = delete;
+
+      private:
+        ConcurrentHashMap & map_;
+    };
+
+    struct Probe {
+        size_t found      = kNotFound;
+        size_t first_free = kNotFound; // 探测链上第一个可复用的墓碑或空槽
+    };
+
+    static size_t reader_slot() {
+        static std::atomic<size_t> next{ 0 };
+        thread_local const size_t  slot = next.fetch_add(1, std::memory_order_relaxed) %
+                                         kReaderSlots;
+        return slot;
+    }
+
+    static std::uint64_t next_meta(std::uint64_t meta, std::uint64_t state) {
+        return ((meta & ~kStateMask) + kVersionStep) | state;
+    }
+
+    std::uint64_t hash_of(const Key & key) const {
+        return detail::mix_hash(static_cast<std::uint64_t>(hash_(key)));
+    }
+
+    // 槽下标用哈希低位，条带用高位，两者互不相关
+    std::mutex & stripe_for(std::uint64_t h) { return stripes_[(h >> 58) & (kStripes - 1)].mutex; }
+
+    // 持有键所在条带锁时调用：别的条带可能正在抢占空槽（BUSY），等它写完再判断
+    Probe locate(const Table & t, const Key & key, std::uint64_t h) const {
+        Probe p;
+        for (size_t i = h & t.mask;; i = (i + 1) & t.mask) {
+            const Slot &  s     = t.slots[i];
+            unsigned      spins = 0;
+            std::uint64_t m     = s.meta.load(std::memory_order_acquire);
+            Key           k;
+            for (;;) {
+                if ((m & kStateMask) == kBusy) {
+                    detail::spin_pause(spins);
+                } else if ((m & kStateMask) != kFull) {
+                    break;
+                } else {
+                    // FULL 槽的键只可能被"删除 + 别的键复用"改掉，所以同样要校验版本
+                    k = s.key.load();
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (s.meta.load(std::memory_order_relaxed) == m) {
+                        break;
+                    }
+                }
+                m = s.meta.load(std::memory_order_acquire);
+            }
+            const std::uint64_t state = m & kStateMask;
+            if (state == kFull && equal_(k, key)) {
+                p.found = i;
+                return p;
+            }
+            if (state != kFull && p.first_free == kNotFound) {
+                p.first_free = i;
+            }
+            if (state == kEmpty) {
+                return p;
+            }
+        }
+    }
+
+    // 从 from 开始抢一个墓碑或空槽写入新键；抢空槽前先预订 used 额度，额度用完返回 false
+    bool claim(Table & t, size_t from, const Key & key, const Value & value) {
+        for (size_t i = from;; i = (i + 1) & t.mask) {
+            Slot &              s     = t.slots[i];
+            std::uint64_t       m     = s.meta.load(std::memory_order_acquire);
+            const std::uint64_t state = m & kStateMask;
+            if (state != kEmpty && state != kTombstone) {
+                continue;
+            }
+            if (state == kEmpty &&
+                t.used.fetch_add(1, std::memory_order_relaxed) >= t.max_used) {
+                t.used.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+            const std::uint64_t busy = next_meta(m, kBusy);
+            if (!s.meta.compare_exchange_strong(m, busy, std::memory_order_acq_rel)) {
+                if (state == kEmpty) {
+                    t.used.fetch_sub(1, std::memory_order_relaxed);
+                }
+                continue; // 被别的条带的写者抢走了
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+            s.key.store(key);
+            s.value.store(value);
+            s.meta.store(next_meta(busy, kFull), std::memory_order_release);
+            return true;
+        }
+    }
+
+    template <typename Update> bool write(const Key & key, Update && update, const Value & init) {
+        const std::uint64_t h = hash_of(key);
+        for (;;) {
+            const Table * observed = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(stripe_for(h));
+                Table &                     t = *table_.load(std::memory_order_acquire);
+                const Probe                 p = locate(t, key, h);
+                if (p.found != kNotFound) {
+                    Slot & s = t.slots[p.found];
+                    Value  v = s.value.load();
+                    update(v); // 先在副本上改：抛异常时槽还没动
+                    const std::uint64_t m    = s.meta.load(std::memory_order_relaxed);
+                    const std::uint64_t busy = next_meta(m, kBusy);
+                    s.meta.store(busy, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_release);
+                    s.value.store(v);
+                    s.meta.store(next_meta(busy, kFull), std::memory_order_release);
+                    return false;
+                }
+                if (claim(t, p.first_free, key, init)) {
+                    size_.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+                observed = &t;
+            }
+            grow(observed); // 表满：先放掉条带锁再扩容，然后重试
+        }
+    }
+
+    void grow(const Table * observed) {
+        AllStripesLock all(*this);
+        Table *        old = table_.load(std::memory_order_relaxed);
+        if (old != observed) {
+            return; // 别的线程已经扩过了
+        }
+        // 活跃键超过 1/4 就翻倍；否则满的主要是墓碑，原容量重建即可
+        size_t capacity = old->mask + 1;
+        if (size_.load(std::memory_order_relaxed) * 4 >= capacity) {
+            capacity *= 2;
+        }
+        std::unique_ptr<Table> fresh(new Table(capacity));
+        migrate(*old, *fresh);
+        table_.store(fresh.get(), std::memory_order_seq_cst);
+        wait_for_readers();
+        current_ = std::move(fresh); // 宽限期已过，释放旧表
+    }
+
+    // 写者都停着，旧表只读；新表还没发布，直接写
+    void migrate(const Table & from, Table & to) const {
+        for (size_t i = 0; i <= from.mask; ++i) {
+            const Slot & s = from.slots[i];
+            if ((s.meta.load(std::memory_order_relaxed) & kStateMask) != kFull) {
+                continue;
+            }
+            const Key key = s.key.load();
+            size_t    j   = hash_of(key) & to.mask;
+            while ((to.slots[j].meta.load(std::memory_order_relaxed) & kStateMask) != kEmpty) {
+                j = (j + 1) & to.mask;
+            }
+            to.slots[j].key.store(key);
+            to.slots[j].value.store(s.value.load());
+            to.slots[j].meta.store(kFull, std::memory_order_relaxed);
+            to.used.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // 宽限期：每个计数都归零过一次之后，再进来的读者只会拿到新表
+    void wait_for_readers() const {
+        for (const ReaderCount & r : readers_) {
+            unsigned spins = 0;
+            while (r.active.load(std::memory_order_seq_cst) != 0) {
+                detail::spin_pause(spins);
+            }
+        }
+    }
+
+    std::atomic<Table *>   table_{ nullptr };
+    std::unique_ptr<Table> current_; // 当前表的所有者；table_ 是读者看到的指针
+    std::atomic<size_t>    size_{ 0 };
+    Stripe                 stripes_[kStripes];
+    mutable ReaderCount    readers_[kReaderSlots];
+    Hash                   hash_;
+    KeyEqual               equal_;
+};
+
+} // namespace parallel
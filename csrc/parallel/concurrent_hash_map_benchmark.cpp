@@ -0,0 +1,398 @@
+/**
+ * @file concurrent_hash_map_benchmark.cpp
+ * @brief ConcurrentHashMap 与 "std::unordered_map + omp critical" 的扩展性对比
+ *
+ * 负载（对应 openmp_race_prevention_examples.cpp 里用 critical 保护共享容器的写法）：
+ *   counter      全部是 upsert(+1)：多线程给一批键计数，最后各键计数之和 = 操作数
+ *   read_mostly  预先放好全部键；90% find、8% insert_or_assign、2% erase 后立刻重新插入
+ *   insert_grow  从很小的表开始，每个线程插入互不相同的（打散的）键，全程伴随并发扩容
+ *
+ * 表实现：
+ *   critical     std::unordered_map，所有访问（包括 find）都在同一个 omp critical 里
+ *   concurrent   parallel::ConcurrentHashMap
+ *
+ * 用法: concurrent_hash_map_benchmark [--ops N] [--keys K] [--threads 1,2,4]
+ *       [--workloads a,b] [--maps a,b] [--repetitions=N] [--json=FILE]
+ *       （microbench::Report 的 JSON 格式，供 bench 目标读取）
+ */
+
+#include <fmt/core.h>
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "concurrent_hash_map.h"
+#include "microbench.h"
+
+namespace {
+
+struct BenchConfig {
+    size_t                   ops       = 1 << 22;
+    size_t                   keys      = 1 << 16;
+    std::vector<size_t>      threads   = { 1, 2, 4, 8, 16, 32, 64 };
+    std::vector<std::string> workloads = { "counter", "read_mostly", "insert_grow" };
+    std::vector<std::string> maps      = { "critical", "concurrent" };
+    int                      reps      = 3;
+};
+
+struct BenchResult {
+    std::string         workload;
+    std::string         map;
+    size_t              threads = 1;
+    std::vector<double> samples_seconds;
+    bool                correct = true;
+
+    std::string name() const { return workload + "/" + map + "/t" + std::to_string(threads); }
+
+    double median() const {
+        std::vector<double> sorted = samples_seconds;
+        std::sort(sorted.begin(), sorted.end());
+        size_t mid = sorted.size() / 2;
+        return sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+    }
+};
+
+std::vector<std::string> split_list(const std::string & s) {
+    std::vector<std::string> items;
+    std::stringstream        ss(s);
+    std::string              item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void print_usage(const char * prog) {
+    fmt::print("用法: {} [选项]\n"
+               "  --ops N                每次运行的总操作数（默认 4194304）\n"
+               "  --keys K               counter / read_mostly 的键空间大小（默认 65536）\n"
+               "  --threads 1,2,4        线程数列表（默认 1,2,4,8,16,32,64）\n"
+               "  --workloads a,b,...    counter,read_mostly,insert_grow\n"
+               "  --maps a,b             critical,concurrent\n"
+               "  --repetitions=N        计时重复次数（默认 3）\n"
+               "  --json=FILE            输出 JSON 结果\n",
+               prog);
+}
+
+bool parse_args(int argc, char * argv[], BenchConfig & cfg) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg  = argv[i];
+        auto        next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--ops") {
+            cfg.ops = std::max<size_t>(1, std::strtoul(next().c_str(), nullptr, 10));
+        } else if (arg == "--keys") {
+            cfg.keys = std::max<size_t>(1, std::strtoul(next().c_str(), nullptr, 10));
+        } else if (arg == "--threads") {
+            cfg.threads.clear();
+            for (const auto & v : split_list(next())) {
+                cfg.threads.push_back(std::max<size_t>(1, std::strtoul(v.c_str(), nullptr, 10)));
+            }
+        } else if (arg == "--workloads") {
+            cfg.workloads = split_list(next());
+        } else if (arg == "--maps") {
+            cfg.maps = split_list(next());
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    return true;
+}
+
+// ==================== 两种表的统一接口 ====================
+
+using Concurrent = parallel::ConcurrentHashMap<uint64_t, uint64_t>;
+
+// 基线：和 example_critical 一样，一个无名 critical 保护整个容器
+class CriticalMap {
+  public:
+    explicit CriticalMap(size_t capacity) { map_.reserve(capacity); }
+
+    bool find(uint64_t key, uint64_t & value) const {
+        bool found = false;
+#pragma omp critical(unordered_map)
+        {
+            auto it = map_.find(key);
+            if (it != map_.end()) {
+                value = it->second;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    void add(uint64_t key, uint64_t delta) {
+#pragma omp critical(unordered_map)
+        map_[key] += delta;
+    }
+
+    void assign(uint64_t key, uint64_t value) {
+#pragma omp critical(unordered_map)
+        map_.insert_or_assign(key, value);
+    }
+
+    void reinsert(uint64_t key, uint64_t value) {
+#pragma omp critical(unordered_map)
+        {
+            map_.erase(key);
+            map_.emplace(key, value);
+        }
+    }
+
+    size_t size() const { return map_.size(); }
+
+  private:
+    std::unordered_map<uint64_t, uint64_t> map_;
+};
+
+class ConcurrentMap {
+  public:
+    explicit ConcurrentMap(size_t capacity) : map_(capacity) {}
+
+    bool find(uint64_t key, uint64_t & value) const {
+        auto v = map_.find(key);
+        if (v) {
+            value = *v;
+        }
+        return v.has_value();
+    }
+
+    void add(uint64_t key, uint64_t delta) {
+        map_.upsert(key, [delta](uint64_t & v) { v += delta; }, delta);
+    }
+
+    void assign(uint64_t key, uint64_t value) { map_.insert_or_assign(key, value); }
+
+    void reinsert(uint64_t key, uint64_t value) {
+        map_.erase(key);
+        map_.insert_or_assign(key, value);
+    }
+
+    size_t size() const { return map_.size(); }
+
+  private:
+    Concurrent map_;
+};
+
+// ==================== 负载 ====================
+
+// 每个线程一个 xorshift 生成器：两种表看到的操作序列完全相同
+inline uint64_t next_random(uint64_t & state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// 把 [0, ops) 均分给各线程，对每个操作调用 op(i, rng)
+template <typename Op> void run_parallel(size_t threads, size_t ops, Op && op) {
+#pragma omp parallel num_threads(static_cast<int>(threads))
+    {
+        const size_t tid   = static_cast<size_t>(omp_get_thread_num());
+        const size_t nt    = static_cast<size_t>(omp_get_num_threads());
+        const size_t begin = ops / nt * tid + std::min(tid, ops % nt);
+        const size_t end   = ops / nt * (tid + 1) + std::min(tid + 1, ops % nt);
+        uint64_t     rng   = 0x9E3779B97F4A7C15ULL * (tid + 1);
+        for (size_t i = begin; i < end; ++i) {
+            op(i, rng);
+        }
+    }
+}
+
+// 运行一次负载并校验结果；返回 {耗时, 是否正确}
+template <typename Map>
+std::pair<double, bool> run_workload(const BenchConfig & cfg, const std::string & workload,
+                                     size_t threads) {
+    const size_t keys = cfg.keys;
+    if (workload == "counter") {
+        Map      map(keys);
+        double   seconds = microbench::Seconds([&] {
+            run_parallel(threads, cfg.ops, [&](size_t, uint64_t & rng) {
+                map.add(next_random(rng) % keys, 1);
+            });
+        });
+        uint64_t total   = 0;
+        for (uint64_t k = 0; k < keys; ++k) {
+            uint64_t v = 0;
+            total += map.find(k, v) ? v : 0;
+        }
+        return { seconds, total == cfg.ops };
+    }
+    if (workload == "read_mostly") {
+        Map map(keys);
+        for (uint64_t k = 0; k < keys; ++k) {
+            map.assign(k, k);
+        }
+        std::vector<uint64_t> hits(threads, 0);
+        double                seconds = microbench::Seconds([&] {
+            run_parallel(threads, cfg.ops, [&](size_t, uint64_t & rng) {
+                const uint64_t r   = next_random(rng);
+                const uint64_t key = r % keys;
+                const uint64_t op  = (r >> 32) % 100;
+                if (op < 90) {
+                    uint64_t v = 0;
+                    hits[static_cast<size_t>(omp_get_thread_num())] += map.find(key, v) ? 1 : 0;
+                } else if (op < 98) {
+                    map.assign(key, r);
+                } else {
+                    map.reinsert(key, r);
+                }
+            });
+        });
+        bool                  all     = map.size() == keys;
+        for (uint64_t k = 0; k < keys && all; ++k) {
+            uint64_t v = 0;
+            all        = map.find(k, v);
+        }
+        return { seconds, all };
+    }
+    if (workload == "insert_grow") {
+        Map    map(16);
+        // 键打散成类似账户 ID 的随机值；连续整数对恒等哈希的 unordered_map 过于友好
+        double seconds = microbench::Seconds([&] {
+            run_parallel(threads, cfg.ops, [&](size_t i, uint64_t &) {
+                map.assign(parallel::detail::mix_hash(i), i);
+            });
+        });
+        bool   all     = map.size() == cfg.ops;
+        for (uint64_t k = 0; k < cfg.ops && all; k += 97) {
+            uint64_t v = 0;
+            all        = map.find(parallel::detail::mix_hash(k), v) && v == k;
+        }
+        return { seconds, all };
+    }
+    throw std::invalid_argument("unknown workload " + workload);
+}
+
+template <typename Map>
+BenchResult measure(const BenchConfig & cfg, const std::string & workload, const char * map,
+                    size_t threads) {
+    BenchResult r;
+    r.workload = workload;
+    r.map      = map;
+    r.threads  = threads;
+    run_workload<Map>(cfg, workload, threads); // 预热
+    for (int rep = 0; rep < cfg.reps; ++rep) {
+        auto [seconds, ok] = run_workload<Map>(cfg, workload, threads);
+        r.samples_seconds.push_back(seconds);
+        r.correct = r.correct && ok;
+    }
+    return r;
+}
+
+bool wants(const std::vector<std::string> & list, const std::string & name) {
+    return std::find(list.begin(), list.end(), name) != list.end();
+}
+
+// ==================== 输出 ====================
+
+void print_workload(const BenchConfig & cfg, const std::vector<BenchResult> & results,
+                    const std::string & workload) {
+    fmt::print("\n[{}] {} 次操作，单位 Mops/s，括号内为相对同线程数 critical 的倍数\n", workload,
+               cfg.ops);
+    fmt::print("  {:<12}", "表");
+    for (size_t t : cfg.threads) {
+        fmt::print(" {:>16}", fmt::format("{} 线程", t));
+    }
+    fmt::print("\n");
+    for (const std::string & map : cfg.maps) {
+        fmt::print("  {:<12}", map);
+        for (size_t t : cfg.threads) {
+            double baseline = 0.0;
+            for (const BenchResult & r : results) {
+                if (r.workload == workload && r.map == "critical" && r.threads == t) {
+                    baseline = r.median();
+                }
+            }
+            std::string cell = "-";
+            for (const BenchResult & r : results) {
+                if (r.workload == workload && r.map == map && r.threads == t) {
+                    double mops = static_cast<double>(cfg.ops) / r.median() / 1e6;
+                    cell        = baseline > 0 ? fmt::format("{:.2f} ({:.2f}x){}", mops,
+                                                             baseline / r.median(),
+                                                             r.correct ? "" : " 错误")
+                                               : fmt::format("{:.2f}", mops);
+                }
+            }
+            fmt::print(" {:>16}", cell);
+        }
+        fmt::print("\n");
+    }
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    BenchConfig                       cfg;
+    std::optional<microbench::Report> report;
+    try {
+        report.emplace(argc, argv, cfg.reps);
+        cfg.reps = report->repetitions();
+        if (!parse_args(argc, argv, cfg)) {
+            return 0;
+        }
+    } catch (const std::exception & e) {
+        fmt::print(stderr, "参数错误: {}\n", e.what());
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    fmt::print("并发哈希表基准（ConcurrentHashMap vs unordered_map + omp critical）\n");
+    fmt::print("=====================================\n");
+    fmt::print("ops = {}，keys = {}，硬件线程 {}，每项重复 {} 次取中位数\n", cfg.ops, cfg.keys,
+               std::thread::hardware_concurrency(), cfg.reps);
+
+    std::vector<BenchResult> results;
+    bool                     all_correct = true;
+    try {
+        for (const std::string & workload : cfg.workloads) {
+            for (size_t t : cfg.threads) {
+                if (wants(cfg.maps, "critical")) {
+                    results.push_back(measure<CriticalMap>(cfg, workload, "critical", t));
+                }
+                if (wants(cfg.maps, "concurrent")) {
+                    results.push_back(measure<ConcurrentMap>(cfg, workload, "concurrent", t));
+                }
+            }
+            print_workload(cfg, results, workload);
+        }
+    } catch (const std::exception & e) {
+        fmt::print(stderr, "参数错误: {}\n", e.what());
+        return 1;
+    }
+
+    for (const BenchResult & r : results) {
+        all_correct = all_correct && r.correct;
+    }
+    fmt::print("\n结果一致: {}\n", all_correct ? "yes" : "NO");
+    // 样本按操作数折算成 ns/操作
+    for (const BenchResult & r : results) {
+        report->Add(r.name(), r.samples_seconds, cfg.ops).correct = r.correct;
+    }
+    int status = report->Finish();
+
+    fmt::print("\n关键学习点：\n");
+    fmt::print("1. critical 把所有线程排成一队，线程越多排队越长；条带锁只让同一条带的写者互斥\n");
+    fmt::print("2. seqlock 读者不写共享内存，读多写少时扩展性最好；代价是写者要改两次版本号\n");
+    fmt::print("3. 扩容时写者要等全部条带锁，读者继续读旧表；宽限期过后才释放旧表\n");
+    fmt::print("4. 线程数超过核数后，持锁线程被换下 CPU 会让其他线程白等，两种表都会变慢\n");
+    return status;
+}
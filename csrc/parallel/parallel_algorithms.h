@@ -0,0 +1,553 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#    include <omp.h>
+#endif
+
+/**
+ * ============================================================================
+ * 并行算法：scan / radix sort / sample sort / stable partition / transform_reduce
+ * ============================================================================
+ *
+ * 所有算法都写成"几个平坦的并行阶段 + 阶段之间很小的串行步骤"：
+ *   阶段 1：每个块独立统计（部分和、直方图、计数）
+ *   串行：  对块的统计结果做前缀和，得到每个块的输出位置
+ *   阶段 2：每个块独立写到自己的位置
+ * 这样每个阶段都只需要后端提供一个 run(tasks, f)，不需要嵌套并行。
+ *
+ * 后端（Backend）只要满足：
+ *   size_t concurrency() const;                             // 用来决定切多少块
+ *   template <typename F> void run(size_t tasks, F && f);   // 对 [0, tasks) 调用 f(i)，全部完成后返回
+ * 已提供 SerialBackend、OpenMPBackend，以及适配现有线程池的 FuturePoolBackend
+ * （::ThreadPool，submit 返回 future）和 EnqueueWaitPoolBackend（concurrent::ThreadPool，
+ * enqueue + wait）。任务里抛出的异常会在 run 返回前重新抛给调用者。
+ *
+ * 注意：池后端会阻塞等待，不能在同一个池的工作线程里调用这些算法。
+ */
+
+namespace parallel {
+
+// ==================== 后端 ====================
+
+/**
+ * @brief 串行后端：作为基线，也方便在没有并行环境时复用同一套代码
+ */
+class SerialBackend {
+  public:
+    size_t concurrency() const { return 1; }
+
+    template <typename F> void run(size_t tasks, F && f) const {
+        for (size_t i = 0; i < tasks; ++i) {
+            f(i);
+        }
+    }
+};
+
+namespace detail {
+
+// 收集任务里的第一个异常，在 run 结束时重新抛出
+class ExceptionSink {
+  public:
+    template <typename F> void guard(F && f) noexcept {
+        try {
+            f();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+    }
+
+    void rethrow() {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+  private:
+    std::mutex         mutex_;
+    std::exception_ptr error_;
+};
+
+} // namespace detail
+
+/**
+ * @brief OpenMP 后端：每个 run 是一个 parallel for，schedule(dynamic, 1) 让块数多于线程数时自动均衡
+ *
+ * 未启用 OpenMP 编译时退化为串行循环（块的划分仍按 threads 进行）
+ */
+class OpenMPBackend {
+  public:
+    explicit OpenMPBackend(size_t threads = 0) : threads_(threads) {
+#ifdef _OPENMP
+        if (threads_ == 0) {
+            threads_ = static_cast<size_t>(omp_get_max_threads());
+        }
+#endif
+        threads_ = std::max<size_t>(1, threads_);
+    }
+
+    size_t concurrency() const { return threads_; }
+
+    template <typename F> void run(size_t tasks, F && f) const {
+        detail::ExceptionSink sink;
+        const long long       count = static_cast<long long>(tasks);
+#ifdef _OPENMP
+#    pragma omp parallel for schedule(dynamic, 1) num_threads(static_cast<int>(threads_))
+#endif
+        for (long long i = 0; i < count; ++i) {
+            sink.guard([&] { f(static_cast<size_t>(i)); });
+        }
+        sink.rethrow();
+    }
+
+  private:
+    size_t threads_;
+};
+
+/**
+ * @brief 适配 submit() 返回 std::future 的线程池（linux_program/pthread_examples 的 ThreadPool）
+ */
+template <typename Pool> class FuturePoolBackend {
+  public:
+    FuturePoolBackend(Pool & pool, size_t threads)
+        : pool_(pool), threads_(std::max<size_t>(1, threads)) {}
+
+    size_t concurrency() const { return threads_; }
+
+    template <typename F> void run(size_t tasks, F && f) {
+        std::vector<std::future<void>> futures;
+        futures.reserve(tasks);
+        for (size_t i = 0; i < tasks; ++i) {
+            futures.push_back(pool_.submit([&f, i] { f(i); }));
+        }
+        // 先全部等待再取异常：否则提前抛出时仍有任务在引用 f
+        for (auto & fut : futures) {
+            fut.wait();
+        }
+        for (auto & fut : futures) {
+            fut.get();
+        }
+    }
+
+  private:
+    Pool & pool_;
+    size_t threads_;
+};
+
+/**
+ * @brief 适配 enqueue(std::function<void()>) + wait() 的线程池（concurrent::ThreadPool）
+ *
+ * wait() 等的是池里的所有任务，所以这个池在算法运行期间不要再提交别的工作
+ */
+template <typename Pool> class EnqueueWaitPoolBackend {
+  public:
+    explicit EnqueueWaitPoolBackend(Pool & pool) : pool_(pool) {}
+
+    size_t concurrency() const { return std::max<size_t>(1, pool_.size()); }
+
+    template <typename F> void run(size_t tasks, F && f) {
+        detail::ExceptionSink sink;
+        for (size_t i = 0; i < tasks; ++i) {
+            pool_.enqueue(std::function<void()>([&sink, &f, i] { sink.guard([&] { f(i); }); }));
+        }
+        pool_.wait();
+        sink.rethrow();
+    }
+
+  private:
+    Pool & pool_;
+};
+
+// ==================== 分块 ====================
+
+namespace detail {
+
+// 每块至少这么多元素，否则调度开销盖过并行收益
+constexpr size_t kMinGrain = 4096;
+// 块数上限 = 线程数 * kTasksPerThread，多切几块让动态调度的后端能均衡负载
+constexpr size_t kTasksPerThread = 4;
+
+template <typename Backend> size_t task_count(const Backend & backend, size_t n) {
+    size_t by_size = std::max<size_t>(1, n / kMinGrain);
+    return std::min(by_size, backend.concurrency() * kTasksPerThread);
+}
+
+// 第 t 块是 [begin(t), begin(t + 1))，块长度相差不超过 1
+inline size_t chunk_begin(size_t n, size_t tasks, size_t t) {
+    return n / tasks * t + std::min(t, n % tasks);
+}
+
+} // namespace detail
+
+// ==================== transform_reduce ====================
+
+/**
+ * @brief 并行 transform_reduce：reduce 必须满足结合律（块内从左到右，块间按块序合并）
+ */
+template <typename Backend, typename It, typename T, typename Reduce, typename Transform>
+T transform_reduce(Backend & backend, It first, It last, T init, Reduce reduce,
+                   Transform transform) {
+    const size_t n = static_cast<size_t>(std::distance(first, last));
+    if (n == 0) {
+        return init;
+    }
+    const size_t   tasks = detail::task_count(backend, n);
+    std::vector<T> partial(tasks, init);
+    backend.run(tasks, [&](size_t t) {
+        size_t b   = detail::chunk_begin(n, tasks, t);
+        size_t e   = detail::chunk_begin(n, tasks, t + 1);
+        It     it  = first + static_cast<std::ptrdiff_t>(b);
+        T      acc = transform(*it);
+        for (++it, ++b; b < e; ++it, ++b) {
+            acc = reduce(std::move(acc), transform(*it));
+        }
+        partial[t] = std::move(acc);
+    });
+    T result = std::move(init);
+    for (T & p : partial) {
+        result = reduce(std::move(result), std::move(p));
+    }
+    return result;
+}
+
+// ==================== scan ====================
+
+/**
+ * @brief 并行 inclusive scan：out[i] = in[0] op ... op in[i]，允许 d_first == first（原地）
+ */
+template <typename Backend, typename It, typename OutIt, typename Op = std::plus<>>
+OutIt inclusive_scan(Backend & backend, It first, It last, OutIt d_first, Op op = Op{}) {
+    using T        = typename std::iterator_traits<It>::value_type;
+    const size_t n = static_cast<size_t>(std::distance(first, last));
+    if (n == 0) {
+        return d_first;
+    }
+    const size_t tasks = detail::task_count(backend, n);
+
+    // 阶段 1：每块的总和
+    std::vector<T> sums(tasks);
+    backend.run(tasks, [&](size_t t) {
+        size_t b   = detail::chunk_begin(n, tasks, t);
+        size_t e   = detail::chunk_begin(n, tasks, t + 1);
+        T      acc = first[static_cast<std::ptrdiff_t>(b)];
+        for (size_t i = b + 1; i < e; ++i) {
+            acc = op(std::move(acc), first[static_cast<std::ptrdiff_t>(i)]);
+        }
+        sums[t] = std::move(acc);
+    });
+    // 串行：sums[t] 变成前 t 块（含）的总和
+    for (size_t t = 1; t < tasks; ++t) {
+        sums[t] = op(sums[t - 1], sums[t]);
+    }
+    // 阶段 2：每块带着前面所有块的总和重新扫一遍
+    backend.run(tasks, [&](size_t t) {
+        size_t b   = detail::chunk_begin(n, tasks, t);
+        size_t e   = detail::chunk_begin(n, tasks, t + 1);
+        T      acc = t == 0 ? T(first[static_cast<std::ptrdiff_t>(b)])
+                            : op(sums[t - 1], first[static_cast<std::ptrdiff_t>(b)]);
+        d_first[static_cast<std::ptrdiff_t>(b)] = acc;
+        for (size_t i = b + 1; i < e; ++i) {
+            acc = op(std::move(acc), first[static_cast<std::ptrdiff_t>(i)]);
+            d_first[static_cast<std::ptrdiff_t>(i)] = acc;
+        }
+    });
+    return d_first + static_cast<std::ptrdiff_t>(n);
+}
+
+/**
+ * @brief 并行 exclusive scan：out[i] = init op in[0] op ... op in[i-1]，允许原地
+ */
+template <typename Backend, typename It, typename OutIt, typename T, typename Op = std::plus<>>
+OutIt exclusive_scan(Backend & backend, It first, It last, OutIt d_first, T init, Op op = Op{}) {
+    const size_t n = static_cast<size_t>(std::distance(first, last));
+    if (n == 0) {
+        return d_first;
+    }
+    const size_t tasks = detail::task_count(backend, n);
+
+    std::vector<T> sums(tasks);
+    backend.run(tasks, [&](size_t t) {
+        size_t b   = detail::chunk_begin(n, tasks, t);
+        size_t e   = detail::chunk_begin(n, tasks, t + 1);
+        T      acc = first[static_cast<std::ptrdiff_t>(b)];
+        for (size_t i = b + 1; i < e; ++i) {
+            acc = op(std::move(acc), first[static_cast<std::ptrdiff_t>(i)]);
+        }
+        sums[t] = std::move(acc);
+    });
+    // 串行：sums[t] 变成第 t 块的起始值（init 加上前面所有块）
+    T running = std::move(init);
+    for (size_t t = 0; t < tasks; ++t) {
+        T next  = op(running, sums[t]);
+        sums[t] = std::move(running);
+        running = std::move(next);
+    }
+    backend.run(tasks, [&](size_t t) {
+        size_t b   = detail::chunk_begin(n, tasks, t);
+        size_t e   = detail::chunk_begin(n, tasks, t + 1);
+        T      acc = sums[t];
+        for (size_t i = b; i < e; ++i) {
+            T value                                 = first[static_cast<std::ptrdiff_t>(i)];
+            d_first[static_cast<std::ptrdiff_t>(i)] = acc; // 先读后写，原地也安全
+            acc                                     = op(std::move(acc), std::move(value));
+        }
+    });
+    return d_first + static_cast<std::ptrdiff_t>(n);
+}
+
+// ==================== radix sort ====================
+
+namespace detail {
+
+/**
+ * @brief 把键映射成无符号整数，使无符号比较的顺序与原类型一致
+ *
+ * - 有符号整数：翻转符号位
+ * - 浮点数：正数翻转符号位，负数翻转全部位（-0.0 排在 +0.0 前，NaN 按位模式排在两端）
+ */
+template <typename K, typename = void> struct RadixKey;
+
+template <typename K> struct RadixKey<K, std::enable_if_t<std::is_integral<K>::value>> {
+    using Bits = std::make_unsigned_t<K>;
+    static Bits bits(K key) {
+        Bits b = static_cast<Bits>(key);
+        if (std::is_signed<K>::value) {
+            b ^= Bits(1) << (sizeof(K) * 8 - 1);
+        }
+        return b;
+    }
+};
+
+template <typename K> struct RadixKey<K, std::enable_if_t<std::is_floating_point<K>::value>> {
+    static_assert(sizeof(K) == 4 || sizeof(K) == 8, "radix_sort supports float and double");
+    using Bits = std::conditional_t<sizeof(K) == 4, uint32_t, uint64_t>;
+    static Bits bits(K key) {
+        Bits b;
+        std::memcpy(&b, &key, sizeof(K));
+        const Bits sign = Bits(1) << (sizeof(K) * 8 - 1);
+        return (b & sign) ? ~b : (b | sign);
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief 并行 LSD 基数排序（每趟 8 位，稳定），支持整数和 float/double
+ *
+ * 每趟：各块统计 256 桶直方图 -> 按 (桶, 块) 顺序前缀和得到写入位置 -> 各块分散写。
+ * 所有键在某一趟落在同一个桶时跳过这一趟（小范围的键只需要很少几趟）。
+ * 需要 n 个元素的临时缓冲区。
+ */
+template <typename Backend, typename K> void radix_sort(Backend & backend, K * data, size_t n) {
+    using Traits              = detail::RadixKey<K>;
+    constexpr size_t kBuckets = 256;
+    constexpr int    kPasses  = static_cast<int>(sizeof(K));
+    if (n < 2) {
+        return;
+    }
+    const size_t        tasks = detail::task_count(backend, n);
+    std::vector<K>      buffer(n);
+    std::vector<size_t> offsets(tasks * kBuckets);
+    K *                 src = data;
+    K *                 dst = buffer.data();
+
+    for (int pass = 0; pass < kPasses; ++pass) {
+        const int shift = pass * 8;
+        std::fill(offsets.begin(), offsets.end(), 0);
+        backend.run(tasks, [&](size_t t) {
+            size_t * count = &offsets[t * kBuckets];
+            size_t   e     = detail::chunk_begin(n, tasks, t + 1);
+            for (size_t i = detail::chunk_begin(n, tasks, t); i < e; ++i) {
+                ++count[(Traits::bits(src[i]) >> shift) & 0xFF];
+            }
+        });
+
+        // 串行：桶在外、块在内做前缀和，保证稳定性；顺便检查这一趟是否可以跳过
+        size_t running = 0;
+        bool   trivial = false;
+        for (size_t d = 0; d < kBuckets; ++d) {
+            size_t bucket_total = 0;
+            for (size_t t = 0; t < tasks; ++t) {
+                size_t c                  = offsets[t * kBuckets + d];
+                offsets[t * kBuckets + d] = running;
+                running += c;
+                bucket_total += c;
+            }
+            trivial = trivial || bucket_total == n;
+        }
+        if (trivial) {
+            continue;
+        }
+
+        backend.run(tasks, [&](size_t t) {
+            size_t * pos = &offsets[t * kBuckets];
+            size_t   e   = detail::chunk_begin(n, tasks, t + 1);
+            for (size_t i = detail::chunk_begin(n, tasks, t); i < e; ++i) {
+                dst[pos[(Traits::bits(src[i]) >> shift) & 0xFF]++] = src[i];
+            }
+        });
+        std::swap(src, dst);
+    }
+
+    if (src != data) {
+        backend.run(tasks, [&](size_t t) {
+            size_t b = detail::chunk_begin(n, tasks, t);
+            size_t e = detail::chunk_begin(n, tasks, t + 1);
+            std::copy(src + b, src + e, data + b);
+        });
+    }
+}
+
+template <typename Backend, typename K> void radix_sort(Backend & backend, std::vector<K> & keys) {
+    radix_sort(backend, keys.data(), keys.size());
+}
+
+// ==================== sample sort ====================
+
+/**
+ * @brief 并行 sample sort：任意比较函数，不稳定
+ *
+ * 1. 等距取 kOversample * buckets 个样本排序，选出 buckets - 1 个分隔键
+ * 2. 各块按分隔键统计每个桶的元素数，前缀和后分散写到临时缓冲区
+ * 3. 每个桶独立 std::sort，再搬回原位置
+ * 大量重复键会落到同一个桶，此时退化为一个大桶的串行排序。
+ */
+template <typename Backend, typename It, typename Compare = std::less<>>
+void sample_sort(Backend & backend, It first, It last, Compare comp = Compare{}) {
+    using T                      = typename std::iterator_traits<It>::value_type;
+    constexpr size_t kOversample = 32;
+    const size_t     n           = static_cast<size_t>(std::distance(first, last));
+    const size_t     tasks       = detail::task_count(backend, n);
+    if (tasks < 2) {
+        std::sort(first, last, comp);
+        return;
+    }
+    const size_t buckets = tasks;
+
+    std::vector<T> samples;
+    samples.reserve(buckets * kOversample);
+    for (size_t i = 0; i < buckets * kOversample; ++i) {
+        samples.push_back(first[static_cast<std::ptrdiff_t>(i * n / (buckets * kOversample))]);
+    }
+    std::sort(samples.begin(), samples.end(), comp);
+    std::vector<T> splitters;
+    for (size_t b = 1; b < buckets; ++b) {
+        splitters.push_back(samples[b * kOversample]);
+    }
+    auto bucket_of = [&](const T & value) {
+        return static_cast<size_t>(
+            std::upper_bound(splitters.begin(), splitters.end(), value, comp) - splitters.begin());
+    };
+
+    // 阶段 1：每块每桶计数；桶号先存下来，阶段 2 不必再二分查找
+    std::vector<size_t>   offsets(tasks * buckets, 0);
+    std::vector<uint32_t> bucket_ids(n);
+    backend.run(tasks, [&](size_t t) {
+        size_t * count = &offsets[t * buckets];
+        size_t   e     = detail::chunk_begin(n, tasks, t + 1);
+        for (size_t i = detail::chunk_begin(n, tasks, t); i < e; ++i) {
+            uint32_t b    = static_cast<uint32_t>(bucket_of(first[static_cast<std::ptrdiff_t>(i)]));
+            bucket_ids[i] = b;
+            ++count[b];
+        }
+    });
+    std::vector<size_t> bucket_begin(buckets + 1, 0);
+    size_t              running = 0;
+    for (size_t b = 0; b < buckets; ++b) {
+        bucket_begin[b] = running;
+        for (size_t t = 0; t < tasks; ++t) {
+            size_t c                 = offsets[t * buckets + b];
+            offsets[t * buckets + b] = running;
+            running += c;
+        }
+    }
+    bucket_begin[buckets] = n;
+
+    // 阶段 2：分散到临时缓冲区
+    std::vector<T> buffer(n);
+    backend.run(tasks, [&](size_t t) {
+        size_t * pos = &offsets[t * buckets];
+        size_t   e   = detail::chunk_begin(n, tasks, t + 1);
+        for (size_t i = detail::chunk_begin(n, tasks, t); i < e; ++i) {
+            buffer[pos[bucket_ids[i]]++] = std::move(first[static_cast<std::ptrdiff_t>(i)]);
+        }
+    });
+
+    // 阶段 3：每个桶排序后搬回
+    backend.run(buckets, [&](size_t b) {
+        auto bb = buffer.begin() + static_cast<std::ptrdiff_t>(bucket_begin[b]);
+        auto be = buffer.begin() + static_cast<std::ptrdiff_t>(bucket_begin[b + 1]);
+        std::sort(bb, be, comp);
+        std::move(bb, be, first + static_cast<std::ptrdiff_t>(bucket_begin[b]));
+    });
+}
+
+// ==================== stable partition ====================
+
+/**
+ * @brief 并行 stable_partition：满足 pred 的元素在前，两部分各自保持原顺序；返回分界点
+ */
+template <typename Backend, typename It, typename Pred>
+It stable_partition(Backend & backend, It first, It last, Pred pred) {
+    using T        = typename std::iterator_traits<It>::value_type;
+    const size_t n = static_cast<size_t>(std::distance(first, last));
+    if (n == 0) {
+        return first;
+    }
+    const size_t tasks = detail::task_count(backend, n);
+
+    // 阶段 1：每块满足条件的个数；谓词结果存下来，保证只对每个元素求值一次
+    std::vector<size_t>  true_before(tasks + 1, 0);
+    std::vector<uint8_t> flags(n);
+    backend.run(tasks, [&](size_t t) {
+        size_t count = 0;
+        size_t e     = detail::chunk_begin(n, tasks, t + 1);
+        for (size_t i = detail::chunk_begin(n, tasks, t); i < e; ++i) {
+            flags[i] = pred(first[static_cast<std::ptrdiff_t>(i)]) ? 1 : 0;
+            count += flags[i];
+        }
+        true_before[t + 1] = count;
+    });
+    for (size_t t = 0; t < tasks; ++t) {
+        true_before[t + 1] += true_before[t];
+    }
+    const size_t total_true = true_before[tasks];
+
+    // 阶段 2：真值写到 [0, total_true)，假值写到 [total_true, n)
+    std::vector<T> buffer(n);
+    backend.run(tasks, [&](size_t t) {
+        size_t b         = detail::chunk_begin(n, tasks, t);
+        size_t e         = detail::chunk_begin(n, tasks, t + 1);
+        size_t true_pos  = true_before[t];
+        size_t false_pos = total_true + (b - true_before[t]);
+        for (size_t i = b; i < e; ++i) {
+            size_t & pos  = flags[i] ? true_pos : false_pos;
+            buffer[pos++] = std::move(first[static_cast<std::ptrdiff_t>(i)]);
+        }
+    });
+
+    backend.run(tasks, [&](size_t t) {
+        size_t b = detail::chunk_begin(n, tasks, t);
+        size_t e = detail::chunk_begin(n, tasks, t + 1);
+        std::move(buffer.begin() + static_cast<std::ptrdiff_t>(b),
+                  buffer.begin() + static_cast<std::ptrdiff_t>(e),
+                  first + static_cast<std::ptrdiff_t>(b));
+    });
+    return first + static_cast<std::ptrdiff_t>(total_true);
+}
+
+} // namespace parallel
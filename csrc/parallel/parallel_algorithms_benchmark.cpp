@@ -0,0 +1,456 @@
+/**
+ * @file parallel_algorithms_benchmark.cpp
+ * @brief parallel_algorithms.h 的扩展性基准：各算法 x 各后端 x 线程数
+ *
+ * 后端：
+ *   std_seq          标准库串行算法（加速比的基准）
+ *   serial           parallel:: 算法 + SerialBackend（看算法本身相对 std 的差距）
+ *   openmp           OpenMPBackend
+ *   pthread_pool     linux_program/pthread_examples 的 ThreadPool（submit + future）
+ *   concurrent_pool  concurrent::ThreadPool（enqueue + wait）
+ *   std_par          std::execution::par（需要 TBB；线程数用 tbb::global_control 限制）
+ *
+ * 用法: parallel_algorithms_benchmark [--n N] [--threads 1,2,4] [--algos a,b] [--backends a,b]
+ *       [--repetitions=N] [--json=FILE]（microbench::Report 的 JSON 格式，供 bench 目标读取）
+ */
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 由 CMake 在找到 TBB 时定义为 1（libstdc++ 的并行算法依赖 TBB）
+#ifndef PARALLEL_HAVE_STD_EXECUTION
+#    define PARALLEL_HAVE_STD_EXECUTION 0
+#endif
+
+#if PARALLEL_HAVE_STD_EXECUTION
+#    include <execution>
+#    include <tbb/global_control.h>
+#endif
+
+#include "gemm_learning.h" // concurrent::ThreadPool
+#include "microbench.h"
+#include "parallel_algorithms.h"
+#include "thread_pool.h"   // ::ThreadPool
+
+namespace {
+
+struct BenchConfig {
+    size_t                   n        = 1 << 21;
+    std::vector<size_t>      threads  = { 1, 2, 4 };
+    std::vector<std::string> algos    = { "inclusive_scan", "exclusive_scan", "radix_sort_u32",
+                                          "radix_sort_f32", "sample_sort_f64", "stable_partition",
+                                          "transform_reduce" };
+    std::vector<std::string> backends = { "std_seq", "serial",          "openmp",
+                                          "pthread_pool", "concurrent_pool", "std_par" };
+    int                      reps     = 5;
+};
+
+struct BenchResult {
+    std::string         algo;
+    std::string         backend;
+    size_t              threads = 1;
+    std::vector<double> samples_seconds;
+    bool                correct = true;
+
+    std::string name() const { return algo + "/" + backend + "/t" + std::to_string(threads); }
+
+    double median() const {
+        std::vector<double> sorted = samples_seconds;
+        std::sort(sorted.begin(), sorted.end());
+        size_t mid = sorted.size() / 2;
+        return sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+    }
+};
+
+std::vector<std::string> split_list(const std::string & s) {
+    std::vector<std::string> items;
+    std::stringstream        ss(s);
+    std::string              item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void print_usage(const char * prog) {
+    fmt::print("用法: {} [选项]\n"
+               "  --n N                  元素数（默认 2097152）\n"
+               "  --threads 1,2,4        线程数列表\n"
+               "  --algos a,b,...        inclusive_scan,exclusive_scan,radix_sort_u32,"
+               "radix_sort_f32,\n"
+               "                         sample_sort_f64,stable_partition,transform_reduce\n"
+               "  --backends a,b,...     std_seq,serial,openmp,pthread_pool,concurrent_pool,"
+               "std_par\n"
+               "  --repetitions=N        计时重复次数（默认 5）\n"
+               "  --json=FILE            输出 JSON 结果\n",
+               prog);
+}
+
+bool parse_args(int argc, char * argv[], BenchConfig & cfg) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg  = argv[i];
+        auto        next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--n") {
+            cfg.n = std::max<size_t>(1, std::strtoul(next().c_str(), nullptr, 10));
+        } else if (arg == "--threads") {
+            cfg.threads.clear();
+            for (const auto & v : split_list(next())) {
+                cfg.threads.push_back(std::max<size_t>(1, std::strtoul(v.c_str(), nullptr, 10)));
+            }
+        } else if (arg == "--algos") {
+            cfg.algos = split_list(next());
+        } else if (arg == "--backends") {
+            cfg.backends = split_list(next());
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    return true;
+}
+
+// ==================== 输入与校验 ====================
+
+struct Inputs {
+    std::vector<uint64_t> small_u64; // scan：值较小，前缀和不溢出
+    std::vector<uint32_t> u32;
+    std::vector<float>    f32;       // 含负数和 ±0
+    std::vector<double>   f64;
+};
+
+Inputs make_inputs(size_t n) {
+    std::mt19937_64                       rng(2024);
+    std::uniform_real_distribution<float> f32(-1e6f, 1e6f);
+    std::normal_distribution<double>      f64(0.0, 1e3);
+    Inputs                                in;
+    in.small_u64.resize(n);
+    in.u32.resize(n);
+    in.f32.resize(n);
+    in.f64.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        in.small_u64[i] = rng() % 1000;
+        in.u32[i]       = static_cast<uint32_t>(rng());
+        in.f32[i]       = i % 97 == 0 ? -0.0f : f32(rng);
+        in.f64[i]       = f64(rng);
+    }
+    return in;
+}
+
+// 输出摘要：按位 FNV-1a，顺序不同摘要就不同（stable_partition 的稳定性也一并校验）
+template <typename T> uint64_t digest(const std::vector<T> & v) {
+    uint64_t h = 1469598103934665603ULL;
+    for (const T & x : v) {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &x, sizeof(T));
+        for (unsigned char b : bytes) {
+            h = (h ^ b) * 1099511628211ULL;
+        }
+    }
+    return h;
+}
+
+// ==================== 后端分派 ====================
+
+struct StdSeq {};
+struct StdPar {};
+
+// ours(backend) 调用 parallel:: 算法；std_call(policy...) 调用标准库算法，串行时不带策略参数
+template <typename Exec, typename Ours, typename Std>
+void dispatch(Exec & exec, Ours && ours, Std && std_call) {
+    if constexpr (std::is_same<Exec, StdSeq>::value) {
+        std_call();
+    } else if constexpr (std::is_same<Exec, StdPar>::value) {
+#if PARALLEL_HAVE_STD_EXECUTION
+        std_call(std::execution::par);
+#else
+        throw std::logic_error("std::execution::par not available");
+#endif
+    } else {
+        ours(exec);
+    }
+}
+
+struct Scratch {
+    std::vector<uint64_t> u64;
+    std::vector<uint32_t> u32;
+    std::vector<float>    f32;
+    std::vector<double>   f64;
+    uint64_t              scalar = 0;
+};
+
+// 计时之外的准备工作：把输入拷到工作区（排序/划分是原地算法）
+void prepare(const std::string & algo, const Inputs & in, Scratch & s) {
+    if (algo == "inclusive_scan" || algo == "exclusive_scan") {
+        s.u64.assign(in.small_u64.size(), 0);
+    } else if (algo == "radix_sort_u32" || algo == "stable_partition") {
+        s.u32 = in.u32;
+    } else if (algo == "radix_sort_f32") {
+        s.f32 = in.f32;
+    } else if (algo == "sample_sort_f64") {
+        s.f64 = in.f64;
+    }
+}
+
+template <typename Exec>
+void run_algorithm(const std::string & algo, Exec & exec, const Inputs & in, Scratch & s) {
+    if (algo == "inclusive_scan") {
+        dispatch(
+            exec,
+            [&](auto & b) {
+                parallel::inclusive_scan(b, in.small_u64.begin(), in.small_u64.end(),
+                                         s.u64.begin());
+            },
+            [&](auto &&... policy) {
+                std::inclusive_scan(policy..., in.small_u64.begin(), in.small_u64.end(),
+                                    s.u64.begin());
+            });
+    } else if (algo == "exclusive_scan") {
+        dispatch(
+            exec,
+            [&](auto & b) {
+                parallel::exclusive_scan(b, in.small_u64.begin(), in.small_u64.end(), s.u64.begin(),
+                                         uint64_t{ 0 });
+            },
+            [&](auto &&... policy) {
+                std::exclusive_scan(policy..., in.small_u64.begin(), in.small_u64.end(),
+                                    s.u64.begin(), uint64_t{ 0 });
+            });
+    } else if (algo == "radix_sort_u32") {
+        dispatch(
+            exec, [&](auto & b) { parallel::radix_sort(b, s.u32); },
+            [&](auto &&... policy) { std::sort(policy..., s.u32.begin(), s.u32.end()); });
+    } else if (algo == "radix_sort_f32") {
+        // std::sort 用 < 比较，-0.0 与 +0.0 相等、相对顺序不定；radix 把 -0.0 排在前面。
+        // 为了摘要可比，基准侧用按位全序比较
+        auto total_order = [](float a, float b) {
+            return parallel::detail::RadixKey<float>::bits(a) <
+                   parallel::detail::RadixKey<float>::bits(b);
+        };
+        dispatch(
+            exec, [&](auto & b) { parallel::radix_sort(b, s.f32); },
+            [&](auto &&... policy) {
+                std::sort(policy..., s.f32.begin(), s.f32.end(), total_order);
+            });
+    } else if (algo == "sample_sort_f64") {
+        dispatch(
+            exec, [&](auto & b) { parallel::sample_sort(b, s.f64.begin(), s.f64.end()); },
+            [&](auto &&... policy) { std::sort(policy..., s.f64.begin(), s.f64.end()); });
+    } else if (algo == "stable_partition") {
+        auto is_odd = [](uint32_t x) { return (x & 1u) != 0; };
+        dispatch(
+            exec,
+            [&](auto & b) { parallel::stable_partition(b, s.u32.begin(), s.u32.end(), is_odd); },
+            [&](auto &&... policy) {
+                std::stable_partition(policy..., s.u32.begin(), s.u32.end(), is_odd);
+            });
+    } else if (algo == "transform_reduce") {
+        // 整数回绕加法满足结合律，任何合并顺序结果都相同
+        auto square = [](uint32_t x) { return static_cast<uint64_t>(x) * x; };
+        dispatch(
+            exec,
+            [&](auto & b) {
+                s.scalar = parallel::transform_reduce(b, in.u32.begin(), in.u32.end(),
+                                                      uint64_t{ 0 }, std::plus<>(), square);
+            },
+            [&](auto &&... policy) {
+                s.scalar = std::transform_reduce(policy..., in.u32.begin(), in.u32.end(),
+                                                 uint64_t{ 0 }, std::plus<>(), square);
+            });
+    } else {
+        throw std::invalid_argument("unknown algorithm " + algo);
+    }
+}
+
+uint64_t result_digest(const std::string & algo, const Scratch & s) {
+    if (algo == "inclusive_scan" || algo == "exclusive_scan") {
+        return digest(s.u64);
+    }
+    if (algo == "radix_sort_u32" || algo == "stable_partition") {
+        return digest(s.u32);
+    }
+    if (algo == "radix_sort_f32") {
+        return digest(s.f32);
+    }
+    if (algo == "sample_sort_f64") {
+        return digest(s.f64);
+    }
+    return s.scalar;
+}
+
+template <typename Exec>
+BenchResult measure(const BenchConfig & cfg, const std::string & algo, const char * backend,
+                    size_t threads, Exec & exec, const Inputs & in, uint64_t expected) {
+    BenchResult r;
+    r.algo    = algo;
+    r.backend = backend;
+    r.threads = threads;
+    Scratch s;
+    prepare(algo, in, s);
+    run_algorithm(algo, exec, in, s); // 预热
+    for (int rep = 0; rep < cfg.reps; ++rep) {
+        prepare(algo, in, s);
+        r.samples_seconds.push_back(
+            microbench::Seconds([&] { run_algorithm(algo, exec, in, s); }));
+        r.correct = r.correct && result_digest(algo, s) == expected;
+    }
+    return r;
+}
+
+bool wants(const std::vector<std::string> & list, const std::string & name) {
+    return std::find(list.begin(), list.end(), name) != list.end();
+}
+
+// ==================== 输出 ====================
+
+void print_algorithm(const BenchConfig & cfg, const std::vector<BenchResult> & results,
+                     const std::string & algo) {
+    double baseline = 0.0;
+    for (const BenchResult & r : results) {
+        if (r.algo == algo && r.backend == "std_seq") {
+            baseline = r.median();
+        }
+    }
+    fmt::print("\n[{}] n = {}，单位 ns/元素，括号内为相对 std 串行的加速比\n", algo, cfg.n);
+    fmt::print("  {:<16}", "后端");
+    for (size_t t : cfg.threads) {
+        fmt::print(" {:>18}", fmt::format("{} 线程", t));
+    }
+    fmt::print("\n");
+    for (const std::string & backend : cfg.backends) {
+        bool any = false;
+        for (const BenchResult & r : results) {
+            any = any || (r.algo == algo && r.backend == backend);
+        }
+        if (!any) {
+            continue;
+        }
+        fmt::print("  {:<16}", backend);
+        for (size_t t : cfg.threads) {
+            std::string cell = "-";
+            for (const BenchResult & r : results) {
+                if (r.algo == algo && r.backend == backend && r.threads == t) {
+                    double per = r.median() / static_cast<double>(cfg.n) * 1e9;
+                    cell       = baseline > 0 ? fmt::format("{:.2f} ({:.2f}x){}", per,
+                                                            baseline / r.median(),
+                                                            r.correct ? "" : " 错误")
+                                              : fmt::format("{:.2f}", per);
+                }
+            }
+            fmt::print(" {:>18}", cell);
+        }
+        fmt::print("\n");
+    }
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    BenchConfig                       cfg;
+    std::optional<microbench::Report> report;
+    try {
+        report.emplace(argc, argv);
+        cfg.reps = report->repetitions();
+        if (!parse_args(argc, argv, cfg)) {
+            return 0;
+        }
+    } catch (const std::exception & e) {
+        fmt::print(stderr, "参数错误: {}\n", e.what());
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (!PARALLEL_HAVE_STD_EXECUTION && wants(cfg.backends, "std_par")) {
+        cfg.backends.erase(std::find(cfg.backends.begin(), cfg.backends.end(), "std_par"));
+        fmt::print("std::execution::par 不可用（未找到 TBB），跳过 std_par\n");
+    }
+
+    fmt::print("并行算法扩展性基准（scan / radix sort / sample sort / stable partition / "
+               "transform_reduce）\n");
+    fmt::print("=====================================\n");
+    fmt::print("n = {}，硬件线程 {}，每项重复 {} 次取中位数\n", cfg.n,
+               std::thread::hardware_concurrency(), cfg.reps);
+
+    Inputs                   in = make_inputs(cfg.n);
+    std::vector<BenchResult> results;
+    bool                     all_correct = true;
+
+    for (const std::string & algo : cfg.algos) {
+        // 参考结果：标准库串行版本
+        StdSeq  seq;
+        Scratch ref;
+        prepare(algo, in, ref);
+        run_algorithm(algo, seq, in, ref);
+        const uint64_t expected = result_digest(algo, ref);
+
+        // 串行后端与线程数无关，只跑一次，记在第一个线程数下
+        const size_t first_t = cfg.threads.front();
+        if (wants(cfg.backends, "std_seq")) {
+            results.push_back(measure(cfg, algo, "std_seq", first_t, seq, in, expected));
+        }
+        if (wants(cfg.backends, "serial")) {
+            parallel::SerialBackend serial;
+            results.push_back(measure(cfg, algo, "serial", first_t, serial, in, expected));
+        }
+        for (size_t t : cfg.threads) {
+            if (wants(cfg.backends, "openmp")) {
+                parallel::OpenMPBackend omp(t);
+                results.push_back(measure(cfg, algo, "openmp", t, omp, in, expected));
+            }
+            if (wants(cfg.backends, "pthread_pool")) {
+                ThreadPool                                pool(t);
+                parallel::FuturePoolBackend<ThreadPool> backend(pool, t);
+                results.push_back(measure(cfg, algo, "pthread_pool", t, backend, in, expected));
+            }
+            if (wants(cfg.backends, "concurrent_pool")) {
+                concurrent::ThreadPool                                     pool(t);
+                parallel::EnqueueWaitPoolBackend<concurrent::ThreadPool> backend(pool);
+                results.push_back(measure(cfg, algo, "concurrent_pool", t, backend, in, expected));
+            }
+#if PARALLEL_HAVE_STD_EXECUTION
+            if (wants(cfg.backends, "std_par")) {
+                tbb::global_control limit(tbb::global_control::max_allowed_parallelism, t);
+                StdPar              par;
+                results.push_back(measure(cfg, algo, "std_par", t, par, in, expected));
+            }
+#endif
+        }
+        print_algorithm(cfg, results, algo);
+    }
+
+    for (const BenchResult & r : results) {
+        all_correct = all_correct && r.correct;
+    }
+    fmt::print("\n结果一致: {}\n", all_correct ? "yes" : "NO");
+    // 样本按元素数折算成 ns/元素，与表格的单位一致
+    for (const BenchResult & r : results) {
+        report->Add(r.name(), r.samples_seconds, cfg.n).correct = r.correct;
+    }
+    int status = report->Finish();
+
+    fmt::print("\n关键学习点：\n");
+    fmt::print("1. 每个算法都是 \"块内统计 -> 串行前缀和 -> 块内写出\"，后端只需要一个 run(tasks, f)\n");
+    fmt::print("2. scan 要读两遍输入，单线程比 std 慢；线程数足够多时才能赚回来\n");
+    fmt::print("3. radix sort 是 O(n) 且每趟都能并行，整数/浮点键通常远快于比较排序\n");
+    fmt::print("4. 池后端每个块都要经过一次锁 + 条件变量，块太小时调度开销会吃掉并行收益\n");
+    return status;
+}
@@ -8,6 +8,15 @@
  */
 
 #include "shape.h"
+#include "shape_registry.h"
+
+/* 注册表批量遍历的回调：统计一批对象的面积 */
+static void sum_areas(Shape* const* shapes, size_t count, void* context) {
+    double* total = (double*)context;
+    for (size_t i = 0; i < count; i++) {
+        *total += Shape_area(shapes[i]);
+    }
+}
 
 /* 多态函数 - 接受任意 Shape 并调用其虚函数 */
 void process_shape(Shape* shape) {
@@ -67,6 +76,31 @@ int main(void) {
         Shape_destroy(shapes[i]);
     }
     
+    /* 注册表：按 ID 查找存活对象、按类型批量遍历（多线程用法见 registry benchmark） */
+    printf("\n=== Shape Registry ===\n");
+    ShapeRegistry* registry = ShapeRegistry_new(16, 1, NULL);
+    ShapeRegistryThread* self = ShapeRegistry_attach(registry);
+    ShapeId big = ShapeRegistry_insert(self, (Shape*)Circle_new(0.0, 0.0, 5.0));
+    ShapeRegistry_insert(self, (Shape*)Circle_new(1.0, 1.0, 1.0));
+    ShapeRegistry_insert(self, (Shape*)Rectangle_new(0.0, 0.0, 2.0, 3.0));
+    printf("Registered %zu shapes\n", ShapeRegistry_size(registry));
+
+    Shape* found = ShapeRegistry_acquire(self, big);
+    if (found) {
+        printf("Lookup id %llu -> %s, area %.2f\n", (unsigned long long)big,
+               Shape_get_type(found), Shape_area(found));
+        ShapeRegistry_release(self);
+    }
+
+    double circle_area = 0.0;
+    size_t circles = ShapeRegistry_for_each_of_type(self, Circle_type(), sum_areas, &circle_area);
+    printf("Circles: %zu, total area %.2f\n", circles, circle_area);
+
+    ShapeRegistry_remove(self, big); /* 延迟销毁：这里还不会打印 Destroying */
+    printf("After remove: %zu shapes\n", ShapeRegistry_size(registry));
+    ShapeRegistry_detach(self);
+    ShapeRegistry_delete(registry); /* 剩余对象通过 Shape_destroy 销毁 */
+
     printf("\n╔══════════════════════════════════════════════════╗\n");
     printf("║              Key Concepts Demonstrated:          ║\n");
     printf("╠══════════════════════════════════════════════════╣\n");
@@ -57,6 +57,10 @@ void Circle_delete(Circle* circle) {
     }
 }
 
+const ShapeVTable* Circle_type(void) {
+    return &Circle_vtable;
+}
+
 /* ========== Rectangle 实现 ========== */
 
 static void Rectangle_draw_impl(const Shape* self) {
@@ -108,6 +112,10 @@ void Rectangle_delete(Rectangle* rect) {
     }
 }
 
+const ShapeVTable* Rectangle_type(void) {
+    return &Rectangle_vtable;
+}
+
 /* ========== Triangle 实现 ========== */
 
 static void Triangle_draw_impl(const Shape* self) {
@@ -166,3 +174,7 @@ void Triangle_delete(Triangle* triangle) {
         free(triangle);
     }
 }
+
+const ShapeVTable* Triangle_type(void) {
+    return &Triangle_vtable;
+}
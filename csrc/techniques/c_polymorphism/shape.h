@@ -91,4 +91,10 @@ typedef struct Triangle {
 Triangle * Triangle_new(double x1, double y1, double x2, double y2, double x3, double y3);
 void       Triangle_delete(Triangle * triangle);
 
+/* 各类型的虚函数表地址：同一类型的对象共享一张表，因此可以当作运行时类型标识
+ * （例如 shape->vtable == Circle_type()，或按类型批量遍历注册表） */
+const ShapeVTable * Circle_type(void);
+const ShapeVTable * Rectangle_type(void);
+const ShapeVTable * Triangle_type(void);
+
 #endif /* C_POLYMORPHISM_SHAPE_H */
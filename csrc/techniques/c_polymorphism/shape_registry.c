@@ -0,0 +1,381 @@
+/* shape_registry.c - 无锁 Shape 注册表的实现
+ *
+ * 数据结构：
+ *   slots[i].key    64 位 ID；EMPTY（从未使用）/ TOMBSTONE（已删除，可复用）
+ *   slots[i].entry  指向 Entry{id, shape}；删除时先把它 CAS 成 NULL
+ *
+ * 为什么 entry 要单独分配、而不是直接存 Shape*：槽位会被复用，
+ * "读到 key == X 之后再去 CAS value"之间槽位可能已经换成了别的 ID。
+ * Entry 里带着 ID，并且受 hazard pointer 保护，验证 entry->id 之后再 CAS，
+ * 就不会误删别人。
+ *
+ * 回收：被摘除的 Entry 先放进本线程的 retired 列表，积累到阈值后扫描
+ * 所有线程的 hazard pointer，没有被引用的才真正销毁（Michael 2004）。
+ */
+
+#include "shape_registry.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define KEY_EMPTY          ((uint64_t)0)
+#define KEY_TOMBSTONE      UINT64_MAX
+#define HAZARDS_PER_THREAD (SHAPE_REGISTRY_BATCH + 2)
+#define ACQUIRE_HAZARD     SHAPE_REGISTRY_BATCH       /* 前 BATCH 个留给 for_each */
+#define REMOVE_HAZARD      (SHAPE_REGISTRY_BATCH + 1) /* 回调里也能 acquire / remove */
+#define CACHE_LINE         64
+
+typedef struct Entry {
+    ShapeId id;
+    Shape * shape;
+} Entry;
+
+typedef struct Slot {
+    _Atomic uint64_t key;
+    _Atomic(Entry *) entry;
+} Slot;
+
+struct ShapeRegistryThread {
+    /* 其他线程扫描时只读 hazards，单独占缓存行，避免和 retired 的写互相干扰 */
+    _Alignas(CACHE_LINE) _Atomic(Entry *) hazards[HAZARDS_PER_THREAD];
+    _Alignas(CACHE_LINE) atomic_int active;
+    ShapeRegistry * registry;
+    Entry **        retired;
+    size_t          retired_count;
+    size_t          retired_capacity;
+};
+
+struct ShapeRegistry {
+    Slot *                slots;
+    size_t                mask;
+    _Atomic size_t        max_probe; /* 任何一次插入用过的最大探测距离，查找只需探测这么远 */
+    _Atomic uint64_t      next_id;
+    _Atomic size_t        live;
+    int                   max_threads;
+    ShapeRegistryThread * threads;
+    ShapeDestroyFn        destroy;
+    size_t                retire_threshold;
+};
+
+/* splitmix64 的终结步骤：连续的 ID 也能均匀散开 */
+static size_t HashId(uint64_t id) {
+    id ^= id >> 30;
+    id *= 0xbf58476d1ce4e5b9ULL;
+    id ^= id >> 27;
+    id *= 0x94d049bb133111ebULL;
+    id ^= id >> 31;
+    return (size_t)id;
+}
+
+static void DestroyEntry(ShapeRegistry * registry, Entry * entry) {
+    if (registry->destroy) {
+        registry->destroy(entry->shape);
+    } else {
+        Shape_destroy(entry->shape);
+    }
+    free(entry);
+}
+
+/* ========== 构造 / 析构 ========== */
+
+ShapeRegistry * ShapeRegistry_new(size_t capacity, int max_threads, ShapeDestroyFn destroy) {
+    if (max_threads <= 0) {
+        return NULL;
+    }
+    ShapeRegistry * registry = (ShapeRegistry *)calloc(1, sizeof(ShapeRegistry));
+    if (!registry) {
+        return NULL;
+    }
+    size_t slot_count = 16;
+    while (slot_count < 2 * capacity) {
+        slot_count <<= 1;
+    }
+    registry->slots   = (Slot *)calloc(slot_count, sizeof(Slot)); /* 全 0 即 KEY_EMPTY / NULL */
+    registry->threads = (ShapeRegistryThread *)aligned_alloc(
+        CACHE_LINE, sizeof(ShapeRegistryThread) * (size_t)max_threads);
+    if (!registry->slots || !registry->threads) {
+        free(registry->slots);
+        free(registry->threads);
+        free(registry);
+        return NULL;
+    }
+    memset(registry->threads, 0, sizeof(ShapeRegistryThread) * (size_t)max_threads);
+    for (int i = 0; i < max_threads; ++i) {
+        registry->threads[i].registry = registry;
+    }
+    registry->mask             = slot_count - 1;
+    registry->max_threads      = max_threads;
+    registry->destroy          = destroy;
+    registry->retire_threshold = 2 * (size_t)max_threads * HAZARDS_PER_THREAD;
+    atomic_init(&registry->max_probe, 0);
+    atomic_init(&registry->next_id, 1);
+    atomic_init(&registry->live, 0);
+    return registry;
+}
+
+void ShapeRegistry_delete(ShapeRegistry * registry) {
+    if (!registry) {
+        return;
+    }
+    for (size_t i = 0; i <= registry->mask; ++i) {
+        Entry * entry = atomic_load(&registry->slots[i].entry);
+        if (entry) {
+            DestroyEntry(registry, entry);
+        }
+    }
+    for (int t = 0; t < registry->max_threads; ++t) {
+        ShapeRegistryThread * thread = &registry->threads[t];
+        for (size_t i = 0; i < thread->retired_count; ++i) {
+            DestroyEntry(registry, thread->retired[i]);
+        }
+        free(thread->retired);
+    }
+    free(registry->threads);
+    free(registry->slots);
+    free(registry);
+}
+
+/* ========== 线程登记 ========== */
+
+ShapeRegistryThread * ShapeRegistry_attach(ShapeRegistry * registry) {
+    for (int i = 0; i < registry->max_threads; ++i) {
+        ShapeRegistryThread * thread   = &registry->threads[i];
+        int                   inactive = 0;
+        if (atomic_compare_exchange_strong(&thread->active, &inactive, 1)) {
+            return thread;
+        }
+    }
+    return NULL;
+}
+
+void ShapeRegistry_detach(ShapeRegistryThread * thread) {
+    for (int i = 0; i < HAZARDS_PER_THREAD; ++i) {
+        atomic_store(&thread->hazards[i], NULL);
+    }
+    /* 未回收的 retired 留在记录里，由下一个 attach 到这条记录的线程或 delete 处理 */
+    atomic_store(&thread->active, 0);
+}
+
+/* ========== hazard pointer 回收 ========== */
+
+static int ComparePointers(const void * a, const void * b) {
+    uintptr_t x = (uintptr_t)(*(Entry * const *)a);
+    uintptr_t y = (uintptr_t)(*(Entry * const *)b);
+    return (x > y) - (x < y);
+}
+
+static void Scan(ShapeRegistryThread * self) {
+    ShapeRegistry * registry = self->registry;
+    size_t          total    = (size_t)registry->max_threads * HAZARDS_PER_THREAD;
+    Entry **        hazards  = (Entry **)malloc(total * sizeof(Entry *));
+    if (!hazards) {
+        return; /* 下次再试；retired 只会多留一会儿 */
+    }
+    size_t count = 0;
+    for (int t = 0; t < registry->max_threads; ++t) {
+        for (int i = 0; i < HAZARDS_PER_THREAD; ++i) {
+            Entry * p = atomic_load(&registry->threads[t].hazards[i]);
+            if (p) {
+                hazards[count++] = p;
+            }
+        }
+    }
+    qsort(hazards, count, sizeof(Entry *), ComparePointers);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < self->retired_count; ++i) {
+        Entry * entry = self->retired[i];
+        if (count > 0 && bsearch(&entry, hazards, count, sizeof(Entry *), ComparePointers)) {
+            self->retired[kept++] = entry;
+        } else {
+            DestroyEntry(registry, entry);
+        }
+    }
+    self->retired_count = kept;
+    free(hazards);
+}
+
+static void Retire(ShapeRegistryThread * self, Entry * entry) {
+    if (self->retired_count == self->retired_capacity) {
+        size_t   capacity = self->retired_capacity ? self->retired_capacity * 2 : 64;
+        Entry ** grown    = (Entry **)realloc(self->retired, capacity * sizeof(Entry *));
+        if (!grown) {
+            Scan(self);
+            if (self->retired_count == self->retired_capacity) {
+                abort(); /* 既扩不了容又回收不掉：无法安全继续 */
+            }
+        } else {
+            self->retired          = grown;
+            self->retired_capacity = capacity;
+        }
+    }
+    self->retired[self->retired_count++] = entry;
+    if (self->retired_count >= self->registry->retire_threshold) {
+        Scan(self);
+    }
+}
+
+/* 发布 hazard 并确认槽位仍指向同一个 entry；失败返回 NULL（槽位已清空）。
+ * 发布必须是 seq_cst：它和随后的重读之间需要 store-load 屏障，否则 Scan 可能
+ * 看不到这个 hazard；清除 hazard 只需要 release */
+static Entry * Protect(_Atomic(Entry *) * hazard, Slot * slot) {
+    Entry * entry = atomic_load(&slot->entry);
+    while (entry) {
+        atomic_store(hazard, entry);
+        Entry * again = atomic_load(&slot->entry);
+        if (again == entry) {
+            return entry;
+        }
+        entry = again;
+    }
+    atomic_store_explicit(hazard, NULL, memory_order_release);
+    return NULL;
+}
+
+/* ========== 插入 / 查找 / 删除 ========== */
+
+static void UpdateMaxProbe(ShapeRegistry * registry, size_t distance) {
+    size_t current = atomic_load(&registry->max_probe);
+    while (current < distance &&
+           !atomic_compare_exchange_weak(&registry->max_probe, &current, distance)) {
+    }
+}
+
+ShapeId ShapeRegistry_insert(ShapeRegistryThread * thread, Shape * shape) {
+    ShapeRegistry * registry = thread->registry;
+    Entry *         entry    = (Entry *)malloc(sizeof(Entry));
+    if (!entry || !shape) {
+        free(entry);
+        return 0;
+    }
+    entry->id    = atomic_fetch_add(&registry->next_id, 1);
+    entry->shape = shape;
+
+    size_t home = HashId(entry->id);
+    for (size_t distance = 0; distance <= registry->mask; ++distance) {
+        Slot *   slot = &registry->slots[(home + distance) & registry->mask];
+        uint64_t key  = atomic_load(&slot->key);
+        if ((key == KEY_EMPTY || key == KEY_TOMBSTONE) &&
+            atomic_compare_exchange_strong(&slot->key, &key, entry->id)) {
+            /* 先扩大查找范围，再发布 entry：拿到 ID 的线程一定能找到它 */
+            UpdateMaxProbe(registry, distance);
+            atomic_store_explicit(&slot->entry, entry, memory_order_release);
+            atomic_fetch_add(&registry->live, 1);
+            return entry->id;
+        }
+    }
+    free(entry);
+    return 0;
+}
+
+static Slot * FindSlot(ShapeRegistry * registry, ShapeId id) {
+    size_t home  = HashId(id);
+    size_t limit = atomic_load(&registry->max_probe);
+    for (size_t distance = 0; distance <= limit; ++distance) {
+        Slot *   slot = &registry->slots[(home + distance) & registry->mask];
+        uint64_t key  = atomic_load(&slot->key);
+        if (key == id) {
+            return slot;
+        }
+        if (key == KEY_EMPTY) {
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+Shape * ShapeRegistry_acquire(ShapeRegistryThread * thread, ShapeId id) {
+    if (id == KEY_EMPTY || id == KEY_TOMBSTONE) {
+        return NULL;
+    }
+    Slot * slot = FindSlot(thread->registry, id);
+    if (!slot) {
+        return NULL;
+    }
+    _Atomic(Entry *) * hazard = &thread->hazards[ACQUIRE_HAZARD];
+    Entry *            entry  = Protect(hazard, slot);
+    /* 槽位可能已被别的 ID 复用：entry 受保护，可以安全地检查它的 ID */
+    if (!entry || entry->id != id) {
+        atomic_store_explicit(hazard, NULL, memory_order_release);
+        return NULL;
+    }
+    return entry->shape;
+}
+
+void ShapeRegistry_release(ShapeRegistryThread * thread) {
+    atomic_store_explicit(&thread->hazards[ACQUIRE_HAZARD], NULL, memory_order_release);
+}
+
+int ShapeRegistry_remove(ShapeRegistryThread * thread, ShapeId id) {
+    if (id == KEY_EMPTY || id == KEY_TOMBSTONE) {
+        return 0;
+    }
+    ShapeRegistry * registry = thread->registry;
+    Slot *          slot     = FindSlot(registry, id);
+    if (!slot) {
+        return 0;
+    }
+    _Atomic(Entry *) * hazard  = &thread->hazards[REMOVE_HAZARD];
+    Entry *            entry   = Protect(hazard, slot);
+    int                removed = 0;
+    if (entry && entry->id == id &&
+        atomic_compare_exchange_strong(&slot->entry, &entry, (Entry *)NULL)) {
+        /* 只有赢得 CAS 的线程会走到这里，key 只会被写一次 TOMBSTONE */
+        atomic_store(&slot->key, KEY_TOMBSTONE);
+        atomic_fetch_sub(&registry->live, 1);
+        removed = 1;
+    }
+    atomic_store_explicit(hazard, NULL, memory_order_release);
+    if (removed) {
+        Retire(thread, entry);
+    }
+    return removed;
+}
+
+/* ========== 批量遍历 ========== */
+
+size_t ShapeRegistry_for_each_of_type(ShapeRegistryThread * thread, const ShapeVTable * type,
+                                      ShapeBatchFn fn, void * context) {
+    ShapeRegistry * registry = thread->registry;
+    Shape *         batch[SHAPE_REGISTRY_BATCH];
+    size_t          count = 0;
+    size_t          total = 0;
+
+    for (size_t i = 0; i <= registry->mask; ++i) {
+        Slot * slot = &registry->slots[i];
+        if (atomic_load_explicit(&slot->entry, memory_order_relaxed) == NULL) {
+            continue; /* 快速跳过空槽，不发布 hazard */
+        }
+        Entry * entry = Protect(&thread->hazards[count], slot);
+        if (!entry) {
+            continue;
+        }
+        if (type && entry->shape->vtable != type) {
+            atomic_store_explicit(&thread->hazards[count], NULL, memory_order_release);
+            continue;
+        }
+        batch[count++] = entry->shape;
+        if (count == SHAPE_REGISTRY_BATCH) {
+            fn(batch, count, context);
+            total += count;
+            for (size_t h = 0; h < count; ++h) {
+                atomic_store_explicit(&thread->hazards[h], NULL, memory_order_release);
+            }
+            count = 0;
+        }
+    }
+    if (count > 0) {
+        fn(batch, count, context);
+        total += count;
+        for (size_t h = 0; h < count; ++h) {
+            atomic_store_explicit(&thread->hazards[h], NULL, memory_order_release);
+        }
+    }
+    return total;
+}
+
+size_t ShapeRegistry_size(const ShapeRegistry * registry) {
+    return atomic_load(&((ShapeRegistry *)registry)->live);
+}
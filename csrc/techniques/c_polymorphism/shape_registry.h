@@ -0,0 +1,79 @@
+/* shape_registry.h - 线程安全、无锁的 Shape 对象注册表
+ *
+ * Circle_new() / Shape_destroy() 只负责单个对象的生命周期，程序里有哪些活着的
+ * Shape、别的线程能不能安全地拿来用，都没有答案。注册表补上这一块：
+ *
+ *   - 开放寻址哈希表（线性探测），键是注册时分配的 64 位 ID，插入/删除都只用 CAS
+ *   - 查找返回的指针由 hazard pointer 保护：别的线程同时删除它，也要等所有持有者
+ *     释放之后才真正调用析构函数
+ *   - 按类型（虚函数表地址）批量遍历，一次回调交出一批对象，适合渲染 pass
+ *
+ * 使用方式：每个线程先 ShapeRegistry_attach() 得到自己的 ShapeRegistryThread，
+ * 之后所有读写操作都带上它；线程退出前 ShapeRegistry_detach()。
+ *
+ * 纯 C11（<stdatomic.h>），可以直接从 C++ 包含。
+ */
+
+#ifndef C_POLYMORPHISM_SHAPE_REGISTRY_H
+#define C_POLYMORPHISM_SHAPE_REGISTRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "shape.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ShapeRegistry       ShapeRegistry;
+typedef struct ShapeRegistryThread ShapeRegistryThread;
+
+/* 0 不是合法 ID：插入失败（表满）时返回 0 */
+typedef uint64_t ShapeId;
+
+/* for_each 每批最多交出的对象数，也是每个线程为遍历预留的 hazard pointer 数 */
+#define SHAPE_REGISTRY_BATCH 64
+
+/* 对象被删除且不再被任何线程引用时调用；NULL 表示使用 Shape_destroy */
+typedef void (*ShapeDestroyFn)(Shape * shape);
+
+/* 批量遍历回调：shapes[0..count) 在回调返回前都不会被释放 */
+typedef void (*ShapeBatchFn)(Shape * const * shapes, size_t count, void * context);
+
+/* capacity：预计同时存活的对象数（表大小取 >= 2 * capacity 的 2 的幂）
+ * max_threads：最多同时 attach 的线程数 */
+ShapeRegistry * ShapeRegistry_new(size_t capacity, int max_threads, ShapeDestroyFn destroy);
+
+/* 调用时不能再有其他线程在使用注册表；仍然存活和待回收的对象都会被销毁 */
+void ShapeRegistry_delete(ShapeRegistry * registry);
+
+/* 线程登记；超过 max_threads 时返回 NULL */
+ShapeRegistryThread * ShapeRegistry_attach(ShapeRegistry * registry);
+void                  ShapeRegistry_detach(ShapeRegistryThread * thread);
+
+/* 登记一个对象，所有权转移给注册表；表满时返回 0，对象仍归调用者 */
+ShapeId ShapeRegistry_insert(ShapeRegistryThread * thread, Shape * shape);
+
+/* 查找并保护对象；返回非 NULL 时必须配对调用 ShapeRegistry_release()。
+ * 每个线程同一时刻只能持有一个 acquire 得到的对象 */
+Shape * ShapeRegistry_acquire(ShapeRegistryThread * thread, ShapeId id);
+void    ShapeRegistry_release(ShapeRegistryThread * thread);
+
+/* 从表中摘除并延迟销毁；返回 1 表示确实由本次调用删除 */
+int ShapeRegistry_remove(ShapeRegistryThread * thread, ShapeId id);
+
+/* 按类型批量遍历：type 为 NULL 表示所有类型（见 Circle_type() 等）。
+ * 遍历期间的插入/删除可能看得到也可能看不到，但交给回调的对象一定是活的。
+ * 返回交给回调的对象总数 */
+size_t ShapeRegistry_for_each_of_type(ShapeRegistryThread * thread, const ShapeVTable * type,
+                                      ShapeBatchFn fn, void * context);
+
+/* 近似的存活对象数（并发修改时只是一个快照） */
+size_t ShapeRegistry_size(const ShapeRegistry * registry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* C_POLYMORPHISM_SHAPE_REGISTRY_H */
@@ -0,0 +1,448 @@
+/* shape_registry_benchmark.c - 多线程 创建 / 查找 / 销毁 基准测试
+ *
+ * 用法: techniques_c_polymorphism_registry_benchmark [每线程迭代数] [--repetitions=N] [--json=FILE]
+ *
+ * 1. 混合负载：每次迭代 插入 1 个对象 + 查找 8 个（多为其他线程创建的）+ 删除 1 个旧对象，
+ *    分别用无锁注册表和"一把互斥锁 + 同样的开放寻址表"实现，线程数 1 / 2 / 4
+ * 2. 渲染 pass：对 Circle 做 for_each_of_type，单独运行 vs 同时有 3 个线程在增删
+ *
+ * 销毁函数只 free 不打印（Shape_destroy 会输出一行日志），并统计调用次数，
+ * 用来确认每个对象恰好被销毁一次。
+ *
+ * 计时和结果记录走 csrc::microbench 的 C 接口，每项重复 N 次（默认 3），表格取最快的一次，
+ * 全部样本写入 JSON。
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "microbench_c.h"
+#include "shape.h"
+#include "shape_registry.h"
+
+#define LOOKUPS_PER_ITER 8
+#define WINDOW           256  /* 每个线程同时持有的对象数 */
+#define RECENT_SLOTS     4096 /* 线程间共享的"最近创建的 ID"，查找从这里取 */
+#define MAX_THREADS      4
+
+static atomic_size_t g_destroyed;
+
+static void QuietDestroy(Shape * shape) {
+    free(shape); /* Circle / Rectangle / Triangle 都是 malloc 出来的，Shape 是第一个成员 */
+    atomic_fetch_add_explicit(&g_destroyed, 1, memory_order_relaxed);
+}
+
+static uint64_t NextRandom(uint64_t * state) {
+    /* xorshift64 */
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static Shape * MakeShape(uint64_t n) {
+    double v = (double)(n % 100) + 1.0;
+    switch (n % 3) {
+    case 0:
+        return (Shape *)Circle_new(v, v, v);
+    case 1:
+        return (Shape *)Rectangle_new(v, v, v, v + 1.0);
+    default:
+        return (Shape *)Triangle_new(0.0, 0.0, v, 0.0, 0.0, v);
+    }
+}
+
+/* ========== 基线：一把互斥锁保护的开放寻址表 ========== */
+
+#define LOCKED_TOMBSTONE UINT64_MAX
+
+typedef struct LockedTable {
+    pthread_mutex_t mutex;
+    uint64_t *      keys;
+    Shape **        values;
+    size_t          mask;
+    uint64_t        next_id;
+    size_t          live;
+    size_t          max_probe; /* 与无锁版相同：墓碑多了以后查找不能只靠遇到空槽停下 */
+} LockedTable;
+
+static size_t LockedHash(uint64_t id) {
+    return (size_t)(id * 0x9e3779b97f4a7c15ULL >> 20);
+}
+
+static void LockedTable_init(LockedTable * table, size_t capacity) {
+    size_t slots = 16;
+    while (slots < 2 * capacity) {
+        slots <<= 1;
+    }
+    pthread_mutex_init(&table->mutex, NULL);
+    table->keys      = (uint64_t *)calloc(slots, sizeof(uint64_t));
+    table->values    = (Shape **)calloc(slots, sizeof(Shape *));
+    table->mask      = slots - 1;
+    table->next_id   = 1;
+    table->live      = 0;
+    table->max_probe = 0;
+}
+
+static void LockedTable_destroy(LockedTable * table) {
+    for (size_t i = 0; i <= table->mask; ++i) {
+        if (table->values[i]) {
+            QuietDestroy(table->values[i]);
+        }
+    }
+    free(table->keys);
+    free(table->values);
+    pthread_mutex_destroy(&table->mutex);
+}
+
+static uint64_t LockedTable_insert(LockedTable * table, Shape * shape) {
+    pthread_mutex_lock(&table->mutex);
+    uint64_t id   = table->next_id++;
+    size_t   home = LockedHash(id);
+    for (size_t d = 0; d <= table->mask; ++d) {
+        size_t i = (home + d) & table->mask;
+        if (table->keys[i] == 0 || table->keys[i] == LOCKED_TOMBSTONE) {
+            table->keys[i]   = id;
+            table->values[i] = shape;
+            table->max_probe = d > table->max_probe ? d : table->max_probe;
+            ++table->live;
+            pthread_mutex_unlock(&table->mutex);
+            return id;
+        }
+    }
+    pthread_mutex_unlock(&table->mutex);
+    return 0;
+}
+
+/* 调用者需持有锁 */
+static size_t LockedTable_find(LockedTable * table, uint64_t id) {
+    size_t home = LockedHash(id);
+    for (size_t d = 0; d <= table->max_probe; ++d) {
+        size_t i = (home + d) & table->mask;
+        if (table->keys[i] == id) {
+            return i;
+        }
+        if (table->keys[i] == 0) {
+            break;
+        }
+    }
+    return SIZE_MAX;
+}
+
+/* 查找并在锁内使用对象（锁就是它的"保护"） */
+static double LockedTable_area(LockedTable * table, uint64_t id) {
+    double area = 0.0;
+    pthread_mutex_lock(&table->mutex);
+    size_t i = LockedTable_find(table, id);
+    if (i != SIZE_MAX) {
+        area = Shape_area(table->values[i]);
+    }
+    pthread_mutex_unlock(&table->mutex);
+    return area;
+}
+
+static void LockedTable_remove(LockedTable * table, uint64_t id) {
+    Shape * shape = NULL;
+    pthread_mutex_lock(&table->mutex);
+    size_t i = LockedTable_find(table, id);
+    if (i != SIZE_MAX) {
+        shape            = table->values[i];
+        table->keys[i]   = LOCKED_TOMBSTONE;
+        table->values[i] = NULL;
+        --table->live;
+    }
+    pthread_mutex_unlock(&table->mutex);
+    if (shape) {
+        QuietDestroy(shape); /* 在锁外释放 */
+    }
+}
+
+/* ========== 混合负载 ========== */
+
+typedef struct Workload {
+    ShapeRegistry *  registry; /* 二选一 */
+    LockedTable *    locked;
+    size_t           iterations;
+    _Atomic uint64_t recent[RECENT_SLOTS];
+    atomic_int       start;
+} Workload;
+
+typedef struct Worker {
+    pthread_t  thread;
+    Workload * workload;
+    int        index;
+    size_t     inserted;
+    size_t     removed;
+    double     area_sum;
+} Worker;
+
+static void * RunMixed(void * arg) {
+    Worker *   worker   = (Worker *)arg;
+    Workload * workload = worker->workload;
+    uint64_t   rng      = 0x9e3779b97f4a7c15ULL * (uint64_t)(worker->index + 1);
+    uint64_t   window[WINDOW];
+    size_t     head  = 0;
+    size_t     count = 0;
+
+    ShapeRegistryThread * self = NULL;
+    if (workload->registry) {
+        self = ShapeRegistry_attach(workload->registry);
+    }
+    while (!atomic_load(&workload->start)) {
+    }
+
+    for (size_t it = 0; it < workload->iterations; ++it) {
+        Shape *  shape = MakeShape(it + (size_t)worker->index);
+        uint64_t id    = self ? ShapeRegistry_insert(self, shape)
+                              : LockedTable_insert(workload->locked, shape);
+        if (id == 0) {
+            QuietDestroy(shape);
+            continue;
+        }
+        ++worker->inserted;
+        atomic_store_explicit(&workload->recent[NextRandom(&rng) % RECENT_SLOTS], id,
+                              memory_order_relaxed);
+
+        for (int k = 0; k < LOOKUPS_PER_ITER; ++k) {
+            uint64_t target = atomic_load_explicit(
+                &workload->recent[NextRandom(&rng) % RECENT_SLOTS], memory_order_relaxed);
+            if (self) {
+                Shape * found = ShapeRegistry_acquire(self, target);
+                if (found) {
+                    worker->area_sum += Shape_area(found);
+                    ShapeRegistry_release(self);
+                }
+            } else {
+                worker->area_sum += LockedTable_area(workload->locked, target);
+            }
+        }
+
+        window[(head + count) % WINDOW] = id;
+        if (++count == WINDOW) {
+            uint64_t oldest = window[head];
+            head            = (head + 1) % WINDOW;
+            --count;
+            if (self) {
+                worker->removed += (size_t)ShapeRegistry_remove(self, oldest);
+            } else {
+                LockedTable_remove(workload->locked, oldest);
+                ++worker->removed;
+            }
+        }
+    }
+
+    if (self) {
+        ShapeRegistry_detach(self);
+    }
+    return NULL;
+}
+
+/* 返回耗时（秒），并检查存活数和销毁次数 */
+static double RunOnce(int threads, size_t iterations, int lock_free, int * consistent) {
+    size_t      capacity             = (size_t)threads * WINDOW * 2;
+    Workload *  workload             = (Workload *)calloc(1, sizeof(Workload));
+    Worker      workers[MAX_THREADS] = {0};
+    LockedTable locked;
+
+    if (lock_free) {
+        workload->registry = ShapeRegistry_new(capacity, threads, QuietDestroy);
+    } else {
+        LockedTable_init(&locked, capacity);
+        workload->locked = &locked;
+    }
+    workload->iterations = iterations;
+    atomic_store(&g_destroyed, 0);
+
+    for (int t = 0; t < threads; ++t) {
+        workers[t].workload = workload;
+        workers[t].index    = t;
+        pthread_create(&workers[t].thread, NULL, RunMixed, &workers[t]);
+    }
+    double start = microbench_now();
+    atomic_store(&workload->start, 1);
+    for (int t = 0; t < threads; ++t) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    double elapsed = microbench_now() - start;
+
+    size_t inserted = 0;
+    size_t removed  = 0;
+    for (int t = 0; t < threads; ++t) {
+        inserted += workers[t].inserted;
+        removed += workers[t].removed;
+    }
+    size_t live = lock_free ? ShapeRegistry_size(workload->registry) : locked.live;
+    if (lock_free) {
+        ShapeRegistry_delete(workload->registry);
+    } else {
+        LockedTable_destroy(&locked);
+    }
+    *consistent = *consistent && live == inserted - removed &&
+                  atomic_load(&g_destroyed) == inserted;
+    free(workload);
+    return elapsed;
+}
+
+static void BenchmarkMixed(MicrobenchReport * report, size_t iterations) {
+    static const char * const kVariants[2] = {"mutex", "lock_free"};
+
+    int      reps       = microbench_report_repetitions(report);
+    double * samples    = (double *)malloc(2 * (size_t)reps * sizeof(double));
+    int      consistent = 1;
+    printf("[1] 混合负载（每次迭代：插入 1 + 查找 %d + 删除 1，每线程 %zu 次迭代）\n",
+           LOOKUPS_PER_ITER, iterations);
+    /* printf 按字节计宽度，中文表头直接手工对齐 */
+    printf("  线程     互斥锁 ns/迭代     无锁 ns/迭代    加速比\n");
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        double best[2] = {1e30, 1e30};
+        int    ok[2]   = {1, 1};
+        for (int r = 0; r < reps; ++r) {
+            for (int lock_free = 0; lock_free < 2; ++lock_free) {
+                double t = RunOnce(threads, iterations, lock_free, &ok[lock_free]);
+                samples[lock_free * reps + r] = t;
+                best[lock_free] = t < best[lock_free] ? t : best[lock_free];
+            }
+        }
+        /* 总吞吐：所有线程的迭代数合计 */
+        double total = (double)iterations * threads;
+        printf("  %-4d %18.1f %16.1f %8.2fx\n", threads, best[0] / total * 1e9,
+               best[1] / total * 1e9, best[0] / best[1]);
+        for (int lock_free = 0; lock_free < 2; ++lock_free) {
+            char name[64];
+            snprintf(name, sizeof(name), "mixed/%s/t%d", kVariants[lock_free], threads);
+            microbench_report_add(report, name, &samples[lock_free * reps], (size_t)reps,
+                                  (uint64_t)total, ok[lock_free]);
+            consistent = consistent && ok[lock_free];
+        }
+    }
+    printf("  存活数与销毁次数一致: %s\n\n", consistent ? "yes" : "NO");
+    free(samples);
+}
+
+/* ========== 渲染 pass ========== */
+
+typedef struct RenderContext {
+    double area;
+    size_t batches;
+} RenderContext;
+
+static void SumAreas(Shape * const * shapes, size_t count, void * context) {
+    RenderContext * render = (RenderContext *)context;
+    for (size_t i = 0; i < count; ++i) {
+        render->area += Shape_area(shapes[i]);
+    }
+    ++render->batches;
+}
+
+typedef struct Churn {
+    ShapeRegistry * registry;
+    atomic_int *    stop;
+    uint64_t        seed;
+} Churn;
+
+static void * RunChurn(void * arg) {
+    Churn *               churn = (Churn *)arg;
+    ShapeRegistryThread * self  = ShapeRegistry_attach(churn->registry);
+    uint64_t              n     = churn->seed;
+    while (!atomic_load_explicit(churn->stop, memory_order_relaxed)) {
+        /* 插入再删除一个 Rectangle（3n+1），不改变 Circle 集合，两次渲染结果可比 */
+        ShapeId id = ShapeRegistry_insert(self, MakeShape(3 * n++ + 1));
+        if (id != 0) {
+            ShapeRegistry_remove(self, id);
+        }
+    }
+    ShapeRegistry_detach(self);
+    return NULL;
+}
+
+static void BenchmarkRender(MicrobenchReport * report, size_t objects) {
+    ShapeRegistry *       registry = ShapeRegistry_new(objects + 1024, MAX_THREADS, QuietDestroy);
+    ShapeRegistryThread * self     = ShapeRegistry_attach(registry);
+    for (size_t i = 0; i < objects; ++i) {
+        ShapeRegistry_insert(self, MakeShape(i));
+    }
+
+    int           reps    = microbench_report_repetitions(report);
+    double *      samples = (double *)malloc(2 * (size_t)reps * sizeof(double));
+    double        best[2] = {1e30, 1e30};
+    RenderContext render[2];
+    atomic_int    stop = 0;
+    Churn         churns[MAX_THREADS - 1];
+    pthread_t     threads[MAX_THREADS - 1];
+    size_t        circles = 0;
+
+    for (int concurrent = 0; concurrent < 2; ++concurrent) {
+        if (concurrent) {
+            for (int t = 0; t < MAX_THREADS - 1; ++t) {
+                churns[t].registry = registry;
+                churns[t].stop     = &stop;
+                churns[t].seed     = (uint64_t)t * 1000003u;
+                pthread_create(&threads[t], NULL, RunChurn, &churns[t]);
+            }
+        }
+        for (int r = 0; r < reps; ++r) {
+            RenderContext pass = {0.0, 0};
+            double        t0   = microbench_now();
+            circles = ShapeRegistry_for_each_of_type(self, Circle_type(), SumAreas, &pass);
+            double t = microbench_now() - t0;
+            samples[concurrent * reps + r] = t;
+            if (t < best[concurrent]) {
+                best[concurrent]   = t;
+                render[concurrent] = pass;
+            }
+        }
+        if (concurrent) {
+            atomic_store(&stop, 1);
+            for (int t = 0; t < MAX_THREADS - 1; ++t) {
+                pthread_join(threads[t], NULL);
+            }
+        }
+    }
+
+    printf("[2] 渲染 pass：for_each_of_type(Circle)（%zu 个对象，约 %zu 个 Circle，每批 %d 个）\n",
+           objects, circles, SHAPE_REGISTRY_BATCH);
+    printf("  场景                       ns/Circle    批次数\n");
+    printf("  单独遍历                %12.2f %9zu\n", best[0] / (double)circles * 1e9,
+           render[0].batches);
+    printf("  同时有 3 个线程在增删   %12.2f %9zu\n", best[1] / (double)circles * 1e9,
+           render[1].batches);
+    printf("  结果一致: %s\n\n", render[0].area == render[1].area ? "yes" : "NO");
+
+    /* 有增删线程时的遍历结果必须与单独遍历相同 */
+    microbench_report_add(report, "render/alone", &samples[0], (size_t)reps, circles, 1);
+    microbench_report_add(report, "render/churn", &samples[reps], (size_t)reps, circles,
+                          render[0].area == render[1].area);
+    free(samples);
+
+    ShapeRegistry_detach(self);
+    ShapeRegistry_delete(registry);
+}
+
+int main(int argc, char * argv[]) {
+    MicrobenchReport * report = microbench_report_new(&argc, argv, 3);
+    if (report == NULL) {
+        return 1;
+    }
+    size_t iterations = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    printf("无锁 Shape 注册表基准测试（开放寻址 + hazard pointer）\n");
+    printf("=====================================\n\n");
+    BenchmarkMixed(report, iterations);
+    BenchmarkRender(report, iterations);
+
+    printf("关键学习点：\n");
+    printf("1. 查找只做原子读和一次 hazard 发布，读多写少时不会像单把锁那样互相排队\n");
+    printf("2. 槽位可复用，所以必须在 hazard 保护下再核对一次 ID，才能排除 ABA\n");
+    printf("3. 删除只是摘链 + 延迟回收：对象要等所有线程都不再引用它才会 free\n");
+    printf("4. 按 vtable 地址过滤、成批交给回调，渲染 pass 不必每个对象都走一次查找\n");
+    printf("5. 单核或无竞争时互斥锁很便宜，无锁版多出的 seq_cst 发布和 Entry 分配反而更贵；\n"
+           "   差距要在多核、多线程同时查找时才会反过来\n");
+    return microbench_report_finish(report);
+}
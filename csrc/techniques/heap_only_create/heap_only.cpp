@@ -9,5 +9,13 @@ int main() {
     p2->destroy();
 
     // HeapOnly2 p3(21);  // error: destructor is private
+
+    auto pooled = PooledHeapOnly::create(7);
+    pooled->say();
+    auto batch = PooledHeapOnly::create_batch(3, 100);
+    batch.back()->say();
+    std::cout << "pool capacity: " << PooledHeapOnly::pool().capacity()
+              << ", in use: " << PooledHeapOnly::pool().in_use() << "\n";
+    // PooledHeapOnly p4(1);  // error: constructor and destructor are private
     return 0;
 }
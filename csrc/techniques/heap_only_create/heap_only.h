@@ -4,6 +4,7 @@
 // 详细说明见 https://www.yuque.com/linyun-lj2sn/ul5f4n/sm4ger2dovekluo7#RgJwr
 
 #include "common.h"
+#include "object_pool.h"
 
 // HeapOnly: can only be created via the static create() factory which
 // returns a std::unique_ptr. Constructor is private and copy is deleted.
@@ -53,4 +54,59 @@ class HeapOnly2 {
     int value{};
 };
 
+// PooledHeapOnly: same factory-only idea as HeapOnly, but for objects created
+// by the million. create() draws a slot from a type-specific ObjectPool instead
+// of calling new, and the returned unique_ptr's deleter runs the (private)
+// destructor and gives the slot back to the pool. No logging here on purpose.
+class PooledHeapOnly {
+  public:
+    struct Deleter {
+        void operator()(PooledHeapOnly * p) const noexcept {
+            p->~PooledHeapOnly();
+            pool().deallocate(p);
+        }
+    };
+
+    using Ptr = std::unique_ptr<PooledHeapOnly, Deleter>;
+
+    PooledHeapOnly(const PooledHeapOnly &)             = delete;
+    PooledHeapOnly & operator=(const PooledHeapOnly &) = delete;
+
+    static Ptr create(int v) {
+        void * slot = pool().allocate();
+        return Ptr(new (slot) PooledHeapOnly(v));
+    }
+
+    // n objects with values first_value, first_value + 1, ...; the slots come
+    // from one locked pool operation instead of n separate allocations
+    static std::vector<Ptr> create_batch(std::size_t n, int first_value = 0) {
+        std::vector<void *> slots;
+        pool().allocate_batch(n, slots);
+        std::vector<Ptr> objects;
+        objects.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            objects.emplace_back(new (slots[i]) PooledHeapOnly(first_value + static_cast<int>(i)));
+        }
+        return objects;
+    }
+
+    // Intentionally leaked: objects may still be released from other static
+    // destructors after this function's statics would have been destroyed
+    static ObjectPool<PooledHeapOnly> & pool() {
+        static auto * instance = new ObjectPool<PooledHeapOnly>();
+        return *instance;
+    }
+
+    void say() const { std::cout << "Hello from PooledHeapOnly: " << value << "\n"; }
+
+    int getValue() const { return value; }
+
+  private:
+    explicit PooledHeapOnly(int v) : value(v) {}
+
+    ~PooledHeapOnly() = default;
+
+    int value;
+};
+
 #endif // CPP_QA_LAB_HEAP_ONLY_H
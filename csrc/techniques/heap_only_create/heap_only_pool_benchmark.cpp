@@ -0,0 +1,80 @@
+// Throughput of the pooled heap-only factory against plain new/delete (what
+// HeapOnly::create does, minus its logging), one object at a time and in batches.
+//
+// Usage: heap_only_pool_benchmark [objects] [--repetitions=N] [--json=FILE]
+//
+// Every round creates `objects` objects, keeps them alive in a vector and then
+// destroys them all; the sum of the last values must agree across the variants.
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "heap_only.h"
+#include "microbench.h"
+
+namespace {
+
+struct PlainSession {
+    explicit PlainSession(int v) : value(v) {}
+
+    int value;
+};
+
+// Runs body once per repetition and records it as `n` object lifetimes;
+// returns the fastest repetition in seconds
+template <typename Body>
+double Measure(microbench::Report & report, const char * name, std::size_t n, Body && body) {
+    std::vector<double> seconds;
+    for (int r = 0; r < report.repetitions(); ++r) {
+        seconds.push_back(microbench::Seconds(body));
+    }
+    report.Add(name, seconds, n);
+    return *std::min_element(seconds.begin(), seconds.end());
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    microbench::Report report(argc, argv);
+    std::size_t        n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    n                    = std::max<std::size_t>(1, n);
+
+    long long sums[3] = {};
+
+    double t_new = Measure(report, "create/new_delete", n, [&] {
+        std::vector<std::unique_ptr<PlainSession>> objects;
+        objects.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            objects.push_back(std::make_unique<PlainSession>(static_cast<int>(i)));
+        }
+        sums[0] += objects.back()->value;
+    });
+
+    PooledHeapOnly::pool().reserve(n); // first-round growth is not what we measure
+    double t_pooled = Measure(report, "create/pooled", n, [&] {
+        std::vector<PooledHeapOnly::Ptr> objects;
+        objects.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            objects.push_back(PooledHeapOnly::create(static_cast<int>(i)));
+        }
+        sums[1] += objects.back()->getValue();
+    });
+    report.last().correct = sums[1] == sums[0];
+
+    double t_batch = Measure(report, "create/pooled_batch", n, [&] {
+        auto objects = PooledHeapOnly::create_batch(n);
+        sums[2] += objects.back()->getValue();
+    });
+    report.last().correct = sums[2] == sums[0];
+
+    auto per_object = [&](double seconds) { return seconds / static_cast<double>(n) * 1e9; };
+    fmt::print("create + destroy {} objects, ns/object: new/delete {:.1f}, pooled {:.1f}, "
+               "pooled batch {:.1f}\n",
+               n, per_object(t_new), per_object(t_pooled), per_object(t_batch));
+    fmt::print("sums match: {}\n", sums[0] == sums[1] && sums[1] == sums[2] ? "yes" : "NO");
+    return report.Finish();
+}
@@ -0,0 +1,114 @@
+#ifndef CPP_QA_LAB_OBJECT_POOL_H
+#define CPP_QA_LAB_OBJECT_POOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// ObjectPool<T>: fixed-size slots for one type, carved out of large chunks and
+// recycled through an intrusive free list. It only hands out raw storage; the
+// caller constructs/destroys T in place (see PooledHeapOnly in heap_only.h).
+//
+// - allocate() / deallocate() take the lock once per object
+// - allocate_batch(n) takes the lock once and grows the pool at most once,
+//   which is where batch creation gets its speed-up
+// - memory is returned to the system only when the pool itself is destroyed
+template <typename T, std::size_t kChunkSlots = 1024> class ObjectPool {
+  public:
+    ObjectPool() = default;
+
+    ObjectPool(const ObjectPool &)             = delete;
+    ObjectPool & operator=(const ObjectPool &) = delete;
+
+    ~ObjectPool() {
+        for (Slot * chunk : chunks_) {
+            ::operator delete(chunk, std::align_val_t(alignof(Slot)));
+        }
+    }
+
+    void * allocate() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_ == nullptr) {
+            grow(kChunkSlots);
+        }
+        return pop();
+    }
+
+    void deallocate(void * p) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        push(static_cast<Slot *>(p));
+    }
+
+    // Append n slots to out
+    void allocate_batch(std::size_t n, std::vector<void *> & out) {
+        out.reserve(out.size() + n);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (capacity_ - in_use_ < n) {
+            grow(std::max(kChunkSlots, n - (capacity_ - in_use_)));
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            out.push_back(pop());
+        }
+    }
+
+    // Pre-allocate so that the next n allocations do not touch the system allocator
+    void reserve(std::size_t n) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (capacity_ - in_use_ < n) {
+            grow(n - (capacity_ - in_use_));
+        }
+    }
+
+    std::size_t capacity() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return capacity_;
+    }
+
+    std::size_t in_use() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return in_use_;
+    }
+
+  private:
+    // A free slot stores the next pointer; an occupied slot stores the object
+    union Slot {
+        Slot * next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    void grow(std::size_t n) {
+        chunks_.reserve(chunks_.size() + 1); // so push_back below cannot throw and leak the chunk
+        auto * chunk = static_cast<Slot *>(
+            ::operator new(n * sizeof(Slot), std::align_val_t(alignof(Slot))));
+        chunks_.push_back(chunk);
+        // Link back to front so that pop() hands out slots in address order
+        for (std::size_t i = n; i-- > 0;) {
+            chunk[i].next = free_;
+            free_         = &chunk[i];
+        }
+        capacity_ += n;
+    }
+
+    void * pop() {
+        Slot * slot = free_;
+        free_       = slot->next;
+        ++in_use_;
+        return slot;
+    }
+
+    void push(Slot * slot) {
+        slot->next = free_;
+        free_      = slot;
+        --in_use_;
+    }
+
+    mutable std::mutex  mutex_;
+    Slot *              free_     = nullptr;
+    std::vector<Slot *> chunks_;
+    std::size_t         capacity_ = 0;
+    std::size_t         in_use_   = 0;
+};
+
+#endif // CPP_QA_LAB_OBJECT_POOL_H
@@ -0,0 +1,730 @@
+// microbench.cpp
+// 微基准框架的运行器：命令行解析、迭代次数校准、重复采样、perf 计数器和结果输出
+// main() 在 microbench_main.cpp 中，这里只提供 RunRegisteredBenchmarks() 和手写驱动用的 Report
+
+#include "microbench.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+#include "common.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace microbench {
+
+#if !defined(__GNUC__) && !defined(__clang__)
+void UseCharPointer(const volatile char *) {}
+#endif
+
+// ============================================================================
+// PerfCounters：Linux perf_event 计数器组
+// ============================================================================
+// 所有事件放在同一个组里，由组长 fd 统一开关、一次 read 读出，
+// 保证各计数器覆盖的是完全相同的时间段。容器 / 虚拟机里常常没有权限或没有 PMU，
+// 这时 Create 返回 nullptr 并给出原因，基准照常运行，只是不报告计数器。
+
+class PerfCounters {
+  public:
+    static std::unique_ptr<PerfCounters> Create(const std::vector<std::string> & names,
+                                                std::string *                    error);
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (auto it = fds_.rbegin(); it != fds_.rend(); ++it) {
+            close(*it);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters &)             = delete;
+    PerfCounters & operator=(const PerfCounters &) = delete;
+
+    void Reset() { Control(kReset); }
+
+    void Start() { Control(kEnable); }
+
+    void Stop() { Control(kDisable); }
+
+    // 读出自上次 Reset 以来的累计值，顺序与 names() 一致
+    std::vector<uint64_t> Read() const;
+
+    const std::vector<std::string> & names() const { return names_; }
+
+  private:
+    enum Op { kReset, kEnable, kDisable };
+
+    PerfCounters() = default;
+
+    void Control(Op op);
+
+    std::vector<std::string> names_;
+    std::vector<int>         fds_;
+};
+
+#if defined(__linux__)
+
+namespace {
+
+struct PerfEventSpec {
+    const char * name;
+    uint32_t     type;
+    uint64_t     config;
+};
+
+const PerfEventSpec kPerfEvents[] = {
+    { "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { "cache-references", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES },
+    { "cache-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { "branches", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+    { "branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { "page-faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+    { "context-switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+    { "task-clock", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+};
+
+} // namespace
+
+std::unique_ptr<PerfCounters> PerfCounters::Create(const std::vector<std::string> & names,
+                                                   std::string *                    error) {
+    std::unique_ptr<PerfCounters> counters(new PerfCounters());
+    for (const std::string & name : names) {
+        const PerfEventSpec * spec = nullptr;
+        for (const auto & candidate : kPerfEvents) {
+            if (name == candidate.name) {
+                spec = &candidate;
+            }
+        }
+        if (spec == nullptr) {
+            *error = fmt::format("未知的计数器 '{}'", name);
+            return nullptr;
+        }
+
+        perf_event_attr attr{};
+        attr.size           = sizeof(attr);
+        attr.type           = spec->type;
+        attr.config         = spec->config;
+        attr.disabled       = counters->fds_.empty() ? 1 : 0; // 只有组长初始为关闭
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_GROUP;
+
+        int group_fd = counters->fds_.empty() ? -1 : counters->fds_.front();
+        int fd       = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+        if (fd < 0) {
+            *error = fmt::format("perf_event_open({}) 失败: {}", name, std::strerror(errno));
+            return nullptr;
+        }
+        counters->fds_.push_back(fd);
+        counters->names_.push_back(name);
+    }
+    return counters;
+}
+
+void PerfCounters::Control(Op op) {
+    if (fds_.empty()) {
+        return;
+    }
+    unsigned long request = op == kReset    ? PERF_EVENT_IOC_RESET
+                            : op == kEnable ? PERF_EVENT_IOC_ENABLE
+                                            : PERF_EVENT_IOC_DISABLE;
+    ioctl(fds_.front(), request, PERF_IOC_FLAG_GROUP);
+}
+
+std::vector<uint64_t> PerfCounters::Read() const {
+    // PERF_FORMAT_GROUP 的布局：{ nr, values[nr] }
+    std::vector<uint64_t> buffer(fds_.size() + 1, 0);
+    std::vector<uint64_t> values(fds_.size(), 0);
+    if (!fds_.empty() &&
+        read(fds_.front(), buffer.data(), buffer.size() * sizeof(uint64_t)) > 0) {
+        std::copy(buffer.begin() + 1, buffer.end(), values.begin());
+    }
+    return values;
+}
+
+#else
+
+std::unique_ptr<PerfCounters> PerfCounters::Create(const std::vector<std::string> &,
+                                                   std::string * error) {
+    *error = "perf 计数器只在 Linux 上可用";
+    return nullptr;
+}
+
+void PerfCounters::Control(Op) {}
+
+std::vector<uint64_t> PerfCounters::Read() const {
+    return {};
+}
+
+#endif
+
+// ============================================================================
+// State
+// ============================================================================
+
+State::State(uint64_t max_iterations, std::vector<int64_t> args, PerfCounters * perf)
+    : max_iterations_(max_iterations), args_(std::move(args)), perf_(perf) {}
+
+void State::StartTiming() {
+    running_ = true;
+    if (perf_ != nullptr) {
+        perf_->Start();
+    }
+    start_ = Clock::now();
+}
+
+void State::PauseTiming() {
+    auto now = Clock::now();
+    if (perf_ != nullptr) {
+        perf_->Stop();
+    }
+    if (running_) {
+        elapsed_seconds_ += std::chrono::duration<double>(now - start_).count();
+        running_          = false;
+    }
+}
+
+void State::ResumeTiming() {
+    StartTiming();
+}
+
+void State::FinishTiming() {
+    PauseTiming();
+    finished_ = true;
+}
+
+// ============================================================================
+// Runner
+// ============================================================================
+
+namespace {
+
+struct Options {
+    std::string              filter      = ".*";
+    double                   min_time    = 0.1;
+    int                      repetitions = 5;
+    std::string              json_path;
+    std::vector<std::string> counters;
+    bool                     list_only = false;
+};
+
+struct SampleSummary {
+    double min    = 0.0;
+    double max    = 0.0;
+    double mean   = 0.0;
+    double median = 0.0;
+    double stddev = 0.0; // 样本标准差(n-1)
+};
+
+SampleSummary Summarize(std::vector<double> samples) {
+    SampleSummary s;
+    if (samples.empty()) {
+        return s;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    s.min    = samples.front();
+    s.max    = samples.back();
+    s.mean   = std::accumulate(samples.begin(), samples.end(), 0.0) / n;
+    s.median = n % 2 == 1 ? samples[n / 2] : 0.5 * (samples[n / 2 - 1] + samples[n / 2]);
+    if (n > 1) {
+        double sq = 0.0;
+        for (double v : samples) {
+            sq += (v - s.mean) * (v - s.mean);
+        }
+        s.stddev = std::sqrt(sq / (n - 1));
+    }
+    return s;
+}
+
+std::vector<std::string> Split(const std::string & text, char sep) {
+    std::vector<std::string> parts;
+    std::stringstream        in(text);
+    std::string              part;
+    while (std::getline(in, part, sep)) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+std::string JsonEscape(const std::string & s) {
+    std::string out;
+    for (char c : s) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += fmt::format("\\u{:04x}", static_cast<int>(c));
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+std::string InstanceName(const Benchmark & bench, const std::vector<int64_t> & args) {
+    std::string name = bench.name();
+    for (int64_t a : args) {
+        name += "/" + std::to_string(a);
+    }
+    return name;
+}
+
+// 1234567 -> "1.23M"
+std::string HumanRate(double per_second, const char * unit) {
+    const char * prefixes[] = { "", "k", "M", "G", "T" };
+    int          p          = 0;
+    while (per_second >= 1000.0 && p < 4) {
+        per_second /= 1000.0;
+        ++p;
+    }
+    return fmt::format("{:.2f}{}{}/s", per_second, prefixes[p], unit);
+}
+
+std::string CpuModel() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string   line;
+    while (std::getline(in, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            auto colon = line.find(':');
+            return colon == std::string::npos ? "" : line.substr(colon + 2);
+        }
+    }
+    return "unknown";
+}
+
+void PrintUsage(const char * argv0) {
+    fmt::print(
+        "用法: {} [选项]\n"
+        "  --filter=<正则>        只运行名字匹配的基准（std::regex_search）\n"
+        "  --min_time=<秒>        每次重复的目标耗时，默认 0.1\n"
+        "  --repetitions=<n>      重复次数，默认 5（报告中位数和变异系数）\n"
+        "  --json=<文件|->        以 JSON 输出结果（含每次重复的样本），- 表示标准输出\n"
+        "  --counters=<列表>      perf 计数器，逗号分隔：cycles,instructions,cache-references,\n"
+        "                         cache-misses,branches,branch-misses,page-faults,\n"
+        "                         context-switches,task-clock\n"
+        "  --list                 只列出基准名字\n",
+        argv0);
+}
+
+// 一个基准实例（名字 + 一组参数）的全部测量结果
+struct RunResult {
+    std::string                   name;
+    std::string                   family;
+    std::vector<int64_t>          args;
+    uint64_t                      iterations = 0;
+    std::vector<double>           samples_ns; // 每次重复的 ns/迭代
+    SampleSummary                 summary;
+    double                        items_per_second = 0.0;
+    double                        bytes_per_second = 0.0;
+    std::map<std::string, double> counters; // 用户计数器 + perf 计数器，均为每次迭代的平均值
+    std::string                   label;
+    std::string                   error;
+    bool                          correct = true; // 只有 Report 的自校验结果会是 false
+};
+
+// 注册基准和 Report 共用的 JSON 输出；perf_error 为空表示计数器正常（或没有请求）
+void WriteJson(std::ostream & os, const std::string & argv0, double min_time, int repetitions,
+               const std::vector<RunResult> & results, const std::string & perf_error) {
+    std::time_t now = std::time(nullptr);
+    char        date[64];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+#if defined(NDEBUG)
+    const char * build_type = "release";
+#else
+    const char * build_type = "debug";
+#endif
+
+    fmt::memory_buffer buf;
+    auto               out = std::back_inserter(buf);
+    fmt::format_to(out, "{{\n  \"context\": {{\n");
+    fmt::format_to(out, "    \"executable\": \"{}\",\n", JsonEscape(argv0));
+    fmt::format_to(out, "    \"date\": \"{}\",\n", date);
+    fmt::format_to(out, "    \"cpu_model\": \"{}\",\n", JsonEscape(CpuModel()));
+    fmt::format_to(out, "    \"num_cpus\": {},\n", std::thread::hardware_concurrency());
+    fmt::format_to(out, "    \"build_type\": \"{}\",\n", build_type);
+    fmt::format_to(out, "    \"min_time\": {},\n", min_time);
+    fmt::format_to(out, "    \"repetitions\": {},\n", repetitions);
+    fmt::format_to(out, "    \"perf_counters\": \"{}\"\n  }},\n",
+                   JsonEscape(perf_error.empty() ? "ok" : perf_error));
+    fmt::format_to(out, "  \"benchmarks\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const RunResult & r = results[i];
+        fmt::format_to(out, "{}\n    {{\"name\": \"{}\", \"family\": \"{}\", \"args\": [{}]",
+                       i == 0 ? "" : ",", JsonEscape(r.name), JsonEscape(r.family),
+                       fmt::join(r.args, ", "));
+        if (!r.error.empty()) {
+            fmt::format_to(out, ", \"error\": \"{}\"}}", JsonEscape(r.error));
+            continue;
+        }
+        fmt::format_to(out,
+                       ", \"iterations\": {}, \"repetitions\": {}, \"time_unit\": \"ns\""
+                       ", \"median\": {:.6g}, \"mean\": {:.6g}, \"stddev\": {:.6g}"
+                       ", \"min\": {:.6g}, \"max\": {:.6g}, \"samples\": [{:.6g}]",
+                       r.iterations, r.samples_ns.size(), r.summary.median, r.summary.mean,
+                       r.summary.stddev, r.summary.min, r.summary.max,
+                       fmt::join(r.samples_ns, ", "));
+        if (r.items_per_second > 0) {
+            fmt::format_to(out, ", \"items_per_second\": {:.6g}", r.items_per_second);
+        }
+        if (r.bytes_per_second > 0) {
+            fmt::format_to(out, ", \"bytes_per_second\": {:.6g}", r.bytes_per_second);
+        }
+        fmt::format_to(out, ", \"counters\": {{");
+        bool first = true;
+        for (const auto & [key, value] : r.counters) {
+            fmt::format_to(out, "{}\"{}\": {:.6g}", first ? "" : ", ", JsonEscape(key), value);
+            first = false;
+        }
+        fmt::format_to(out, "}}, \"label\": \"{}\", \"correct\": {}}}", JsonEscape(r.label),
+                       r.correct ? "true" : "false");
+    }
+    fmt::format_to(out, "\n  ]\n}}\n");
+    os << fmt::to_string(buf);
+}
+
+} // namespace
+
+class Runner {
+  public:
+    explicit Runner(Options options) : options_(std::move(options)) {}
+
+    int Run(const char * argv0);
+
+  private:
+    static constexpr uint64_t kMaxIterations = 1000000000;
+
+    // 单次运行：构造 State、调用基准函数、检查是否真的跑了计时循环
+    double RunOnce(const Benchmark & bench, const std::vector<int64_t> & args, uint64_t iterations,
+                   PerfCounters * perf, State ** out_state);
+
+    uint64_t Calibrate(const Benchmark & bench, const std::vector<int64_t> & args, double min_time);
+
+    RunResult Measure(const Benchmark & bench, const std::vector<int64_t> & args);
+
+    static void PrintHeader(std::FILE * out, size_t width);
+
+    static void PrintRow(std::FILE * out, const RunResult & r, size_t width);
+
+    Options                       options_;
+    std::unique_ptr<PerfCounters> perf_;
+    std::unique_ptr<State>        last_state_;
+};
+
+double Runner::RunOnce(const Benchmark & bench, const std::vector<int64_t> & args,
+                       uint64_t iterations, PerfCounters * perf, State ** out_state) {
+    last_state_ = std::make_unique<State>(iterations, args, perf);
+    if (perf != nullptr) {
+        perf->Reset();
+    }
+    bench.function()(*last_state_);
+    if (!last_state_->finished_) {
+        throw std::runtime_error("基准函数没有执行 for (auto _ : state) 计时循环");
+    }
+    if (out_state != nullptr) {
+        *out_state = last_state_.get();
+    }
+    return last_state_->elapsed_seconds_;
+}
+
+// 从 1 次迭代开始，按耗时估算放大倍数，直到单次运行达到 min_time
+uint64_t Runner::Calibrate(const Benchmark & bench, const std::vector<int64_t> & args,
+                           double min_time) {
+    uint64_t iterations = 1;
+    for (;;) {
+        double seconds = RunOnce(bench, args, iterations, nullptr, nullptr);
+        if (seconds >= min_time || iterations >= kMaxIterations) {
+            return iterations;
+        }
+        // 离目标还很远时最多放大 10 倍，接近时按比例多给 40% 余量
+        double multiplier = seconds / min_time > 0.1 ? min_time * 1.4 / seconds : 10.0;
+        auto   next       = static_cast<uint64_t>(std::ceil(iterations * multiplier));
+        iterations        = std::min(kMaxIterations, std::max(iterations + 1, next));
+    }
+}
+
+RunResult Runner::Measure(const Benchmark & bench, const std::vector<int64_t> & args) {
+    RunResult result;
+    result.family = bench.name();
+    result.args   = args;
+    result.name   = InstanceName(bench, args);
+
+    double min_time    = bench.min_time() > 0 ? bench.min_time() : options_.min_time;
+    int    repetitions = bench.repetitions() > 0 ? bench.repetitions() : options_.repetitions;
+    try {
+        // 校准本身也起到预热作用；固定迭代次数时单独预热一次
+        uint64_t iterations = bench.iterations();
+        if (iterations == 0) {
+            iterations = Calibrate(bench, args, min_time);
+        } else {
+            RunOnce(bench, args, iterations, nullptr, nullptr);
+        }
+        result.iterations = iterations;
+
+        std::map<std::string, double> counter_sums;
+        double                        items = 0.0, bytes = 0.0, seconds_total = 0.0;
+        for (int r = 0; r < repetitions; ++r) {
+            State * state   = nullptr;
+            double  seconds = RunOnce(bench, args, iterations, perf_.get(), &state);
+            result.samples_ns.push_back(seconds / static_cast<double>(iterations) * 1e9);
+            seconds_total += seconds;
+            items         += static_cast<double>(state->items_processed_);
+            bytes         += static_cast<double>(state->bytes_processed_);
+            for (const auto & [key, value] : state->counters) {
+                counter_sums[key] += value / static_cast<double>(iterations);
+            }
+            if (perf_ != nullptr) {
+                std::vector<uint64_t> values = perf_->Read();
+                for (size_t i = 0; i < values.size(); ++i) {
+                    counter_sums[perf_->names()[i]] +=
+                        static_cast<double>(values[i]) / static_cast<double>(iterations);
+                }
+            }
+            result.label = state->label_;
+        }
+        for (const auto & [key, sum] : counter_sums) {
+            result.counters[key] = sum / repetitions;
+        }
+        result.summary          = Summarize(result.samples_ns);
+        result.items_per_second = seconds_total > 0 ? items / seconds_total : 0.0;
+        result.bytes_per_second = seconds_total > 0 ? bytes / seconds_total : 0.0;
+    } catch (const std::exception & e) {
+        result.error = e.what();
+    }
+    return result;
+}
+
+void Runner::PrintHeader(std::FILE * out, size_t width) {
+    fmt::print(out, "{:<{}} {:>14} {:>8} {:>12}  {}\n", "Benchmark", width, "Time(ns)", "CV",
+               "Iterations", "Throughput / Counters");
+    fmt::print(out, "{}\n", std::string(width + 60, '-'));
+}
+
+void Runner::PrintRow(std::FILE * out, const RunResult & r, size_t width) {
+    if (!r.error.empty()) {
+        fmt::print(out, "{:<{}} ERROR: {}\n", r.name, width, r.error);
+        return;
+    }
+    double      cv = r.summary.mean > 0 ? r.summary.stddev / r.summary.mean * 100.0 : 0.0;
+    std::string extra;
+    if (r.items_per_second > 0) {
+        extra += HumanRate(r.items_per_second, " items") + "  ";
+    }
+    if (r.bytes_per_second > 0) {
+        extra += HumanRate(r.bytes_per_second, "B") + "  ";
+    }
+    for (const auto & [key, value] : r.counters) {
+        extra += fmt::format("{}={:.4g}  ", key, value);
+    }
+    extra += r.label;
+    while (!extra.empty() && extra.back() == ' ') {
+        extra.pop_back();
+    }
+    fmt::print(out, "{:<{}} {:>14.3f} {:>7.2f}% {:>12}  {}\n", r.name, width, r.summary.median, cv,
+               r.iterations, extra);
+    std::fflush(out);
+}
+
+int Runner::Run(const char * argv0) {
+    std::regex filter;
+    try {
+        filter = std::regex(options_.filter);
+    } catch (const std::regex_error & e) {
+        fmt::print(stderr, "无效的 --filter 正则 '{}': {}\n", options_.filter, e.what());
+        return 2;
+    }
+
+    // 展开参数扫描：没有参数的基准是一个实例，否则每组参数一个实例
+    std::vector<std::pair<const Benchmark *, std::vector<int64_t>>> instances;
+    for (const auto & bench : Registry()) {
+        std::vector<std::vector<int64_t>> arg_sets = bench->args();
+        if (arg_sets.empty()) {
+            arg_sets.emplace_back();
+        }
+        for (auto & args : arg_sets) {
+            if (std::regex_search(InstanceName(*bench, args), filter)) {
+                instances.emplace_back(bench.get(), std::move(args));
+            }
+        }
+    }
+
+    if (options_.list_only) {
+        for (const auto & [bench, args] : instances) {
+            fmt::print("{}\n", InstanceName(*bench, args));
+        }
+        return 0;
+    }
+
+    std::string perf_error;
+    if (!options_.counters.empty()) {
+        perf_ = PerfCounters::Create(options_.counters, &perf_error);
+        if (perf_ == nullptr) {
+            fmt::print(stderr, "perf 计数器不可用，继续运行但不报告计数器: {}\n", perf_error);
+        }
+    }
+
+    // JSON 写到标准输出时，表格改写到标准错误，保证标准输出是合法 JSON
+    const bool   json_to_stdout = options_.json_path == "-";
+    std::FILE *  table_out      = json_to_stdout ? stderr : stdout;
+    fmt::print(table_out, "运行 {} 个基准实例（min_time = {}s, repetitions = {}）\n\n",
+               instances.size(), options_.min_time, options_.repetitions);
+
+    size_t width = 9;
+    for (const auto & [bench, args] : instances) {
+        width = std::max(width, InstanceName(*bench, args).size());
+    }
+    PrintHeader(table_out, width);
+
+    std::vector<RunResult> results;
+    bool                   failed = false;
+    for (const auto & [bench, args] : instances) {
+        results.push_back(Measure(*bench, args));
+        failed = failed || !results.back().error.empty();
+        PrintRow(table_out, results.back(), width);
+    }
+    fmt::print(table_out, "\n");
+
+    if (json_to_stdout) {
+        WriteJson(std::cout, argv0, options_.min_time, options_.repetitions, results, perf_error);
+    } else if (!options_.json_path.empty()) {
+        std::ofstream file(options_.json_path);
+        if (!file) {
+            fmt::print(stderr, "无法写入 {}\n", options_.json_path);
+            return 2;
+        }
+        WriteJson(file, argv0, options_.min_time, options_.repetitions, results, perf_error);
+        fmt::print(table_out, "结果已写入 {}\n", options_.json_path);
+    }
+    return failed ? 1 : 0;
+}
+
+int RunRegisteredBenchmarks(int argc, char * argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg   = argv[i];
+        auto        eq    = arg.find('=');
+        std::string key   = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        try {
+            if (key == "--filter") {
+                options.filter = value;
+            } else if (key == "--min_time") {
+                options.min_time = std::stod(value);
+            } else if (key == "--repetitions") {
+                options.repetitions = std::max(1, std::stoi(value));
+            } else if (key == "--json") {
+                options.json_path = value;
+            } else if (key == "--counters") {
+                options.counters = Split(value, ',');
+            } else if (key == "--list") {
+                options.list_only = true;
+            } else if (key == "--help" || key == "-h") {
+                PrintUsage(argv[0]);
+                return 0;
+            } else {
+                fmt::print(stderr, "未知选项: {}\n", arg);
+                PrintUsage(argv[0]);
+                return 2;
+            }
+        } catch (const std::exception &) {
+            fmt::print(stderr, "选项 {} 的值无效: '{}'\n", key, value);
+            return 2;
+        }
+    }
+    return Runner(std::move(options)).Run(argv[0]);
+}
+
+// ============================================================================
+// Report
+// ============================================================================
+
+Report::Report(int & argc, char ** argv, int default_repetitions)
+    : argv0_(argc > 0 ? argv[0] : ""), repetitions_(std::max(1, default_repetitions)) {
+    int kept = argc > 0 ? 1 : 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg   = argv[i];
+        auto        eq    = arg.find('=');
+        std::string key   = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (key == "--json") {
+            // 驱动程序自己往标准输出打印表格，JSON 只能写文件
+            if (value.empty() || value == "-") {
+                throw std::invalid_argument("--json 需要一个文件路径");
+            }
+            json_path_ = value;
+        } else if (key == "--repetitions") {
+            repetitions_ = std::max(1, std::stoi(value));
+        } else if (key != "--min_time") {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+}
+
+Report::Entry & Report::Add(std::string name, const std::vector<double> & seconds,
+                            uint64_t iterations) {
+    Entry & entry    = entries_.emplace_back();
+    entry.name       = std::move(name);
+    entry.iterations = std::max<uint64_t>(1, iterations);
+    for (double s : seconds) {
+        entry.samples_ns.push_back(s / static_cast<double>(entry.iterations) * 1e9);
+    }
+    return entry;
+}
+
+int Report::Finish() const {
+    std::vector<RunResult> results;
+    bool                   wrong = false;
+    for (const Entry & entry : entries_) {
+        RunResult & r = results.emplace_back();
+        r.name        = entry.name;
+        r.family      = entry.name.substr(0, entry.name.find('/'));
+        r.iterations  = entry.iterations;
+        r.samples_ns  = entry.samples_ns;
+        r.summary     = Summarize(entry.samples_ns);
+        r.counters    = entry.counters;
+        r.label       = entry.label;
+        r.correct     = entry.correct;
+        wrong         = wrong || !entry.correct;
+    }
+    if (!json_path_.empty()) {
+        std::ofstream file(json_path_);
+        if (!file) {
+            fmt::print(stderr, "无法写入 {}\n", json_path_);
+            return 2;
+        }
+        WriteJson(file, argv0_, 0.0, repetitions_, results, "");
+        fmt::print("结果已写入 {}\n", json_path_);
+    }
+    return wrong ? 1 : 0;
+}
+
+} // namespace microbench
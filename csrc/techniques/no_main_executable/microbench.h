@@ -0,0 +1,371 @@
+// microbench.h
+// 自注册微基准框架：BENCHMARK(fn) 宏 + 共享的 main 提供者
+//
+// 与 main.cpp 中的 TestRegistrar 是同一个套路：
+//   - 用户文件里只写基准函数和 BENCHMARK(...)，静态对象构造时把基准登记到全局表
+//   - main() 由 microbench_main.cpp 提供，链接 csrc::microbench_main 即可得到可执行文件
+//
+// 框架负责：迭代次数自动校准、重复采样与统计、参数扫描（Arg / Range / DenseRange）、
+// 按正则过滤、Linux perf 计数器、控制台表格和 JSON 输出。用法：
+//
+//   static void BM_Sort(microbench::State & state) {
+//       std::vector<int> data(state.range(0));
+//       for (auto _ : state) {
+//           state.PauseTiming();
+//           FillRandom(data);
+//           state.ResumeTiming();
+//           std::sort(data.begin(), data.end());
+//           microbench::DoNotOptimize(data.data());
+//       }
+//       state.SetItemsProcessed(state.iterations() * state.range(0));
+//   }
+//   BENCHMARK(BM_Sort)->Range(64, 1 << 16);
+//
+// 命令行：--filter=<正则> --min_time=<秒> --repetitions=<n> --json=<文件|->
+//         --counters=cycles,instructions,... --list
+//
+// 自己写 main、自己打印表格的驱动程序（gemm_demo、各 *_benchmark）链接 csrc::microbench，
+// 用文件末尾的 Seconds / Report 计时和记录，输出与注册基准相同格式的 JSON。
+
+#ifndef CPP_QA_LAB_CSRC_TECHNIQUES_NO_MAIN_EXECUTABLE_MICROBENCH_H_
+#define CPP_QA_LAB_CSRC_TECHNIQUES_NO_MAIN_EXECUTABLE_MICROBENCH_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace microbench {
+
+// ============================================================================
+// 防优化工具
+// ============================================================================
+
+#if defined(__GNUC__) || defined(__clang__)
+
+// 让编译器认为 value 被读取（必要时也被修改），从而不能删除产生它的计算
+template <typename T> inline void DoNotOptimize(const T & value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <typename T> inline void DoNotOptimize(T & value) {
+#if defined(__clang__)
+    asm volatile("" : "+r,m"(value) : : "memory");
+#else
+    asm volatile("" : "+m,r"(value) : : "memory");
+#endif
+}
+
+// 编译器屏障：强制把挂起的写入落到内存，之后的读也不能用寄存器里的旧值
+inline void ClobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+#else
+
+void UseCharPointer(const volatile char * p);
+
+template <typename T> inline void DoNotOptimize(const T & value) {
+    UseCharPointer(&reinterpret_cast<const volatile char &>(value));
+}
+
+inline void ClobberMemory() {
+    std::atomic_signal_fence(std::memory_order_acq_rel);
+}
+
+#endif
+
+class PerfCounters;
+
+// ============================================================================
+// State：一次运行的上下文
+// ============================================================================
+
+class State {
+  public:
+    State(uint64_t max_iterations, std::vector<int64_t> args, PerfCounters * perf);
+
+    // for (auto _ : state) 的迭代器：到达末尾时停止计时
+    // Value 标成 [[maybe_unused]]，循环变量 _ 不会触发 -Wunused-but-set-variable
+    struct [[maybe_unused]] Value {};
+
+    class Iterator {
+      public:
+        Iterator(uint64_t remaining, State * parent) : remaining_(remaining), parent_(parent) {}
+
+        Value operator*() const { return {}; }
+
+        Iterator & operator++() {
+            --remaining_;
+            return *this;
+        }
+
+        bool operator!=(const Iterator &) const {
+            if (remaining_ != 0) {
+                return true;
+            }
+            parent_->FinishTiming();
+            return false;
+        }
+
+      private:
+        uint64_t remaining_;
+        State *  parent_;
+    };
+
+    Iterator begin() {
+        StartTiming();
+        return Iterator(max_iterations_, this);
+    }
+
+    Iterator end() { return Iterator(0, this); }
+
+    // 参数扫描的第 i 个参数
+    int64_t range(size_t i = 0) const { return args_.at(i); }
+
+    uint64_t iterations() const { return max_iterations_; }
+
+    // 计时循环内不想计入的准备工作（有额外开销，循环体太短时不要用）
+    void PauseTiming();
+    void ResumeTiming();
+
+    void SetItemsProcessed(int64_t items) { items_processed_ = items; }
+
+    void SetBytesProcessed(int64_t bytes) { bytes_processed_ = bytes; }
+
+    void SetLabel(std::string label) { label_ = std::move(label); }
+
+    // 用户自定义计数器：按每次迭代的平均值报告
+    std::map<std::string, double> counters;
+
+  private:
+    friend class Runner;
+
+    void StartTiming();
+    void FinishTiming();
+
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t             max_iterations_;
+    std::vector<int64_t> args_;
+    PerfCounters *       perf_;
+    Clock::time_point    start_{};
+    double               elapsed_seconds_ = 0.0;
+    bool                 running_         = false;
+    bool                 finished_        = false;
+    int64_t              items_processed_ = 0;
+    int64_t              bytes_processed_ = 0;
+    std::string          label_;
+};
+
+// ============================================================================
+// Benchmark：注册信息与参数扫描
+// ============================================================================
+
+using BenchmarkFunction = std::function<void(State &)>;
+
+class Benchmark {
+  public:
+    Benchmark(std::string name, BenchmarkFunction fn)
+        : name_(std::move(name)), fn_(std::move(fn)) {}
+
+    // 追加一组参数；多次调用即多个实例
+    Benchmark * Arg(int64_t x) { return Args({ x }); }
+
+    Benchmark * Args(std::vector<int64_t> xs) {
+        args_.push_back(std::move(xs));
+        return this;
+    }
+
+    // lo, lo*m, lo*m^2, ..., hi（最后一个一定是 hi）；与 Google Benchmark 一样，
+    // lo 为 0 时先放入 0，再从 1 开始乘
+    Benchmark * Range(int64_t lo, int64_t hi, int64_t multiplier = 8) {
+        if (lo < 0 || hi < lo) {
+            throw std::invalid_argument(name_ + ": Range 要求 0 <= lo <= hi");
+        }
+        if (multiplier < 2) {
+            throw std::invalid_argument(name_ + ": Range 的 multiplier 至少为 2");
+        }
+        if (lo == 0) {
+            Arg(0);
+            if (hi == 0) {
+                return this;
+            }
+            lo = 1;
+        }
+        for (int64_t x = lo; x < hi; x *= multiplier) {
+            Arg(x);
+            if (x > hi / multiplier) {
+                break; // 再乘就超过 hi（也避免溢出）
+            }
+        }
+        return Arg(hi);
+    }
+
+    Benchmark * DenseRange(int64_t lo, int64_t hi, int64_t step = 1) {
+        if (hi < lo) {
+            throw std::invalid_argument(name_ + ": DenseRange 要求 lo <= hi");
+        }
+        if (step <= 0) {
+            throw std::invalid_argument(name_ + ": DenseRange 的 step 必须为正");
+        }
+        for (int64_t x = lo;; x += step) {
+            Arg(x);
+            if (hi - x < step) {
+                break; // 下一个会超过 hi（也避免溢出）
+            }
+        }
+        return this;
+    }
+
+    // 每次重复的目标耗时；覆盖命令行的 --min_time
+    Benchmark * MinTime(double seconds) {
+        min_time_ = seconds;
+        return this;
+    }
+
+    Benchmark * Repetitions(int n) {
+        repetitions_ = n;
+        return this;
+    }
+
+    // 固定迭代次数，跳过校准（适合单次就很慢的基准）
+    Benchmark * Iterations(uint64_t n) {
+        iterations_ = n;
+        return this;
+    }
+
+    const std::string & name() const { return name_; }
+
+    const BenchmarkFunction & function() const { return fn_; }
+
+    const std::vector<std::vector<int64_t>> & args() const { return args_; }
+
+    double min_time() const { return min_time_; }
+
+    int repetitions() const { return repetitions_; }
+
+    uint64_t iterations() const { return iterations_; }
+
+  private:
+    std::string                       name_;
+    BenchmarkFunction                 fn_;
+    std::vector<std::vector<int64_t>> args_;
+    double                            min_time_    = 0.0; // 0 表示用命令行 / 默认值
+    int                               repetitions_ = 0;
+    uint64_t                          iterations_  = 0;
+};
+
+// 全局注册表：函数内静态变量，不受跨编译单元静态初始化顺序的影响
+inline std::vector<std::unique_ptr<Benchmark>> & Registry() {
+    static std::vector<std::unique_ptr<Benchmark>> registry;
+    return registry;
+}
+
+inline Benchmark * RegisterBenchmark(std::string name, BenchmarkFunction fn) {
+    Registry().push_back(std::make_unique<Benchmark>(std::move(name), std::move(fn)));
+    return Registry().back().get();
+}
+
+// 解析命令行并运行所有匹配的基准；microbench_main.cpp 的 main() 只调用它
+int RunRegisteredBenchmarks(int argc, char * argv[]);
+
+// ============================================================================
+// 手写驱动程序：计时函数与 Report
+// ============================================================================
+// 实验流程复杂（多线程扫描、自带正确性校验、先准备大块数据）的程序不适合拆成
+// BENCHMARK 函数，它们保留自己的 main 和表格，但计时都用这里的函数，
+// 结果交给 Report，以注册基准的 JSON 格式写出，bench 运行器按同一种方式读取：
+//
+//   int main(int argc, char * argv[]) {
+//       microbench::Report report(argc, argv); // 取走 --json= / --repetitions=
+//       double best = report.Time("sort/100000", [&] { Sort(data); });
+//       report.Add("gemm/blocked/512", samples).counters["gflops"] = gflops;
+//       return report.Finish();
+//   }
+
+// 从 start 到现在的秒数
+inline double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 运行一次 body，返回耗时（秒）
+template <typename Body> double Seconds(Body && body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return SecondsSince(start);
+}
+
+class Report {
+  public:
+    // 一项结果：samples_ns 为每次重复里每次操作的平均耗时
+    struct Entry {
+        std::string                   name;
+        uint64_t                      iterations = 1; // 每次重复包含的操作数
+        std::vector<double>           samples_ns;
+        std::map<std::string, double> counters;
+        std::string                   label;
+        bool                          correct = true; // 自带校验的基准在结果错误时置 false
+    };
+
+    // 从命令行取走 --json=<文件>、--repetitions=<n>，并接受、忽略 --min_time=<秒>
+    // （手写驱动自己决定每次重复的工作量）；其余参数留在 argv 里由驱动程序解析。
+    // 单次运行很重的驱动可以调低 default_repetitions
+    Report(int & argc, char ** argv, int default_repetitions = 5);
+
+    int repetitions() const { return repetitions_; }
+
+    const std::string & json_path() const { return json_path_; }
+
+    // 记录一项已经测好的结果；seconds 为每次重复的总耗时，iterations 为每次重复的操作数
+    // 返回的引用在 Report 销毁前一直有效（deque 尾部插入不移动已有元素）
+    Entry & Add(std::string name, const std::vector<double> & seconds, uint64_t iterations = 1);
+
+    // 运行 body repetitions() 次（每次连续 iterations 遍）并记录，返回最快一次里
+    // 单遍的耗时（秒）；取最小值过滤调度和冷缓存噪声，中位数等统计留给 JSON
+    template <typename Body>
+    double Time(std::string name, Body && body, uint64_t iterations = 1) {
+        std::vector<double> seconds;
+        for (int r = 0; r < repetitions_; ++r) {
+            seconds.push_back(Seconds([&] {
+                for (uint64_t i = 0; i < iterations; ++i) {
+                    body();
+                }
+            }));
+        }
+        Add(std::move(name), seconds, iterations);
+        return *std::min_element(seconds.begin(), seconds.end()) /
+               static_cast<double>(iterations);
+    }
+
+    // 最近一次 Add / Time 记录的项，用于事后补上计数器或校验结果
+    Entry & last() { return entries_.back(); }
+
+    // 指定了 --json 时写出结果；有 correct == false 的项返回 1，写文件失败返回 2，否则 0
+    int Finish() const;
+
+  private:
+    std::string       argv0_;
+    std::string       json_path_;
+    int               repetitions_ = 5;
+    std::deque<Entry> entries_;
+};
+
+} // namespace microbench
+
+#define MICROBENCH_CONCAT_IMPL(a, b) a##b
+#define MICROBENCH_CONCAT(a, b)      MICROBENCH_CONCAT_IMPL(a, b)
+
+// BENCHMARK(BM_Foo)->Arg(8)->Range(64, 4096);
+#define BENCHMARK(fn)                                                                     \
+    [[maybe_unused]] static ::microbench::Benchmark * MICROBENCH_CONCAT(                  \
+        microbench_registered_, __COUNTER__) = ::microbench::RegisterBenchmark(#fn, fn)
+
+#endif // CPP_QA_LAB_CSRC_TECHNIQUES_NO_MAIN_EXECUTABLE_MICROBENCH_H_
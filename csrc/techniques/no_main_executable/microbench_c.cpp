@@ -0,0 +1,49 @@
+// microbench_c.cpp
+// microbench_c.h 的实现：MicrobenchReport 就是 microbench::Report，异常不越过 C 边界
+
+#include "microbench_c.h"
+
+#include <chrono>
+#include <exception>
+#include <vector>
+
+#include "common.h"
+#include "microbench.h"
+
+struct MicrobenchReport {
+    microbench::Report report;
+};
+
+extern "C" {
+
+double microbench_now(void) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+MicrobenchReport * microbench_report_new(int * argc, char ** argv, int default_repetitions) {
+    try {
+        return new MicrobenchReport{ microbench::Report(*argc, argv, default_repetitions) };
+    } catch (const std::exception & e) {
+        fmt::print(stderr, "参数错误: {}\n", e.what());
+        return nullptr;
+    }
+}
+
+int microbench_report_repetitions(const MicrobenchReport * report) {
+    return report->report.repetitions();
+}
+
+void microbench_report_add(MicrobenchReport * report, const char * name, const double * seconds,
+                           size_t count, uint64_t iterations, int correct) {
+    std::vector<double> samples(seconds, seconds + count);
+    report->report.Add(name, samples, iterations).correct = correct != 0;
+}
+
+int microbench_report_finish(MicrobenchReport * report) {
+    int status = report->report.Finish();
+    delete report;
+    return status;
+}
+
+} // extern "C"
@@ -0,0 +1,45 @@
+/* microbench_c.h
+ * microbench::Report 的 C 接口：纯 C 的驱动程序（c_polymorphism 的注册表基准）
+ * 链接 csrc::microbench 后用它计时和记录，输出与 C++ 驱动相同格式的 JSON。
+ *
+ *   MicrobenchReport * report = microbench_report_new(&argc, argv, 5);
+ *   double start = microbench_now();
+ *   ...
+ *   double seconds = microbench_now() - start;
+ *   microbench_report_add(report, "mixed/lock_free/t4", &seconds, 1, ops, 1);
+ *   return microbench_report_finish(report);
+ */
+
+#ifndef CPP_QA_LAB_CSRC_TECHNIQUES_NO_MAIN_EXECUTABLE_MICROBENCH_C_H_
+#define CPP_QA_LAB_CSRC_TECHNIQUES_NO_MAIN_EXECUTABLE_MICROBENCH_C_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct MicrobenchReport MicrobenchReport;
+
+/* 单调时钟的当前时间（秒），与 microbench::Seconds 用同一个时钟 */
+double microbench_now(void);
+
+/* 从命令行取走 --json= / --repetitions= / --min_time=，规则同 microbench::Report；
+ * 参数错误时打印原因并返回 NULL */
+MicrobenchReport * microbench_report_new(int * argc, char ** argv, int default_repetitions);
+
+int microbench_report_repetitions(const MicrobenchReport * report);
+
+/* seconds[0..count) 为每次重复的总耗时，iterations 为每次重复的操作数；correct 为 0 表示结果错误 */
+void microbench_report_add(MicrobenchReport * report, const char * name, const double * seconds,
+                           size_t count, uint64_t iterations, int correct);
+
+/* 写出 JSON 并释放 report，返回值同 microbench::Report::Finish */
+int microbench_report_finish(MicrobenchReport * report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CPP_QA_LAB_CSRC_TECHNIQUES_NO_MAIN_EXECUTABLE_MICROBENCH_C_H_ */
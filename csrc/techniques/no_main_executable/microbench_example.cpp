@@ -0,0 +1,124 @@
+// microbench_example.cpp
+// microbench 框架的使用示例：文件里没有 main，也没有手写计时
+//
+// 运行：
+//   ./build/bin/techniques/techniques_microbench_example
+//   ./build/bin/techniques/techniques_microbench_example --filter=Sort --json=-
+//   ./build/bin/techniques/techniques_microbench_example --counters=cycles,instructions
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "microbench.h"
+
+namespace {
+
+// 1. 参数扫描：预留容量与否对 push_back 的影响
+void BM_VectorPushBack(microbench::State & state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        std::vector<int> v;
+        for (size_t i = 0; i < n; ++i) {
+            v.push_back(static_cast<int>(i));
+        }
+        microbench::DoNotOptimize(v.data());
+        microbench::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+BENCHMARK(BM_VectorPushBack)->Range(8, 4096);
+
+void BM_VectorPushBackReserved(microbench::State & state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        std::vector<int> v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            v.push_back(static_cast<int>(i));
+        }
+        microbench::DoNotOptimize(v.data());
+        microbench::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+BENCHMARK(BM_VectorPushBackReserved)->Range(8, 4096);
+
+// 2. PauseTiming：每轮重新打乱数据，打乱本身不计入排序时间
+void BM_Sort(microbench::State & state) {
+    std::vector<int> data(static_cast<size_t>(state.range(0)));
+    std::mt19937     rng(42);
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (int & x : data) {
+            x = static_cast<int>(rng());
+        }
+        state.ResumeTiming();
+        std::sort(data.begin(), data.end());
+        microbench::DoNotOptimize(data.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Sort)->Range(1 << 10, 1 << 16);
+
+// 3. 多个参数 + 自定义计数器：map / unordered_map 查找，第二个参数是命中率（%）
+template <typename Map> void BM_Lookup(microbench::State & state) {
+    const auto n        = static_cast<int>(state.range(0));
+    const auto hit_rate = static_cast<int>(state.range(1));
+    Map        table;
+    for (int i = 0; i < n; ++i) {
+        table[i * 2] = i;
+    }
+    std::vector<int> keys(1024);
+    std::mt19937     rng(7);
+    for (int & k : keys) {
+        int i = static_cast<int>(rng() % n);
+        k     = static_cast<int>(rng() % 100) < hit_rate ? i * 2 : i * 2 + 1;
+    }
+
+    int64_t hits = 0;
+    size_t  next = 0;
+    for (auto _ : state) {
+        hits += table.count(keys[next]);
+        next  = (next + 1) & 1023;
+    }
+    // 计数器按每次迭代平均：总命中数 / 迭代次数 = 命中率
+    state.counters["hit_ratio"] = static_cast<double>(hits);
+}
+
+// 宏参数里不能直接出现带逗号的模板实参，先起别名
+using OrderedMap = std::map<int, int>;
+using HashMap    = std::unordered_map<int, int>;
+BENCHMARK(BM_Lookup<OrderedMap>)->Args({ 1 << 10, 90 })->Args({ 1 << 16, 90 });
+BENCHMARK(BM_Lookup<HashMap>)->Args({ 1 << 10, 90 })->Args({ 1 << 16, 90 });
+
+// 4. 不加 DoNotOptimize 的反例：整个循环被优化掉，测出来接近 0
+void BM_SumWithoutSink(microbench::State & state) {
+    std::vector<int> v(1024, 1);
+    for (auto _ : state) {
+        int sum = 0;
+        for (int x : v) {
+            sum += x;
+        }
+        (void) sum;
+    }
+    state.SetLabel("结果未使用，循环被删除");
+}
+BENCHMARK(BM_SumWithoutSink);
+
+void BM_SumWithSink(microbench::State & state) {
+    std::vector<int> v(1024, 1);
+    for (auto _ : state) {
+        int sum = 0;
+        for (int x : v) {
+            sum += x;
+        }
+        microbench::DoNotOptimize(sum);
+    }
+}
+BENCHMARK(BM_SumWithSink);
+
+} // namespace
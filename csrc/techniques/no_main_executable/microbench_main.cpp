@@ -0,0 +1,9 @@
+// microbench_main.cpp
+// 微基准的 main 函数提供者，作用与 main_provider.cpp 相同：
+// 基准文件里只有 BENCHMARK(...) 注册，链接 csrc::microbench_main 后由这里进入运行器
+
+#include "microbench.h"
+
+int main(int argc, char * argv[]) {
+    return microbench::RunRegisteredBenchmarks(argc, argv);
+}
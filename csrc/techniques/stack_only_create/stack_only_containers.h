@@ -0,0 +1,531 @@
+// stack_only_containers.h
+// Stack-only scoped containers for allocation-free temporaries.
+//
+// Same technique as StackOnly in stack_only.cpp (operator new is deleted), applied
+// to containers that keep their first N elements in an inline buffer:
+//   - InlineVector<T, N>
+//   - InlineString<N>
+//   - InlineHashMap<K, V, N>
+// Beyond N they spill to a caller-provided std::pmr::memory_resource (typically a
+// std::pmr::monotonic_buffer_resource that is reset once per outer iteration), so
+// even the overflow path does not have to touch the global heap.
+//
+// Compile-time guarantees:
+//   - `new InlineVector<...>`, `std::make_unique<InlineVector<...>>()` do not compile
+//   - copy / move are deleted, so the inline buffer can never be duplicated into
+//     (or pointed at from) an object with a different lifetime
+// What C++ cannot forbid: being a member of a heap-allocated object, or being
+// placement-new'ed by a container. Use these types as local variables only.
+
+#ifndef CPP_QA_LAB_STACK_ONLY_CONTAINERS_H
+#define CPP_QA_LAB_STACK_ONLY_CONTAINERS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Base class carrying the "no heap" rule. Deleting the array and nothrow forms
+// too closes the obvious loopholes.
+class StackOnlyBase {
+  public:
+    static void * operator new(std::size_t)                          = delete;
+    static void * operator new[](std::size_t)                        = delete;
+    static void * operator new(std::size_t, const std::nothrow_t &)   = delete;
+    static void * operator new[](std::size_t, const std::nothrow_t &) = delete;
+    static void   operator delete(void *)                            = delete;
+    static void   operator delete[](void *)                          = delete;
+
+  protected:
+    StackOnlyBase() = default;
+    ~StackOnlyBase() = default;
+
+    StackOnlyBase(const StackOnlyBase &)             = delete;
+    StackOnlyBase & operator=(const StackOnlyBase &) = delete;
+};
+
+// True when `new T` is ill-formed; used below to check the guarantee at compile time
+template <typename T, typename = void> struct is_stack_only : std::true_type {};
+
+template <typename T>
+struct is_stack_only<T, std::void_t<decltype(new T)>> : std::false_type {};
+
+template <typename T> inline constexpr bool is_stack_only_v = is_stack_only<T>::value;
+
+// ============================================================================
+// InlineVector<T, N>
+// ============================================================================
+
+template <typename T, std::size_t N> class InlineVector : private StackOnlyBase {
+    static_assert(N > 0, "InlineVector needs at least one inline slot");
+
+  public:
+    using value_type     = T;
+    using iterator       = T *;
+    using const_iterator = const T *;
+
+    explicit InlineVector(std::pmr::memory_resource * arena = std::pmr::get_default_resource())
+        : data_(inline_data()), arena_(arena) {}
+
+    ~InlineVector() {
+        clear();
+        release_spill();
+    }
+
+    template <typename... Args> T & emplace_back(Args &&... args) {
+        if (size_ == capacity_) {
+            return grow_and_emplace(std::forward<Args>(args)...);
+        }
+        T * p = ::new (static_cast<void *>(data_ + size_)) T(std::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+
+    void push_back(const T & value) { emplace_back(value); }
+
+    void push_back(T && value) { emplace_back(std::move(value)); }
+
+    void pop_back() {
+        --size_;
+        data_[size_].~T();
+    }
+
+    void clear() {
+        for (std::size_t i = 0; i < size_; ++i) {
+            data_[i].~T();
+        }
+        size_ = 0;
+    }
+
+    void reserve(std::size_t n) {
+        if (n > capacity_) {
+            grow(n);
+        }
+    }
+
+    T & operator[](std::size_t i) { return data_[i]; }
+
+    const T & operator[](std::size_t i) const { return data_[i]; }
+
+    T & back() { return data_[size_ - 1]; }
+
+    T * data() { return data_; }
+
+    const T * data() const { return data_; }
+
+    iterator begin() { return data_; }
+
+    iterator end() { return data_ + size_; }
+
+    const_iterator begin() const { return data_; }
+
+    const_iterator end() const { return data_ + size_; }
+
+    std::size_t size() const { return size_; }
+
+    std::size_t capacity() const { return capacity_; }
+
+    bool empty() const { return size_ == 0; }
+
+    // Still inside the inline buffer, i.e. nothing has been taken from the arena
+    bool on_stack() const { return data_ == inline_data(); }
+
+    static constexpr std::size_t inline_capacity() { return N; }
+
+  private:
+    T * inline_data() { return reinterpret_cast<T *>(inline_); }
+
+    const T * inline_data() const { return reinterpret_cast<const T *>(inline_); }
+
+    T * allocate(std::size_t n) {
+        return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T * p, std::size_t n) { arena_->deallocate(p, n * sizeof(T), alignof(T)); }
+
+    // Move (or copy) the elements into fresh. If a constructor throws, the ones
+    // already built in fresh are destroyed and the originals are left untouched.
+    void move_into(T * fresh) {
+        std::size_t i = 0;
+        try {
+            for (; i < size_; ++i) {
+                ::new (static_cast<void *>(fresh + i)) T(std::move_if_noexcept(data_[i]));
+            }
+        } catch (...) {
+            for (std::size_t j = 0; j < i; ++j) {
+                fresh[j].~T();
+            }
+            throw;
+        }
+    }
+
+    // Only called once every element lives in fresh
+    void adopt(T * fresh, std::size_t new_capacity) {
+        for (std::size_t i = 0; i < size_; ++i) {
+            data_[i].~T();
+        }
+        release_spill();
+        data_     = fresh;
+        capacity_ = new_capacity;
+    }
+
+    void grow(std::size_t new_capacity) {
+        T * fresh = allocate(new_capacity);
+        try {
+            move_into(fresh);
+        } catch (...) {
+            deallocate(fresh, new_capacity);
+            throw;
+        }
+        adopt(fresh, new_capacity);
+    }
+
+    // The new element is built first: args may refer to an element of this vector
+    // (v.push_back(v[0])), which must still be intact at that point
+    template <typename... Args> T & grow_and_emplace(Args &&... args) {
+        const std::size_t new_capacity = capacity_ * 2;
+        T *               fresh        = allocate(new_capacity);
+        T *               p            = nullptr;
+        try {
+            p = ::new (static_cast<void *>(fresh + size_)) T(std::forward<Args>(args)...);
+            move_into(fresh);
+        } catch (...) {
+            if (p) {
+                p->~T();
+            }
+            deallocate(fresh, new_capacity);
+            throw;
+        }
+        adopt(fresh, new_capacity);
+        ++size_;
+        return *p;
+    }
+
+    void release_spill() {
+        if (!on_stack()) {
+            arena_->deallocate(data_, capacity_ * sizeof(T), alignof(T));
+        }
+    }
+
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+    T *                         data_;
+    std::size_t                 size_     = 0;
+    std::size_t                 capacity_ = N;
+    std::pmr::memory_resource * arena_;
+};
+
+// ============================================================================
+// InlineString<N>: up to N characters inline, always NUL-terminated
+// ============================================================================
+
+template <std::size_t N> class InlineString : private StackOnlyBase {
+  public:
+    explicit InlineString(std::pmr::memory_resource * arena = std::pmr::get_default_resource())
+        : data_(inline_), arena_(arena) {
+        inline_[0] = '\0';
+    }
+
+    InlineString(std::string_view s,
+                 std::pmr::memory_resource * arena = std::pmr::get_default_resource())
+        : InlineString(arena) {
+        append(s);
+    }
+
+    ~InlineString() { release_spill(); }
+
+    InlineString & append(std::string_view s) {
+        if (size_ + s.size() > capacity_) {
+            // s may point into our own buffer, so it is copied before that buffer is released
+            grow(std::max(size_ + s.size(), capacity_ * 2), s);
+            return *this;
+        }
+        std::memcpy(data_ + size_, s.data(), s.size());
+        size_ += s.size();
+        data_[size_] = '\0';
+        return *this;
+    }
+
+    InlineString & operator+=(std::string_view s) { return append(s); }
+
+    InlineString & operator+=(char c) {
+        push_back(c);
+        return *this;
+    }
+
+    void push_back(char c) {
+        if (size_ == capacity_) {
+            grow(capacity_ * 2);
+        }
+        data_[size_++] = c;
+        data_[size_]   = '\0';
+    }
+
+    // Append the decimal representation without going through std::to_string
+    InlineString & append_number(std::uint64_t v) {
+        char   digits[20];
+        char * end = digits + sizeof(digits);
+        char * p   = end;
+        do {
+            *--p = static_cast<char>('0' + v % 10);
+            v /= 10;
+        } while (v != 0);
+        return append(std::string_view(p, static_cast<std::size_t>(end - p)));
+    }
+
+    void clear() {
+        size_    = 0;
+        data_[0] = '\0';
+    }
+
+    void reserve(std::size_t n) {
+        if (n > capacity_) {
+            grow(std::max(n, capacity_ * 2));
+        }
+    }
+
+    const char * c_str() const { return data_; }
+
+    const char * data() const { return data_; }
+
+    std::size_t size() const { return size_; }
+
+    std::size_t capacity() const { return capacity_; }
+
+    bool empty() const { return size_ == 0; }
+
+    bool on_stack() const { return data_ == inline_; }
+
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+    operator std::string_view() const { return view(); }
+
+  private:
+    // Move to a buffer of new_capacity, appending tail on the way
+    void grow(std::size_t new_capacity, std::string_view tail = std::string_view()) {
+        auto * fresh = static_cast<char *>(arena_->allocate(new_capacity + 1, 1));
+        std::memcpy(fresh, data_, size_);
+        std::memcpy(fresh + size_, tail.data(), tail.size());
+        size_ += tail.size();
+        fresh[size_] = '\0';
+        release_spill();
+        data_     = fresh;
+        capacity_ = new_capacity;
+    }
+
+    void release_spill() {
+        if (!on_stack()) {
+            arena_->deallocate(data_, capacity_ + 1, 1);
+        }
+    }
+
+    char                        inline_[N + 1];
+    char *                      data_;
+    std::size_t                 size_     = 0;
+    std::size_t                 capacity_ = N;
+    std::pmr::memory_resource * arena_;
+};
+
+// ============================================================================
+// InlineHashMap<K, V, N>: open addressing with linear probing
+// ============================================================================
+//
+// The inline table has the smallest power of two >= 2N slots, so up to N entries
+// stay at load factor <= 0.5 without leaving the stack. Past N the table doubles
+// into the arena. Erase uses backward-shift deletion, so there are no tombstones.
+
+template <typename K, typename V, std::size_t N, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>>
+class InlineHashMap : private StackOnlyBase {
+    static constexpr std::size_t RoundUpPow2(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    static constexpr std::size_t kInlineSlots = RoundUpPow2(2 * N);
+
+    struct Slot {
+        bool used;
+        alignas(std::pair<K, V>) unsigned char storage[sizeof(std::pair<K, V>)];
+
+        std::pair<K, V> & entry() {
+            return *std::launder(reinterpret_cast<std::pair<K, V> *>(storage));
+        }
+    };
+
+  public:
+    using value_type = std::pair<K, V>;
+
+    explicit InlineHashMap(std::pmr::memory_resource * arena = std::pmr::get_default_resource())
+        : slots_(inline_), arena_(arena) {
+        for (Slot & s : inline_) {
+            s.used = false;
+        }
+    }
+
+    ~InlineHashMap() {
+        clear();
+        release_spill();
+    }
+
+    // Insert (key, V(args...)) if key is absent; returns the value and whether it was inserted
+    template <typename... Args> std::pair<V *, bool> try_emplace(const K & key, Args &&... args) {
+        std::size_t i = probe(key);
+        if (slots_[i].used) {
+            return { &slots_[i].entry().second, false };
+        }
+        if (size_ + 1 > max_size_before_grow()) {
+            grow();
+            i = probe(key);
+        }
+        Slot & s = slots_[i];
+        ::new (static_cast<void *>(s.storage))
+            std::pair<K, V>(std::piecewise_construct, std::forward_as_tuple(key),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+        s.used = true;
+        ++size_;
+        return { &s.entry().second, true };
+    }
+
+    V & operator[](const K & key) { return *try_emplace(key).first; }
+
+    V * find(const K & key) {
+        std::size_t i = probe(key);
+        return slots_[i].used ? &slots_[i].entry().second : nullptr;
+    }
+
+    const V * find(const K & key) const { return const_cast<InlineHashMap *>(this)->find(key); }
+
+    bool contains(const K & key) const { return find(key) != nullptr; }
+
+    bool erase(const K & key) {
+        std::size_t i = probe(key);
+        if (!slots_[i].used) {
+            return false;
+        }
+        slots_[i].entry().~pair();
+        slots_[i].used = false;
+        --size_;
+        // Backward shift: pull later entries of the same cluster into the hole when
+        // their home slot is not strictly between the hole and their position
+        const std::size_t mask = slot_count_ - 1;
+        std::size_t       hole = i;
+        for (std::size_t j = (i + 1) & mask; slots_[j].used; j = (j + 1) & mask) {
+            std::size_t home = home_slot(slots_[j].entry().first);
+            if (((j - home) & mask) >= ((j - hole) & mask)) {
+                ::new (static_cast<void *>(slots_[hole].storage))
+                    std::pair<K, V>(std::move(slots_[j].entry()));
+                slots_[hole].used = true;
+                slots_[j].entry().~pair();
+                slots_[j].used = false;
+                hole           = j;
+            }
+        }
+        return true;
+    }
+
+    void clear() {
+        for (std::size_t i = 0; i < slot_count_ && size_ > 0; ++i) {
+            if (slots_[i].used) {
+                slots_[i].entry().~pair();
+                slots_[i].used = false;
+                --size_;
+            }
+        }
+    }
+
+    // Visit every (key, value); order is unspecified
+    template <typename F> void for_each(F && f) {
+        for (std::size_t i = 0; i < slot_count_; ++i) {
+            if (slots_[i].used) {
+                f(slots_[i].entry().first, slots_[i].entry().second);
+            }
+        }
+    }
+
+    std::size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    std::size_t slot_count() const { return slot_count_; }
+
+    bool on_stack() const { return slots_ == inline_; }
+
+    static constexpr std::size_t inline_capacity() { return N; }
+
+  private:
+    std::size_t max_size_before_grow() const { return slot_count_ / 2; }
+
+    std::size_t home_slot(const K & key) const {
+        // Fibonacci hashing: std::hash<int> is the identity, so mix before masking
+        std::uint64_t h = static_cast<std::uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<std::size_t>(h >> 32) & (slot_count_ - 1);
+    }
+
+    // Slot holding key, or the empty slot where it would be inserted
+    std::size_t probe(const K & key) const {
+        const std::size_t mask = slot_count_ - 1;
+        std::size_t       i    = home_slot(key);
+        while (slots_[i].used && !equal_(slots_[i].entry().first, key)) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void grow() {
+        Slot *      old_slots = slots_;
+        std::size_t old_count = slot_count_;
+        std::size_t new_count = old_count * 2;
+
+        void * fresh = arena_->allocate(new_count * sizeof(Slot), alignof(Slot));
+        slots_       = static_cast<Slot *>(fresh);
+        slot_count_  = new_count;
+        for (std::size_t i = 0; i < new_count; ++i) {
+            slots_[i].used = false;
+        }
+        for (std::size_t i = 0; i < old_count; ++i) {
+            if (old_slots[i].used) {
+                Slot & dst = slots_[probe(old_slots[i].entry().first)];
+                ::new (static_cast<void *>(dst.storage))
+                    std::pair<K, V>(std::move(old_slots[i].entry()));
+                dst.used = true;
+                old_slots[i].entry().~pair();
+            }
+        }
+        if (old_slots != inline_) {
+            arena_->deallocate(old_slots, old_count * sizeof(Slot), alignof(Slot));
+        }
+    }
+
+    void release_spill() {
+        if (!on_stack()) {
+            arena_->deallocate(slots_, slot_count_ * sizeof(Slot), alignof(Slot));
+        }
+    }
+
+    Slot                        inline_[kInlineSlots];
+    Slot *                      slots_;
+    std::size_t                 slot_count_ = kInlineSlots;
+    std::size_t                 size_       = 0;
+    std::pmr::memory_resource * arena_;
+    [[no_unique_address]] Hash     hash_;
+    [[no_unique_address]] KeyEqual equal_;
+};
+
+// The guarantee, checked where the types are defined
+static_assert(is_stack_only_v<InlineVector<int, 4>>);
+static_assert(is_stack_only_v<InlineString<16>>);
+static_assert(is_stack_only_v<InlineHashMap<int, int, 8>>);
+static_assert(!std::is_copy_constructible_v<InlineVector<int, 4>> &&
+              !std::is_move_constructible_v<InlineVector<int, 4>>);
+
+#endif // CPP_QA_LAB_STACK_ONLY_CONTAINERS_H
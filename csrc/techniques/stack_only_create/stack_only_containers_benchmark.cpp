@@ -0,0 +1,249 @@
+// ============================================================================
+// 栈上容器基准测试：InlineVector / InlineString / InlineHashMap
+// ============================================================================
+// 用法: stack_only_containers_benchmark [记录数]
+//
+// 每个场景都是"循环里建一个临时容器、用完即丢"：
+// 1. 切分 CSV 行：std::vector<string_view> vs InlineVector<string_view, 16>
+// 2. 拼接缓存键 "session:<id>:<shard>"：std::string（超出 SSO）vs InlineString<32>
+// 3. 每条记录的小直方图：std::unordered_map<int, int> vs InlineHashMap<int, int, 32>
+// 4. 超出 N 的行：InlineVector 溢出到默认堆 vs 溢出到栈上缓冲区的 monotonic arena
+// ============================================================================
+
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "microbench.h"
+#include "stack_only_containers.h"
+
+namespace {
+
+std::vector<std::string> MakeLines(std::size_t n, int min_fields, int max_fields) {
+    std::mt19937             rng(42);
+    std::vector<std::string> lines;
+    lines.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        int         fields = min_fields + static_cast<int>(rng() % (max_fields - min_fields + 1));
+        std::string line;
+        for (int f = 0; f < fields; ++f) {
+            if (f > 0) {
+                line += ',';
+            }
+            line.append(1 + rng() % 10, static_cast<char>('a' + rng() % 26));
+        }
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+// 把一行切成字段后做一点"真实"的工作：最长字段长度 + 字段数
+template <typename Fields> std::size_t SplitAndScore(std::string_view line, Fields & fields) {
+    std::size_t start = 0;
+    while (true) {
+        std::size_t comma = line.find(',', start);
+        if (comma == std::string_view::npos) {
+            fields.push_back(line.substr(start));
+            break;
+        }
+        fields.push_back(line.substr(start, comma - start));
+        start = comma + 1;
+    }
+    std::size_t longest = 0;
+    for (std::string_view f : fields) {
+        longest = std::max(longest, f.size());
+    }
+    return longest + fields.size();
+}
+
+void PrintHeader(const char * unit) {
+    fmt::print("  {:<44} {:>9} {:>9}\n", "方式", unit, "加速比");
+}
+
+void PrintRow(const char * name, double seconds, double baseline, std::size_t n) {
+    fmt::print("  {:<44} {:>9.1f} {:>8.2f}x\n", name, seconds / static_cast<double>(n) * 1e9,
+               baseline / seconds);
+}
+
+void BenchmarkSplit(microbench::Report & report, std::size_t n) {
+    auto        lines   = MakeLines(n, 4, 12);
+    std::size_t sums[2] = {};
+
+    double t_vector = report.Time("split/std_vector", [&] {
+        std::size_t sum = 0;
+        for (const std::string & line : lines) {
+            std::vector<std::string_view> fields;
+            sum += SplitAndScore(line, fields);
+        }
+        sums[0] = sum;
+    });
+    double t_inline = report.Time("split/inline_vector", [&] {
+        std::size_t sum = 0;
+        for (const std::string & line : lines) {
+            InlineVector<std::string_view, 16> fields;
+            sum += SplitAndScore(line, fields);
+        }
+        sums[1] = sum;
+    });
+
+    fmt::print("[1] 切分 CSV 行（{} 行，4~12 个字段）\n", n);
+    PrintHeader("ns/行");
+    PrintRow("std::vector<string_view>", t_vector, t_vector, n);
+    PrintRow("InlineVector<string_view, 16>", t_inline, t_vector, n);
+    fmt::print("  结果一致: {}\n\n", sums[0] == sums[1] ? "yes" : "NO");
+}
+
+void BenchmarkKeys(microbench::Report & report, std::size_t n) {
+    std::uint64_t hashes[2] = {};
+
+    double t_string = report.Time("keys/std_string", [&] {
+        std::uint64_t h = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            std::string key = "session:";
+            key += std::to_string(10000000 + i);
+            key += ':';
+            key += std::to_string(i % 64);
+            h ^= std::hash<std::string_view>()(key) + i;
+        }
+        hashes[0] = h;
+    });
+    double t_inline = report.Time("keys/inline_string", [&] {
+        std::uint64_t h = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            InlineString<32> key("session:");
+            key.append_number(10000000 + i);
+            key += ':';
+            key.append_number(i % 64);
+            h ^= std::hash<std::string_view>()(key.view()) + i;
+        }
+        hashes[1] = h;
+    });
+
+    fmt::print("[2] 拼接缓存键 \"session:<id>:<shard>\"（{} 个，约 20 字节）\n", n);
+    PrintHeader("ns/键");
+    PrintRow("std::string + std::to_string", t_string, t_string, n);
+    PrintRow("InlineString<32> + append_number", t_inline, t_string, n);
+    fmt::print("  结果一致: {}\n\n", hashes[0] == hashes[1] ? "yes" : "NO");
+}
+
+void BenchmarkHistogram(microbench::Report & report, std::size_t n) {
+    constexpr int    kValuesPerRecord = 24;
+    std::mt19937     rng(7);
+    std::vector<int> values(n * kValuesPerRecord);
+    for (int & v : values) {
+        v = static_cast<int>(rng() % 64);
+    }
+    std::size_t sums[2] = {};
+
+    // 每条记录：不同值的个数 + 最高频次
+    double t_unordered = report.Time("histogram/unordered_map", [&] {
+        std::size_t sum = 0;
+        for (std::size_t r = 0; r < n; ++r) {
+            std::unordered_map<int, int> counts;
+            int                          top = 0;
+            for (int k = 0; k < kValuesPerRecord; ++k) {
+                top = std::max(top, ++counts[values[r * kValuesPerRecord + k]]);
+            }
+            sum += counts.size() + static_cast<std::size_t>(top);
+        }
+        sums[0] = sum;
+    });
+    double t_inline = report.Time("histogram/inline_hash_map", [&] {
+        std::size_t sum = 0;
+        for (std::size_t r = 0; r < n; ++r) {
+            InlineHashMap<int, int, 32> counts;
+            int                         top = 0;
+            for (int k = 0; k < kValuesPerRecord; ++k) {
+                top = std::max(top, ++counts[values[r * kValuesPerRecord + k]]);
+            }
+            sum += counts.size() + static_cast<std::size_t>(top);
+        }
+        sums[1] = sum;
+    });
+
+    fmt::print("[3] 每条记录的直方图（{} 条，每条 24 个 0~63 的值）\n", n);
+    PrintHeader("ns/条");
+    PrintRow("std::unordered_map<int, int>", t_unordered, t_unordered, n);
+    PrintRow("InlineHashMap<int, int, 32>", t_inline, t_unordered, n);
+    fmt::print("  结果一致: {}\n\n", sums[0] == sums[1] ? "yes" : "NO");
+}
+
+void BenchmarkSpill(microbench::Report & report, std::size_t n) {
+    std::size_t count   = std::max<std::size_t>(1, n / 4);
+    auto        lines   = MakeLines(count, 24, 64);
+    std::size_t sums[3] = {};
+
+    double t_vector = report.Time("spill/std_vector", [&] {
+        std::size_t sum = 0;
+        for (const std::string & line : lines) {
+            std::vector<std::string_view> fields;
+            sum += SplitAndScore(line, fields);
+        }
+        sums[0] = sum;
+    });
+    double t_heap = report.Time("spill/inline_vector_heap", [&] {
+        std::size_t sum = 0;
+        for (const std::string & line : lines) {
+            InlineVector<std::string_view, 16> fields;
+            sum += SplitAndScore(line, fields);
+        }
+        sums[1] = sum;
+    });
+    // arena 的第一块缓冲区本身也在栈上；每行结束时 release() 把指针拨回开头
+    double t_arena = report.Time("spill/inline_vector_arena", [&] {
+        std::size_t                         sum = 0;
+        unsigned char                       buffer[4096];
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                                  std::pmr::null_memory_resource());
+        for (const std::string & line : lines) {
+            {
+                InlineVector<std::string_view, 16> fields(&arena);
+                sum += SplitAndScore(line, fields);
+            }
+            arena.release();
+        }
+        sums[2] = sum;
+    });
+
+    fmt::print("[4] 超出内联容量的行（{} 行，24~64 个字段，N = 16）\n", count);
+    PrintHeader("ns/行");
+    PrintRow("std::vector<string_view>", t_vector, t_vector, count);
+    PrintRow("InlineVector 溢出到默认堆", t_heap, t_vector, count);
+    PrintRow("InlineVector 溢出到栈上 monotonic arena", t_arena, t_vector, count);
+    fmt::print("  结果一致: {}\n\n", sums[0] == sums[1] && sums[0] == sums[2] ? "yes" : "NO");
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    microbench::Report report(argc, argv);
+    std::size_t        n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 400000;
+    n                    = std::max<std::size_t>(1, n);
+
+    spdlog::info("栈上容器基准测试（InlineVector / InlineString / InlineHashMap）");
+    spdlog::info("=====================================");
+    fmt::print("sizeof: InlineVector<string_view, 16> = {}, InlineString<32> = {}, "
+               "InlineHashMap<int, int, 32> = {}\n\n",
+               sizeof(InlineVector<std::string_view, 16>), sizeof(InlineString<32>),
+               sizeof(InlineHashMap<int, int, 32>));
+    BenchmarkSplit(report, n);
+    BenchmarkKeys(report, n);
+    BenchmarkHistogram(report, n);
+    BenchmarkSpill(report, n);
+
+    spdlog::info("关键学习点：");
+    spdlog::info("1. 临时容器的成本大多是 malloc/free，而不是元素操作本身");
+    spdlog::info("2. 删除 operator new 让\"只能在栈上\"成为编译期规则，inline 缓冲区不会被带到堆上");
+    spdlog::info("3. 超出 N 时溢出到调用者给的 arena；arena 按外层循环整体释放，仍然不碰全局堆");
+    spdlog::info("4. N 取典型规模的上界即可，太大会增加栈占用和清零/拷贝成本");
+    return report.Finish();
+}
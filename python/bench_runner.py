@@ -0,0 +1,368 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+基准回归运行器
+功能：按 CMake 生成的 manifest 运行所有注册的基准程序，收集逐次样本，
+      与保存的基线做统计检验（Mann-Whitney U），标出显著且超过噪声阈值的退化
+
+只依赖 Python 标准库，单机离线运行。通常通过构建目标调用：
+    cmake --build build --target bench_baseline   # 保存基线
+    cmake --build build --target bench            # 与基线对比，退化时返回非 0
+"""
+
+import json
+import math
+import os
+import platform
+import re
+import subprocess
+import sys
+import tempfile
+import time
+import unicodedata
+from datetime import datetime
+from pathlib import Path
+
+
+# ============================================================================
+# 统计工具
+# ============================================================================
+
+def median(values):
+    s = sorted(values)
+    n = len(s)
+    if n == 0:
+        return float('nan')
+    return s[n // 2] if n % 2 == 1 else 0.5 * (s[n // 2 - 1] + s[n // 2])
+
+
+def robust_cv(values):
+    """稳健变异系数：1.4826 * MAD / 中位数，对偶发的慢样本不敏感"""
+    m = median(values)
+    if len(values) < 2 or m <= 0:
+        return 0.0
+    mad = median([abs(v - m) for v in values])
+    return 1.4826 * mad / m
+
+
+def _ranks(values):
+    """平均秩（相同值取中间秩），返回秩列表和每组并列的个数"""
+    order = sorted(range(len(values)), key=lambda i: values[i])
+    ranks = [0.0] * len(values)
+    ties = []
+    i = 0
+    while i < len(order):
+        j = i
+        while j + 1 < len(order) and values[order[j + 1]] == values[order[i]]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[order[k]] = (i + j) / 2.0 + 1.0
+        ties.append(j - i + 1)
+        i = j + 1
+    return ranks, ties
+
+
+def _exact_u_distribution(n1, n2):
+    """无并列时 U 统计量的精确分布：counts[u] = 取到 U == u 的排列数"""
+    # table[i][j][u]：i 个 x、j 个 y 时 U == u 的排列数
+    table = [[[1] for _ in range(n2 + 1)] for _ in range(n1 + 1)]
+    for i in range(1, n1 + 1):
+        for j in range(1, n2 + 1):
+            # 最大的元素来自 x：它比所有 j 个 y 都大，U 增加 j
+            a = [0] * j + table[i - 1][j]
+            b = table[i][j - 1]
+            size = max(len(a), len(b))
+            table[i][j] = [(a[k] if k < len(a) else 0) + (b[k] if k < len(b) else 0)
+                           for k in range(size)]
+    return table[n1][n2]
+
+
+def mann_whitney_u(x, y):
+    """
+    双侧 Mann-Whitney U 检验
+    :return: (U_x, p 值)；样本小且无并列时用精确分布，否则用带并列修正的正态近似
+    """
+    n1, n2 = len(x), len(y)
+    ranks, ties = _ranks(list(x) + list(y))
+    r1 = sum(ranks[:n1])
+    u1 = r1 - n1 * (n1 + 1) / 2.0
+    u2 = n1 * n2 - u1
+    u_min = min(u1, u2)
+
+    if n1 * n2 <= 400 and all(t == 1 for t in ties):
+        counts = _exact_u_distribution(n1, n2)
+        total = sum(counts)
+        tail = sum(counts[:int(u_min) + 1])
+        return u1, min(1.0, 2.0 * tail / total)
+
+    n = n1 + n2
+    tie_term = sum(t ** 3 - t for t in ties) / (n * (n - 1)) if n > 1 else 0.0
+    sigma = math.sqrt(n1 * n2 / 12.0 * ((n + 1) - tie_term))
+    if sigma == 0:
+        return u1, 1.0
+    z = (abs(u1 - n1 * n2 / 2.0) - 0.5) / sigma
+    p = math.erfc(max(z, 0.0) / math.sqrt(2.0))
+    return u1, min(1.0, p)
+
+
+# ============================================================================
+# 运行基准
+# ============================================================================
+
+def cpu_model():
+    try:
+        with open('/proc/cpuinfo', encoding='utf-8') as f:
+            for line in f:
+                if line.startswith('model name'):
+                    return line.split(':', 1)[1].strip()
+    except OSError:
+        pass
+    return platform.processor() or platform.machine()
+
+
+def git_revision(source_dir):
+    try:
+        out = subprocess.run(['git', 'rev-parse', '--short', 'HEAD'], cwd=source_dir,
+                             capture_output=True, text=True, timeout=10)
+        if out.returncode == 0:
+            return out.stdout.strip()
+    except (OSError, subprocess.SubprocessError):
+        pass
+    return 'unknown'
+
+
+def run_process(cmd, timeout):
+    """运行一次基准程序，丢弃表格输出；返回错误信息或 None"""
+    try:
+        proc = subprocess.run(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE,
+                              timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return f'超时（>{timeout}s）'
+    except OSError as e:
+        return str(e)
+    if proc.returncode != 0:
+        tail = proc.stderr.decode('utf-8', 'replace').strip().splitlines()[-3:]
+        return f'退出码 {proc.returncode}: ' + ' | '.join(tail)
+    return None
+
+
+def collect(entry, args, tmp_dir):
+    """
+    所有注册的程序都链接 csrc::microbench，输出同一种 JSON：
+    benchmarks[].samples 为每次重复的 ns/操作，自带校验的项带 correct 字段
+    """
+    out_file = Path(tmp_dir) / f"{entry['name']}.json"
+    cmd = [entry['path']] + entry['args'] + [f'--json={out_file}',
+                                             f'--repetitions={args.repetitions}']
+    if args.min_time is not None:
+        cmd.append(f'--min_time={args.min_time}')
+    err = run_process(cmd, args.timeout)
+    if not out_file.exists():
+        return {}, err or '没有写出 JSON'
+    with open(out_file, encoding='utf-8') as f:
+        data = json.load(f)
+    results = {}
+    for b in data.get('benchmarks', []):
+        if 'error' in b:
+            continue
+        results[f"{entry['name']}/{b['name']}"] = {'unit': 'ns', 'samples': b['samples'],
+                                                    'correct': b.get('correct', True)}
+    # 结果校验失败时程序以退出码 1 结束，但 JSON 照常写出，错误项留给 correct 字段报告
+    if err and all(r['correct'] for r in results.values()):
+        return {}, err
+    return results, None
+
+
+def run_all(manifest, args):
+    benchmarks = {}
+    errors = {}
+    pattern = re.compile(args.filter) if args.filter else None
+    entries = [e for e in manifest['benchmarks'] if pattern is None or pattern.search(e['name'])]
+    with tempfile.TemporaryDirectory(prefix='bench_runner_') as tmp_dir:
+        for idx, entry in enumerate(entries, 1):
+            print(f"[{idx}/{len(entries)}] {entry['name']}", flush=True)
+            start = time.perf_counter()
+            results, err = collect(entry, args, tmp_dir)
+            if err:
+                print(f'    失败: {err}')
+                errors[entry['name']] = err
+                continue
+            print(f'    {len(results)} 项，用时 {time.perf_counter() - start:.1f}s')
+            benchmarks.update(results)
+    return benchmarks, errors
+
+
+# ============================================================================
+# 与基线对比
+# ============================================================================
+
+def incorrect_results(benchmarks):
+    """自带校验的基准（JSON 里的 correct 字段）中结果错误的项"""
+    return sorted(name for name, b in benchmarks.items() if b.get('correct') is False)
+
+
+def compare(baseline, current, args):
+    """逐项对比；返回 (行列表, 退化项列表, 结果错误项列表)"""
+    rows = []
+    regressions = []
+    wrong = incorrect_results(current)
+    for name in sorted(set(baseline) | set(current)):
+        if name not in current:
+            rows.append((name, '', '', '', '', '', '缺失'))
+            continue
+        if name not in baseline:
+            verdict = '结果错误' if name in wrong else '新增'
+            rows.append((name, '', fmt_ns(median(current[name]['samples'])), '', '', '', verdict))
+            continue
+        old = baseline[name]['samples']
+        new = current[name]['samples']
+        old_med, new_med = median(old), median(new)
+        change = new_med / old_med - 1.0 if old_med > 0 else 0.0
+        # 噪声感知阈值：两次运行中较大的稳健 CV 乘以系数，不低于固定下限
+        noise = max(robust_cv(old), robust_cv(new))
+        threshold = max(args.threshold, args.noise_factor * noise)
+        if min(len(old), len(new)) < 3:
+            p = float('nan')
+            significant = False
+        else:
+            _, p = mann_whitney_u(old, new)
+            significant = p < args.alpha
+        if name in wrong:
+            verdict = '结果错误'  # 错误的结果谈不上快慢
+        elif significant and change > threshold:
+            verdict = '退化'
+            regressions.append(name)
+        elif significant and change < -threshold:
+            verdict = '改进'
+        else:
+            verdict = '~'
+        rows.append((name, fmt_ns(old_med), fmt_ns(new_med), f'{change * 100:+.1f}%',
+                     f'{threshold * 100:.1f}%', 'n/a' if math.isnan(p) else f'{p:.4f}', verdict))
+    return rows, regressions, wrong
+
+
+def fmt_ns(ns):
+    for unit, scale in (('s', 1e9), ('ms', 1e6), ('us', 1e3)):
+        if ns >= scale:
+            return f'{ns / scale:.3f} {unit}'
+    return f'{ns:.2f} ns'
+
+
+def pad(text, width, right=False):
+    """按显示宽度补齐：中文等宽字符占两列"""
+    shown = sum(2 if unicodedata.east_asian_width(c) in 'WF' else 1 for c in text)
+    fill = ' ' * max(0, width - shown)
+    return fill + text if right else text + fill
+
+
+def print_table(rows):
+    header = ('基准', '基线中位数', '当前中位数', '变化', '阈值', 'p 值', '结论')
+    widths = (max([4] + [len(r[0]) for r in rows]), 14, 14, 8, 7, 7, 0)
+    print()
+    for r in [header, None] + rows:
+        if r is None:
+            print('-' * (sum(widths) + 14))
+            continue
+        cells = [pad(r[0], widths[0])]
+        cells += [pad(c, w, right=True) for c, w in zip(r[1:6], widths[1:6])]
+        print('  '.join(cells + [r[6]]))
+
+
+def main():
+    import argparse
+
+    parser = argparse.ArgumentParser(description='运行所有注册的基准并与基线对比')
+    parser.add_argument('--manifest', required=True, help='CMake 生成的 bench/manifest.json')
+    parser.add_argument('--baseline', required=True, help='基线 JSON 路径')
+    parser.add_argument('--output', help='本次结果写到这里（默认不写）')
+    parser.add_argument('--save-baseline', action='store_true', help='把本次结果保存为新基线')
+    parser.add_argument('--compare-only', metavar='RESULT_JSON',
+                        help='不运行，直接拿已有结果文件和基线对比')
+    parser.add_argument('--filter', help='只运行名字匹配该正则的基准程序')
+    parser.add_argument('--repetitions', type=int, default=7,
+                        help='传给每个程序的 --repetitions（默认 7）')
+    parser.add_argument('--min-time', dest='min_time', type=float,
+                        help='传给每个程序的 --min_time（只影响 BENCHMARK() 注册的基准）')
+    parser.add_argument('--timeout', type=float, default=600, help='单次运行超时（秒）')
+    parser.add_argument('--alpha', type=float, default=0.01, help='显著性水平（默认 0.01）')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='最小相对变化，低于它不算退化（默认 0.05）')
+    parser.add_argument('--noise-factor', type=float, default=2.0,
+                        help='阈值至少为该系数乘以稳健 CV（默认 2）')
+    parser.add_argument('--no-fail', action='store_true', help='有退化时也返回 0')
+    args = parser.parse_args()
+
+    source_dir = Path(__file__).resolve().parent.parent
+    if args.compare_only:
+        with open(args.compare_only, encoding='utf-8') as f:
+            result = json.load(f)
+        errors = result.get('errors', {})
+    else:
+        with open(args.manifest, encoding='utf-8') as f:
+            manifest = json.load(f)
+        benchmarks, errors = run_all(manifest, args)
+        result = {
+            'context': {
+                'date': datetime.now().isoformat(timespec='seconds'),
+                'host': platform.node(),
+                'cpu_model': cpu_model(),
+                'num_cpus': os.cpu_count(),
+                'git_revision': git_revision(source_dir),
+                'repetitions': args.repetitions,
+            },
+            'benchmarks': benchmarks,
+            'errors': errors,
+        }
+        if args.output:
+            Path(args.output).parent.mkdir(parents=True, exist_ok=True)
+            with open(args.output, 'w', encoding='utf-8') as f:
+                json.dump(result, f, indent=1, ensure_ascii=False)
+            print(f'\n结果已写入: {args.output}')
+
+    if args.save_baseline:
+        wrong = incorrect_results(result['benchmarks'])
+        if wrong:
+            print(f'{len(wrong)} 项结果校验失败，不保存基线: {", ".join(wrong)}')
+            return 1
+        Path(args.baseline).parent.mkdir(parents=True, exist_ok=True)
+        with open(args.baseline, 'w', encoding='utf-8') as f:
+            json.dump(result, f, indent=1, ensure_ascii=False)
+        print(f'基线已保存: {args.baseline}（{len(result["benchmarks"])} 项）')
+        return 1 if errors else 0
+
+    if not Path(args.baseline).exists():
+        print(f'没有基线 {args.baseline}，先运行 bench_baseline（或加 --save-baseline）')
+        return 1 if errors else 0
+
+    with open(args.baseline, encoding='utf-8') as f:
+        baseline = json.load(f)
+    old_ctx, new_ctx = baseline.get('context', {}), result.get('context', {})
+    if old_ctx.get('cpu_model') != new_ctx.get('cpu_model'):
+        print(f"警告: 基线来自不同的 CPU（{old_ctx.get('cpu_model')}），对比结果仅供参考")
+    if args.filter:
+        # 只对比本次运行的程序；键的第一段是程序名
+        pattern = re.compile(args.filter)
+        for data in (baseline, result):
+            data['benchmarks'] = {k: v for k, v in data['benchmarks'].items()
+                                  if pattern.search(k.split('/', 1)[0])}
+
+    rows, regressions, wrong = compare(baseline['benchmarks'], result['benchmarks'], args)
+    print_table(rows)
+    print(f"\n基线: {old_ctx.get('date')} ({old_ctx.get('git_revision')})  "
+          f"当前: {new_ctx.get('date')} ({new_ctx.get('git_revision')})")
+    print(f'判定规则: Mann-Whitney U 双侧 p < {args.alpha}，且中位数变化超过 '
+          f'max({args.threshold * 100:.0f}%, {args.noise_factor:g} x 稳健 CV)')
+    if errors:
+        print(f'{len(errors)} 个基准程序运行失败: {", ".join(sorted(errors))}')
+    # 结果错误和运行失败一样总是失败，--no-fail 只放过性能退化
+    if wrong:
+        print(f'{len(wrong)} 项结果校验失败: {", ".join(wrong)}')
+    if regressions:
+        print(f'{len(regressions)} 项显著退化: {", ".join(regressions)}')
+        return 1 if errors or wrong or not args.no_fail else 0
+    print('没有显著退化')
+    return 1 if errors or wrong else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,101 @@
+
+#include "common.hpp"
+#include "parallel/concurrent_hash_map.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Map = parallel::ConcurrentHashMap<std::uint64_t, std::uint64_t>;
+
+constexpr int kThreads = 4;
+
+template <typename F> void run_threads(F && f) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&f, t] { f(t); });
+    }
+    for (auto & th : threads) {
+        th.join();
+    }
+}
+
+} // namespace
+
+TEST_CASE("single-threaded find, insert_or_assign, upsert and erase") {
+    Map map(16);
+    CHECK_FALSE(map.find(1).has_value());
+    CHECK(map.insert_or_assign(1, 10));
+    CHECK_FALSE(map.insert_or_assign(1, 11));
+    CHECK(map.find(1).value() == 11);
+
+    CHECK(map.upsert(2, [](std::uint64_t & v) { v += 5; }, 100));
+    CHECK_FALSE(map.upsert(2, [](std::uint64_t & v) { v += 5; }, 100));
+    CHECK(map.find(2).value() == 105);
+
+    CHECK(map.erase(1));
+    CHECK_FALSE(map.erase(1));
+    CHECK_FALSE(map.contains(1));
+    CHECK(map.size() == 1);
+
+    // Tombstones left by erase must not break probing or be counted as live keys.
+    for (std::uint64_t k = 0; k < 1000; ++k) {
+        map.insert_or_assign(k, k * 2);
+        if (k % 3 == 0) {
+            map.erase(k);
+        }
+    }
+    CHECK(map.size() == 1000 - 334);
+    CHECK(map.find(998).value() == 1996);
+    CHECK_FALSE(map.contains(999));
+    CHECK(map.capacity() >= 1024);
+}
+
+TEST_CASE("concurrent upserts grow the table without losing updates") {
+    Map                     map(16);
+    constexpr std::uint64_t kKeys = 5000;
+    constexpr int           kReps = 3;
+    run_threads([&](int) {
+        for (int rep = 0; rep < kReps; ++rep) {
+            for (std::uint64_t k = 0; k < kKeys; ++k) {
+                map.upsert(k, [](std::uint64_t & v) { ++v; }, 1);
+            }
+        }
+    });
+    CHECK(map.size() == kKeys);
+    bool all_counted = true;
+    for (std::uint64_t k = 0; k < kKeys; ++k) {
+        all_counted = all_counted && map.find(k).value_or(0) == kThreads * kReps;
+    }
+    CHECK(all_counted);
+}
+
+TEST_CASE("readers see either the old or the new value while writers churn") {
+    Map                     map(64);
+    constexpr std::uint64_t kKeys = 256;
+    for (std::uint64_t k = 0; k < kKeys; ++k) {
+        map.insert_or_assign(k, k);
+    }
+    std::atomic<bool> torn{ false };
+    run_threads([&](int t) {
+        for (std::uint64_t i = 0; i < 20000; ++i) {
+            std::uint64_t k = (i * 7 + t) % kKeys;
+            if (t == 0) {
+                // Values are always k + n * kKeys, so any other value is a torn read.
+                map.upsert(k, [&](std::uint64_t & v) { v += kKeys; }, k);
+            } else if (t == 1 && i % 4 == 0) {
+                map.erase(k);
+                map.insert_or_assign(k, k);
+            } else if (auto v = map.find(k)) {
+                if (*v % kKeys != k) {
+                    torn = true;
+                }
+            }
+        }
+    });
+    CHECK_FALSE(torn.load());
+    CHECK(map.size() == kKeys);
+}
@@ -2,6 +2,9 @@
 #include "common.hpp"
 #include "heap_only.h"
 
+#include <cstdint>
+#include <set>
+
 TEST_CASE("create returns non-null and value is preserved") {
     auto p = HeapOnly::create(7);
     REQUIRE(p != nullptr);
@@ -13,3 +16,73 @@ TEST_CASE("create returns non-null and value is preserved") {
 // comments because they should not compile:
 // HeapOnly s(1); // error: constructor is private
 // HeapOnly copy = *p; // error: copy ctor deleted
+
+TEST_CASE("pooled create returns the slot to the pool on destruction") {
+    auto &            pool    = PooledHeapOnly::pool();
+    const std::size_t before  = pool.in_use();
+    void *            address = nullptr;
+    {
+        auto p = PooledHeapOnly::create(11);
+        REQUIRE(p != nullptr);
+        CHECK(p->getValue() == 11);
+        CHECK(pool.in_use() == before + 1);
+        address = p.get();
+    }
+    CHECK(pool.in_use() == before);
+
+    // The free list is LIFO, so the next object reuses the slot just released
+    auto q = PooledHeapOnly::create(12);
+    CHECK(static_cast<void *>(q.get()) == address);
+    CHECK(q->getValue() == 12);
+}
+
+TEST_CASE("pooled objects can be moved and released early") {
+    auto &              pool   = PooledHeapOnly::pool();
+    const std::size_t   before = pool.in_use();
+    auto                a      = PooledHeapOnly::create(1);
+    PooledHeapOnly::Ptr b      = std::move(a);
+    CHECK(a == nullptr);
+    CHECK(b->getValue() == 1);
+    b.reset();
+    CHECK(pool.in_use() == before);
+}
+
+TEST_CASE("create_batch yields distinct objects with consecutive values") {
+    auto &            pool   = PooledHeapOnly::pool();
+    const std::size_t before = pool.in_use();
+    const std::size_t n      = 5000;
+
+    auto batch = PooledHeapOnly::create_batch(n, 100);
+    REQUIRE(batch.size() == n);
+    CHECK(pool.in_use() == before + n);
+    CHECK(pool.capacity() >= pool.in_use());
+
+    std::set<const PooledHeapOnly *> addresses;
+    for (std::size_t i = 0; i < n; ++i) {
+        CHECK(batch[i]->getValue() == 100 + static_cast<int>(i));
+        addresses.insert(batch[i].get());
+    }
+    CHECK(addresses.size() == n);
+
+    // Releasing and re-creating the same number must not grow the pool
+    const std::size_t capacity = pool.capacity();
+    batch.clear();
+    CHECK(pool.in_use() == before);
+    batch = PooledHeapOnly::create_batch(n);
+    CHECK(pool.capacity() == capacity);
+}
+
+TEST_CASE("ObjectPool keeps slots aligned for over-aligned types") {
+    struct alignas(64) CacheLine {
+        char bytes[64];
+    };
+    ObjectPool<CacheLine, 8> pool;
+    std::vector<void *>      slots;
+    pool.allocate_batch(20, slots);
+    CHECK(pool.capacity() >= 20);
+    for (void * p : slots) {
+        CHECK(reinterpret_cast<std::uintptr_t>(p) % 64 == 0);
+        pool.deallocate(p);
+    }
+    CHECK(pool.in_use() == 0);
+}
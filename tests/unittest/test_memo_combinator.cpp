@@ -0,0 +1,48 @@
+
+#include "common.hpp"
+#include "basic/memo_combinator.h"
+
+#include <cstdint>
+#include <stdexcept>
+
+using cpp_qa_lab::basic::FlatMemo;
+using cpp_qa_lab::basic::HashMemo;
+using cpp_qa_lab::basic::MakeMemoY;
+using cpp_qa_lab::basic::MakeTrampolinedY;
+
+namespace {
+
+// Hofstadter Q: the keys of the two dependencies are computed from values.
+auto HofstadterQ() {
+    return [](auto & self, int n) -> int {
+        return n <= 2 ? 1 : self(n - self(n - 1)) + self(n - self(n - 2));
+    };
+}
+
+} // namespace
+
+TEST_CASE("trampolined evaluation handles keys computed from placeholder values") {
+    auto memo  = MakeMemoY<FlatMemo<int, int>>(HofstadterQ());
+    auto tramp = MakeTrampolinedY<FlatMemo<int, int>>(HofstadterQ());
+    CHECK(tramp(10) == 6);
+    CHECK(tramp(2000) == memo(2000));
+}
+
+TEST_CASE("a key that depends on itself or an ancestor is reported as a cycle") {
+    auto self_loop = MakeTrampolinedY<FlatMemo<int, int>>(
+        [](auto & self, int n) -> int { return n == 0 ? 0 : self(n) + 1; });
+    CHECK_THROWS_AS(self_loop(3), std::logic_error);
+
+    // 5 -> 4 -> 3 -> 5
+    auto ring = MakeTrampolinedY<HashMemo<int, int>>(
+        [](auto & self, int n) -> int { return n == 3 ? self(5) : self(n - 1); });
+    CHECK_THROWS_AS(ring(5), std::logic_error);
+}
+
+TEST_CASE("shared subproblems on a deep chain are not mistaken for a cycle") {
+    auto fib = MakeTrampolinedY<FlatMemo<uint64_t, int>>([](auto & self, int n) -> uint64_t {
+        return n < 2 ? n : (self(n - 1) + self(n - 2)) % 1000000007;
+    });
+    CHECK(fib(200000) > 0);
+    CHECK(fib.cache().size() == 200001);
+}
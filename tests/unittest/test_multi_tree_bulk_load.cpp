@@ -0,0 +1,205 @@
+
+#include "common.hpp"
+#include "algo/multi_tree_bulk_load.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Every case runs with SerialBackend and OpenMPBackend(4). Tests are not built with
+// OpenMP, so the latter runs its chunks serially, but it splits the work differently.
+namespace {
+
+struct Payload {
+    int value;
+
+    explicit Payload(int v) : value(v) {}
+};
+
+using Tree  = algo::MultiTree<Payload>;
+using Node  = algo::TreeNode<Payload>;
+using Edges = std::vector<algo::TreeEdge<Payload>>;
+
+template <typename F> void for_each_backend(F && f) {
+    parallel::SerialBackend serial;
+    f(serial);
+    parallel::OpenMPBackend openmp(4);
+    f(openmp);
+}
+
+std::unique_ptr<Payload> parse_payload(std::string_view field) {
+    if (field.empty()) {
+        return nullptr;
+    }
+    return std::make_unique<Payload>(std::stoi(std::string(field)));
+}
+
+// Message of the std::invalid_argument thrown by bulkLoadTree, empty if none was thrown
+template <typename Backend> std::string load_error(Backend & backend, Edges edges) {
+    try {
+        algo::bulkLoadTree(backend, std::move(edges));
+    } catch (const std::invalid_argument & e) {
+        return e.what();
+    }
+    return "";
+}
+
+bool contains(const std::string & text, const char * part) {
+    return text.find(part) != std::string::npos;
+}
+
+} // namespace
+
+TEST_CASE("bulk load keeps input order and indexes every name") {
+    for_each_backend([](auto & backend) {
+        Edges edges;
+        edges.push_back({ "model", "encoder", std::make_unique<Payload>(1) });
+        edges.push_back({ "encoder", "attention", nullptr });
+        edges.push_back({ "model", "decoder", std::make_unique<Payload>(2) });
+        edges.push_back({ "model", "head", nullptr });
+
+        // "model" is never a child, so it becomes the implicit root
+        Tree tree = algo::bulkLoadTree(backend, std::move(edges), "bulk");
+        REQUIRE(tree.getRoot() != nullptr);
+        CHECK(tree.getRoot()->getNodeName() == "model");
+        CHECK(tree.getNodeCount() == 5);
+        REQUIRE(tree.getRoot()->getChildrenCount() == 3);
+        CHECK(tree.getRoot()->getChildAt(0)->getNodeName() == "encoder");
+        CHECK(tree.getRoot()->getChildAt(1)->getNodeName() == "decoder");
+        CHECK(tree.getRoot()->getChildAt(2)->getNodeName() == "head");
+        CHECK(tree.findNodeByName("decoder")->getData()->value == 2);
+        CHECK(tree.findNodeByName("attention")->getParent() == tree.findNodeByName("encoder"));
+        CHECK(tree.findNodeByName("model") == tree.getRoot());
+    });
+}
+
+TEST_CASE("bulk load rejects duplicate and empty children") {
+    for_each_backend([](auto & backend) {
+        Edges duplicate;
+        duplicate.push_back({ "", "root", nullptr });
+        duplicate.push_back({ "root", "a", nullptr });
+        duplicate.push_back({ "root", "b", nullptr });
+        duplicate.push_back({ "b", "a", nullptr });
+        CHECK(contains(load_error(backend, std::move(duplicate)), "more than once"));
+
+        Edges empty;
+        empty.push_back({ "", "root", nullptr });
+        empty.push_back({ "root", "", nullptr });
+        CHECK(contains(load_error(backend, std::move(empty)), "empty child name"));
+    });
+}
+
+TEST_CASE("bulk load needs exactly one root and every node reachable from it") {
+    for_each_backend([](auto & backend) {
+        // An explicit root and an implicit one ("orphan" is never a child)
+        Edges two_roots;
+        two_roots.push_back({ "", "root", nullptr });
+        two_roots.push_back({ "root", "a", nullptr });
+        two_roots.push_back({ "orphan", "b", nullptr });
+        const std::string roots = load_error(backend, std::move(two_roots));
+        CHECK(contains(roots, "exactly one root, found 2"));
+
+        // b and c are each other's parent: the root is unique, but the cycle hangs off nothing
+        Edges cycle;
+        cycle.push_back({ "", "root", nullptr });
+        cycle.push_back({ "root", "a", nullptr });
+        cycle.push_back({ "b", "c", nullptr });
+        cycle.push_back({ "c", "b", nullptr });
+        const std::string unreachable = load_error(backend, std::move(cycle));
+        CHECK(contains(unreachable, "2 nodes are not reachable"));
+
+        // Without any root the whole edge set is a cycle
+        Edges closed;
+        closed.push_back({ "x", "y", nullptr });
+        closed.push_back({ "y", "x", nullptr });
+        CHECK(contains(load_error(backend, std::move(closed)), "found 0"));
+    });
+}
+
+TEST_CASE("CSV lines split across chunks are parsed exactly once") {
+    // Large enough that parseEdgeCsv cuts the text into several chunks; line lengths
+    // vary so the chunk boundaries land inside lines, on '\r', on '\n' and on blank lines.
+    std::string text = "# parent,child,value\r\n,root,0\r\n";
+    const int   n    = 6000;
+    for (int i = 1; i <= n; ++i) {
+        const std::string parent = i < 10 ? "root" : "n" + std::to_string(i / 10);
+        text += " " + parent + " , n" + std::to_string(i) + " ," + std::to_string(i);
+        text += i % 3 == 0 ? "\r\n" : "\n";
+        if (i % 7 == 0) {
+            text += "\r\n";
+        }
+        if (i % 11 == 0) {
+            text += "# comment " + std::string(i % 13, '-') + "\n\n";
+        }
+    }
+
+    for_each_backend([&](auto & backend) {
+        Edges edges = algo::parseEdgeCsv<Payload>(backend, text, parse_payload);
+        REQUIRE(edges.size() == static_cast<size_t>(n) + 1);
+        CHECK(edges[0].parent.empty());
+        CHECK(edges[0].child == "root");
+        int mismatches = 0;
+        for (int i = 1; i <= n; ++i) {
+            const bool ok = edges[i].child == "n" + std::to_string(i) && edges[i].payload &&
+                            edges[i].payload->value == i;
+            mismatches += ok ? 0 : 1;
+        }
+        CHECK(mismatches == 0);
+        CHECK(edges[n].parent == "n" + std::to_string(n / 10));
+
+        Tree tree = algo::bulkLoadTree(backend, std::move(edges));
+        CHECK(tree.getNodeCount() == static_cast<size_t>(n) + 1);
+        CHECK(tree.findNodeByName("n4321")->getParent() == tree.findNodeByName("n432"));
+    });
+
+    parallel::SerialBackend serial;
+    CHECK_THROWS_AS(algo::parseEdgeCsv<Payload>(serial, "root\n", parse_payload),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(algo::parseEdgeCsv<Payload>(serial, "root, ,1\n", parse_payload),
+                    std::invalid_argument);
+}
+
+TEST_CASE("createChildTo adds new names to a valid cache") {
+    for_each_backend([](auto & backend) {
+        Edges edges;
+        edges.push_back({ "", "root", nullptr });
+        edges.push_back({ "root", "a", nullptr });
+        Tree tree = algo::bulkLoadTree(backend, std::move(edges));
+
+        // The index built by the load is the cache; each child is found through it
+        Node * z  = tree.createChildTo("a", "z");
+        Node * z2 = tree.createChildTo("z", "z2");
+        REQUIRE(z != nullptr);
+        REQUIRE(z2 != nullptr);
+        CHECK(z2->getParent() == z);
+        CHECK(tree.findNodeByName("z") == z);
+        CHECK(tree.findNodeByName("z2") == z2);
+        CHECK(tree.createChildTo("missing", "w") == nullptr);
+    });
+}
+
+TEST_CASE("createChildTo with an existing name falls back to a full rebuild") {
+    // After a rebuild the node that comes last in level order owns the name. Checking
+    // both a deeper and a shallower duplicate rules out keeping either entry blindly.
+    Tree deeper;
+    deeper.createRoot("root");
+    deeper.createChildTo("root", "y");
+    deeper.createChildTo("root", "x");
+    Node * deeper_y = deeper.createChildTo("x", "y");
+    CHECK(deeper.findNodeByName("y") == deeper_y);
+
+    Tree shallower;
+    shallower.createRoot("root");
+    shallower.createChildTo("root", "x");
+    Node * first_y = shallower.createChildTo("x", "y");
+    Node * second  = shallower.createChildTo("root", "y");
+    CHECK(second != first_y);
+    CHECK(shallower.findNodeByName("y") == first_y);
+
+    // New names added after the rebuild are still found incrementally
+    Node * later = shallower.createChildTo("y", "later");
+    CHECK(later->getParent() == first_y);
+    CHECK(shallower.findNodeByName("later") == later);
+}
@@ -0,0 +1,111 @@
+
+#include "common.hpp"
+#include "parallel/parallel_algorithms.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// Large enough that every algorithm splits the input into several chunks.
+// Tests are not built with OpenMP, so OpenMPBackend(4) runs the chunks serially;
+// the chunking and prefix-sum logic is still exercised.
+namespace {
+
+constexpr std::size_t kN = 100003;
+
+std::vector<std::uint32_t> random_u32(std::size_t n, std::uint32_t seed) {
+    std::mt19937               rng(seed);
+    std::vector<std::uint32_t> v(n);
+    for (auto & x : v) {
+        x = rng();
+    }
+    return v;
+}
+
+} // namespace
+
+TEST_CASE("inclusive and exclusive scan match std, also in place") {
+    parallel::OpenMPBackend    backend(4);
+    std::vector<std::uint64_t> in(kN);
+    std::iota(in.begin(), in.end(), 1);
+
+    std::vector<std::uint64_t> expected(kN), out(kN);
+    std::inclusive_scan(in.begin(), in.end(), expected.begin());
+    parallel::inclusive_scan(backend, in.begin(), in.end(), out.begin());
+    CHECK(out == expected);
+
+    std::exclusive_scan(in.begin(), in.end(), expected.begin(), std::uint64_t{ 5 });
+    std::vector<std::uint64_t> inplace = in;
+    parallel::exclusive_scan(backend, inplace.begin(), inplace.end(), inplace.begin(),
+                             std::uint64_t{ 5 });
+    CHECK(inplace == expected);
+}
+
+TEST_CASE("radix sort handles signed integers and floats") {
+    parallel::OpenMPBackend backend(4);
+
+    std::vector<std::int32_t> ints(kN);
+    std::mt19937              rng(1);
+    for (auto & x : ints) {
+        x = static_cast<std::int32_t>(rng());
+    }
+    std::vector<std::int32_t> expected_ints = ints;
+    std::sort(expected_ints.begin(), expected_ints.end());
+    parallel::radix_sort(backend, ints);
+    CHECK(ints == expected_ints);
+
+    std::vector<double>              doubles(kN);
+    std::normal_distribution<double> dist(0.0, 100.0);
+    for (auto & x : doubles) {
+        x = dist(rng);
+    }
+    std::vector<double> expected_doubles = doubles;
+    std::sort(expected_doubles.begin(), expected_doubles.end());
+    parallel::radix_sort(backend, doubles);
+    CHECK(doubles == expected_doubles);
+}
+
+TEST_CASE("sample sort sorts with a custom comparator") {
+    parallel::OpenMPBackend backend(4);
+    auto                    v        = random_u32(kN, 2);
+    auto                    expected = v;
+    std::sort(expected.begin(), expected.end(), std::greater<>());
+    parallel::sample_sort(backend, v.begin(), v.end(), std::greater<>());
+    CHECK(v == expected);
+}
+
+TEST_CASE("stable partition keeps relative order on both sides") {
+    parallel::OpenMPBackend backend(4);
+    auto                    v              = random_u32(kN, 3);
+    auto                    expected       = v;
+    auto                    divisible_by_3 = [](std::uint32_t x) { return x % 3 == 0; };
+    auto expected_mid = std::stable_partition(expected.begin(), expected.end(), divisible_by_3);
+    auto mid          = parallel::stable_partition(backend, v.begin(), v.end(), divisible_by_3);
+    CHECK(mid - v.begin() == expected_mid - expected.begin());
+    CHECK(v == expected);
+}
+
+TEST_CASE("transform_reduce matches the serial backend and propagates exceptions") {
+    parallel::SerialBackend serial;
+    parallel::OpenMPBackend backend(4);
+    auto                    v      = random_u32(kN, 4);
+    auto                    square = [](std::uint32_t x) { return std::uint64_t{ x } * x; };
+    CHECK(parallel::transform_reduce(backend, v.begin(), v.end(), std::uint64_t{ 0 }, std::plus<>(),
+                                     square) ==
+          parallel::transform_reduce(serial, v.begin(), v.end(), std::uint64_t{ 0 }, std::plus<>(),
+                                     square));
+
+    auto throwing = [](std::uint32_t x) -> std::uint64_t {
+        if (x == 0) {
+            throw std::runtime_error("zero");
+        }
+        return x;
+    };
+    v[kN / 2] = 0;
+    CHECK_THROWS_AS(parallel::transform_reduce(backend, v.begin(), v.end(), std::uint64_t{ 0 },
+                                               std::plus<>(), throwing),
+                    std::runtime_error);
+}
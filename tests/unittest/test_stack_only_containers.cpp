@@ -0,0 +1,158 @@
+
+#include "common.hpp"
+#include "techniques/stack_only_create/stack_only_containers.h"
+
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Throws from the copy constructor once `budget` copies have been made
+struct Fragile {
+    static int budget;
+    static int live;
+
+    int value;
+
+    explicit Fragile(int v) : value(v) { ++live; }
+
+    Fragile(const Fragile & other) : value(other.value) {
+        if (budget-- == 0) {
+            throw std::runtime_error("copy failed");
+        }
+        ++live;
+    }
+
+    ~Fragile() { --live; }
+};
+
+int Fragile::budget = 0;
+int Fragile::live   = 0;
+
+// Sends every run of eight consecutive keys to the same home slot, so inserts build
+// long probe clusters and erase has to shift entries back across them.
+struct ClusterHash {
+    std::size_t operator()(int key) const { return static_cast<std::size_t>(key / 8); }
+};
+
+using ClusteredMap = InlineHashMap<int, std::string, 4, ClusterHash>;
+
+} // namespace
+
+// The default (heap) resource really frees spilled buffers, so ASan sees any
+// use of a released buffer.
+TEST_CASE("push_back of an own element survives the growth it triggers") {
+    InlineVector<std::string, 2> v;
+    v.push_back(std::string(40, 'a'));
+    v.push_back(std::string(40, 'b'));
+    v.push_back(v[0]); // full inline buffer: spills
+    v.push_back(v[1]);
+    v.push_back(v[2]); // full spilled buffer: grows again
+    CHECK(v.size() == 5);
+    CHECK(v[2] == std::string(40, 'a'));
+    CHECK(v[3] == std::string(40, 'b'));
+    CHECK(v[4] == std::string(40, 'a'));
+}
+
+TEST_CASE("a throwing copy during growth leaves the vector unchanged") {
+    std::pmr::monotonic_buffer_resource arena;
+    {
+        InlineVector<Fragile, 2> v(&arena);
+        v.emplace_back(1);
+        v.emplace_back(2);
+        // The new element is built, then the first relocation copy throws.
+        Fragile::budget = 1;
+        CHECK_THROWS_AS(v.push_back(Fragile(3)), std::runtime_error);
+        CHECK(v.size() == 2);
+        CHECK(v.on_stack());
+        CHECK(v[0].value == 1);
+        CHECK(v[1].value == 2);
+        CHECK(Fragile::live == 2);
+        Fragile::budget = 100;
+    }
+    CHECK(Fragile::live == 0);
+}
+
+TEST_CASE("append of the string's own contents after it spilled") {
+    InlineString<2> s("ab");
+    s.append("cd");
+    CHECK_FALSE(s.on_stack());
+    s.append(s.view());
+    CHECK(s.view() == "abcdabcd");
+    s.append(s.view()); // grows again from the spilled buffer
+    CHECK(s.view() == "abcdabcdabcdabcd");
+    CHECK(s.c_str()[s.size()] == '\0');
+}
+
+TEST_CASE("hash map keeps every key while growing past its inline slots") {
+    ClusteredMap m;
+    CHECK(m.on_stack());
+    for (int k = 0; k < 100; ++k) {
+        CHECK(m.try_emplace(k, std::to_string(k)).second);
+    }
+    CHECK_FALSE(m.on_stack());
+    CHECK(m.size() == 100);
+    CHECK(m.slot_count() >= 200);
+    for (int k = 0; k < 100; ++k) {
+        REQUIRE(m.find(k) != nullptr);
+        CHECK(*m.find(k) == std::to_string(k));
+    }
+    CHECK_FALSE(m.contains(100));
+}
+
+TEST_CASE("hash map erase inside a probe cluster keeps the rest reachable") {
+    ClusteredMap m;
+    for (int k = 0; k < 8; ++k) {
+        m[k] = std::to_string(k); // one cluster: all share a home slot
+    }
+    CHECK(m.erase(3));
+    CHECK_FALSE(m.erase(3));
+    CHECK_FALSE(m.contains(3));
+    for (int k = 0; k < 8; ++k) {
+        if (k != 3) {
+            REQUIRE(m.find(k) != nullptr);
+            CHECK(*m.find(k) == std::to_string(k));
+        }
+    }
+
+    // Random inserts and erases against std::map; the map spills and stays dense.
+    std::mt19937                       rng(7);
+    std::uniform_int_distribution<int> key(0, 63);
+    std::map<int, std::string>         model;
+    m.clear();
+    for (int step = 0; step < 4000; ++step) {
+        int k = key(rng);
+        if (rng() % 3 == 0) {
+            CHECK(m.erase(k) == (model.erase(k) == 1));
+        } else {
+            m[k]     = std::to_string(step);
+            model[k] = std::to_string(step);
+        }
+        if (step % 97 == 0) {
+            CHECK(m.size() == model.size());
+            for (int q = 0; q < 64; ++q) {
+                auto it = model.find(q);
+                REQUIRE(m.contains(q) == (it != model.end()));
+                if (it != model.end()) {
+                    CHECK(*m.find(q) == it->second);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("hash map overwrites existing keys in place") {
+    InlineHashMap<std::string, int, 4> m;
+    CHECK(m.try_emplace("a", 1).second);
+    m["b"] = 2;
+    CHECK_FALSE(m.try_emplace("a", 10).second); // an existing key is not replaced
+    CHECK(*m.find("a") == 1);
+    m["a"] = 11;
+    m["b"] += 20;
+    CHECK(m.size() == 2);
+    CHECK(*m.find("a") == 11);
+    CHECK(*m.find("b") == 22);
+}
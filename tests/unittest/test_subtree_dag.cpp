@@ -0,0 +1,139 @@
+
+#include "common.hpp"
+#include "algo/multi_tree.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+struct Payload {
+    int value;
+
+    explicit Payload(int v) : value(v) {}
+};
+
+using Tree   = algo::MultiTree<Payload>;
+using Node   = algo::TreeNode<Payload>;
+using Dag    = algo::SubtreeDag<Payload>;
+using Change = algo::TreeDiffEntry<Payload>;
+
+// model -> [block(a -> x, b), block(a -> x, b), head]
+void build(Tree & tree, int x_value) {
+    auto * root = tree.createRoot("model");
+    for (int i = 0; i < 2; ++i) {
+        auto * block = root->createChild("block");
+        block->createChild("a", std::unordered_set<std::string>{ "in" })
+            ->createChild("x", std::unordered_set<std::string>{},
+                          std::make_unique<Payload>(x_value));
+        block->createChild("b");
+    }
+    root->createChild("head");
+}
+
+uint64_t hash_payload(const Payload & p) { return static_cast<uint64_t>(p.value); }
+
+} // namespace
+
+TEST_CASE("identical subtrees share one id and are reported as duplicates") {
+    Tree tree;
+    build(tree, 1);
+    Dag dag = tree.buildSubtreeDag();
+
+    const Node * block0 = tree.getRoot()->getChildAt(0);
+    const Node * block1 = tree.getRoot()->getChildAt(1);
+    CHECK(dag.nodeCount() == 10);
+    // model, block, a, x, b, head
+    CHECK(dag.size() == 6);
+    CHECK(dag.idOf(block0) == dag.idOf(block1));
+    CHECK(dag.entry(dag.idOf(block0)).occurrences == 2);
+    CHECK(dag.entry(dag.idOf(block0)).subtree_size == 4);
+
+    auto groups = dag.duplicateGroups();
+    CHECK(groups.size() == 2);
+    CHECK(groups[0].front()->getNodeName() == "block");
+    CHECK(groups[1].front()->getNodeName() == "a");
+
+    // Input names are part of the label, so changing them splits the shared subtree.
+    tree.getRoot()->getChildAt(1)->getChildAt(0)->addInputName("extra");
+    Dag split = tree.buildSubtreeDag();
+    CHECK(split.idOf(block0) != split.idOf(block1));
+    CHECK(split.idOf(block0->getChildAt(1)) == split.idOf(block1->getChildAt(1)));
+}
+
+TEST_CASE("payloads only take part when a payload hash is given") {
+    Tree tree;
+    build(tree, 1);
+    tree.getRoot()->getChildAt(1)->getChildAt(0)->getChildAt(0)->getData()->value = 2;
+
+    const Node * block0 = tree.getRoot()->getChildAt(0);
+    const Node * block1 = tree.getRoot()->getChildAt(1);
+    Dag          names_only = tree.buildSubtreeDag();
+    Dag          with_data  = tree.buildSubtreeDag(hash_payload);
+    CHECK(names_only.idOf(block0) == names_only.idOf(block1));
+    CHECK(with_data.idOf(block0) != with_data.idOf(block1));
+}
+
+TEST_CASE("merged levels keep one representative per distinct subtree") {
+    Tree tree;
+    build(tree, 1);
+    auto levels = tree.getMergedLevels();
+    CHECK(levels.size() == 4);
+    CHECK(levels[1].size() == 2); // block, head
+    CHECK(levels[1][0].first == "block");
+    CHECK(levels[1][0].second.size() == 1);
+    CHECK(levels[3][0].first == "x");
+}
+
+TEST_CASE("diff reports only the changed paths") {
+    Tree before;
+    Tree after;
+    build(before, 1);
+    build(after, 1);
+    CHECK(before.diff(after, hash_payload).empty());
+
+    Node * block1 = after.getRoot()->getChildAt(1);
+    block1->getChildAt(0)->getChildAt(0)->getData()->value = 5;
+    block1->removeChildAt(1);
+    after.getRoot()->getChildAt(2)->createChild("argmax");
+
+    auto changes = before.diff(after, hash_payload);
+    CHECK(changes.size() == 3);
+    int added    = 0;
+    int removed  = 0;
+    int modified = 0;
+    for (const Change & c : changes) {
+        if (c.kind == Change::Kind::Added) {
+            ++added;
+            CHECK(c.after->getNodeName() == "argmax");
+        } else if (c.kind == Change::Kind::Removed) {
+            ++removed;
+            CHECK(c.before->getNodeName() == "b");
+        } else {
+            ++modified;
+            CHECK(c.after->getNodeName() == "x");
+        }
+    }
+    CHECK(added == 1);
+    CHECK(removed == 1);
+    CHECK(modified == 1);
+
+    // Without a payload hash the value change is invisible.
+    CHECK(before.diff(after).size() == 2);
+}
+
+TEST_CASE("interning a tree after one of its subtrees does not count it twice") {
+    Tree tree;
+    build(tree, 1);
+    const Node * block0 = tree.getRoot()->getChildAt(0);
+
+    Dag            dag;
+    const uint32_t block_id = dag.intern(block0);
+    CHECK(dag.intern(tree.getRoot()) == dag.idOf(tree.getRoot()));
+    CHECK(dag.idOf(block0) == block_id);
+    CHECK(dag.nodeCount() == 10);
+    CHECK(dag.entry(block_id).occurrences == 2);
+}
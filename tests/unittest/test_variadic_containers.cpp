@@ -0,0 +1,51 @@
+
+#include "common.hpp"
+#include "basic/variadic_containers.h"
+
+#include <stdexcept>
+#include <string>
+
+using cpp_variadic::FastVariant;
+using cpp_variadic::PackedTuple;
+
+namespace {
+
+struct NoDefault {
+    explicit NoDefault(int v) : value(v) {}
+
+    int value;
+};
+
+struct Boom {
+    Boom() { throw std::runtime_error("boom"); }
+};
+
+} // namespace
+
+TEST_CASE("single-element PackedTuple is copyable and movable") {
+    PackedTuple<int>       a(5);
+    PackedTuple<int>       b(a);
+    const PackedTuple<int> c(b);
+    PackedTuple<int>       d(std::move(b));
+    CHECK(c.Get<0>() == 5);
+    CHECK(d == a);
+}
+
+TEST_CASE("PackedTuple constructs members in place without default construction") {
+    PackedTuple<NoDefault, char> t(NoDefault(1), 'x');
+    CHECK(t.Get<0>().value == 1);
+    CHECK(t.Get<1>() == 'x');
+
+    PackedTuple<char, std::string, char> s('a', std::string("packed"), 'b');
+    CHECK(s.Get<1>() == "packed");
+    CHECK(s.Get<2>() == 'b');
+}
+
+TEST_CASE("a valueless FastVariant holds none of its alternatives") {
+    FastVariant<int, Boom> v(1);
+    CHECK_THROWS_AS(v.Emplace<1>(), std::runtime_error);
+    CHECK(v.valueless());
+    CHECK_FALSE(v.HoldsAlternative<int>());
+    CHECK_FALSE(v.HoldsAlternative<Boom>());
+    CHECK(v.GetIf<int>() == nullptr);
+}